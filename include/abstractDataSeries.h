@@ -23,6 +23,22 @@
  *
  *   Final      -- data is finalized; no more values are accepted; end state
  *
+ * Modified: 10/19/26
+ * Notes:    --Added isValidCell for kernels that walk a bitmap directly
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a validity bitmap. Cells that hold no data (gaps in the
+ *             file, sentinel values, padding) are marked invalid instead of
+ *             passing their placeholder values off as data. A NULL bitmap
+ *             means every cell is valid.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added getDataType
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added raw data access (getValueSize, getRawData, loadRawData)
+ *             so finalized series can be stored and restored in binary form
+ *
  * Modified: 08/12/10
  * Notes:    --Reverting back to inheritance for dynamic polymorphism
  *           --Pushing template into child class
@@ -50,6 +66,7 @@
  */
 #include <string>
 #include <cstring>
+#include <stdint.h>
 
 #ifndef CRSCORR_ABSTRACTDATASERIES_H
 #define CRSCORR_ABSTRACTDATASERIES_H
@@ -77,6 +94,27 @@ class AbstractDataSeries {
     int resolution;           // time resolution of the data, minutes
     int startTime;            // start time in HHMM format of the data set
                               //   measured from 00:00 UTC
+    uint64_t* validity;       // bit i set when cell i holds data; NULL when
+                              //   every cell does
+
+    //----<VALIDITY METHODS>----------------------------------------------------
+    /*
+     * Builds the validity of this series from cells of another series: cell i
+     *   of this series takes the validity of cell i * step + offset of the
+     *   source. The bitmap stays NULL when every chosen cell is valid.
+     */
+    void sampleValidity( const AbstractDataSeries& source,
+                         const int step,
+                         const int offset );
+
+    /*
+     * Builds the validity of this series as the concatenation of two series.
+     *   The length of this series must already be the combined length.
+     */
+    void concatValidity( const uint64_t* const first,
+                         const int firstLength,
+                         const uint64_t* const second,
+                         const int secondLength );
     //----<ACCESSOR METHODS>----------------------------------------------------
     /*
      * Updates the collecting state. This will only convert collecting to true
@@ -117,6 +155,15 @@ class AbstractDataSeries {
      */
     const bool setParams( const int len, const int start, const int reso );
 
+    /*
+     * Moves an unused series into the collecting state with a fixed length,
+     *   start time, and resolution, with every cell invalid until a value is
+     *   placed into it.
+     *
+     * Return: bool -- true on success
+     */
+    const bool setGrid( const int len, const int start, const int reso );
+
     /*
      * Updates the length variable
      */
@@ -190,6 +237,66 @@ class AbstractDataSeries {
      */
     virtual void finalizeData() = 0;
 
+    /*
+     * Lays out an unused series as a grid of len cells at the provided
+     *   resolution and start time. Values are then placed into cells by
+     *   index with placeValue rather than appended; cells never placed stay
+     *   invalid after finalizeData.
+     *
+     * Param:
+     *   const int len -- number of cells, > 0
+     *   const int reso -- resolution of the cells
+     *   const int start -- start time of the first cell
+     *
+     * Return: bool -- true on success
+     */
+    virtual const bool initGrid( const int len,
+                                 const int reso,
+                                 const int start ) = 0;
+
+    /*
+     * Stores a value into a cell of a grid series and marks it valid. A
+     *   value placed twice into the same cell replaces the first.
+     *
+     * Return: bool -- true on success
+     */
+    virtual const bool placeValue( const void* value, const int cell ) = 0;
+
+    /*
+     * Returns the data type constant (DATATYPE_INT, DATATYPE_DOUBLE) of the
+     *   stored values.
+     */
+    virtual const int getDataType() const = 0;
+
+    /*
+     * Returns the size in bytes of a single stored value.
+     */
+    virtual const int getValueSize() const = 0;
+
+    /*
+     * Allows untyped access to the finalized data array. Returns NULL if the
+     *   series is not final.
+     */
+    virtual const void* getRawData() const = 0;
+
+    /*
+     * Loads a block of previously finalized values directly into a series
+     *   that has not yet received any data, moving it to the Final state.
+     *   Values are copied and must be of the series' own type.
+     *
+     * Param:
+     *   const void* values -- array of len values
+     *   const int len -- number of values, > 0
+     *   const int reso -- resolution of the values
+     *   const int start -- start time of the values
+     *
+     * Return: bool -- true on success
+     */
+    virtual const bool loadRawData( const void* values,
+                                    const int len,
+                                    const int reso,
+                                    const int start ) = 0;
+
     //----<ACCESSOR METHODS>---------------------------------------------------
     /*
      * Retrieves the label of the data series
@@ -211,6 +318,33 @@ class AbstractDataSeries {
      */
     const int getStartTime() const;
 
+    /*
+     * Returns the validity bitmap, one bit per cell in 64 bit words, or NULL
+     *   if every cell holds data.
+     */
+    const uint64_t* getValidity() const;
+
+    /*
+     * Returns true if the cell holds data rather than a placeholder.
+     */
+    const bool isValid( const int cell ) const;
+
+    /*
+     * Returns the number of cells holding data.
+     */
+    const int getValidCount() const;
+
+    /*
+     * Marks count cells starting at first as holding no data.
+     */
+    void invalidate( const int first, const int count );
+
+    /*
+     * Replaces the validity bitmap with a copy of the provided words, which
+     *   must cover the current length. NULL marks every cell valid.
+     */
+    void setValidity( const uint64_t* const words );
+
     /*
      * Returns whether the series is in collection mode or not.
      *
@@ -232,4 +366,13 @@ class AbstractDataSeries {
     const bool isFinal() const;
 };
 
+/*
+ * Returns true if cell holds data in a validity bitmap as returned by
+ *   getValidity(). A NULL bitmap marks every cell valid; the cell is not
+ *   range checked.
+ */
+inline bool isValidCell( const uint64_t* validity, const int cell ) {
+  return validity == NULL || (( validity[ cell >> 6 ] >> ( cell & 63 )) & 1 );
+}// end inline bool isValidCell( const uint64_t*, const int )
+
 #endif
@@ -3,6 +3,16 @@
  *   NTP reference clock. This format is subject to regular changes during
  *   developement.
  *
+ * Modified: 10/19/26
+ * Notes:    snapshot() finds its series through the label index
+ *
+ * Modified: 10/19/26
+ * Notes:    A rotated file is read to its end before the new one is followed
+ *
+ * Modified: 10/19/26
+ * Notes:    Added a tail mode which follows a growing clockstats file and
+ *             feeds newly appended wwv5 lines into the open data series
+ *
  * Modified: 07/17/10
  * Notes:    Initial Creation
  */
@@ -35,19 +45,38 @@
 #define WWV5_LABEL_10 "WV10"          // identifier for wwv2 station
 #define WWV5_LABEL_15 "WV15"          // identifier for wwv2 station
 #define WWV5_LABEL_20 "WV20"          // identifier for wwv2 station
+#define WWV5_TAIL_CHUNK 65536         // bytes read at once while tailing
 
 
 class ClkStatsParser : public FileParser {
 
   public:
+    /*
+     * SampleCallback
+     *
+     * Invoked in tail mode each time a value is appended to one of the open
+     *   data series. The value points to an int or a double according to the
+     *   type of the series' tag.
+     */
+    typedef void (*SampleCallback)( const AbstractDataSeries& series,
+                                    const void* value,
+                                    void* context );
+
     //----< (DE/CON)STRUCTORS >-------------------------------------------------
     /*
      * Constructors are supplied without parameters as those shouldn't be
      *   needed (minus the copy constructor). Destructors and the assignment
      *   operator are also provided here.
+     *
+     * The callback constructor opens the file in tail mode instead of parsing
+     *   it: the data series stay open (collecting) and are filled by poll()
+     *   or follow() as the reference clock appends lines.
      */
     ClkStatsParser();
     ClkStatsParser( string fileName );
+    ClkStatsParser( string fileName,
+                    SampleCallback callback,
+                    void* context = NULL );
     ClkStatsParser( const ClkStatsParser& copy );
     ~ClkStatsParser();
     ClkStatsParser& operator=(const ClkStatsParser& copy );
@@ -59,7 +88,81 @@ class ClkStatsParser : public FileParser {
      */
     void parseFile();
 
+    //----< TAIL METHODS >------------------------------------------------------
+    /*
+     * Reads any bytes appended to the file since the last call and parses the
+     *   complete lines among them. A trailing partial line is held until the
+     *   rest of it arrives. A truncated file is restarted from its beginning.
+     *   A replaced (rotated) file is first read to its end, then the file
+     *   now carrying the name is followed from its beginning.
+     *
+     * Return: number of wwv5 lines processed, -1 on error
+     */
+    const int poll();
+
+    /*
+     * Repeatedly polls the file until *stop becomes true. Between polls the
+     *   function waits for a modification notice from inotify, or for the
+     *   interval when inotify is unavailable.
+     *
+     * Param:
+     *   const int interval -- longest wait between polls, milliseconds
+     *   volatile bool* const stop -- set by the caller to end following
+     *
+     * Return: false if the file could not be followed
+     */
+    const bool follow( const int interval, volatile bool* const stop );
+
+    /*
+     * Ends tail mode and finalizes the data series, after which they are
+     *   available through getSeries().
+     */
+    void finishTail();
+
+    /*
+     * Returns a finalized copy of an open data series so that correlations
+     *   can be run on the data collected so far. The caller owns the copy.
+     *
+     * Return: the copy or NULL if the label is not found or has no data
+     */
+    template<typename DataType>
+    DataSeries<DataType>* snapshot( const FileParser::DataTag* tag ) const
+    {
+      LOG_DEBUG( 11, "( " << tag->label << " )" )
+
+      int index = findIndex( tag->label );
+      if( index < 0 || data[index] == NULL
+          || tags[index].type != tag->type
+          || SeriesType<DataType>::type != tag->type
+          || ( !data[index]->isCollecting() && !data[index]->isFinal() ))
+      {
+        return NULL;
+      }
+      DataSeries<DataType>* copy = new DataSeries<DataType>(
+          *static_cast<const DataSeries<DataType>*>( data[index] ));
+      if( copy->isCollecting() ) {
+        copy->finalizeData();
+      }
+      return copy;
+    }// end DataSeries<DataType>* snapshot( const DataTag* ) const
+
   protected:
+    //----< PARSING METHODS >---------------------------------------------------
+    /*
+     * Tokenizes a single clockstats line and, if it is a wwv5 line, adds its
+     *   values to the data series of the station it reports.
+     *
+     * Param:
+     *   char* dataLine -- null terminated line, modified by tokenizing
+     *   const int lineLength -- bytes in the line
+     *   const int startTime -- start time passed to the series
+     *
+     * Return: true if the line was a usable wwv5 line
+     */
+    const bool parseLine( char* dataLine,
+                          const int lineLength,
+                          const int startTime );
+
     //----< MISC >--------------------------------------------------------------
      /*
       * Static array which contains all of the labels used for the data
@@ -67,6 +170,28 @@ class ClkStatsParser : public FileParser {
       *   so that a user can select which data series to retrieve.
       */
    static const FileParser::DataTag tags[];
+
+  private:
+    //----< TAIL STATE >--------------------------------------------------------
+    SampleCallback sampleCallback;    // receiver of tailed values
+    void* sampleContext;              // passed through to sampleCallback
+    int tailFile;                     // descriptor of the followed file
+    long long tailOffset;             // bytes of the file consumed so far
+    string tailPartial;               // incomplete last line
+    int tailStartTime;                // start time counter, as in parseFile
+    bool tailing;                     // series open and following the file
+
+    /*
+     * Opens the followed file, resetting the offset and partial line.
+     */
+    const bool openTail();
+
+    /*
+     * Parses the complete lines appended to the open file since tailOffset.
+     *
+     * Return: number of wwv5 lines processed, -1 on error
+     */
+    const int readTail();
 };
 
 #endif
\ No newline at end of file
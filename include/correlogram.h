@@ -0,0 +1,220 @@
+/*
+ * Sliding window correlogram: the correlation of two series at a range of
+ *   lags, recomputed over a window stepped along them, giving a window by
+ *   lag matrix that shows how a lag relationship drifts over months.
+ *
+ *   Entry ( w, lag ) is the Pearson correlation of the jointly valid pairs
+ *   a[ s + i ], b[ s + i + lag ] for i in 0 to window - 1, where s = w * hop,
+ *   the same normalization crsCorr::maskedCorrelation uses; a positive lag
+ *   pairs a with later b.
+ *
+ *   Consecutive windows share all but hop cells, so rather than correlating
+ *   each window afresh, the six sums behind every lag's correlation (count,
+ *   sum a, sum b, sum a^2, sum b^2, sum ab) are updated by removing the
+ *   cells that leave and adding the cells that enter. Each sum runs over the
+ *   lags in its inner loop, contiguous and vectorizable. Windows are split
+ *   into contiguous blocks, one per thread, and sums are rebuilt from
+ *   scratch every CORRELOGRAM_REFRESH windows to bound rounding drift.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <string>
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+#include <crsCorr/dataSeries.h>
+
+#ifndef CRSCORR_CORRELOGRAM_H
+#define CRSCORR_CORRELOGRAM_H
+
+#define CORRELOGRAM_REFRESH 64          // windows between rebuilt sums
+#define CORRELOGRAM_VERSION 1           // binary file layout
+
+// namespace convention
+using std::string;
+
+class Correlogram {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    /*
+     * Block
+     *
+     * The windows one thread computes, with the centered, masked inputs all
+     *   threads share.
+     */
+    typedef struct Block {
+      Correlogram* correlogram;
+      const double* a;                  // centered a, 0 where invalid
+      const double* aMask;              // 1 where a is valid
+      const double* b;                  // centered b padded by lag, 0 where
+                                        // invalid or out of range
+      const double* bMask;              // 1 where padded b is valid
+      int first;                        // first window
+      int last;                         // one past the last window
+    } Block;
+
+    //----< DATA MEMBERS >------------------------------------------------------
+    double* values;                     // windows * lags correlations
+    int* counts;                        // jointly valid pairs per entry
+    uint64_t* validity;                 // bit per defined entry
+    const int windows;
+    const int window;                   // cells per window
+    const int hop;                      // cells between window starts
+    const int minLag;                   // first lag in cells
+    const int lags;                     // lags per window
+    const int resolution;               // minutes per cell
+    const int startTime;                // start time of the series
+
+    //----< THREAD METHODS >----------------------------------------------------
+    /*
+     * Entry point for a worker thread.
+     */
+    static void* run( void* block );
+
+    /*
+     * Computes the windows of one block.
+     */
+    void computeBlock( const Block& block );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    Correlogram( const int windows,
+                 const int window,
+                 const int hop,
+                 const int minLag,
+                 const int lags,
+                 const int resolution,
+                 const int startTime );
+
+    ~Correlogram();
+
+    /*
+     * Fills the matrix from two arrays on the same time grid.
+     *
+     * Param:
+     *   const double* a, b -- values
+     *   const uint64_t* aValid, bValid -- validity bitmaps; NULL if all are
+     *                                     valid
+     *   const int aLength, bLength -- lengths; aLength must hold the windows
+     *   const int threads -- worker threads, 0 for one per processor
+     *
+     * Return: bool -- false if the windows do not fit or a thread failed
+     */
+    const bool compute( const double* a,
+                        const uint64_t* aValid,
+                        const int aLength,
+                        const double* b,
+                        const uint64_t* bValid,
+                        const int bLength,
+                        const int threads = 0 );
+
+    const int getWindows() const { return windows; }
+    const int getLags() const { return lags; }
+    const int getWindow() const { return window; }
+    const int getHop() const { return hop; }
+    const int getMinLag() const { return minLag; }
+    const int getResolution() const { return resolution; }
+
+    /*
+     * Returns the correlations of a window, one per lag from minLag.
+     */
+    const double* getRow( const int index ) const;
+
+    /*
+     * Returns the jointly valid pairs of a window, one per lag.
+     */
+    const int* getCounts( const int index ) const;
+
+    /*
+     * Returns true when entry ( index, lag ) is defined: at least two pairs
+     *   and neither side constant.
+     */
+    const bool isDefined( const int index, const int lag ) const;
+
+    /*
+     * Returns the lag, in cells from minLag, of the greatest defined
+     *   correlation of a window, or -1 if none is defined.
+     */
+    const int getPeakLag( const int index ) const;
+
+    /*
+     * Writes the matrix as a binary file: the bytes "CGRM", int fields of
+     *   version, windows, lags, window, hop, minLag, resolution, and
+     *   startTime, then the correlations, the pair counts, and the validity
+     *   words.
+     */
+    const bool writeBinary( const string path ) const;
+
+    /*
+     * Writes one text line per defined entry, columns of window start and
+     *   lag in minutes, correlation, and pair count.
+     */
+    const bool writeColumns( const string path ) const;
+
+    /*
+     * Correlogram of two finalized series with the same resolution, with
+     *   window, hop, and lags given in minutes, or NULL on error.
+     */
+    template<typename TypeA, typename TypeB>
+    static Correlogram* correlate( const DataSeries<TypeA>& a,
+                                   const DataSeries<TypeB>& b,
+                                   const int windowMinutes,
+                                   const int hopMinutes,
+                                   const int minLagMinutes,
+                                   const int maxLagMinutes,
+                                   const int threads = 0 )
+    {
+      LOG_DEBUG( 12, "( " << a.getLabel() << ", " << b.getLabel() << ", " \
+                     << windowMinutes << ", " << hopMinutes << ", " \
+                     << minLagMinutes << ", " << maxLagMinutes << " )" )
+
+      const int resolution = a.getResolution();
+      if( a.getData() == NULL || b.getData() == NULL ) {
+        LOG_ERR( "Series are not final." )
+        return NULL;
+      } else if( b.getResolution() != resolution ) {
+        LOG_ERR( "Mismatching resolutions." )
+        return NULL;
+      } else if( a.getStartTime() != b.getStartTime() ) {
+        LOG_ERR( "WARNING: Mismatching start times." )
+      }
+      const int window = windowMinutes / resolution;
+      const int hop = hopMinutes / resolution;
+      const int minLag = minLagMinutes / resolution;
+      const int lags = maxLagMinutes / resolution - minLag + 1;
+      if( window < 2 || hop < 1 || lags < 1 || window > a.getLength() ) {
+        LOG_ERR( "Cannot slide a " << windowMinutes << " minute window by " \
+                 << hopMinutes << " over lags " << minLagMinutes << " to " \
+                 << maxLagMinutes << " in " << a.getLength() << " cells" )
+        return NULL;
+      }
+
+      double* aValues = new double[ a.getLength() ];
+      double* bValues = new double[ b.getLength() ];
+      for( int i = 0; i < a.getLength(); i++ ) {
+        aValues[i] = a.getData()[i];
+      }
+      for( int i = 0; i < b.getLength(); i++ ) {
+        bValues[i] = b.getData()[i];
+      }
+      Correlogram* correlogram = new Correlogram(
+                                   ( a.getLength() - window ) / hop + 1,
+                                   window, hop, minLag, lags, resolution,
+                                   a.getStartTime() );
+      bool computed = correlogram->compute( aValues, a.getValidity(),
+                                            a.getLength(), bValues,
+                                            b.getValidity(), b.getLength(),
+                                            threads );
+      delete[] aValues;
+      delete[] bValues;
+      if( !computed ) {
+        delete correlogram;
+        return NULL;
+      }
+      return correlogram;
+    }// end static Correlogram* correlate( const DataSeries<TypeA>&, ... )
+};
+
+#endif
@@ -4,6 +4,10 @@
  * Future work might involve including the nttw library to perform these
  *   calculations.
  *
+ * Modified: 10/19/26
+ * Notes:    --Added crossCorrMasked, a cross correlation over jointly valid
+ *             samples only, computed directly or with FFTs
+ *
  * Modified: 07/29/10
  * Notes:    --Modified function signatures for const
  *
@@ -11,14 +15,176 @@
  * Notes:    --Initial creation
  */
 
+#include <stdint.h>
+
 #include <crsCorr/global.h>
 #include <crsCorr/dataSeries.h>
 
 #ifndef CRSCORR_CRSCORR_H
 #define CRSCORR_CRSCORR_H
 
+// masked correlation methods
+#define CRSCORR_METHOD_AUTO 0
+#define CRSCORR_METHOD_DIRECT 1
+#define CRSCORR_METHOD_FFT 2
+
+// auto selects the FFT once the direct sum exceeds this many products
+#define CRSCORR_FFT_THRESHOLD 65536
+
 class crsCorr {
   public:
+    /*
+     * Correlates two arrays using only the samples valid in both. For each
+     *   delay, with the same alignment as crossCorrDouble, computes
+     *
+     *     sums -- sum of the products of jointly valid samples
+     *     counts -- number of jointly valid samples
+     *     normalized -- Pearson correlation of the jointly valid samples
+     *
+     *   The FFT method correlates the masks along with the masked values, so
+     *   gaps cost nothing extra. normalizedValid receives a bit per delay,
+     *   set when the correlation is defined (at least two jointly valid
+     *   samples, neither side constant). Output arrays hold
+     *   longLen - shortLen + 1 entries and any of them may be NULL.
+     *
+     * Param:
+     *  const double* shortData, longData -- values
+     *  const uint64_t* shortValid, longValid -- validity bitmaps; NULL means
+     *                                           every sample is valid
+     *  const int shortLen, longLen -- lengths, shortLen <= longLen
+     *  const int method -- CRSCORR_METHOD_AUTO, _DIRECT, or _FFT
+     */
+    static void maskedCorrelation( const double* shortData,
+                                   const uint64_t* shortValid,
+                                   const int shortLen,
+                                   const double* longData,
+                                   const uint64_t* longValid,
+                                   const int longLen,
+                                   double* sums,
+                                   int* counts,
+                                   double* normalized,
+                                   uint64_t* normalizedValid,
+                                   const int method = CRSCORR_METHOD_AUTO );
+
+    /*
+     * Cross correlation which skips samples the series mark invalid rather
+     *   than multiplying their placeholder values. Parameters are checked as
+     *   in crossCorrDouble.
+     *
+     * Param:
+     *  const DataSeries<ShortType>* -- short data set
+     *  const DataSeries<LongType>* -- long data set
+     *  DataSeries<double>** sums -- if not NULL, receives a new series of
+     *                               the summed products per delay
+     *  DataSeries<int>** counts -- if not NULL, receives a new series of the
+     *                              jointly valid sample counts per delay
+     *  const int method -- CRSCORR_METHOD_AUTO, _DIRECT, or _FFT
+     *
+     * Return: New series of the normalized correlation per delay. Delays
+     *           where it is undefined are marked invalid.
+     */
+    template<typename LongType, typename ShortType>
+    static const DataSeries<double>* crossCorrMasked(
+                           const DataSeries<ShortType>* shortSeries,
+                           const DataSeries<LongType>* longSeries,
+                           DataSeries<double>** sums = NULL,
+                           DataSeries<int>** counts = NULL,
+                           const int method = CRSCORR_METHOD_AUTO )
+    {
+      if( shortSeries == NULL ) {
+        LOG_ERR( "Passed NULL for short data series." )
+        return NULL;
+      } else if( longSeries == NULL ) {
+        LOG_ERR( "Passed NULL for long data series." )
+        return NULL;
+      }
+
+      LOG_DEBUG( 13, ": Correlating " << shortSeries->getValidCount() \
+                     << " of " << shortSeries->getLength() << " with " \
+                     << longSeries->getValidCount() << " of " \
+                     << longSeries->getLength() << " values." )
+
+      // parameter checks
+      if( shortSeries->getResolution() != longSeries->getResolution() ) {
+        LOG_ERR( "Mismatching resolutions." )
+        return NULL;
+      } else if( shortSeries->getStartTime() != longSeries->getStartTime() ) {
+        LOG_ERR( "WARNING: Mismatching start times." )
+      }
+      if( shortSeries->getLength() > longSeries->getLength() ) {
+        LOG_ERR( "Short series is longer than long series" )
+        return NULL;
+      } else if( shortSeries->getData() == NULL
+                 || longSeries->getData() == NULL )
+      {
+        LOG_ERR( "Series are not final." )
+        return NULL;
+      }
+
+      // widen both series to double
+      int shortLen = shortSeries->getLength();
+      int longLen = longSeries->getLength();
+      int length = longLen - shortLen + 1;
+      double* shortData = new double[ shortLen ];
+      double* longData = new double[ longLen ];
+      for( int i = 0; i < shortLen; i++ ) {
+        shortData[i] = shortSeries->getData()[i];
+      }
+      for( int i = 0; i < longLen; i++ ) {
+        longData[i] = longSeries->getData()[i];
+      }
+
+      double* sumValues = new double[ length ];
+      int* countValues = new int[ length ];
+      double* normalized = new double[ length ];
+      uint64_t* normalizedValid = new uint64_t[ ( length + 63 ) / 64 ];
+      maskedCorrelation( shortData, shortSeries->getValidity(), shortLen,
+                         longData, longSeries->getValidity(), longLen,
+                         sumValues, countValues, normalized, normalizedValid,
+                         method );
+
+      // generate result series
+      int reso = shortSeries->getResolution();
+      int start = shortSeries->getStartTime();
+      DataSeries<double>* resultSeries = new DataSeries<double>( "RESULT" );
+      resultSeries->initGrid( length, reso, start );
+      if( sums != NULL ) {
+        *sums = new DataSeries<double>( "SUMS" );
+        (*sums)->initGrid( length, reso, start );
+      }
+      if( counts != NULL ) {
+        *counts = new DataSeries<int>( "COUNTS" );
+        (*counts)->initGrid( length, reso, start );
+      }
+      for( int i = 0; i < length; i++ ) {
+        if(( normalizedValid[ i >> 6 ] >> ( i & 63 )) & 1 ) {
+          resultSeries->placeValue( &normalized[i], i );
+        }
+        if( sums != NULL && countValues[i] > 0 ) {
+          (*sums)->placeValue( &sumValues[i], i );
+        }
+        if( counts != NULL ) {
+          (*counts)->placeValue( &countValues[i], i );
+        }
+      }
+      resultSeries->finalizeData();
+      if( sums != NULL ) {
+        (*sums)->finalizeData();
+      }
+      if( counts != NULL ) {
+        (*counts)->finalizeData();
+      }
+
+      // cleanup and return
+      delete[] shortData;
+      delete[] longData;
+      delete[] sumValues;
+      delete[] countValues;
+      delete[] normalized;
+      delete[] normalizedValid;
+      return resultSeries;
+    }// end static DataSeries<double>* crsCorr::crossCorrMasked( ... )
+
     /*
      * Perform a cross correlation on the two provided arrays.
      *
@@ -3,6 +3,25 @@
  * Provides the data storage implementation of the abstract base class,
  *   abstractDataSeries.
  *
+ * Modified: 10/19/26
+ * Notes:    --Added setValue for repairing single cells of a final series
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added adoptData so computed values can become a series without
+ *             another copy
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added grid series: values are placed into cells by index and
+ *             unplaced cells are left invalid. Resampling and concatenation
+ *             carry the validity bitmap along with the values.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added SeriesType, mapping value types to data type constants,
+ *             and getDataType
+ *
+ * Modified: 10/19/26
+ * Notes:    --Implemented raw data access for binary storage of series
+ *
  * Modified: 08/19/10
  * Notes:    --Adjusted cases on the add value routine to promote most used
  *             cases to the top
@@ -22,6 +41,28 @@
 // namespace convention
 using std::string;
 
+/*
+ * SeriesType
+ *
+ * Maps the value type of a DataSeries to its data type constant so that
+ *   requests can be checked against a tag table at compile time rather than
+ *   with a dynamic_cast.
+ */
+template<typename DataType>
+struct SeriesType {
+  static const int type = DATATYPE_IGNORE;
+};
+
+template<>
+struct SeriesType<int> {
+  static const int type = DATATYPE_INT;
+};
+
+template<>
+struct SeriesType<double> {
+  static const int type = DATATYPE_DOUBLE;
+};
+
 template<typename DataType>
 class DataSeries : public AbstractDataSeries {
 
@@ -162,6 +203,7 @@ class DataSeries : public AbstractDataSeries {
           for( int i = 0; i < len; i++ ) {
             data[i] = series.data[i * newRes + start ];
           }// copy values
+          sampleValidity( series, newRes, start );
         }// good parameters
       } else if ( newRes > series.getResolution()
                   && newRes % series.getResolution() == 0 )
@@ -183,6 +225,7 @@ class DataSeries : public AbstractDataSeries {
           for( int i = 0; i < len; i++ ) {
             data[i] = series.data[i * step + start ];
           }// copy values
+          sampleValidity( series, step, start );
         }// good values
       } else {
         // DEFAULT -- not resampling at all, just copy data
@@ -203,6 +246,7 @@ class DataSeries : public AbstractDataSeries {
         for( int i = 0; i < len ; i++ ) {
           data[i] = series.data[i];
         }// copy values
+        setValidity( series.getValidity() );
       }// resampling
     }// end void resample( const DataType* const, const int )
 
@@ -264,7 +308,16 @@ class DataSeries : public AbstractDataSeries {
         // collecting state
         LOG_DEBUG( 3, ": Collecting state." )
         data = NULL;
-        copyTempData( copyClone->tempDataList );
+        tempDataList = NULL;
+        curDataListNode = NULL;
+        dataNodeCount = 0;
+        if( copyClone->data != NULL ) {
+          // grid series
+          data = new DataType[ getLength() ];
+          memcpy( data, copyClone->data, getLength() * sizeof( DataType ));
+        } else {
+          copyTempData( copyClone->tempDataList );
+        }
       } else {
         // idle state
         LOG_DEBUG( 3, ": Idle state." )
@@ -300,7 +353,13 @@ class DataSeries : public AbstractDataSeries {
       } else if( isCollecting() ) {
         // collecting state
         LOG_DEBUG( 3, ": Collecting state." )
-        copyTempData( copy.tempDataList );
+        if( copy.data != NULL ) {
+          // grid series
+          data = new DataType[ getLength() ];
+          memcpy( data, copy.data, getLength() * sizeof( DataType ));
+        } else {
+          copyTempData( copy.tempDataList );
+        }
       } else {
         // idle state
         LOG_DEBUG( 3, ": Idle state." )
@@ -356,8 +415,10 @@ class DataSeries : public AbstractDataSeries {
       if( !isCollecting() && !isFinal() ) {
         // never activated, nothing is occuring
       } else if( isCollecting() && !isFinal() ) {
-        // collecting data, free temp data
+        // collecting data, free temp data or the grid
         freeTempData();
+        delete[] data;
+        data = NULL;
       } else if( isFinal() ) {
         // data finalized, kill it
         delete[] data;
@@ -427,6 +488,7 @@ class DataSeries : public AbstractDataSeries {
         for( int i = 0; i < lenAdd; i++ ) {
           sum.data[i + lenThis] = toAdd.data[i];
         }
+        sum.concatValidity( this->validity, lenThis, toAdd.validity, lenAdd );
 
         LOG_DEBUG( 3, ":Returning value." );
         return sum;
@@ -476,6 +538,7 @@ class DataSeries : public AbstractDataSeries {
           this->data[i + lenThis] = toAdd.data[i];
         }
         this->length = newLength;
+        concatValidity( this->validity, lenThis, toAdd.validity, lenAdd );
 
         delete[] tempData;
         tempData = NULL;
@@ -553,6 +616,9 @@ class DataSeries : public AbstractDataSeries {
         std::cerr << __FUNCTION__ << ": Attempting to add NULL value."
                   << std::endl;
         return false;
+      } else if( data != NULL ) {
+        LOG_ERR( "Series ('" << getLabel() << "') is a grid; use placeValue." )
+        return false;
       }
 
       // Perform the cast and hope that things do not blow up. Unfortunately,
@@ -617,6 +683,14 @@ class DataSeries : public AbstractDataSeries {
       // update state machine
       setFinal();
 
+      // grid series already hold their array; drop a bitmap with no gaps
+      if( data != NULL ) {
+        if( getValidCount() == getLength() ) {
+          setValidity( NULL );
+        }
+        return;
+      }
+
       // iterate and condense values
       if( data != NULL ) {
         delete[] data;
@@ -636,7 +710,147 @@ class DataSeries : public AbstractDataSeries {
       freeTempData();
     }// end void finalizeData()
 
+    /*
+     * Lays out an unused series as a grid of len zeroed, invalid cells.
+     */
+    const bool initGrid( const int len,
+                         const int reso,
+                         const int start )
+    {
+      LOG_DEBUG( 5, "( " << len << ", " << reso << ", " << start << " )" )
+
+      if( !setGrid( len, start, reso )) {
+        return false;
+      }
+      data = new DataType[ len ];
+      memset( data, 0, len * sizeof( DataType ));
+      return true;
+    }// end const bool initGrid( const int, const int, const int )
+
+    /*
+     * Stores a value into a cell of a grid series and marks it valid.
+     */
+    const bool placeValue( const void* value, const int cell )
+    {
+      //LOG_DEBUG( 5, "( " << value << ", " << cell << " )" )
+
+      if( !isCollecting() || data == NULL ) {
+        LOG_ERR( "Series ('" << getLabel() << "') is not a collecting grid." )
+        return false;
+      } else if( value == NULL ) {
+        LOG_ERR( "Attempting to place NULL value." )
+        return false;
+      } else if( cell < 0 || cell >= getLength() ) {
+        LOG_ERR( "Cell " << cell << " outside grid of length " << getLength() )
+        return false;
+      }
+
+      data[cell] = *(const DataType*)value;
+      validity[ cell >> 6 ] |= (uint64_t)1 << ( cell & 63 );
+      return true;
+    }// end const bool placeValue( const void*, const int )
+
+    /*
+     * Overwrites the value of a cell of a final series, e.g. to repair an
+     *   outlier. The cell's validity is left as it is.
+     */
+    const bool setValue( const int cell, const DataType value )
+    {
+      //LOG_DEBUG( 5, "( " << cell << ", " << value << " )" )
+
+      if( !isFinal() || data == NULL ) {
+        LOG_ERR( "Series ('" << getLabel() << "') is not final." )
+        return false;
+      } else if( cell < 0 || cell >= getLength() ) {
+        LOG_ERR( "Cell " << cell << " outside series of length " \
+                 << getLength() )
+        return false;
+      }
+
+      data[cell] = value;
+      return true;
+    }// end const bool setValue( const int, const DataType )
+
+    /*
+     * Copies a block of finalized values into an unused series and moves it
+     *   directly into the Final state. Fails if any data has been added.
+     */
+    const bool loadRawData( const void* values,
+                            const int len,
+                            const int reso,
+                            const int start )
+    {
+      LOG_DEBUG( 5, "( values, " << len << ", " << reso << ", " \
+                    << start << " )" )
+
+      if( isCollecting() || isFinal() ) {
+        LOG_ERR( "Series ('" << getLabel() << "') already holds data." )
+        return false;
+      } else if( values == NULL ) {
+        LOG_ERR( "Attempting to load NULL values." )
+        return false;
+      }
+
+      if( !setParams( len, start, reso )) {
+        return false;
+      }
+      data = new DataType[ len ];
+      memcpy( data, values, len * sizeof( DataType ));
+      return true;
+    }// end const bool loadRawData( const void*, const int, ... )
+
+    /*
+     * Takes ownership of an array of len values allocated with new[] and
+     *   moves an unused series directly into the Final state. The array is
+     *   deleted if the series cannot take it.
+     */
+    const bool adoptData( DataType* values,
+                          const int len,
+                          const int reso,
+                          const int start )
+    {
+      LOG_DEBUG( 5, "( values, " << len << ", " << reso << ", " \
+                    << start << " )" )
+
+      if( isCollecting() || isFinal() ) {
+        LOG_ERR( "Series ('" << getLabel() << "') already holds data." )
+        delete[] values;
+        return false;
+      } else if( values == NULL ) {
+        LOG_ERR( "Attempting to adopt NULL values." )
+        return false;
+      }
+
+      if( !setParams( len, start, reso )) {
+        delete[] values;
+        return false;
+      }
+      data = values;
+      return true;
+    }// end const bool adoptData( DataType*, const int, ... )
+
     //----<ACCESSOR METHODS>---------------------------------------------------
+    /*
+     * Returns the data type constant of the series.
+     */
+    const int getDataType() const {
+      return SeriesType<DataType>::type;
+    }// end const int getDataType() const
+
+    /*
+     * Returns the size of a single value of the series.
+     */
+    const int getValueSize() const {
+      return sizeof( DataType );
+    }// end const int getValueSize() const
+
+    /*
+     * Untyped version of getData() for binary storage.
+     */
+    const void* getRawData() const {
+      return getData();
+    }// end const void* getRawData() const
+
     /*
      * Allows access to the internal data array if the state is final.
      */
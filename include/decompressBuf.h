@@ -0,0 +1,148 @@
+/*
+ * Stream buffer which decompresses a gzip (or, when built with libzstd, a
+ *   zstd) file on the fly so that the FileParsers can read archived data
+ *   files through an ordinary std::istream without a temporary file.
+ *
+ * Decompression runs on its own thread. The thread fills a small ring of
+ *   fixed-size chunks while the parser consumes the previous ones, so reading
+ *   the compressed file and inflating it overlap with parsing. Both the chunk
+ *   size and the number of chunks in the ring are tunable.
+ *
+ * Concatenated gzip members are read as one stream. As with gzip -d, bytes
+ *   after the last member that do not begin another member are ignored with
+ *   a warning rather than failing the file.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Trailing garbage after the last gzip member is ignored
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <streambuf>
+#include <string>
+#include <pthread.h>
+
+#include <crsCorr/global.h>
+
+#ifndef CRSCORR_DECOMPRESSBUF_H
+#define CRSCORR_DECOMPRESSBUF_H
+
+// default ring dimensions
+#define DECOMPRESS_CHUNK_SIZE 262144
+#define DECOMPRESS_CHUNK_COUNT 4
+
+// compression formats
+#define COMPRESSION_NONE 0
+#define COMPRESSION_GZIP 1
+#define COMPRESSION_ZSTD 2
+
+// namespace convention
+using std::string;
+
+class DecompressBuf : public std::streambuf {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    /*
+     * Chunk
+     *
+     * One slot of the ring. The decompression thread fills a slot and the
+     *   reader hands it to the get area of the stream buffer.
+     */
+    typedef struct Chunk {
+      char* bytes;
+      size_t count;
+    } Chunk;
+
+    //----< DATA MEMBERS >------------------------------------------------------
+    const string fileName;      // compressed file
+    const int format;           // one of the COMPRESSION_ constants
+    const size_t chunkSize;     // bytes per chunk
+    const int chunkCount;       // chunks in the ring
+
+    Chunk* chunks;              // the ring
+    int filled;                 // chunks ready for the reader
+    int readIndex;              // chunk currently in the get area, -1 if none
+    int writeIndex;             // next chunk the thread fills
+    bool finished;              // thread has produced its last chunk
+    bool stopping;              // reader is going away
+    bool failed;                // decompression error occurred
+    bool started;               // thread was created
+    int fileDescriptor;         // compressed file, owned by the thread
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t chunkReady;  // signalled when a chunk is filled
+    pthread_cond_t chunkFree;   // signalled when a chunk is released
+
+    //----< THREAD METHODS >----------------------------------------------------
+    /*
+     * Entry point for the decompression thread.
+     */
+    static void* run( void* buffer );
+
+    /*
+     * Waits for a free chunk. Returns NULL if the reader is stopping.
+     */
+    Chunk* acquireChunk();
+
+    /*
+     * Publishes a filled chunk to the reader.
+     */
+    void publishChunk();
+
+    /*
+     * Decompression loops for the supported formats. Both return false on
+     *   a read or format error.
+     */
+    const bool inflateGzip( int file );
+    const bool inflateZstd( int file );
+
+    // no copies
+    DecompressBuf( const DecompressBuf& copy );
+    DecompressBuf& operator=( const DecompressBuf& copy );
+
+/*****< PROTECTED >************************************************************/
+  protected:
+    /*
+     * Moves the next filled chunk into the get area, waiting for the
+     *   decompression thread if necessary.
+     */
+    int_type underflow();
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    //----< (DE)(CON)STRUCTORS >------------------------------------------------
+    /*
+     * Starts decompressing the provided file.
+     *
+     * Param:
+     *   const string file -- path of the compressed file
+     *   const int format -- COMPRESSION_GZIP or COMPRESSION_ZSTD
+     *   const size_t chunkSize -- bytes per chunk
+     *   const int chunkCount -- chunks in the ring, at least two
+     */
+    DecompressBuf( const string file,
+                   const int format,
+                   const size_t chunkSize = DECOMPRESS_CHUNK_SIZE,
+                   const int chunkCount = DECOMPRESS_CHUNK_COUNT );
+    ~DecompressBuf();
+
+    //----< ACCESSOR METHODS >--------------------------------------------------
+    /*
+     * Returns true if the file was opened and no decompression error has
+     *   been seen so far.
+     */
+    const bool good();
+
+    //----< UTILITIES >---------------------------------------------------------
+    /*
+     * Determines the compression format of a file from its leading bytes.
+     *   Returns COMPRESSION_NONE for plain or unreadable files. zstd files are
+     *   recognized even when zstd support is not built so that they fail
+     *   loudly instead of being parsed as text.
+     */
+    static const int detectFormat( const string file );
+};
+
+#endif
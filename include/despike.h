@@ -0,0 +1,117 @@
+/*
+ * Hampel despiking. A sample is a spike when it lies more than threshold
+ *   scaled MADs from the median of the centered window around it:
+ *
+ *     | x - median | > threshold * 1.4826 * MAD
+ *
+ *   where MAD is the median absolute deviation of the window from its
+ *   median, scaled by 1.4826 to estimate the standard deviation of normal
+ *   data. Only valid samples take part, and windows whose MAD is zero (flat
+ *   or quantized stretches) flag nothing since they give no scale.
+ *
+ *   The window is kept in a RankWindow of value ranks as it slides, so the
+ *   median is found in O(log n) and the MAD, a selection from the two sorted
+ *   runs of deviations on either side of the median, in O(log^2 n) per
+ *   sample rather than by sorting each window.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+#include <crsCorr/dataSeries.h>
+
+#ifndef CRSCORR_DESPIKE_H
+#define CRSCORR_DESPIKE_H
+
+// what happens to a spike
+#define DESPIKE_OFF 0                   // nothing; despiking is disabled
+#define DESPIKE_FLAG 1                  // the cell is marked invalid
+#define DESPIKE_REPLACE 2               // the value becomes the window median
+
+#define DESPIKE_THRESHOLD 3.0           // default threshold in scaled MADs
+#define DESPIKE_MAD_SCALE 1.4826
+
+class Despike {
+  public:
+    /*
+     * Finds the spikes of an array.
+     *
+     * Param:
+     *   const double* values -- samples
+     *   const uint64_t* validity -- validity bitmap; NULL if all are valid
+     *   const int count -- number of samples
+     *   const int halfWidth -- the window around a sample holds halfWidth
+     *                          samples on either side
+     *   const double threshold -- limit in scaled MADs
+     *   uint64_t* spikes -- ( count + 63 ) / 64 words receiving a bit per
+     *                       spike
+     *   double* medians -- if not NULL, receives the window median of every
+     *                      spike
+     *
+     * Return: int -- number of spikes, or -1 for bad parameters
+     */
+    static const int hampel( const double* values,
+                             const uint64_t* validity,
+                             const int count,
+                             const int halfWidth,
+                             const double threshold,
+                             uint64_t* spikes,
+                             double* medians = NULL );
+
+    /*
+     * Despikes a final series in place, either invalidating each spike or
+     *   replacing it with its window median (truncated for integer series).
+     *   The window holds half the cells of windowMinutes on either side of
+     *   each cell, and must hold at least one.
+     *
+     * Return: int -- number of spikes, or -1 on error
+     */
+    template<typename DataType>
+    static const int despike( DataSeries<DataType>& series,
+                              const int windowMinutes,
+                              const double threshold = DESPIKE_THRESHOLD,
+                              const int mode = DESPIKE_FLAG )
+    {
+      LOG_DEBUG( 12, "( " << series.getLabel() << ", " << windowMinutes \
+                     << ", " << threshold << ", " << mode << " )" )
+
+      const DataType* data = series.getData();
+      const int length = series.getLength();
+      const int halfWidth = windowMinutes / series.getResolution() / 2;
+      if( mode == DESPIKE_OFF ) {
+        return 0;
+      } else if( data == NULL || halfWidth < 1
+                 || ( mode != DESPIKE_FLAG && mode != DESPIKE_REPLACE ))
+      {
+        LOG_ERR( "Cannot despike '" << series.getLabel() << "' over " \
+                 << windowMinutes << " minutes in mode " << mode )
+        return -1;
+      }
+
+      double* values = new double[ length ];
+      for( int i = 0; i < length; i++ ) {
+        values[i] = data[i];
+      }
+      uint64_t* spikes = new uint64_t[ ( length + 63 ) / 64 ];
+      double* medians = new double[ length ];
+      int found = hampel( values, series.getValidity(), length, halfWidth,
+                          threshold, spikes, medians );
+      for( int i = 0; found > 0 && i < length; i++ ) {
+        if(( spikes[ i >> 6 ] >> ( i & 63 )) & 1 ) {
+          if( mode == DESPIKE_FLAG ) {
+            series.invalidate( i, 1 );
+          } else {
+            series.setValue( i, (DataType)medians[i] );
+          }
+        }
+      }
+      delete[] values;
+      delete[] spikes;
+      delete[] medians;
+      return found;
+    }// end static const int despike( DataSeries<DataType>&, ... )
+};
+
+#endif
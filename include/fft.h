@@ -0,0 +1,106 @@
+/*
+ * Fast fourier transform used by the analysis routines. Transforms are
+ *   in place and operate on complex values. Lengths that are powers of two
+ *   use a radix-2 transform; any other length, such as the 288 or 1440
+ *   samples of a day, is transformed exactly with Bluestein's chirp-z
+ *   algorithm, a convolution carried out by a padded power of two transform.
+ *
+ *   The twiddle factors, bit reversal order, and chirp of each length are
+ *   computed once into a plan that is cached for the life of the program,
+ *   so repeated transforms of daily series reuse their tables.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added per length plans, arbitrary lengths, and real input
+ *             transforms
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <complex>
+#include <map>
+#include <vector>
+#include <pthread.h>
+
+#include <crsCorr/global.h>
+
+#ifndef CRSCORR_FFT_H
+#define CRSCORR_FFT_H
+
+class Fft {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    /*
+     * Tables for one transform length.
+     */
+    struct Plan {
+      int n;
+      std::vector< std::complex<double> > twiddles;   // e^( -2 pi i k / n ),
+                                                      // k < n / 2
+      std::vector<int> reversal;        // bit reversed index, powers of two
+      int padded;                       // Bluestein length, 0 if unused
+      std::vector< std::complex<double> > chirp;      // e^( -pi i k^2 / n )
+      std::vector< std::complex<double> > chirpSpectrum;  // transformed,
+                                                          // padded conj chirp
+    };
+
+    static std::map<int, Plan*> plans;  // every plan built, by length
+    static pthread_mutex_t planLock;    // guards plans
+
+    /*
+     * Returns the plan of a length, building it on first use.
+     */
+    static const Plan* getPlan( const int n );
+
+    static void radix2( std::complex<double>* values,
+                        const Plan* plan,
+                        const bool inverse );
+
+    static void bluestein( std::complex<double>* values,
+                           const Plan* plan,
+                           const bool inverse );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Returns the smallest transform length, a power of two, that holds
+     *   minLength values.
+     */
+    static const int getSize( const int minLength );
+
+    /*
+     * Transforms n values in place. The inverse transform is scaled by 1 / n
+     *   so that a forward transform followed by an inverse transform restores
+     *   the input.
+     *
+     * Param:
+     *   std::complex<double>* values -- values to transform
+     *   const int n -- number of values, any positive length
+     *   const bool inverse -- true for the inverse transform
+     */
+    static void transform( std::complex<double>* values,
+                           const int n,
+                           const bool inverse = false );
+
+    /*
+     * Forward transform of n real values. Only the n / 2 + 1 bins from zero
+     *   frequency through Nyquist are returned; the rest are their
+     *   conjugates. Even lengths are packed into a complex transform of half
+     *   the length.
+     *
+     * Param:
+     *   const double* values -- n values
+     *   const int n -- number of values
+     *   std::complex<double>* bins -- receives n / 2 + 1 bins
+     */
+    static void realTransform( const double* values,
+                               const int n,
+                               std::complex<double>* bins );
+
+    /*
+     * Returns the number of plans cached so far.
+     */
+    static const int getPlanCount();
+};
+
+#endif
@@ -3,6 +3,57 @@
  *   extract DataSeries objects from a file via processing functions defined
  *   within the children classes.
  *
+ * Modified: 10/19/26
+ * Notes:    findIndex() is protected so children can use the label index.
+ *
+ * Modified: 10/19/26
+ * Notes:    A parser may be constructed without opening its file, for series
+ *             filled from rows another parser has read.
+ *
+ * Modified: 10/19/26
+ * Notes:    initGrid() may cover several days. placeStampedRows() places
+ *             rows stamped with an MJD and seconds on a grid spanning their
+ *             days, averaging those that share a cell.
+ *
+ * Modified: 10/19/26
+ * Notes:    Tags may request Hampel despiking, applied to their series after
+ *             parsing (see setDespikeMode()).
+ *
+ * Modified: 10/19/26
+ * Notes:    Sidecar values are compressed with SeriesCodec unless raw storage
+ *             is selected with setCacheEncoding().
+ *
+ * Modified: 10/19/26
+ * Notes:    Added initGrid() and getGridCell() so children can place values by
+ *             the time on each line rather than by line order. Padding is
+ *             marked invalid instead of posing as zero valued data.
+ *
+ * Modified: 10/19/26
+ * Notes:    Added getTable(), a columnar SeriesTable of the finalized series
+ *             built once per file.
+ *
+ * Modified: 10/19/26
+ * Notes:    Labels are resolved through a hash index built once per tag table
+ *             instead of a linear scan, and getSeries no longer needs RTTI.
+ *             Added SeriesHandle, a label resolved once for repeated O(1)
+ *             access to a series.
+ *
+ * Modified: 10/19/26
+ * Notes:    Resampled series are memoized by (series, reso, start) instead of
+ *             being allocated on every getSeries call. An optional memory
+ *             budget evicts the least recently requested resamples.
+ *
+ * Modified: 10/19/26
+ * Notes:    dataStream is now a generic istream. gzip (and zstd) compressed
+ *             files are decompressed on the fly by a DecompressBuf, so all
+ *             children read archived files without changes.
+ *
+ * Modified: 10/19/26
+ * Notes:    Added a binary sidecar cache of the finalized series. Children
+ *             call loadFile() which either restores the series from a
+ *             sidecar whose key (path, size, mtime, schema) matches or
+ *             parses the text file and writes a new sidecar.
+ *
  * Modified: 08/11/10
  * Notes:    Restructuring to use new template class data series.
  *           Using only input stream commands for reading lines
@@ -21,12 +72,41 @@
 
 #include <fstream>
 #include <string>
+#include <map>
+#include <vector>
+#include <pthread.h>
 #include <crsCorr/global.h>
 #include <crsCorr/dataSeries.h>
+#include <crsCorr/seriesTable.h>
+#include <crsCorr/decompressBuf.h>
+#include <crsCorr/seriesCodec.h>
+#include <crsCorr/despike.h>
 
 #ifndef CRSCORR_FILEPARSER_H
 #define CRSCORR_FILEPARSER_H
 
+/*
+ * Sidecar cache constants. The version must be incremented whenever a change
+ *   to the parsing routines would alter the values stored for a file, since
+ *   the cache key cannot detect that on its own.
+ */
+#define FILEPARSER_CACHE_MAGIC "CRSC"
+#define FILEPARSER_CACHE_VERSION 4
+#define FILEPARSER_CACHE_EXT ".crsc"
+
+/*
+ * Number of most recently requested resamples that are never evicted by the
+ *   resample budget, so that a pair of series fetched for a correlation stay
+ *   valid together.
+ */
+#define FILEPARSER_RESAMPLE_KEEP 2
+
+/*
+ * Longest span of days placeStampedRows() lays a grid over, guarding against
+ *   a corrupt date allocating an enormous grid.
+ */
+#define FILEPARSER_MAX_DAYS 3660
+
 class FileParser {
   public:
     /*
@@ -36,33 +116,119 @@ class FileParser {
      * and defines what the types of those series are. Data Type Constants are
      * defined above. IGNORE will result in a NULL data series to conserve
      * space.
+     *
+     * A positive despikeWindow requests Hampel despiking of the series over a
+     * window of that many minutes once the file is parsed; despikeThreshold
+     * is the limit in scaled MADs, 0 for DESPIKE_THRESHOLD. Tables that omit
+     * both leave the series as parsed.
      */
     typedef struct DataTag {
       const string label;
       const int type;
       const int reso;
       const int start;
+      const int despikeWindow;
+      const double despikeThreshold;
     } DataTag;
 
+    /*
+     * SeriesHandle
+     *
+     * A label resolved to its position in a parser's tag table. Obtained from
+     *   getHandle() and valid for every parser that shares the tag table, so
+     *   one handle serves all the files of a batch.
+     */
+    template<typename DataType>
+    class SeriesHandle {
+      friend class FileParser;
+
+      private:
+        const DataTag* tags;            // tag table the index refers to
+        int index;                      // position in that table, -1 if none
+
+      public:
+        SeriesHandle() : tags( NULL ), index( -1 ) {}
+
+        /*
+         * Returns true if the label was found with a matching type.
+         */
+        const bool isValid() const { return index >= 0; }
+    };
+
 /*****< PRIVATE >**************************************************************/
   private:
     /*
-     * Sampled
+     * ResampleKey
      *
-     * Small structure that maintains a linked list of the resampled data
-     * series for this parser. Ensures that all references are deleted with
-     * this parser.
+     * Identifies a resampled series by the index of its source series and
+     * the requested resolution and start time.
+     */
+    typedef struct ResampleKey {
+      int index;
+      int reso;
+      int start;
+
+      bool operator<( const ResampleKey& other ) const {
+        if( index != other.index ) {
+          return index < other.index;
+        } else if( reso != other.reso ) {
+          return reso < other.reso;
+        }
+        return start < other.start;
+      }
+    } ResampleKey;
+
+    /*
+     * Resample
+     *
+     * Entry of the resample cache. The cache owns the series, so all of them
+     * are deleted with this parser or when evicted.
      */
     typedef struct Resample {
       AbstractDataSeries* series;
-      struct Resample* next;
+      size_t bytes;                     // memory held by the values
+      unsigned long lastUse;            // resampleClock at last request
     } Resample;
 
+    typedef std::map<ResampleKey, Resample> ResampleCache;
+
+    /*
+     * LabelIndex
+     *
+     * Open addressing hash table from label to tag index. One is built for
+     * each tag table and shared by all parsers using it.
+     */
+    typedef struct LabelIndex {
+      int* slots;                       // tag index or -1 for an empty slot
+      unsigned int mask;                // slot count less one
+    } LabelIndex;
+
+    typedef std::map<const DataTag*, const LabelIndex*> LabelIndexes;
+
     //----< DATA MEMBERS >------------------------------------------------------
     const string localFileName;         // name of the opened file
     int length;                         // length of data series
-    Resample* resamples;                // linked list of resampled data series
-    Resample* resamplesEnd;             // last resampled data series in list
+    const LabelIndex* labelIndex;       // label lookup for dataTags
+    SeriesTable* table;                 // columnar copy of data, built lazily
+    ResampleCache resamples;            // memoized resampled data series
+    size_t resampleBytes;               // memory held by resamples
+    unsigned long resampleClock;        // counts resample requests
+
+    bool streamOpen;                    // data file was opened
+    DecompressBuf* decompressBuf;       // decompressor for compressed files
+    char* streamBuffer;                 // read buffer for plain files
+
+    static size_t streamChunkSize;      // read/decompress chunk size
+    static int streamChunkCount;        // chunks decompressed ahead
+    static size_t resampleBudget;       // resample memory limit, 0 for none
+    static LabelIndexes labelIndexes;   // label index of each tag table,
+                                        //   kept for the program's lifetime
+    static pthread_mutex_t labelIndexLock;  // guards labelIndexes
+    static bool caching;                // sidecar cache enabled
+    static string cacheDirectory;       // sidecar location, empty for beside
+                                        //   the data file
+    static int cacheEncoding;           // SERIESCODEC_RAW or _PACKED
+    static int despikeMode;             // DESPIKE_OFF, _FLAG, or _REPLACE
 
     //----< UTILITIES >---------------------------------------------------------
     /*
@@ -89,11 +255,115 @@ class FileParser {
      */
     void initDataSeries();
 
+    /*
+     * Opens dataStream on the data file, inserting a decompressor when the
+     *   file's leading bytes identify it as gzip or zstd compressed.
+     */
+    void openStream();
+
+    //----< LABEL INDEX >-------------------------------------------------------
+    /*
+     * Returns the label index of the provided tag table, building it on first
+     *   use. Only INT and DOUBLE tags are indexed; the first occurrence of a
+     *   repeated label wins, as it did for the old linear search.
+     */
+    static const LabelIndex* getLabelIndex( const DataTag* const tags,
+                                            const int tagCount );
+
+    //----< RESAMPLE CACHE >----------------------------------------------------
+    /*
+     * Returns the memoized resample of the series at index, or NULL if it has
+     *   not been requested yet. Marks the resample as recently used.
+     */
+    AbstractDataSeries* findResample( const int index,
+                                      const int reso,
+                                      const int start );
+
+    /*
+     * Adds a resample to the cache, then evicts the least recently requested
+     *   resamples while the cache exceeds the budget.
+     */
+    void addResample( const int index,
+                      const int reso,
+                      const int start,
+                      AbstractDataSeries* series );
+
+    //----< SIDECAR CACHE >-----------------------------------------------------
+    /*
+     * Returns the path of the sidecar cache for the opened file.
+     */
+    const string getCachePath() const;
+
+    /*
+     * Returns a hash of the tag table and the cache version. Any change in the
+     *   labels, types, resolutions, or start times of a parser invalidates
+     *   its existing sidecars.
+     */
+    const unsigned int getSchemaHash() const;
+
+    /*
+     * Attempts to restore every data series from the sidecar cache. The
+     *   sidecar is completely validated against the key and its checksum
+     *   before any series is touched, so a stale or corrupt sidecar leaves
+     *   the parser untouched.
+     *
+     * Param:
+     *   const long long size -- size of the data file in bytes
+     *   const long long mtime -- modification time of the data file, ns
+     *
+     * Return: true if all series were loaded from the sidecar
+     */
+    const bool loadCache( const long long size, const long long mtime );
+
+    /*
+     * Writes the finalized data series to the sidecar cache. Failures are
+     *   not fatal; the file is simply parsed again next time.
+     */
+    void storeCache( const long long size, const long long mtime ) const;
+
+    /*
+     * Returns the series at index, resampled and memoized when a resolution
+     *   and start time are provided. The caller has checked the type.
+     */
+    template<typename DataType>
+    const DataSeries<DataType>* lookupSeries( const int index,
+                                              const int reso,
+                                              const int start )
+    {
+      if( data[index] == NULL ) {
+        LOG_ERR( "Null data series with non-null data type. Expected " \
+                 << dataTags[index].label )
+        return NULL;
+      }
+
+      if( reso != RESOLUTION_IGNORE
+          && reso > 1
+          && start != START_TIME_IGNORE
+          && start >= 0 )
+      {
+        LOG_DEBUG( 7, ": Resampling series with " << reso << ", " << start )
+
+        AbstractDataSeries* cached = findResample( index, reso, start );
+        if( cached != NULL ) {
+          return static_cast<const DataSeries<DataType>*>( cached );
+        }
+
+        DataSeries<DataType>* toReturn = new DataSeries<DataType>(
+                                         *data[index],
+                                         data[index]->getLabel(),
+                                         reso,
+                                         start );
+        addResample( index, reso, start, toReturn );
+        return toReturn;
+      }
+      return static_cast<const DataSeries<DataType>*>( data[index] );
+    }// end const DataSeries<DataType>* lookupSeries( const int, ... )
+
 /*****< PROTECTED >************************************************************/
   protected:
     //----< DATA MEMBERS >------------------------------------------------------
     AbstractDataSeries** data;         // data values
-    std::ifstream* dataStream;        // input stream for parsing
+    std::istream* dataStream;         // input stream for parsing
     const DataTag* const dataTags;      // data descriptors
 
     //----< PARSING METHODS >---------------------------------------------------
@@ -102,6 +372,12 @@ class FileParser {
      */
     virtual void parseFile() = 0;
 
+    //----< LABEL INDEX >-------------------------------------------------------
+    /*
+     * Returns the index of the series with the provided label, or -1.
+     */
+    const int findIndex( const string& label ) const;
+
     //----< UTILITIES >---------------------------------------------------------
     /*
      * Ensures that all of the data series contained within the file parser
@@ -110,6 +386,73 @@ class FileParser {
      */
     void finalizeSeriesData();
 
+    /*
+     * Lays out every data series as a grid covering the provided number of
+     *   days at its tag's resolution and start time. Parsers whose lines
+     *   carry a time of day call this before parsing and place each value
+     *   into the cell for its time; cells for missing lines or missing values
+     *   stay invalid.
+     */
+    void initGrid( const int days = 1 );
+
+    /*
+     * Despikes the final series whose tags request it, as set by
+     *   setDespikeMode(). Called by finalizeSeriesData().
+     */
+    void despikeSeriesData();
+
+    /*
+     * Returns the grid cell of a series for a time of day in HHMM format, or
+     *   -1 if the time does not fall on a cell of that series.
+     */
+    const int getGridCell( const int index, const int hourMin ) const;
+
+    /*
+     * Returns the grid cell of a series holding a time stamped as a day of
+     *   the grid, counted from 0, and seconds into that day, or -1 if the
+     *   time falls outside the grid. Unlike getGridCell() the time need not
+     *   be aligned to a cell; it is binned into the cell containing it.
+     */
+    const int getStampCell( const int index,
+                            const int day,
+                            const double seconds ) const;
+
+    /*
+     * Places into each cell of a grid series the mean of the samples binned
+     *   into it, rounded for INT series. Cells without samples stay invalid.
+     *
+     * Param:
+     *   const int index -- series to fill
+     *   const int* cells -- cell of each sample, -1 to skip the sample
+     *   const double* values -- value of the first sample
+     *   const int count -- number of samples
+     *   const int stride -- doubles between consecutive samples' values
+     */
+    void placeMeans( const int index,
+                     const int* cells,
+                     const double* values,
+                     const int count,
+                     const int stride );
+
+    /*
+     * Lays out a grid spanning the days of the rows (see initGrid()) and
+     *   places the mean of each column into the series of its tag. A row holds
+     *   one value per tag, in tag order, with the MJD in column 0 and the
+     *   seconds past midnight in column 1; columns of ignored tags are unused.
+     *
+     * Return: false if the rows span more than FILEPARSER_MAX_DAYS
+     */
+    const bool placeStampedRows( const std::vector<double>& rows );
+
+    /*
+     * As above, but over the grid of the days from firstDay to lastDay, so
+     *   that series filled from different rows line up. Rows outside those
+     *   days are skipped.
+     */
+    const bool placeStampedRows( const std::vector<double>& rows,
+                                 const int firstDay,
+                                 const int lastDay );
+
     /*
      * Some data files contain a header and some sort of significant artifact
      *   prior to the actual data. This utility function advances the dataStream
@@ -127,6 +470,15 @@ class FileParser {
      */
     bool findArtifact( const char* artifact );
 
+    /*
+     * Fills the data series for the opened file. Restores them from the
+     *   sidecar cache when its key matches the file; otherwise invokes
+     *   parseFile() and finalizeSeriesData() and then stores a new sidecar.
+     *   Children should call this from their constructors in place of
+     *   calling parseFile() directly.
+     */
+    void loadFile();
+
 /*****< PUBLIC >***************************************************************/
   public:
     //----< ACCESSOR METHODS >--------------------------------------------------
@@ -141,11 +493,76 @@ class FileParser {
      */
     const DataTag* const getTags() const;
 
+    /*
+     * Returns the name of the file the parser was constructed with.
+     */
+    const string& getFileName() const;
+
+    /*
+     * Enables or disables the sidecar cache for all parsers constructed
+     *   afterwards. Enabled by default.
+     */
+    static void setCaching( const bool enabled );
+
+    /*
+     * Places sidecars in the provided directory instead of next to each data
+     *   file. Useful when the data directory is read-only. An empty string
+     *   restores the default.
+     */
+    static void setCacheDirectory( const string directory );
+
+    /*
+     * Selects how sidecars written afterwards store the values of each series:
+     *   SERIESCODEC_PACKED (the default) compresses them with SeriesCodec,
+     *   SERIESCODEC_RAW stores them as they are in memory. Sidecars of either
+     *   encoding are read regardless.
+     */
+    static void setCacheEncoding( const int encoding );
+
+    /*
+     * Selects what the despiking stage does to the spikes of series whose
+     *   tags request it, for files loaded afterwards: DESPIKE_FLAG (the
+     *   default) marks them invalid, DESPIKE_REPLACE substitutes the window
+     *   median, and DESPIKE_OFF leaves every series as parsed.
+     */
+    static void setDespikeMode( const int mode );
+
+    /*
+     * Tunes the buffering of data files for all parsers constructed
+     *   afterwards. Plain files are read through a buffer of chunkSize bytes.
+     *   Compressed files are decompressed chunkSize bytes at a time by a
+     *   separate thread, which may run up to chunkCount chunks ahead.
+     */
+    static void setStreamBuffers( const size_t chunkSize,
+                                  const int chunkCount );
+
+    /*
+     * Limits the memory held by the resampled series of each parser. Once a
+     *   parser exceeds the budget, the least recently requested resamples
+     *   are deleted, except for the FILEPARSER_RESAMPLE_KEEP most recent.
+     *   Series returned by getSeries before that may then be invalid, so
+     *   callers holding many resamples at once should leave the budget at 0,
+     *   which disables eviction and is the default.
+     */
+    static void setResampleBudget( const size_t bytes );
+
+    /*
+     * Returns the memory held by the resampled series of this parser.
+     */
+    const size_t getResampleBytes() const;
+
+    /*
+     * Deletes all resampled series of this parser.
+     */
+    void clearResamples();
+
     //----< DATA METHODS >------------------------------------------------------
     /*
      * Provide access to the data the file parser has extraced from the data
      *   file. If that type of data is not available for the given label, the
      *   request must return a null pointer.
+     * A resampled series is created on the first request for its resolution
+     *   and start time and shared by later requests.
      *
      * Param:
      *   const DataTag* label -- specifies the label and type
@@ -164,82 +581,98 @@ class FileParser {
         return NULL;
       }
 
-      // iterate through datasets looking for specified label
-      bool found = false;
-      int index = 0;
-      while( !found && index < length ) {
-        if( data[index] != NULL ) {
-          // non-null data series
-          //LOG_DEBUG( 6, ": checking " << data[index]->getLabel() )
-          if( !tag->label.compare( data[index]->getLabel() )) {
-            found = true;
-          } else {
-            index++;
-          }
-        } else if( dataTags[index].type != DATATYPE_IGNORE ) {
-          LOG_ERR( "Null data series with non-null data type. Expected " \
-                   << dataTags[index].label )
-          index++;
-        } else {
-          index++;
-        }
-      }
-
       // return NULL if dataset not found.
-      if( !found ) {
+      int index = findIndex( tag->label );
+      if( index < 0 ) {
         LOG_DEBUG( 7, ": Failed to find dataset: " << tag->label << "." )
         return NULL;
       }
 
       // return NULL if dataType does not match
-      if( tag->type != dataTags[index].type ) {
+      if( tag->type != dataTags[index].type
+          || SeriesType<DataType>::type != dataTags[index].type )
+      {
         LOG_ERR( "Data types do not match. Found " << dataTags[index].type \
                  << ". Expected " << tag->type )
         return NULL;
       }
 
-      // return Data Series
-      if( tag->reso != RESOLUTION_IGNORE
-          && tag->reso > 1
-          && tag->start != START_TIME_IGNORE
-          && tag->start >= 0 )
-      {
-        LOG_DEBUG( 7, ": Resampling series with " << tag->reso << ", " \
-                      << tag->start )
+      return lookupSeries<DataType>( index, tag->reso, tag->start );
+    }// end DataSeries<DataType>* getSeries( const DataTag* const )
 
-        DataSeries<DataType>* toReturn = new DataSeries<DataType>(
-                                         *data[index],
-                                         data[index]->getLabel(),
-                                         tag->reso,
-                                         tag->start );
-        if( resamples == NULL ) {
-          resamples = new Resample;
-          resamples->series = toReturn;
-          resamples->next = NULL;
-          resamplesEnd = resamples;
-        } else {
-          resamplesEnd->next = new Resample;
-          resamplesEnd = resamplesEnd->next;
-          resamplesEnd->series = toReturn;
-          resamplesEnd->next = NULL;
-        }
-        return toReturn;
+    /*
+     * Returns all finalized series of the file as one columnar table, built
+     *   on the first call. Returns NULL if the parser holds no data.
+     */
+    const SeriesTable* getTable();
+
+    /*
+     * Resolves a label to a handle for repeated access through the handle
+     *   overloads of getSeries. The handle is invalid if the label is not
+     *   present or its type is not DataType.
+     *
+     * Param:
+     *   const string& label -- label of the series
+     */
+    template<typename DataType>
+    const SeriesHandle<DataType> getHandle( const string& label ) const {
+      LOG_DEBUG( 8, "( " << label << " )" )
+
+      SeriesHandle<DataType> handle;
+      int index = findIndex( label );
+      if( index >= 0 && SeriesType<DataType>::type == dataTags[index].type ) {
+        handle.tags = dataTags;
+        handle.index = index;
       } else {
-        return dynamic_cast<const DataSeries<DataType>*>( data[index] );
+        LOG_DEBUG( 7, ": No " << SeriesType<DataType>::type \
+                      << " series labeled " << label << "." )
       }
-    }// end DataSeries<DataType>* getSeries( const DataTag* const )
+      return handle;
+    }// end const SeriesHandle<DataType> getHandle( const string& ) const
+
+    /*
+     * Returns the series of a handle in constant time, or NULL if the handle
+     *   is invalid or belongs to a different tag table.
+     */
+    template<typename DataType>
+    const DataSeries<DataType>* getSeries(
+        const SeriesHandle<DataType>& handle ) const
+    {
+      if( handle.tags != dataTags || handle.index < 0 || data == NULL ) {
+        return NULL;
+      }
+      return static_cast<const DataSeries<DataType>*>( data[handle.index] );
+    }// end const DataSeries<DataType>* getSeries( const SeriesHandle& ) const
 
+    /*
+     * Returns the series of a handle resampled to the provided resolution
+     *   and start time, sharing the resample cache with the tag overload.
+     */
+    template<typename DataType>
+    const DataSeries<DataType>* getSeries(
+        const SeriesHandle<DataType>& handle,
+        const int reso,
+        const int start )
+    {
+      if( handle.tags != dataTags || handle.index < 0 || data == NULL ) {
+        return NULL;
+      }
+      return lookupSeries<DataType>( handle.index, reso, start );
+    }// end const DataSeries<DataType>* getSeries( const SeriesHandle&, ... )
 
     //----< (DE)(CON)STRUCTORS >------------------------------------------------
     /*
      * Generic constructor is supplied but highly discouraged as the resulting
      *   FileParser object will be useless..
-     * Parameterized constructor is recommended with a dataStream.
+     * Parameterized constructor is recommended with a dataStream. Children
+     *   that fill their series from rows read elsewhere pass false for
+     *   openFile; the name then only identifies the parser.
      * Copy constructor supplied.
      */
     FileParser();
     FileParser( string fileName,
-                const DataTag* const dataTags );
+                const DataTag* const dataTags,
+                const bool openFile = true );
     FileParser( const FileParser& copy );
     virtual ~FileParser();
 };
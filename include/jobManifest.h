@@ -0,0 +1,125 @@
+/*
+ * Record of the jobs a run completed, so that a later run over the same
+ *   days redoes only the jobs whose inputs changed. Each entry maps a job
+ *   key, such as the result file a job writes, to a 64 bit signature of
+ *   everything the job read: the fingerprints of its input files and its
+ *   stage parameters. A job is current when its key is recorded with the
+ *   signature it would have now.
+ *
+ *   Input files are fingerprinted by size and modification time, or, with
+ *   JOBMANIFEST_CONTENT, by an FNV-1a hash of their bytes, which survives
+ *   copies and touches at the cost of reading every input. Fingerprints are
+ *   cached for the life of the manifest, so a file shared by many jobs is
+ *   examined once.
+ *
+ *   The manifest file is text, one "signature key" line per entry under a
+ *   version line, and is replaced through a rename so an interrupted run
+ *   leaves the previous manifest intact.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <string>
+#include <map>
+#include <stdint.h>
+#include <pthread.h>
+
+#include <crsCorr/global.h>
+
+#ifndef CRSCORR_JOBMANIFEST_H
+#define CRSCORR_JOBMANIFEST_H
+
+#define JOBMANIFEST_VERSION 1
+
+// fingerprint modes
+#define JOBMANIFEST_MTIME 0
+#define JOBMANIFEST_CONTENT 1
+
+#define JOBMANIFEST_SEED 14695981039346656037ULL   // FNV-1a 64 offset basis
+#define JOBMANIFEST_MISSING 0ULL                   // fingerprint of no file
+
+// namespace convention
+using std::string;
+
+class JobManifest {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    typedef std::map<string, uint64_t> Entries;
+
+    //----< DATA MEMBERS >------------------------------------------------------
+    const string fileName;
+    const int mode;                     // one of the fingerprint modes
+    Entries entries;                    // signature per job key
+    Entries fingerprints;               // fingerprint per input file
+    bool changed;                       // entries differ from the file
+    pthread_mutex_t lock;
+
+    /*
+     * Hashes the bytes of a file, or returns JOBMANIFEST_MISSING.
+     */
+    const uint64_t hashContents( const string& path ) const;
+
+    // no copies
+    JobManifest( const JobManifest& copy );
+    JobManifest& operator=( const JobManifest& copy );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    JobManifest( const string fileName, const int mode = JOBMANIFEST_MTIME );
+
+    ~JobManifest();
+
+    /*
+     * Reads the manifest file. A missing file is an empty manifest.
+     *
+     * Return: false if the file exists but cannot be read
+     */
+    const bool load();
+
+    /*
+     * Writes the manifest file if any entry changed since load().
+     */
+    const bool save();
+
+    /*
+     * Returns the fingerprint of an input file, or JOBMANIFEST_MISSING if
+     *   it does not exist.
+     */
+    const uint64_t fingerprint( const string& path );
+
+    /*
+     * Returns true when key is recorded with signature.
+     */
+    const bool isCurrent( const string& key, const uint64_t signature );
+
+    /*
+     * Records that the job of key completed with signature.
+     */
+    void record( const string& key, const uint64_t signature );
+
+    /*
+     * Drops the entry of key, so its job runs next time.
+     */
+    void forget( const string& key );
+
+    const int getEntries();
+    const int getMode() const { return mode; }
+
+    /*
+     * FNV-1a 64 hash of bytes, continuing from seed; used to build
+     *   signatures. Text is hashed with its length so that consecutive
+     *   strings cannot run together.
+     */
+    static const uint64_t hash( const void* bytes,
+                                const size_t count,
+                                const uint64_t seed = JOBMANIFEST_SEED );
+
+    static const uint64_t hashText( const string& text,
+                                    const uint64_t seed = JOBMANIFEST_SEED );
+
+    static const uint64_t hashValue( const uint64_t value,
+                                     const uint64_t seed = JOBMANIFEST_SEED );
+};
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * Lomb-Scargle periodogram of unevenly sampled data. Where spectra of a
+ *   gridded series zero fill its dropouts, the Lomb-Scargle periodogram fits
+ *   a sinusoid at each frequency by least squares to the samples that exist:
+ *
+ *     P(f) = 1 / ( 2 var ) * [ ( sum y cos w( t - tau ) )^2
+ *                                / sum cos^2 w( t - tau )
+ *                            + ( sum y sin w( t - tau ) )^2
+ *                                / sum sin^2 w( t - tau ) ]
+ *
+ *   with y the samples less their mean, w = 2 pi f, and tau the offset that
+ *   makes the sine and cosine terms orthogonal. Power is Lomb's normalized
+ *   power, dimensionless, so under pure noise it is exponentially
+ *   distributed with unit mean.
+ *
+ *   The trigonometric sums over every frequency are not taken directly,
+ *   which costs O( N F ). Following Press and Rybicki, each sample is
+ *   extirpolated (reverse interpolated) onto a regular grid with Lagrange
+ *   weights on its LOMBSCARGLE_SPREAD nearest points, after which one real
+ *   FFT of the grid gives all the sums of y cos wt and y sin wt, and a
+ *   second, of the samples at doubled phase, those of cos 2wt and sin 2wt,
+ *   for O( N + F log F ) in all.
+ *
+ *   Frequencies run in steps of 1 / ( oversampling * T ) cycles per day, T
+ *   the span of the samples, up to nyquistFactor times the mean Nyquist
+ *   frequency N / ( 2 T ).
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <vector>
+
+#include <crsCorr/global.h>
+#include <crsCorr/dataSeries.h>
+#include <crsCorr/spectrum.h>
+
+#ifndef CRSCORR_LOMBSCARGLE_H
+#define CRSCORR_LOMBSCARGLE_H
+
+#define LOMBSCARGLE_SPREAD 4            // grid points each sample spreads to
+#define LOMBSCARGLE_OVERSAMPLING 4.0    // default frequency oversampling
+
+class LombScargle {
+  public:
+    /*
+     * Computes the periodogram of samples at arbitrary times.
+     *
+     * Param:
+     *   const double* times -- sample times in days, in any order
+     *   const double* values -- sample values
+     *   const int count -- number of samples, at least three
+     *   const double oversampling -- frequency steps per 1 / T, at least one
+     *   const double nyquistFactor -- highest frequency as a multiple of the
+     *                                 mean Nyquist frequency
+     *
+     * Return: PowerSpectrum* -- normalized power per bin, bin 0 (zero
+     *                           frequency) held at 0; NULL for too few
+     *                           samples, no span, or no variance
+     */
+    static PowerSpectrum* periodogram( const double* times,
+                                       const double* values,
+                                       const int count,
+                                       const double oversampling
+                                                   = LOMBSCARGLE_OVERSAMPLING,
+                                       const double nyquistFactor = 1.0 );
+
+    /*
+     * Probability that pure noise reaches the provided power in at least
+     *   one of independent frequencies, 1 - ( 1 - e^-power )^independent.
+     *   The independent frequencies of a periodogram are roughly its bins
+     *   divided by the oversampling.
+     */
+    static const double falseAlarm( const double power,
+                                    const double independent );
+
+    /*
+     * Periodogram of the valid cells of a finalized series, or NULL on
+     *   error.
+     */
+    template<typename DataType>
+    static PowerSpectrum* periodogram( const DataSeries<DataType>& series,
+                                       const double oversampling
+                                                   = LOMBSCARGLE_OVERSAMPLING,
+                                       const double nyquistFactor = 1.0 )
+    {
+      LOG_DEBUG( 12, "( " << series.getLabel() << ", " << oversampling \
+                     << ", " << nyquistFactor << " )" )
+
+      const DataType* data = series.getData();
+      const int length = series.getLength();
+      if( data == NULL || length <= 0 ) {
+        LOG_ERR( "Series ('" << series.getLabel() << "') is not final." )
+        return NULL;
+      }
+
+      std::vector<double> times;
+      std::vector<double> values;
+      const double cellDays = series.getResolution() / 1440.0;
+      for( int i = 0; i < length; i++ ) {
+        if( series.isValid( i )) {
+          times.push_back( i * cellDays );
+          values.push_back( data[i] );
+        }
+      }
+      if( times.empty() ) {
+        LOG_ERR( "Series ('" << series.getLabel() << "') has no valid cells." )
+        return NULL;
+      }
+      return periodogram( &times[0], &values[0], times.size(), oversampling,
+                          nyquistFactor );
+    }// end static PowerSpectrum* periodogram( const DataSeries<DataType>&, ... )
+};
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Parses the loopstats files written by ntpd, one line per update of the
+ *   clock discipline:
+ *
+ *     MJD seconds offset(s) frequency(ppm) jitter(s) wander(ppm) poll
+ *
+ *   for example
+ *
+ *     61332 3671.912 -0.000012345 -21.817 0.000031623 0.004150 6
+ *
+ *   Lines are placed by their MJD and seconds rather than by their order, on
+ *   a grid of minutes that spans every day in the file, so a file holding
+ *   several days (or with lines missing) lines up with the other sources.
+ *   Lines that share a cell are averaged.
+ *
+ * Modified: 10/19/26
+ * Notes:    Initial Creation
+ */
+
+#include <crsCorr/fileParser.h>
+#include <crsCorr/dataSeries.h>
+
+#ifndef CRSCORR_LOOPSTATS_FILEPARSER_H
+#define CRSCORR_LOOPSTATS_FILEPARSER_H
+
+#define LOOPSTATS_VALUES 7            // fields of a loopstats line
+
+class LoopStatsParser : public FileParser {
+
+  public:
+    /*
+     * Determines which values to extract from the given data file.
+     *
+     * Label        Value                               Suggested Type
+     *-------------------------------------------------------------------------
+     *  mjd          Modified Julian Day of the line     Int
+     *  sec          Seconds past midnight UTC           Double
+     *  offset       Clock offset, seconds               Double
+     *  freq         Frequency offset, ppm               Double
+     *  jitter       RMS offset jitter, seconds          Double
+     *  wander       RMS frequency wander, ppm           Double
+     *  poll         Poll interval, log2 seconds         Int
+     */
+   static const FileParser::DataTag tags[];
+
+    //----< (DE/CON)STRUCTORS >------------------------------------------------
+    /*
+     * Constructors are supplied without parameters as those shouldn't be
+     *   needed (minus the copy constructor). Destructors and the assignment
+     *   operator are also provided here.
+     */
+    LoopStatsParser();
+    LoopStatsParser( string fileName );
+    LoopStatsParser( const LoopStatsParser& copy );
+    ~LoopStatsParser();
+    LoopStatsParser& operator=(const LoopStatsParser& copy );
+
+  protected:
+    //----< FILE METHODS >-----------------------------------------------------
+    /*
+     * Begins the actual file processing and fills the associated data file
+     *   with various types of DataSeries.
+     */
+    void parseFile();
+
+};
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Parses the peerstats files written by ntpd, one line per update of a peer:
+ *
+ *     MJD seconds address status offset(s) delay(s) dispersion(s) jitter(s)
+ *
+ *   for example
+ *
+ *     61332 3671.912 127.127.36.0 9614 -0.000123 0.000000 0.000945 0.000310
+ *
+ *   Every peer's lines are interleaved. The series follow the system peer,
+ *   the peer whose status word selects it for synchronization, so they hold
+ *   the measurements of whichever source disciplined the clock at each time.
+ *   As with LoopStatsParser, lines are placed by their MJD and seconds on a
+ *   grid of minutes spanning the days in the file, and lines sharing a cell
+ *   are averaged.
+ *
+ *   A demultiplexing parser also routes every line, in the same single pass,
+ *   to a child parser for its peer, found through an open addressing table
+ *   keyed by a hash of the address. Children exist only for the peers that
+ *   appear in the file and share the file's grid, so any peer's series line
+ *   up with the others and with the system peer's.
+ *
+ * Modified: 10/19/26
+ * Notes:    Added demultiplexing into a child parser per peer
+ *
+ * Modified: 10/19/26
+ * Notes:    Initial Creation
+ */
+
+#include <string>
+#include <vector>
+#include <crsCorr/fileParser.h>
+#include <crsCorr/dataSeries.h>
+
+#ifndef CRSCORR_PEERSTATS_FILEPARSER_H
+#define CRSCORR_PEERSTATS_FILEPARSER_H
+
+#define PEERSTATS_VALUES 8            // fields of a peerstats line
+#define PEERSTATS_ADDRESS_INDEX 2     // token index of the peer address
+#define PEERSTATS_STATUS_INDEX 3      // token index of the status word
+#define PEERSTATS_SELECT_SHIFT 8      // position of the select code in status
+#define PEERSTATS_SELECT_MASK 7       // bits of the select code
+#define PEERSTATS_SELECT_SYSPEER 6    // select code of the system peer
+#define PEERSTATS_PEER_SLOTS 16       // initial slots of the peer table
+
+class PeerStatsParser : public FileParser {
+
+  public:
+    /*
+     * Determines which values to extract from the given data file.
+     *
+     * Label        Value                               Suggested Type
+     *-------------------------------------------------------------------------
+     *  mjd          Modified Julian Day of the line     Int
+     *  sec          Seconds past midnight UTC           Double
+     *  address      Peer address                        (ignore)
+     *  status       Peer status word, hex               (ignore)
+     *  offset       Peer clock offset, seconds          Double
+     *  delay        Roundtrip delay, seconds            Double
+     *  dispersion   Dispersion, seconds                 Double
+     *  jitter       RMS jitter, seconds                 Double
+     */
+   static const FileParser::DataTag tags[];
+
+    //----< (DE/CON)STRUCTORS >------------------------------------------------
+    /*
+     * Constructors are supplied without parameters as those shouldn't be
+     *   needed (minus the copy constructor). Destructors and the assignment
+     *   operator are also provided here.
+     *
+     * With demultiplex set the file is always parsed rather than restored
+     *   from its sidecar, since the sidecar holds only the system peer, and
+     *   a child parser is built for every peer. Copies have no children.
+     */
+    PeerStatsParser();
+    PeerStatsParser( string fileName );
+    PeerStatsParser( string fileName, const bool demultiplex );
+    PeerStatsParser( const PeerStatsParser& copy );
+    ~PeerStatsParser();
+    PeerStatsParser& operator=(const PeerStatsParser& copy );
+
+    //----< PEER METHODS >-----------------------------------------------------
+    /*
+     * Returns the number of peers found by demultiplexing, 0 otherwise.
+     */
+    const int getPeerCount() const;
+
+    /*
+     * Returns the child parser of a peer in order of first appearance, or
+     *   NULL for an index out of range.
+     */
+    PeerStatsParser* getPeer( const int index ) const;
+
+    /*
+     * Returns the child parser of the peer with the provided address, or
+     *   NULL if the peer does not appear in the file.
+     */
+    PeerStatsParser* findPeer( const string& address ) const;
+
+    /*
+     * Returns the address of a child parser's peer; empty for the parser of
+     *   the file.
+     */
+    const string& getAddress() const;
+
+    /*
+     * Splits a peerstats line in place and converts its fields into a row,
+     *   one value per tag, leaving the address and status columns 0.
+     *
+     * Param:
+     *   char* dataLine -- null terminated line, modified by splitting
+     *   const int lineLength -- bytes in the line
+     *   double* row -- (out) PEERSTATS_VALUES values
+     *   char** address -- (out) the address field within dataLine
+     *   const bool systemPeerOnly -- skip converting other peers' lines
+     *
+     * Return: the status word, or -1 if the line is malformed or skipped
+     */
+    static const long parseLine( char* dataLine,
+                                 const int lineLength,
+                                 double* row,
+                                 char** address,
+                                 const bool systemPeerOnly );
+
+  protected:
+    //----< FILE METHODS >-----------------------------------------------------
+    /*
+     * Begins the actual file processing and fills the associated data file
+     *   with various types of DataSeries.
+     */
+    void parseFile();
+
+  private:
+    //----< PEER STATE >-------------------------------------------------------
+    bool demultiplexing;              // route lines to children while parsing
+    string address;                   // peer of a child, empty otherwise
+    std::vector<PeerStatsParser*> peers;  // children by first appearance
+    std::vector<string> peerAddresses;    // address of each peer
+    std::vector<unsigned int> peerHashes; // address hash of each peer
+    std::vector<int> peerSlots;       // open addressing table of peer indices,
+                                      //   -1 for an empty slot
+
+    /*
+     * Child constructor: places the rows of one peer on the grid of the days
+     *   from firstDay to lastDay and finalizes its series.
+     */
+    PeerStatsParser( const string& fileName,
+                     const string& address,
+                     const std::vector<double>& rows,
+                     const int firstDay,
+                     const int lastDay );
+
+    /*
+     * Returns the index of the peer with the provided address and its hash,
+     *   or -1 if it has not been seen.
+     */
+    const int findPeerIndex( const char* address,
+                             const unsigned int hash ) const;
+
+    /*
+     * Records a new peer and returns its index, doubling the table whenever
+     *   it becomes half full.
+     */
+    const int addPeer( const char* address, const unsigned int hash );
+
+    /*
+     * Returns the FNV-1a hash of an address.
+     */
+    static const unsigned int hashAddress( const char* address );
+};
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Order statistics of a window slid along an array. Every valid sample is
+ *   ranked once, ties by cell, and the window is held as counts of the ranks
+ *   it contains in a Fenwick tree, so adding or removing a sample and
+ *   selecting the k-th smallest value each take O(log n) rather than
+ *   sorting the window.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <vector>
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+
+#ifndef CRSCORR_RANKWINDOW_H
+#define CRSCORR_RANKWINDOW_H
+
+class RankWindow {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    std::vector<double> sorted;         // valid values in rank order
+    std::vector<int> rankOf;            // rank of each cell, -1 if invalid
+    std::vector<int> tree;              // Fenwick tree of rank counts
+    int top;                            // highest power of two <= ranks
+    int size;                           // samples in the window
+
+    void update( const int cell, const int change );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Ranks the valid samples of an array and starts with an empty window.
+     *   The array is not referenced after construction.
+     *
+     * Param:
+     *   const double* values -- samples
+     *   const uint64_t* validity -- validity bitmap; NULL if all are valid
+     *   const int count -- number of samples
+     */
+    RankWindow( const double* values,
+                const uint64_t* validity,
+                const int count );
+
+    /*
+     * Returns true if the cell holds a valid sample, one the window can hold.
+     */
+    const bool isRanked( const int cell ) const;
+
+    /*
+     * Returns the number of samples in the window.
+     */
+    const int getSize() const;
+
+    /*
+     * Adds or removes the sample of a cell. Cells outside the array or
+     *   without a valid sample are ignored, so a caller may slide the window
+     *   past either end.
+     */
+    void insert( const int cell );
+    void remove( const int cell );
+
+    /*
+     * Returns the k-th smallest value in the window, k from 1 to getSize().
+     */
+    const double select( int k ) const;
+};
+
+#endif
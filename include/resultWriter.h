@@ -0,0 +1,207 @@
+/*
+ * Writes result tables, such as the correlation of a pair at each lag, to a
+ *   file in one of two formats:
+ *
+ *     RESULTWRITER_TEXT -- whitespace separated columns, one line per row,
+ *       after a '#' comment line naming the series and columns, so gnuplot
+ *       reads them as before ("using 5:4"). Numbers are formatted with
+ *       std::to_chars: locale independent, and doubles in the shortest form
+ *       that reads back to the same value.
+ *     RESULTWRITER_BINARY -- a columnar table with a small header. Each
+ *       table is the bytes "CRSR", int fields of version, resolution, lag
+ *       offset, rows, and columns, the two series labels, then each column as
+ *       its int type (DATATYPE_INT or DATATYPE_DOUBLE), its label, and its
+ *       values. Labels are an int length followed by their bytes; all fields
+ *       are in native byte order.
+ *
+ *   Output is gathered into large chunks and written a chunk at a time. An
+ *   asynchronous writer hands full chunks to its own thread through a ring,
+ *   as DecompressBuf does for reading, so formatting the next rows overlaps
+ *   with writing the previous ones.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Documented that rows may skip lags
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <string>
+#include <pthread.h>
+
+#include <crsCorr/global.h>
+
+#ifndef CRSCORR_RESULTWRITER_H
+#define CRSCORR_RESULTWRITER_H
+
+// formats
+#define RESULTWRITER_TEXT 0
+#define RESULTWRITER_BINARY 1
+
+// binary layout
+#define RESULTWRITER_MAGIC "CRSR"
+#define RESULTWRITER_VERSION 1
+
+// default ring dimensions
+#define RESULTWRITER_CHUNK_SIZE 1048576
+#define RESULTWRITER_CHUNK_COUNT 4
+
+// longest formatted number
+#define RESULTWRITER_NUMBER_SIZE 32
+
+// namespace convention
+using std::string;
+
+/*
+ * ResultHeader
+ *
+ * Describes a table: the two series correlated, their common resolution in
+ *   minutes, and the lag in cells of the first row. Rows need not be
+ *   consecutive lags (lags without a defined result may be left out), so a
+ *   table that skips lags carries each row's lag in a column of its own.
+ */
+typedef struct ResultHeader {
+  string labelA;
+  string labelB;
+  int resolution;
+  int lagOffset;
+} ResultHeader;
+
+/*
+ * ResultColumn
+ *
+ * A column of a table. Exactly one of ints and doubles is used, according to
+ *   type; the caller keeps the values until the table is written.
+ */
+typedef struct ResultColumn {
+  string label;
+  int type;                             // DATATYPE_INT or DATATYPE_DOUBLE
+  const int* ints;
+  const double* doubles;
+} ResultColumn;
+
+
+class ResultWriter {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    /*
+     * Chunk
+     *
+     * One slot of the ring, filled by the caller and emptied by a write.
+     */
+    typedef struct Chunk {
+      char* bytes;
+      size_t count;
+    } Chunk;
+
+    //----< DATA MEMBERS >------------------------------------------------------
+    const string fileName;
+    const int format;           // one of the RESULTWRITER_ formats
+    const bool asynchronous;    // chunks are written by the thread
+    const size_t chunkSize;     // bytes per chunk
+    const int chunkCount;       // chunks in the ring
+
+    Chunk* chunks;              // the ring
+    int fillIndex;              // chunk the caller is filling
+    int writeIndex;             // next chunk the thread writes
+    int filled;                 // chunks waiting for the thread
+    bool stopping;              // no more chunks will be handed over
+    bool failed;                // a write failed
+    bool started;               // thread was created
+    bool closed;                // close() has run
+    int fileDescriptor;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t chunkReady;  // signalled when a chunk is handed over
+    pthread_cond_t chunkFree;   // signalled when a chunk is written
+
+    //----< THREAD METHODS >----------------------------------------------------
+    /*
+     * Entry point for the writing thread.
+     */
+    static void* run( void* writer );
+
+    /*
+     * Writes bytes to the file, retrying partial writes. Returns false on
+     *   error.
+     */
+    const bool writeBytes( const char* bytes, const size_t count );
+
+    //----< BUFFER METHODS >----------------------------------------------------
+    /*
+     * Writes the chunk being filled, or hands it to the thread and moves on
+     *   to a free one.
+     */
+    void flushChunk();
+
+    /*
+     * Returns room for count bytes in the chunk being filled, flushing it
+     *   first if it lacks the room. count must not exceed the chunk size.
+     */
+    char* reserve( const size_t count );
+
+    /*
+     * Appends bytes of any length.
+     */
+    void append( const void* bytes, const size_t count );
+
+    /*
+     * Appends a length prefixed label.
+     */
+    void appendLabel( const string& label );
+
+    // no copies
+    ResultWriter( const ResultWriter& copy );
+    ResultWriter& operator=( const ResultWriter& copy );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Creates or truncates the file.
+     *
+     * Param:
+     *   const string fileName -- result file
+     *   const int format -- RESULTWRITER_TEXT or RESULTWRITER_BINARY
+     *   const bool asynchronous -- write chunks on a separate thread
+     *   const size_t chunkSize -- bytes gathered before each write
+     *   const int chunkCount -- chunks in the ring when asynchronous
+     */
+    ResultWriter( const string fileName,
+                  const int format = RESULTWRITER_TEXT,
+                  const bool asynchronous = false,
+                  const size_t chunkSize = RESULTWRITER_CHUNK_SIZE,
+                  const int chunkCount = RESULTWRITER_CHUNK_COUNT );
+
+    /*
+     * Closes the writer if close() was not called.
+     */
+    ~ResultWriter();
+
+    /*
+     * Appends a table of rows entries in each column. Several tables may be
+     *   written to one file.
+     *
+     * Return: false if the writer has failed or a column is malformed
+     */
+    const bool writeTable( const ResultHeader& header,
+                           const ResultColumn* columns,
+                           const int columnCount,
+                           const int rows );
+
+    /*
+     * Writes everything still buffered and closes the file.
+     *
+     * Return: true if every byte was written
+     */
+    const bool close();
+
+    /*
+     * Returns false once opening or a write has failed.
+     */
+    const bool good() const;
+
+    const int getFormat() const { return format; }
+};
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * Statistics of a trailing window slid along a series. The window ending at
+ *   cell i covers cells i - window + 1 through i, and only its valid cells
+ *   take part. Each statistic is updated as the window slides rather than
+ *   recomputed:
+ *
+ *     mean, variance -- Welford updates, O(1) per cell
+ *     min, max       -- monotonic deque of candidates, O(1) amortized
+ *     quantile       -- a RankWindow of value ranks, O(log n) per cell
+ *
+ *   Quantiles interpolate linearly between the order statistics on either
+ *   side of q * ( n - 1 ), so q = 0.5 gives the median.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <string>
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+#include <crsCorr/dataSeries.h>
+
+#ifndef CRSCORR_ROLLINGSTATS_H
+#define CRSCORR_ROLLINGSTATS_H
+
+// statistics
+#define ROLLING_MEAN 0
+#define ROLLING_VARIANCE 1                // sample variance, n - 1
+#define ROLLING_MIN 2
+#define ROLLING_MAX 3
+#define ROLLING_QUANTILE 4
+
+// namespace convention
+using std::string;
+
+class RollingStats {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    static void rollMoments( const double* values,
+                             const uint64_t* validity,
+                             const int count,
+                             const int window,
+                             const bool variance,
+                             const int minValid,
+                             double* out,
+                             uint64_t* outValid );
+
+    static void rollExtreme( const double* values,
+                             const uint64_t* validity,
+                             const int count,
+                             const int window,
+                             const bool maximum,
+                             const int minValid,
+                             double* out,
+                             uint64_t* outValid );
+
+    static void rollQuantile( const double* values,
+                              const uint64_t* validity,
+                              const int count,
+                              const int window,
+                              const double quantile,
+                              const int minValid,
+                              double* out,
+                              uint64_t* outValid );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Computes a rolling statistic of an array into caller owned buffers, so
+     *   the output may be written straight into another series' layout.
+     *
+     * Param:
+     *   const double* values -- samples
+     *   const uint64_t* validity -- validity bitmap; NULL if all are valid
+     *   const int count -- number of samples
+     *   const int window -- window length in cells
+     *   const int statistic -- one of the ROLLING_ constants
+     *   const double quantile -- quantile for ROLLING_QUANTILE, 0 to 1
+     *   const int minValid -- fewest valid cells a window needs for a defined
+     *                         result; variance always needs two
+     *   double* out -- count results; undefined results are 0
+     *   uint64_t* outValid -- if not NULL, ( count + 63 ) / 64 words that
+     *                         receive a bit per defined result
+     *
+     * Return: bool -- false for a bad window, statistic, or quantile
+     */
+    static const bool compute( const double* values,
+                               const uint64_t* validity,
+                               const int count,
+                               const int window,
+                               const int statistic,
+                               const double quantile,
+                               const int minValid,
+                               double* out,
+                               uint64_t* outValid );
+
+    /*
+     * Rolls a statistic along a finalized series with a window of the
+     *   provided length in minutes, a whole number of cells of at least one.
+     *   Returns a new series with the same resolution and start time, whose
+     *   cells are valid where the statistic is defined, or NULL on error.
+     */
+    template<typename DataType>
+    static DataSeries<double>* rolling( const DataSeries<DataType>& series,
+                                        const int windowMinutes,
+                                        const int statistic,
+                                        const string label,
+                                        const double quantile = 0.5,
+                                        const int minValid = 1 )
+    {
+      LOG_DEBUG( 12, "( " << series.getLabel() << ", " << windowMinutes \
+                     << ", " << statistic << ", " << label << " )" )
+
+      const DataType* data = series.getData();
+      const int length = series.getLength();
+      const int window = windowMinutes / series.getResolution();
+      if( data == NULL || length <= 0 ) {
+        LOG_ERR( "Series ('" << series.getLabel() << "') is not final." )
+        return NULL;
+      } else if( window < 1 || windowMinutes % series.getResolution() != 0 ) {
+        LOG_ERR( "Window of " << windowMinutes << " minutes is not a whole " \
+                 << "number of " << series.getResolution() << " minute cells." )
+        return NULL;
+      }
+
+      double* values = new double[ length ];
+      for( int i = 0; i < length; i++ ) {
+        values[i] = data[i];
+      }
+      double* out = new double[ length ];
+      const int words = ( length + 63 ) / 64;
+      uint64_t* outValid = new uint64_t[ words ];
+      bool good = compute( values, series.getValidity(), length, window,
+                           statistic, quantile, minValid, out, outValid );
+      delete[] values;
+
+      DataSeries<double>* result = NULL;
+      if( good ) {
+        result = new DataSeries<double>( label );
+        result->adoptData( out, length, series.getResolution(),
+                           series.getStartTime() );
+        result->setValidity( outValid );
+        if( result->getValidCount() == length ) {
+          result->setValidity( NULL );
+        }
+      } else {
+        delete[] out;
+      }
+      delete[] outValid;
+      return result;
+    }// end static DataSeries<double>* rolling( const DataSeries<DataType>&, ... )
+};
+
+#endif
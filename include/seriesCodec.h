@@ -0,0 +1,94 @@
+/*
+ * Lossless encodings for the values of a series, used when series are
+ *   written to disk. Values are encoded in independent blocks of
+ *   SERIESCODEC_BLOCK values:
+ *
+ *     integers -- delta-of-delta, zigzag mapped, and bit packed at the
+ *                 width that minimizes the block, with the few wider
+ *                 values stored separately as exceptions
+ *     doubles  -- XOR with the previous value, storing only the meaningful
+ *                 bits (Gorilla); repeated values cost one bit each
+ *
+ * Each block is a BlockHeader followed by its payload.
+ *
+ * Modified: 10/19/26
+ * Notes:    --decodeBlock() is private; columns are decoded whole
+ *
+ * Modified: 10/19/26
+ * Notes:    --Removed BlockDecoder; no consumer streamed columns through it
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <string>
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+
+#ifndef CRSCORR_SERIESCODEC_H
+#define CRSCORR_SERIESCODEC_H
+
+#define SERIESCODEC_BLOCK 1024          // values per block
+#define SERIESCODEC_MAX_WIDTH 56        // widest packed integer field
+
+// column encodings
+#define SERIESCODEC_RAW 0
+#define SERIESCODEC_PACKED 1
+
+// namespace convention
+using std::string;
+
+class SeriesCodec {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    /*
+     * BlockHeader
+     *
+     * Leads every encoded block.
+     */
+    typedef struct BlockHeader {
+      uint32_t count;                   // values in the block
+      uint32_t bytes;                   // payload bytes after the header
+    } BlockHeader;
+
+    /*
+     * Decodes the block at in into values, which must hold SERIESCODEC_BLOCK
+     *   values.
+     *
+     * Return: size_t -- bytes consumed, or 0 if the block is malformed. The
+     *                   number of values decoded is stored in decoded.
+     */
+    static const size_t decodeBlock( const char* in,
+                                     const size_t size,
+                                     const int type,
+                                     void* values,
+                                     int* decoded );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Appends the encoding of count values of the provided type
+     *   (DATATYPE_INT or DATATYPE_DOUBLE) to out.
+     *
+     * Return: bool -- false for an unsupported type
+     */
+    static const bool encode( const void* values,
+                              const int count,
+                              const int type,
+                              string& out );
+
+    /*
+     * Decodes an entire encoded column of count values into values.
+     *
+     * Return: bool -- false if the encoding is malformed or does not hold
+     *                 exactly count values
+     */
+    static const bool decode( const char* in,
+                              const size_t size,
+                              const int type,
+                              const int count,
+                              void* values );
+};
+
+#endif
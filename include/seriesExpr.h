@@ -0,0 +1,496 @@
+/*
+ * Elementwise arithmetic on finalized DataSeries. Since operator+ of a
+ *   DataSeries concatenates, elementwise work starts from a series wrapped
+ *   by elementwise() or from one of the named functions:
+ *
+ *     add, sub, mul, div -- binary arithmetic; div always yields double
+ *     abs, log           -- unary functions; log yields double
+ *     clamp              -- limits values to [low, high]
+ *
+ *   Once wrapped, the +, -, *, and / operators combine series, expressions,
+ *   and scalars elementwise. Nothing is computed while an expression is
+ *   built; evaluate() walks the whole expression once per cell in a single
+ *   loop, with no intermediate series, e.g.
+ *
+ *     DataSeries<double>* diff = evaluate(
+ *         ( elementwise( *vsynmax ) - *hsynmax ) * scale, "diff" );
+ *
+ *   A cell of the result is valid only where every series in the expression
+ *   is valid. Every series must share one length, resolution, and start
+ *   time; evaluate() reports a mismatch and returns NULL.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <string>
+#include <cmath>
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+#include <crsCorr/dataSeries.h>
+
+#ifndef CRSCORR_SERIESEXPR_H
+#define CRSCORR_SERIESEXPR_H
+
+// namespace convention
+using std::string;
+
+/*
+ * SeriesShape
+ *
+ * Length, resolution, and start time shared by the series of an expression.
+ *   Expressions of scalars alone have no shape.
+ */
+typedef struct SeriesShape {
+  bool known;                           // a series has been seen
+  bool matched;                         // every series agreed
+  int length;
+  int resolution;
+  int startTime;
+} SeriesShape;
+
+/*
+ * SeriesPromote
+ *
+ * Value type of an operation on two value types: int with int stays int,
+ *   anything with double becomes double.
+ */
+template<typename Left, typename Right>
+struct SeriesPromote {
+  typedef double type;
+};
+
+template<>
+struct SeriesPromote<int, int> {
+  typedef int type;
+};
+
+/*
+ * SeriesExpr
+ *
+ * Base of every expression node, so that operators only apply to
+ *   expressions. Each node provides:
+ *
+ *     ValueType                    -- type of its values
+ *     value( i )                   -- value of cell i
+ *     validWord( w )               -- validity bits of cells 64w to 64w+63
+ *     shape( SeriesShape& )        -- merges its series into the shape
+ */
+template<typename Derived>
+struct SeriesExpr {
+  const Derived& self() const {
+    return static_cast<const Derived&>( *this );
+  }
+};
+
+//----< LEAVES >----------------------------------------------------------------
+/*
+ * A finalized series. A series that is not final gives an empty shape.
+ */
+template<typename DataType>
+class SeriesTerminal : public SeriesExpr< SeriesTerminal<DataType> > {
+  private:
+    const DataType* data;
+    const uint64_t* validity;
+    int length;
+    int resolution;
+    int startTime;
+
+  public:
+    typedef DataType ValueType;
+
+    SeriesTerminal( const DataSeries<DataType>& series )
+      : data( series.getData() ), validity( series.getValidity() ),
+        length( series.getLength() ), resolution( series.getResolution() ),
+        startTime( series.getStartTime() ) {}
+
+    DataType value( const int i ) const {
+      return data[i];
+    }
+
+    uint64_t validWord( const int word ) const {
+      return validity == NULL ? ~(uint64_t)0 : validity[word];
+    }
+
+    void shape( SeriesShape& shape ) const {
+      if( data == NULL ) {
+        shape.matched = false;
+      } else if( !shape.known ) {
+        shape.known = true;
+        shape.length = length;
+        shape.resolution = resolution;
+        shape.startTime = startTime;
+      } else if( shape.length != length || shape.resolution != resolution
+                 || shape.startTime != startTime )
+      {
+        shape.matched = false;
+      }
+    }
+};
+
+
+/*
+ * A constant, valid in every cell.
+ */
+template<typename DataType>
+class SeriesScalar : public SeriesExpr< SeriesScalar<DataType> > {
+  private:
+    DataType constant;
+
+  public:
+    typedef DataType ValueType;
+
+    SeriesScalar( const DataType constant ) : constant( constant ) {}
+
+    DataType value( const int ) const { return constant; }
+    uint64_t validWord( const int ) const { return ~(uint64_t)0; }
+    void shape( SeriesShape& ) const {}
+};
+
+/*
+ * SeriesIsExpr
+ *
+ * True for the node types, which derive from SeriesExpr of themselves.
+ */
+template<typename Operand>
+struct SeriesIsExpr {
+  static char test( const SeriesExpr<Operand>* );
+  static long test( ... );
+  static const bool value =
+      sizeof( test( (const Operand*)NULL )) == sizeof( char );
+};
+
+/*
+ * SeriesOperand
+ *
+ * Node type of each kind of operand: series become terminals, numbers
+ *   become scalars, and expressions are kept as they are. Other types have
+ *   no node type, so the builders below do not apply to them.
+ */
+template<typename Operand, bool isExpr = SeriesIsExpr<Operand>::value>
+struct SeriesOperand {
+};
+
+template<typename Operand>
+struct SeriesOperand<Operand, true> {
+  typedef Operand type;
+};
+
+template<typename DataType>
+struct SeriesOperand<DataSeries<DataType>, false> {
+  typedef SeriesTerminal<DataType> type;
+};
+
+template<>
+struct SeriesOperand<int, false> {
+  typedef SeriesScalar<int> type;
+};
+
+template<>
+struct SeriesOperand<double, false> {
+  typedef SeriesScalar<double> type;
+};
+
+//----< OPERATIONS >------------------------------------------------------------
+struct SeriesAdd {
+  template<typename Type>
+  static Type apply( const Type left, const Type right ) {
+    return left + right;
+  }
+};
+
+struct SeriesSub {
+  template<typename Type>
+  static Type apply( const Type left, const Type right ) {
+    return left - right;
+  }
+};
+
+struct SeriesMul {
+  template<typename Type>
+  static Type apply( const Type left, const Type right ) {
+    return left * right;
+  }
+};
+
+struct SeriesDiv {
+  template<typename Type>
+  static Type apply( const Type left, const Type right ) {
+    return left / right;
+  }
+};
+
+struct SeriesAbs {
+  template<typename Type>
+  static Type apply( const Type operand ) {
+    return operand < 0 ? -operand : operand;
+  }
+};
+
+struct SeriesLog {
+  template<typename Type>
+  static Type apply( const Type operand ) {
+    return std::log( operand );
+  }
+};
+
+/*
+ * SeriesResult
+ *
+ * Value type of an operation on operands of the provided types.
+ */
+template<typename Operation, typename Left, typename Right = Left>
+struct SeriesResult {
+  typedef typename SeriesPromote<Left, Right>::type type;
+};
+
+template<typename Left, typename Right>
+struct SeriesResult<SeriesDiv, Left, Right> {
+  typedef double type;
+};
+
+template<typename Operand>
+struct SeriesResult<SeriesLog, Operand, Operand> {
+  typedef double type;
+};
+
+//----< NODES >-----------------------------------------------------------------
+template<typename Operation, typename Left, typename Right>
+class SeriesBinary : public SeriesExpr< SeriesBinary<Operation, Left, Right> > {
+  private:
+    Left left;
+    Right right;
+
+  public:
+    typedef typename SeriesResult<Operation,
+                                  typename Left::ValueType,
+                                  typename Right::ValueType>::type ValueType;
+
+    SeriesBinary( const Left& left, const Right& right )
+      : left( left ), right( right ) {}
+
+    ValueType value( const int i ) const {
+      return Operation::apply( (ValueType)left.value( i ),
+                               (ValueType)right.value( i ));
+    }
+
+    uint64_t validWord( const int word ) const {
+      return left.validWord( word ) & right.validWord( word );
+    }
+
+    void shape( SeriesShape& shape ) const {
+      left.shape( shape );
+      right.shape( shape );
+    }
+};
+
+
+template<typename Operation, typename Operand>
+class SeriesUnary : public SeriesExpr< SeriesUnary<Operation, Operand> > {
+  private:
+    Operand operand;
+
+  public:
+    typedef typename SeriesResult<Operation,
+                                  typename Operand::ValueType>::type ValueType;
+
+    SeriesUnary( const Operand& operand ) : operand( operand ) {}
+
+    ValueType value( const int i ) const {
+      return Operation::apply( (ValueType)operand.value( i ));
+    }
+
+    uint64_t validWord( const int word ) const {
+      return operand.validWord( word );
+    }
+
+    void shape( SeriesShape& shape ) const {
+      operand.shape( shape );
+    }
+};
+
+
+template<typename Operand>
+class SeriesClamp : public SeriesExpr< SeriesClamp<Operand> > {
+  public:
+    typedef typename Operand::ValueType ValueType;
+
+  private:
+    Operand operand;
+    ValueType low;
+    ValueType high;
+
+  public:
+    SeriesClamp( const Operand& operand,
+                 const ValueType low,
+                 const ValueType high )
+      : operand( operand ), low( low ), high( high ) {}
+
+    ValueType value( const int i ) const {
+      ValueType v = operand.value( i );
+      return v < low ? low : ( v > high ? high : v );
+    }
+
+    uint64_t validWord( const int word ) const {
+      return operand.validWord( word );
+    }
+
+    void shape( SeriesShape& shape ) const {
+      operand.shape( shape );
+    }
+};
+
+//----< BUILDERS >--------------------------------------------------------------
+/*
+ * Starts an elementwise expression from a series.
+ */
+template<typename DataType>
+SeriesTerminal<DataType> elementwise( const DataSeries<DataType>& series ) {
+  return SeriesTerminal<DataType>( series );
+}
+
+#define SERIESEXPR_BINARY( name, operation )                                   \
+  template<typename Left, typename Right>                                      \
+  SeriesBinary<operation,                                                      \
+               typename SeriesOperand<Left>::type,                             \
+               typename SeriesOperand<Right>::type>                            \
+  name( const Left& left, const Right& right ) {                               \
+    return SeriesBinary<operation,                                             \
+                        typename SeriesOperand<Left>::type,                    \
+                        typename SeriesOperand<Right>::type>( left, right );   \
+  }
+
+SERIESEXPR_BINARY( add, SeriesAdd )
+SERIESEXPR_BINARY( sub, SeriesSub )
+SERIESEXPR_BINARY( mul, SeriesMul )
+SERIESEXPR_BINARY( div, SeriesDiv )
+
+#undef SERIESEXPR_BINARY
+
+/*
+ * Operators apply when either operand is an expression; the other may be
+ *   an expression, a series, or a number.
+ */
+#define SERIESEXPR_OPERATOR( symbol, operation )                               \
+  template<typename Left, typename Right>                                      \
+  SeriesBinary<operation, Left, Right>                                         \
+  operator symbol( const SeriesExpr<Left>& left,                               \
+                   const SeriesExpr<Right>& right ) {                          \
+    return SeriesBinary<operation, Left, Right>( left.self(), right.self() );  \
+  }                                                                            \
+  template<typename Left, typename Right>                                      \
+  SeriesBinary<operation, Left, typename SeriesOperand<Right>::type>           \
+  operator symbol( const SeriesExpr<Left>& left, const Right& right ) {        \
+    return SeriesBinary<operation, Left,                                       \
+                        typename SeriesOperand<Right>::type>( left.self(),     \
+                                                              right );         \
+  }                                                                            \
+  template<typename Left, typename Right>                                      \
+  SeriesBinary<operation, typename SeriesOperand<Left>::type, Right>           \
+  operator symbol( const Left& left, const SeriesExpr<Right>& right ) {        \
+    return SeriesBinary<operation, typename SeriesOperand<Left>::type,         \
+                        Right>( left, right.self() );                          \
+  }
+
+SERIESEXPR_OPERATOR( +, SeriesAdd )
+SERIESEXPR_OPERATOR( -, SeriesSub )
+SERIESEXPR_OPERATOR( *, SeriesMul )
+SERIESEXPR_OPERATOR( /, SeriesDiv )
+
+#undef SERIESEXPR_OPERATOR
+
+/*
+ * Unary functions apply to series and expressions only, leaving abs and log
+ *   of plain numbers to the standard library.
+ */
+#define SERIESEXPR_UNARY( name, operation )                                    \
+  template<typename DataType>                                                  \
+  SeriesUnary<operation, SeriesTerminal<DataType> >                            \
+  name( const DataSeries<DataType>& operand ) {                                \
+    return SeriesUnary<operation, SeriesTerminal<DataType> >( operand );       \
+  }                                                                            \
+  template<typename Operand>                                                   \
+  SeriesUnary<operation, Operand>                                              \
+  name( const SeriesExpr<Operand>& operand ) {                                 \
+    return SeriesUnary<operation, Operand>( operand.self() );                  \
+  }
+
+SERIESEXPR_UNARY( abs, SeriesAbs )
+SERIESEXPR_UNARY( log, SeriesLog )
+
+#undef SERIESEXPR_UNARY
+
+template<typename DataType>
+SeriesClamp< SeriesTerminal<DataType> >
+clamp( const DataSeries<DataType>& operand,
+       const DataType low,
+       const DataType high )
+{
+  return SeriesClamp< SeriesTerminal<DataType> >( operand, low, high );
+}
+
+template<typename Operand>
+SeriesClamp<Operand> clamp( const SeriesExpr<Operand>& operand,
+                            const typename Operand::ValueType low,
+                            const typename Operand::ValueType high )
+{
+  return SeriesClamp<Operand>( operand.self(), low, high );
+}
+
+//----< EVALUATION >------------------------------------------------------------
+/*
+ * Computes an expression into a new finalized series with the provided
+ *   label, or returns NULL if the expression holds no finalized series or
+ *   its series differ in length, resolution, or start time. The caller owns
+ *   the returned series.
+ */
+template<typename Expr>
+DataSeries<typename Expr::ValueType>* evaluate( const SeriesExpr<Expr>& expr,
+                                                const string label = "EXPR" )
+{
+  typedef typename Expr::ValueType ValueType;
+  LOG_DEBUG( 14, "( expr, " << label << " )" )
+
+  const Expr& node = expr.self();
+  SeriesShape shape = { false, true, 0, 0, 0 };
+  node.shape( shape );
+  if( !shape.matched ) {
+    LOG_ERR( "Series of '" << label << "' are not all final with matching " \
+             << "length, resolution, and start time." )
+    return NULL;
+  } else if( !shape.known || shape.length <= 0 ) {
+    LOG_ERR( "Expression '" << label << "' holds no series values." )
+    return NULL;
+  }
+
+  // one fused pass over the values
+  const int length = shape.length;
+  ValueType* values = new ValueType[ length ];
+  for( int i = 0; i < length; i++ ) {
+    values[i] = node.value( i );
+  }
+
+  // and one over the validity words
+  const int words = ( length + 63 ) / 64;
+  uint64_t* validity = new uint64_t[ words ];
+  bool allValid = true;
+  for( int word = 0; word < words; word++ ) {
+    validity[word] = node.validWord( word );
+    if( word == words - 1 && length % 64 != 0 ) {
+      validity[word] &= ( (uint64_t)1 << ( length % 64 )) - 1;
+      allValid &= validity[word] == ( (uint64_t)1 << ( length % 64 )) - 1;
+    } else {
+      allValid &= validity[word] == ~(uint64_t)0;
+    }
+  }
+
+  DataSeries<ValueType>* result = new DataSeries<ValueType>( label );
+  result->adoptData( values, length, shape.resolution, shape.startTime );
+  if( !allValid ) {
+    result->setValidity( validity );
+  }
+  delete[] validity;
+  return result;
+}// end DataSeries<typename Expr::ValueType>* evaluate( const SeriesExpr<Expr>&, ... )
+
+#endif
@@ -0,0 +1,269 @@
+/*
+ * Filters for removing trends and noise from series before they are
+ *   correlated. Every SeriesFilter keeps its state between calls to
+ *   process(), so a long record may be filtered whole or a block at a time
+ *   as it is streamed in, with identical results:
+ *
+ *     FirFilter     -- convolution with a kernel; long kernels are applied
+ *                      by FFT overlap-save
+ *     BiquadFilter  -- cascade of second order IIR sections
+ *     MovingAverage -- trailing mean of a fixed window, O(1) per sample
+ *
+ *   removeMean() and detrend() fit the whole record and so work on complete
+ *   arrays only.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <string>
+#include <vector>
+#include <complex>
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+#include <crsCorr/dataSeries.h>
+
+#ifndef CRSCORR_SERIESFILTER_H
+#define CRSCORR_SERIESFILTER_H
+
+// kernels at least this long are applied by FFT overlap-save
+#define SERIESFILTER_FFT_TAPS 64
+
+// most polynomial order detrend() fits
+#define SERIESFILTER_MAX_ORDER 8
+
+// namespace convention
+using std::string;
+
+class SeriesFilter {
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    virtual ~SeriesFilter() {}
+
+    /*
+     * Filters count samples following those of the previous call. in and out
+     *   may be the same array to filter in place.
+     */
+    virtual void process( const double* in, double* out, const int count ) = 0;
+
+    /*
+     * Forgets all previous samples, as if newly constructed.
+     */
+    virtual void reset() = 0;
+
+    /*
+     * Filters a finalized series from a reset state into a new series of the
+     *   same length, resolution, start time, and validity. Invalid cells hold
+     *   the previous valid value (or the first valid value before it) while
+     *   filtering so that placeholders do not ring through the output.
+     *   Returns NULL if the series is not final or holds no valid cells.
+     */
+    template<typename DataType>
+    DataSeries<double>* apply( const DataSeries<DataType>& series,
+                               const string label )
+    {
+      LOG_DEBUG( 12, "( " << series.getLabel() << ", " << label << " )" )
+
+      double* values = bridgeGaps( series );
+      if( values == NULL ) {
+        return NULL;
+      }
+      reset();
+      process( values, values, series.getLength() );
+      return makeSeries( series, values, label );
+    }// end DataSeries<double>* apply( const DataSeries<DataType>&, ... )
+
+    //----< WHOLE RECORD METHODS >----------------------------------------------
+    /*
+     * Subtracts the mean of the valid samples from every sample.
+     *
+     * Param:
+     *   double* values -- samples, changed in place
+     *   const uint64_t* validity -- validity bitmap; NULL if all are valid
+     *   const int count -- number of samples
+     *
+     * Return: bool -- false if no sample is valid
+     */
+    static const bool removeMean( double* values,
+                                  const uint64_t* validity,
+                                  const int count );
+
+    /*
+     * Subtracts the least squares polynomial of the provided order (1 for a
+     *   line) fitted to the valid samples, indexed by cell, from every sample.
+     *
+     * Return: bool -- false if the order is outside 0 to
+     *                 SERIESFILTER_MAX_ORDER or too few samples are valid
+     */
+    static const bool detrend( double* values,
+                               const uint64_t* validity,
+                               const int count,
+                               const int order = 1 );
+
+    /*
+     * Series versions of removeMean (order 0) and detrend, returning a new
+     *   series or NULL.
+     */
+    template<typename DataType>
+    static DataSeries<double>* detrend( const DataSeries<DataType>& series,
+                                        const string label,
+                                        const int order = 1 )
+    {
+      LOG_DEBUG( 12, "( " << series.getLabel() << ", " << label << ", " \
+                     << order << " )" )
+
+      double* values = bridgeGaps( series );
+      if( values == NULL ) {
+        return NULL;
+      }
+      if( !detrend( values, series.getValidity(), series.getLength(), order )) {
+        delete[] values;
+        return NULL;
+      }
+      return makeSeries( series, values, label );
+    }// end static DataSeries<double>* detrend( const DataSeries<DataType>&, ... )
+
+/*****< PROTECTED >************************************************************/
+  protected:
+    /*
+     * Copies the values of a finalized series into a new array, filling
+     *   invalid cells with the nearest earlier valid value (or the first
+     *   valid value for leading cells). Returns NULL if there is nothing to
+     *   filter.
+     */
+    template<typename DataType>
+    static double* bridgeGaps( const DataSeries<DataType>& series ) {
+      const DataType* data = series.getData();
+      const int length = series.getLength();
+      if( data == NULL || length <= 0 || series.getValidCount() == 0 ) {
+        LOG_ERR( "Series ('" << series.getLabel() << "') has no valid " \
+                 << "values to filter." )
+        return NULL;
+      }
+
+      int first = 0;
+      while( !series.isValid( first )) {
+        first++;
+      }
+      double* values = new double[ length ];
+      double held = data[first];
+      for( int i = 0; i < length; i++ ) {
+        if( series.isValid( i )) {
+          held = data[i];
+        }
+        values[i] = held;
+      }
+      return values;
+    }// end static double* bridgeGaps( const DataSeries<DataType>& )
+
+    /*
+     * Wraps filtered values in a new series shaped like the source.
+     */
+    static DataSeries<double>* makeSeries( const AbstractDataSeries& source,
+                                           double* values,
+                                           const string label );
+};
+
+
+class FirFilter : public SeriesFilter {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    std::vector<double> taps;           // kernel, taps[0] applied to newest
+    std::vector<double> history;        // last taps - 1 inputs, oldest first
+
+    // overlap-save state, used for long kernels only
+    int fftSize;                        // 0 when filtering directly
+    std::vector< std::complex<double> > spectrum;  // transform of the kernel
+    std::vector< std::complex<double> > work;      // transform buffer
+
+    void processDirect( const double* in, double* out, const int count );
+    void processFft( const double* in, double* out, const int count );
+
+    // keeps the last taps - 1 inputs after a block
+    void updateHistory( const double* in, const int count );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Builds a causal filter, out[n] = sum of kernel[k] * in[n - k], with
+     *   samples before the first taken as zero. Kernels of at least
+     *   SERIESFILTER_FFT_TAPS taps are applied by overlap-save unless
+     *   useFft is false.
+     */
+    FirFilter( const double* kernel, const int count, const bool useFft = true );
+
+    void process( const double* in, double* out, const int count );
+    void reset();
+};
+
+
+class BiquadFilter : public SeriesFilter {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    /*
+     * Section
+     *
+     * One second order section, normalized so a0 = 1, in transposed direct
+     *   form II.
+     */
+    typedef struct Section {
+      double b0, b1, b2;
+      double a1, a2;
+      double z1, z2;                    // state
+    } Section;
+
+    std::vector<Section> sections;
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    //----< SECTION METHODS >---------------------------------------------------
+    /*
+     * Appends a section with transfer function
+     *   ( b0 + b1 z^-1 + b2 z^-2 ) / ( 1 + a1 z^-1 + a2 z^-2 ).
+     */
+    void addSection( const double b0, const double b1, const double b2,
+                     const double a1, const double a2 );
+
+    /*
+     * Append Butterworth style (Q = 1/sqrt(2) by default) low and high pass
+     *   sections. cutoff is a fraction of the sample rate, between 0 and 0.5;
+     *   for series the sample rate is one per resolution minutes, so a cutoff
+     *   of resolution / 60.0 passes periods longer than an hour.
+     *
+     * Return: bool -- false for a cutoff or Q outside the valid range
+     */
+    const bool addLowPass( const double cutoff, const double q = 0.70710678 );
+    const bool addHighPass( const double cutoff, const double q = 0.70710678 );
+
+    const int getSectionCount() const { return sections.size(); }
+
+    void process( const double* in, double* out, const int count );
+    void reset();
+};
+
+
+class MovingAverage : public SeriesFilter {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    std::vector<double> window;         // ring of the last inputs
+    int next;                           // ring position of the oldest input
+    int filled;                         // inputs held, up to the window
+    double sum;                         // sum of the inputs held
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Averages the last width samples. The first width - 1 outputs average
+     *   the samples seen so far.
+     */
+    MovingAverage( const int width );
+
+    void process( const double* in, double* out, const int count );
+    void reset();
+};
+
+#endif
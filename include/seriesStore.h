@@ -0,0 +1,320 @@
+/*
+ * Persistent store of parsed series spanning many days. Each label of each
+ *   source is kept as a pair of files under <root>/<source>/:
+ *
+ *     <label>.dat -- a header page followed by the values of every day, one
+ *                    fixed size slot per calendar day
+ *     <label>.vld -- the validity bits of every day, one fixed size slot per
+ *                    calendar day
+ *
+ *   A day's slot sits at an offset computed from its date alone, so storing
+ *   or finding any day is O(1) and a range of days is one contiguous run of
+ *   values. Queries map the files and return views into the mapping rather
+ *   than copies. Days that were never stored read back as invalid.
+ *
+ * The store does no locking; use one writer per label at a time.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Storing a day before the first stored year re-bases the label
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <string>
+#include <map>
+#include <vector>
+
+#include <crsCorr/global.h>
+#include <crsCorr/dataSeries.h>
+#include <crsCorr/fileParser.h>
+
+#ifndef CRSCORR_SERIESSTORE_H
+#define CRSCORR_SERIESSTORE_H
+
+#define SERIESSTORE_MAGIC "CRSS"
+#define SERIESSTORE_VERSION 1
+#define SERIESSTORE_HEADER_SIZE 4096     // values start on a page boundary
+
+// namespace convention
+using std::string;
+
+/*
+ * Typed, read-only view of a run of days from a SeriesStore. Cells are
+ *   numbered from the first cell of the first day. A view remains usable
+ *   until the store that produced it is destroyed.
+ */
+template<typename DataType>
+class StoreView {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    const DataType* values;             // first cell
+    const unsigned char* validity;      // validity slot of the first day
+    int length;                         // cells in the view
+    int cellsPerDay;                    // cells in one day
+    int validityBytes;                  // bytes in one day's validity slot
+    int resolution;                     // minutes per cell
+    int startTime;                      // minutes from 00:00 of cell 0
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    //----< (DE)(CON)STRUCTORS >------------------------------------------------
+    StoreView( const DataType* values = NULL,
+               const unsigned char* validity = NULL,
+               const int length = 0,
+               const int cellsPerDay = 0,
+               const int resolution = DEFAULT_RESOLUTION,
+               const int startTime = DEFAULT_START_TIME )
+      : values( values ), validity( validity ), length( length ),
+        cellsPerDay( cellsPerDay ), validityBytes( ( cellsPerDay + 7 ) / 8 ),
+        resolution( resolution ), startTime( startTime ) {}
+
+    //----< ACCESSOR METHODS >--------------------------------------------------
+    const int getLength() const { return length; }
+    const int getCellsPerDay() const { return cellsPerDay; }
+    const int getResolution() const { return resolution; }
+    const int getStartTime() const { return startTime; }
+    const DataType* getData() const { return values; }
+
+    /*
+     * Returns true if the view does not refer to stored data.
+     */
+    const bool isEmpty() const { return values == NULL; }
+
+    /*
+     * Returns true if cell holds data rather than a placeholder.
+     */
+    const bool isValid( const int cell ) const {
+      int bit = cell % cellsPerDay;
+      return ( validity[ ( cell / cellsPerDay ) * validityBytes + ( bit >> 3 ) ]
+               >> ( bit & 7 )) & 1;
+    }
+
+    const DataType& operator[]( const int cell ) const {
+      return values[cell];
+    }
+};
+
+
+class SeriesStore {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    /*
+     * Header
+     *
+     * First bytes of a .dat file. baseDay is the day number (days since
+     *   1970-01-01) of the first slot; dayCount is the number of slots the
+     *   files hold.
+     */
+    typedef struct Header {
+      char magic[4];
+      int version;
+      int type;                         // DATATYPE_INT or DATATYPE_DOUBLE
+      int valueSize;                    // bytes per value
+      int resolution;                   // minutes per cell
+      int startTime;                    // minutes from 00:00 of the first cell
+      int cellsPerDay;                  // cells in one day
+      int baseDay;                      // day number of slot 0
+      int dayCount;                     // slots held by the files
+    } Header;
+
+    /*
+     * Segment
+     *
+     * An opened label: its header and the current mappings of its files.
+     *   Mappings replaced after the files grow are retired rather than
+     *   unmapped so that views handed out earlier stay valid.
+     */
+    typedef struct Segment {
+      Header header;
+      int valueFd;
+      int validityFd;
+      char* values;                     // mapping of the .dat file
+      size_t valuesSize;
+      unsigned char* validity;          // mapping of the .vld file
+      size_t validitySize;
+    } Segment;
+
+    typedef std::map<string, Segment*> Segments;
+
+    //----< DATA MEMBERS >------------------------------------------------------
+    string root;                        // directory holding the sources
+    Segments segments;                  // opened labels by path
+    std::vector< std::pair<void*, size_t> > retired;  // replaced mappings
+
+    // no copies
+    SeriesStore( const SeriesStore& copy );
+    SeriesStore& operator=( const SeriesStore& copy );
+
+    //----< SEGMENT METHODS >---------------------------------------------------
+    /*
+     * Returns the opened segment of a label, opening its files if needed.
+     *   When the files do not exist and a layout series is provided they are
+     *   created with its type, resolution, and start time, beginning with
+     *   January 1 of the year of day; otherwise NULL is returned.
+     */
+    Segment* openSegment( const string& source,
+                          const string& label,
+                          const AbstractDataSeries* layout,
+                          const int day );
+
+    /*
+     * Grows the files of a segment to hold the provided slot and updates the
+     *   header on disk.
+     */
+    const bool growSegment( Segment* segment, const int slot );
+
+    /*
+     * Moves slot 0 of a segment back to January 1 of the year of day. The
+     *   files at key are replaced by copies with the earlier slots prepended
+     *   and invalid, so views handed out earlier keep the old files.
+     */
+    const bool rebaseSegment( Segment* segment,
+                              const string& key,
+                              const int day );
+
+    /*
+     * Maps the current extent of a segment's files if not already mapped.
+     */
+    const bool mapSegment( Segment* segment );
+
+    /*
+     * Resolves a label and date range to a segment and its first slot.
+     *   Returns NULL if the label is not stored or the range is invalid.
+     */
+    Segment* findRange( const string& source,
+                        const string& label,
+                        const int fromDate,
+                        const int toDate,
+                        int* firstSlot,
+                        int* dayCount );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    //----< (DE)(CON)STRUCTORS >------------------------------------------------
+    /*
+     * Opens the store rooted at the provided directory, creating the
+     *   directory when it is first written to.
+     */
+    SeriesStore( const string rootDir );
+    ~SeriesStore();
+
+    //----< DATE UTILITIES >----------------------------------------------------
+    /*
+     * Converts a YYYYMMDD date to a day number (days since 1970-01-01) and
+     *   back. dateToDay returns -1 for a malformed date.
+     */
+    static const int dateToDay( const int date );
+    static const int dayToDate( const int day );
+
+    //----< STORAGE METHODS >---------------------------------------------------
+    /*
+     * Stores one day of a finalized series. The first day stored for a label
+     *   fixes its type, resolution, and start time; later days must match.
+     *   Cells past the end of the series, and cells the series marks
+     *   invalid, are stored as invalid. Storing a day again replaces it.
+     *   Days may be stored in any order; a day before the first stored year
+     *   copies the label's files once to make room for it.
+     *
+     * Param:
+     *   const string& source -- name of the data source, e.g. "clkStats"
+     *   const AbstractDataSeries* series -- one day of values
+     *   const int date -- date of the values, YYYYMMDD
+     *
+     * Return: bool -- true on success
+     */
+    const bool storeDay( const string& source,
+                         const AbstractDataSeries* series,
+                         const int date );
+
+    /*
+     * Stores one day of every series of a parser under the series' labels.
+     *
+     * Return: int -- number of series stored
+     */
+    const int storeParser( const string& source,
+                           const FileParser* parser,
+                           const int date );
+
+    //----< QUERY METHODS >-----------------------------------------------------
+    /*
+     * Returns the days from fromDate through toDate (inclusive, YYYYMMDD) of
+     *   a stored label at its stored resolution as a view into the store. The
+     *   view is empty if the label is not stored, is not of DataType, or
+     *   does not reach fromDate; days past the stored extent are clipped.
+     */
+    template<typename DataType>
+    const StoreView<DataType> getView( const string& source,
+                                       const string& label,
+                                       const int fromDate,
+                                       const int toDate )
+    {
+      LOG_DEBUG( 5, "( " << source << ", " << label << ", " << fromDate \
+                    << ", " << toDate << " )" )
+
+      int firstSlot = 0;
+      int dayCount = 0;
+      Segment* segment = findRange( source, label, fromDate, toDate,
+                                    &firstSlot, &dayCount );
+      if( segment == NULL
+          || segment->header.type != SeriesType<DataType>::type )
+      {
+        return StoreView<DataType>();
+      }
+
+      const Header& header = segment->header;
+      return StoreView<DataType>(
+          (const DataType*)( segment->values + SERIESSTORE_HEADER_SIZE )
+              + (size_t)firstSlot * header.cellsPerDay,
+          segment->validity
+              + (size_t)firstSlot * (( header.cellsPerDay + 7 ) / 8 ),
+          dayCount * header.cellsPerDay,
+          header.cellsPerDay,
+          header.resolution,
+          header.startTime );
+    }// end const StoreView<DataType> getView( const string&, ... )
+
+    /*
+     * Copies the days from fromDate through toDate of a stored label into a
+     *   new finalized series, resampled to reso when it differs from the
+     *   stored resolution. Returns NULL if the range is not stored.
+     */
+    template<typename DataType>
+    DataSeries<DataType>* getSeries( const string& source,
+                                     const string& label,
+                                     const int fromDate,
+                                     const int toDate,
+                                     const int reso = RESOLUTION_IGNORE )
+    {
+      LOG_DEBUG( 5, "( " << source << ", " << label << ", " << fromDate \
+                    << ", " << toDate << ", " << reso << " )" )
+
+      const StoreView<DataType> view =
+          getView<DataType>( source, label, fromDate, toDate );
+      if( view.isEmpty() ) {
+        return NULL;
+      }
+
+      DataSeries<DataType>* series = new DataSeries<DataType>( label );
+      series->initGrid( view.getLength(),
+                        view.getResolution(),
+                        view.getStartTime() );
+      for( int i = 0; i < view.getLength(); i++ ) {
+        if( view.isValid( i )) {
+          series->placeValue( &view[i], i );
+        }
+      }
+      series->finalizeData();
+
+      if( reso > 0 && reso != view.getResolution() ) {
+        DataSeries<DataType>* resampled = new DataSeries<DataType>(
+            *series, label, reso, view.getStartTime() );
+        delete series;
+        series = resampled;
+      }
+      return series;
+    }// end DataSeries<DataType>* getSeries( const string&, ... )
+};
+
+#endif
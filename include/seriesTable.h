@@ -0,0 +1,168 @@
+/*
+ * Columnar table of all the series parsed from one data file. The columns
+ *   share a single time axis (resolution, start time, length) and live in one
+ *   arena allocated once per file: each column is a contiguous, aligned array
+ *   of values followed by a packed validity bitmap with one bit per cell.
+ *
+ * Operations across several columns walk plain arrays through ColumnSpan
+ *   instead of chasing one heap allocated DataSeries per column.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Columns starting later or earlier by whole cells are aligned
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <string>
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+#include <crsCorr/dataSeries.h>
+
+#ifndef CRSCORR_SERIESTABLE_H
+#define CRSCORR_SERIESTABLE_H
+
+#define SERIESTABLE_ALIGNMENT 64        // byte alignment of each column
+
+// namespace convention
+using std::string;
+
+/*
+ * Typed, read-only view of one column of a SeriesTable. A default constructed
+ *   span is empty.
+ */
+template<typename DataType>
+class ColumnSpan {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    const DataType* values;             // first cell
+    const uint64_t* validity;           // bit i set when cell i holds data
+    int length;                         // cells in the column
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    //----< (DE)(CON)STRUCTORS >------------------------------------------------
+    ColumnSpan( const DataType* values = NULL,
+                const uint64_t* validity = NULL,
+                const int length = 0 )
+      : values( values ), validity( validity ), length( length ) {}
+
+    //----< ACCESSOR METHODS >--------------------------------------------------
+    const int getLength() const { return length; }
+    const DataType* getData() const { return values; }
+    const uint64_t* getValidity() const { return validity; }
+
+    /*
+     * Returns true if the span does not refer to a column.
+     */
+    const bool isEmpty() const { return values == NULL; }
+
+    /*
+     * Returns true if cell holds data rather than a placeholder.
+     */
+    const bool isValid( const int cell ) const {
+      return ( validity[ cell >> 6 ] >> ( cell & 63 )) & 1;
+    }
+
+    const DataType& operator[]( const int cell ) const {
+      return values[cell];
+    }
+};
+
+
+class SeriesTable {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    /*
+     * Column
+     *
+     * Describes one column. Offsets are relative to the start of the arena.
+     */
+    typedef struct Column {
+      string label;
+      int type;                         // DATATYPE_INT or DATATYPE_DOUBLE
+      size_t valueOffset;               // offset of the values
+      size_t validityOffset;            // offset of the validity bitmap
+      int validCount;                   // cells holding data
+    } Column;
+
+    //----< DATA MEMBERS >------------------------------------------------------
+    char* memory;                       // allocation holding the arena
+    char* arena;                        // aligned start of the arena
+    size_t arenaSize;                   // usable bytes in the arena
+    Column* columns;                    // column descriptors
+    int columnCount;                    // number of columns
+    int length;                         // cells per column
+    int resolution;                     // shared resolution, minutes
+    int startTime;                      // shared start time
+
+    // no copies
+    SeriesTable( const SeriesTable& copy );
+    SeriesTable& operator=( const SeriesTable& copy );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    //----< (DE)(CON)STRUCTORS >------------------------------------------------
+    /*
+     * Builds a table from finalized series. NULL entries are skipped. The
+     *   first series fixes the resolution; the table starts with the earliest
+     *   series and each column is placed at the offset of its own start time.
+     *   Series with a different resolution, or starting between cells, cannot
+     *   share the time axis and are skipped with an error. Cells a series
+     *   marks invalid, and cells a series does not cover, are marked invalid.
+     *
+     * Param:
+     *   const AbstractDataSeries* const * series -- series to copy
+     *   const int seriesCount -- entries in series
+     */
+    SeriesTable( const AbstractDataSeries* const * series,
+                 const int seriesCount );
+    ~SeriesTable();
+
+    //----< ACCESSOR METHODS >--------------------------------------------------
+    const int getColumnCount() const;
+    const int getLength() const;
+    const int getResolution() const;
+    const int getStartTime() const;
+
+    /*
+     * Returns the bytes allocated for values and bitmaps of all columns.
+     */
+    const size_t getArenaSize() const;
+
+    /*
+     * Column descriptors. Column indexes run from 0 to getColumnCount() - 1.
+     */
+    const string& getLabel( const int column ) const;
+    const int getType( const int column ) const;
+    const int getValidCount( const int column ) const;
+
+    /*
+     * Returns the index of the column with the provided label, or -1.
+     */
+    const int findColumn( const string& label ) const;
+
+    //----< DATA METHODS >------------------------------------------------------
+    /*
+     * Returns a typed view of a column, or an empty span if the column does
+     *   not exist or does not hold values of DataType.
+     */
+    template<typename DataType>
+    const ColumnSpan<DataType> getColumn( const int column ) const {
+      if( column < 0 || column >= columnCount
+          || columns[column].type != SeriesType<DataType>::type )
+      {
+        LOG_DEBUG( 4, ": No column " << column << " of type " \
+                      << SeriesType<DataType>::type )
+        return ColumnSpan<DataType>();
+      }
+      return ColumnSpan<DataType>(
+          (const DataType*)( arena + columns[column].valueOffset ),
+          (const uint64_t*)( arena + columns[column].validityOffset ),
+          length );
+    }// end const ColumnSpan<DataType> getColumn( const int ) const
+};
+
+#endif
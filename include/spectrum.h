@@ -0,0 +1,393 @@
+/*
+ * Power spectra of series. A periodogram transforms the whole series once;
+ *   Welch's method averages the periodograms of overlapping segments,
+ *   trading frequency resolution for a steadier estimate. Each segment has
+ *   its valid mean removed and is tapered by a window before its real input
+ *   transform:
+ *
+ *     rectangular -- w = 1
+ *     Hann        -- w = 0.5 - 0.5 cos( 2 pi j / n )
+ *     Hamming     -- w = 0.54 - 0.46 cos( 2 pi j / n )
+ *     Blackman    -- w = 0.42 - 0.5 cos( 2 pi j / n ) + 0.08 cos( 4 pi j / n )
+ *
+ *   Spectra are one sided densities, scaled so that summing power times bin
+ *   width gives the variance of the windowed data. Invalid cells hold the
+ *   mean (contribute nothing) and the scaling uses the window energy of the
+ *   valid cells only, so gaps lower the resolution rather than the level.
+ *
+ *   Transforms go through Fft's plan cache, so the segments of a Welch
+ *   estimate and repeated daily series share one set of tables.
+ *
+ *   Cross spectra of two series a and b average conj( A ) B over the
+ *   segments both cover. From the cross spectral density Sab and the auto
+ *   spectra over the same segments come the magnitude squared coherence
+ *
+ *     Cab = | Sab |^2 / ( Saa Sbb )
+ *
+ *   in 0 to 1, and the phase of Sab, from which the lag of b behind a at
+ *   each frequency follows. The windowed transforms of each series' segments
+ *   are kept in SegmentSpectra, so a batch of pairs transforms each series
+ *   once: a 10 by 40 coherence matrix costs 50 sets of transforms and 400
+ *   cheap averages rather than 400 sets of transforms.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added cross spectral density, coherence, and phase lag, with
+ *             segment transforms shared across batches of pairs
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <complex>
+#include <vector>
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+#include <crsCorr/dataSeries.h>
+
+#ifndef CRSCORR_SPECTRUM_H
+#define CRSCORR_SPECTRUM_H
+
+// windows
+#define SPECTRUM_WINDOW_RECTANGULAR 0
+#define SPECTRUM_WINDOW_HANN 1
+#define SPECTRUM_WINDOW_HAMMING 2
+#define SPECTRUM_WINDOW_BLACKMAN 3
+
+// segments with fewer valid cells than this fraction are left out of Welch
+#define SPECTRUM_MIN_COVERAGE 0.5
+
+/*
+ * A one sided power spectrum. Frequencies are in cycles per day and power
+ *   in squared series units per cycle per day.
+ */
+class PowerSpectrum {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    double* power;                      // one value per bin
+    int bins;                           // bins, zero frequency through Nyquist
+    double binWidth;                    // cycles per day between bins
+    int segments;                       // periodograms averaged
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Takes ownership of power.
+     */
+    PowerSpectrum( double* power,
+                   const int bins,
+                   const double binWidth,
+                   const int segments );
+
+    ~PowerSpectrum();
+
+    const double* getPower() const { return power; }
+    const int getBins() const { return bins; }
+    const double getBinWidth() const { return binWidth; }
+    const double getFrequency( const int bin ) const { return bin * binWidth; }
+    const int getSegments() const { return segments; }
+
+    /*
+     * Returns the sum of power times bin width, the variance the spectrum
+     *   accounts for.
+     */
+    const double getTotalPower() const;
+
+    /*
+     * Returns the bin of greatest power above zero frequency.
+     */
+    const int getPeakBin() const;
+
+    /*
+     * Scales the spectrum so its bins above zero frequency sum to one, each
+     *   bin then holding its fraction of the variance.
+     */
+    void normalize();
+};
+
+
+/*
+ * A one sided cross spectrum of two series, with the same frequency units
+ *   as PowerSpectrum.
+ */
+class CrossSpectrum {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    std::complex<double>* csd;          // cross spectral density per bin
+    double* coherence;                  // magnitude squared coherence per bin
+    int bins;
+    double binWidth;                    // cycles per day between bins
+    int segments;                       // segments both series covered
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Takes ownership of csd and coherence.
+     */
+    CrossSpectrum( std::complex<double>* csd,
+                   double* coherence,
+                   const int bins,
+                   const double binWidth,
+                   const int segments );
+
+    ~CrossSpectrum();
+
+    const std::complex<double>* getCsd() const { return csd; }
+    const double* getCoherence() const { return coherence; }
+    const int getBins() const { return bins; }
+    const double getBinWidth() const { return binWidth; }
+    const double getFrequency( const int bin ) const { return bin * binWidth; }
+    const int getSegments() const { return segments; }
+
+    /*
+     * Returns the phase of the cross spectrum in radians, negative when the
+     *   second series lags the first.
+     */
+    const double getPhase( const int bin ) const;
+
+    /*
+     * Returns the lag in minutes of the second series behind the first at a
+     *   bin, within half a period either way since phase wraps; 0 at zero
+     *   frequency.
+     */
+    const double getLag( const int bin ) const;
+};
+
+
+/*
+ * The windowed transforms of every segment of one series, built once by
+ *   Spectrum::transformSeries and read by every spectrum the series takes
+ *   part in.
+ */
+class SegmentSpectra {
+  friend class Spectrum;
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    std::vector< std::complex<double> > transforms;   // bins per segment,
+                                                      // segment after segment
+    std::vector<double> energy;         // valid window energy per segment,
+                                        // 0 for a skipped segment
+    int segment;                        // cells per segment
+    int step;                           // cells between segment starts
+    int window;                         // SPECTRUM_WINDOW_ constant
+    int resolution;                     // minutes per cell
+    int startTime;                      // start time of the series
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    SegmentSpectra( const int segment,
+                    const int step,
+                    const int window,
+                    const int resolution,
+                    const int startTime );
+
+    const int getSegment() const { return segment; }
+    const int getBins() const { return segment / 2 + 1; }
+    const int getSegmentCount() const { return energy.size(); }
+    const int getResolution() const { return resolution; }
+
+    /*
+     * Returns true when two sets of segments were cut and windowed alike
+     *   from series on the same time grid, so their segments pair up.
+     */
+    const bool isCompatible( const SegmentSpectra& other ) const;
+};
+
+
+class Spectrum {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    /*
+     * Sums the scaled cross and auto spectra of the segments a and b both
+     *   cover, in densities per cycle per sample; any output may be NULL.
+     *   Returns the number of segments summed.
+     */
+    static const int accumulate( const SegmentSpectra& a,
+                                 const SegmentSpectra& b,
+                                 std::complex<double>* cross,
+                                 double* autoA,
+                                 double* autoB );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Fills n window weights. Windows are periodic, the form suited to
+     *   spectral estimates. Returns false for an unknown window.
+     */
+    static const bool makeWindow( const int window, const int n, double* out );
+
+    /*
+     * Number of one sided bins of an n point transform.
+     */
+    static const int getBins( const int n ) { return n / 2 + 1; }
+
+    /*
+     * Welch estimate of an array. A single segment of count cells gives the
+     *   windowed periodogram.
+     *
+     * Param:
+     *   const double* values -- samples
+     *   const uint64_t* validity -- validity bitmap; NULL if all are valid
+     *   const int count -- number of samples
+     *   const int segment -- segment length in cells, at most count
+     *   const int step -- cells between segment starts; segment - step cells
+     *                     overlap
+     *   const int window -- one of the SPECTRUM_WINDOW_ constants
+     *   double* power -- receives getBins( segment ) densities per cycle per
+     *                    sample
+     *
+     * Return: int -- segments averaged, or -1 on error or when no segment has
+     *                enough valid cells
+     */
+    static const int welch( const double* values,
+                            const uint64_t* validity,
+                            const int count,
+                            const int segment,
+                            const int step,
+                            const int window,
+                            double* power );
+
+    /*
+     * Transforms the segments of an array into segments, whose segment,
+     *   step, and window select the cut. Segments with too few valid cells
+     *   are kept with zero energy so segment indexes stay aligned in time.
+     *
+     * Return: int -- usable segments, or -1 on error or when there are none
+     */
+    static const int transformSegments( const double* values,
+                                        const uint64_t* validity,
+                                        const int count,
+                                        SegmentSpectra& segments );
+
+    /*
+     * Averages the segments of a series into its Welch estimate.
+     */
+    static PowerSpectrum* autoSpectrum( const SegmentSpectra& segments );
+
+    /*
+     * Cross spectrum and coherence of two transformed series, or NULL when
+     *   their segments are incompatible or share no usable segment.
+     */
+    static CrossSpectrum* crossSpectrum( const SegmentSpectra& a,
+                                         const SegmentSpectra& b );
+
+    /*
+     * Cross spectra of every row against every column, in row major order,
+     *   with NULL for pairs that cannot be estimated. Each series is
+     *   transformed once by the caller, however many pairs it joins.
+     */
+    static std::vector<CrossSpectrum*> crossBatch(
+                              const std::vector<const SegmentSpectra*>& rows,
+                              const std::vector<const SegmentSpectra*>& cols );
+
+    /*
+     * Transforms the segments of a finalized series, of the provided length
+     *   in minutes and overlapping by the provided fraction, for use in
+     *   auto and cross spectra. Returns NULL on error.
+     */
+    template<typename DataType>
+    static SegmentSpectra* transformSeries( const DataSeries<DataType>& series,
+                                            const int segmentMinutes,
+                                            const int window
+                                                      = SPECTRUM_WINDOW_HANN,
+                                            const double overlap = 0.5 )
+    {
+      LOG_DEBUG( 12, "( " << series.getLabel() << ", " << segmentMinutes \
+                     << ", " << window << ", " << overlap << " )" )
+
+      const DataType* data = series.getData();
+      const int length = series.getLength();
+      const int resolution = series.getResolution();
+      const int segment = segmentMinutes / resolution;
+      if( data == NULL || length <= 0 ) {
+        LOG_ERR( "Series ('" << series.getLabel() << "') is not final." )
+        return NULL;
+      } else if( segment < 2 || segment > length
+                 || !( overlap >= 0.0 && overlap < 1.0 ))
+      {
+        LOG_ERR( "Cannot split " << length << " cells into " \
+                 << segmentMinutes << " minute segments overlapping by " \
+                 << overlap )
+        return NULL;
+      }
+
+      double* values = new double[ length ];
+      for( int i = 0; i < length; i++ ) {
+        values[i] = data[i];
+      }
+      int step = (int)( segment * ( 1.0 - overlap ) + 0.5 );
+      SegmentSpectra* segments = new SegmentSpectra( segment,
+                                                     step < 1 ? 1 : step,
+                                                     window, resolution,
+                                                     series.getStartTime() );
+      int usable = transformSegments( values, series.getValidity(), length,
+                                      *segments );
+      delete[] values;
+      if( usable < 0 ) {
+        delete segments;
+        return NULL;
+      }
+      return segments;
+    }// end static SegmentSpectra* transformSeries( const DataSeries<DataType>&, ... )
+
+    /*
+     * Windowed periodogram of a finalized series, or NULL on error.
+     */
+    template<typename DataType>
+    static PowerSpectrum* periodogram( const DataSeries<DataType>& series,
+                                       const int window = SPECTRUM_WINDOW_HANN )
+    {
+      return welch( series, series.getLength() * series.getResolution(),
+                    window, 0.0 );
+    }// end static PowerSpectrum* periodogram( const DataSeries<DataType>&, ... )
+
+    /*
+     * Welch estimate of a finalized series over segments of the provided
+     *   length in minutes, overlapping by the provided fraction. Returns NULL
+     *   on error.
+     */
+    template<typename DataType>
+    static PowerSpectrum* welch( const DataSeries<DataType>& series,
+                                 const int segmentMinutes,
+                                 const int window = SPECTRUM_WINDOW_HANN,
+                                 const double overlap = 0.5 )
+    {
+      SegmentSpectra* segments = transformSeries( series, segmentMinutes,
+                                                  window, overlap );
+      if( segments == NULL ) {
+        return NULL;
+      }
+      PowerSpectrum* spectrum = autoSpectrum( *segments );
+      delete segments;
+      return spectrum;
+    }// end static PowerSpectrum* welch( const DataSeries<DataType>&, ... )
+
+    /*
+     * Cross spectrum and coherence of two finalized series with the same
+     *   resolution and start time, or NULL on error.
+     */
+    template<typename TypeA, typename TypeB>
+    static CrossSpectrum* crossSpectrum( const DataSeries<TypeA>& a,
+                                         const DataSeries<TypeB>& b,
+                                         const int segmentMinutes,
+                                         const int window = SPECTRUM_WINDOW_HANN,
+                                         const double overlap = 0.5 )
+    {
+      SegmentSpectra* segmentsA = transformSeries( a, segmentMinutes, window,
+                                                   overlap );
+      SegmentSpectra* segmentsB = transformSeries( b, segmentMinutes, window,
+                                                   overlap );
+      CrossSpectrum* spectrum = NULL;
+      if( segmentsA != NULL && segmentsB != NULL ) {
+        spectrum = crossSpectrum( *segmentsA, *segmentsB );
+      }
+      delete segmentsA;
+      delete segmentsB;
+      return spectrum;
+    }// end static CrossSpectrum* crossSpectrum( const DataSeries<TypeA>&, ... )
+};
+
+#endif
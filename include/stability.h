@@ -0,0 +1,206 @@
+/*
+ * Clock stability statistics of phase data x, in seconds, sampled every
+ *   tau0 seconds, at averaging times tau = m tau0:
+ *
+ *     ADEV -- overlapping Allan deviation
+ *               AVAR = sum ( x[i+2m] - 2 x[i+m] + x[i] )^2
+ *                      / ( 2 tau^2 ( N - 2m ))
+ *     MDEV -- modified Allan deviation, which averages the phase over m
+ *               samples first and so separates white from flicker phase noise
+ *               MVAR = sum_j ( sum_{i=j}^{j+m-1} x[i+2m] - 2 x[i+m] + x[i] )^2
+ *                      / ( 2 m^2 tau^2 ( N - 3m + 1 ))
+ *     TDEV -- time deviation, tau / sqrt( 3 ) MDEV, in seconds
+ *     MTIE -- maximum time interval error, the largest peak to peak phase
+ *               excursion within any window of m + 1 samples
+ *
+ *   The inner sums of MDEV come from differences of one prefix sum of the
+ *   phase, S[j+3m] - 3 S[j+2m] + 3 S[j+m] - S[j], so every statistic costs
+ *   O( N ) per tau whatever m is. MTIE takes its window extremes from
+ *   windows of 2^k samples widened by doubling, one O( N ) pass per level
+ *   and per tau. A term counts only when every sample it spans is valid,
+ *   read from a prefix count of valid samples, so gaps drop terms rather
+ *   than corrupt them. Frequency data y are integrated into phase first.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <vector>
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+#include <crsCorr/dataSeries.h>
+
+#ifndef CRSCORR_STABILITY_H
+#define CRSCORR_STABILITY_H
+
+// statistics
+#define STABILITY_ADEV 0
+#define STABILITY_MDEV 1
+#define STABILITY_TDEV 2
+#define STABILITY_MTIE 3
+
+/*
+ * A stability statistic at each of a set of averaging times.
+ */
+class StabilityCurve {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    double* taus;                       // averaging times in seconds
+    double* deviations;                 // statistic per tau, 0 if undefined
+    int* terms;                         // terms averaged per tau
+    int points;
+    int statistic;                      // STABILITY_ constant
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Takes ownership of the arrays.
+     */
+    StabilityCurve( double* taus,
+                    double* deviations,
+                    int* terms,
+                    const int points,
+                    const int statistic );
+
+    ~StabilityCurve();
+
+    const double* getTaus() const { return taus; }
+    const double* getDeviations() const { return deviations; }
+    const int* getTerms() const { return terms; }
+    const int getPoints() const { return points; }
+    const int getStatistic() const { return statistic; }
+};
+
+
+class Stability {
+  public:
+    /*
+     * Largest averaging factor m a statistic supports over count samples.
+     */
+    static const int getMaxFactor( const int statistic, const int count );
+
+    /*
+     * Fills the octave factors 1, 2, 4, ... up to getMaxFactor into factors
+     *   and returns how many there are.
+     */
+    static const int octaveFactors( const int statistic,
+                                    const int count,
+                                    std::vector<int>& factors );
+
+    /*
+     * Integrates count frequency samples into count + 1 phase samples,
+     *   x[i+1] = x[i] + y[i] tau0. Phase sample i + 1 is invalid where y[i]
+     *   is, so no term spans a gap.
+     *
+     * Param:
+     *   uint64_t* phaseValid -- ( count + 64 ) / 64 words, or NULL when
+     *                           frequencyValid is NULL
+     */
+    static void frequencyToPhase( const double* frequency,
+                                  const uint64_t* frequencyValid,
+                                  const int count,
+                                  const double tau0,
+                                  double* phase,
+                                  uint64_t* phaseValid );
+
+    /*
+     * Computes a statistic of phase data at each averaging factor.
+     *
+     * Param:
+     *   const double* phase -- phase samples in seconds
+     *   const uint64_t* validity -- validity bitmap; NULL if all are valid
+     *   const int count -- number of samples
+     *   const double tau0 -- seconds between samples
+     *   const int statistic -- one of the STABILITY_ constants
+     *   const int* factors -- averaging factors m, each at least one
+     *   const int factorCount -- number of factors
+     *   double* deviations -- receives the statistic per factor, 0 where no
+     *                         term is complete
+     *   int* terms -- if not NULL, receives the terms used per factor
+     *
+     * Return: bool -- false for bad parameters
+     */
+    static const bool compute( const double* phase,
+                               const uint64_t* validity,
+                               const int count,
+                               const double tau0,
+                               const int statistic,
+                               const int* factors,
+                               const int factorCount,
+                               double* deviations,
+                               int* terms );
+
+    /*
+     * Statistic of a finalized series at every octave tau, taking tau0 from
+     *   its resolution. The series holds phase in seconds, or fractional
+     *   frequency when isFrequency is set. Returns NULL on error.
+     */
+    template<typename DataType>
+    static StabilityCurve* octaves( const DataSeries<DataType>& series,
+                                    const int statistic,
+                                    const bool isFrequency = false )
+    {
+      LOG_DEBUG( 12, "( " << series.getLabel() << ", " << statistic << ", " \
+                     << isFrequency << " )" )
+
+      const DataType* data = series.getData();
+      const int length = series.getLength();
+      if( data == NULL || length <= 0 ) {
+        LOG_ERR( "Series ('" << series.getLabel() << "') is not final." )
+        return NULL;
+      }
+
+      const double tau0 = series.getResolution() * 60.0;
+      const int count = isFrequency ? length + 1 : length;
+      double* phase = new double[ count ];
+      uint64_t* phaseValid = NULL;
+      const uint64_t* validity = series.getValidity();
+      if( isFrequency ) {
+        double* frequency = new double[ length ];
+        for( int i = 0; i < length; i++ ) {
+          frequency[i] = data[i];
+        }
+        if( validity != NULL ) {
+          phaseValid = new uint64_t[ ( count + 63 ) / 64 ];
+        }
+        frequencyToPhase( frequency, validity, length, tau0, phase,
+                          phaseValid );
+        delete[] frequency;
+        validity = phaseValid;
+      } else {
+        for( int i = 0; i < length; i++ ) {
+          phase[i] = data[i];
+        }
+      }
+
+      std::vector<int> factors;
+      const int points = octaveFactors( statistic, count, factors );
+      StabilityCurve* curve = NULL;
+      if( points > 0 ) {
+        double* taus = new double[ points ];
+        double* deviations = new double[ points ];
+        int* terms = new int[ points ];
+        for( int p = 0; p < points; p++ ) {
+          taus[p] = factors[p] * tau0;
+        }
+        if( compute( phase, validity, count, tau0, statistic, &factors[0],
+                     points, deviations, terms ))
+        {
+          curve = new StabilityCurve( taus, deviations, terms, points,
+                                      statistic );
+        } else {
+          delete[] taus;
+          delete[] deviations;
+          delete[] terms;
+        }
+      } else {
+        LOG_ERR( "Series ('" << series.getLabel() << "') is too short." )
+      }
+      delete[] phase;
+      delete[] phaseValid;
+      return curve;
+    }// end static StabilityCurve* octaves( const DataSeries<DataType>&, ... )
+};
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * Pool of worker threads that run small independent tasks, such as parsing
+ *   one data file or correlating one pair of series. Each worker keeps its
+ *   own deque of tasks: it takes its newest task first, and once its deque is
+ *   empty it steals the oldest task of another worker. A task may submit
+ *   further tasks, which go to the deque of the worker running it, so work
+ *   that becomes ready as a stage finishes stays on that worker unless
+ *   another one runs dry.
+ *
+ * Modified: 10/19/26
+ * Notes:    --If no worker thread starts, wait() runs the tasks itself
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+#include <crsCorr/global.h>
+
+#ifndef CRSCORR_TASKPOOL_H
+#define CRSCORR_TASKPOOL_H
+
+class TaskPool {
+  public:
+    /*
+     * Signature of a task. The pool is passed along so that the task can
+     *   submit the tasks that depend on it.
+     */
+    typedef void (*TaskFunction)( TaskPool* pool, void* argument );
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    /*
+     * Task
+     *
+     * A function and its argument, owned by the submitter.
+     */
+    typedef struct Task {
+      TaskFunction function;
+      void* argument;
+    } Task;
+
+    /*
+     * Worker
+     *
+     * A thread and its deque. The deque is guarded by its own lock so that
+     *   submitting and stealing touch only the workers involved.
+     */
+    typedef struct Worker {
+      TaskPool* pool;
+      int index;
+      std::deque<Task> tasks;
+      pthread_mutex_t lock;
+      pthread_t thread;
+      bool started;
+    } Worker;
+
+    //----< DATA MEMBERS >------------------------------------------------------
+    std::vector<Worker*> workers;
+    int queued;                         // tasks waiting in the deques
+    int pending;                        // tasks submitted and not finished
+    int running;                        // worker threads started
+    unsigned int nextWorker;            // receives the next outside task
+    bool stopping;                      // workers exit once the deques empty
+    pthread_key_t currentWorker;        // Worker of the calling thread
+    pthread_mutex_t stateLock;          // guards the counters above
+    pthread_cond_t workAvailable;       // signalled when a task is queued
+    pthread_cond_t allFinished;         // signalled when pending reaches 0
+
+    //----< THREAD METHODS >----------------------------------------------------
+    /*
+     * Entry point for a worker thread.
+     */
+    static void* run( void* worker );
+
+    /*
+     * Takes the newest task of the worker's own deque, or else the oldest
+     *   task of another worker. Returns false if every deque is empty.
+     */
+    const bool takeTask( Worker* worker, Task& task );
+
+    /*
+     * Runs a taken task and counts it finished.
+     */
+    void runTask( const Task& task );
+
+    // no copies
+    TaskPool( const TaskPool& copy );
+    TaskPool& operator=( const TaskPool& copy );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    /*
+     * Starts the workers. If no thread can be started the pool still
+     *   accepts tasks, and wait() runs them on the calling thread.
+     *
+     * Param:
+     *   const int threads -- worker threads, 0 for one per processor
+     */
+    TaskPool( const int threads = 0 );
+
+    /*
+     * Waits for every submitted task, then stops the workers.
+     */
+    ~TaskPool();
+
+    /*
+     * Queues a task. From within a task it goes to the running worker's
+     *   deque, otherwise to the workers in turn.
+     */
+    void submit( TaskFunction function, void* argument );
+
+    /*
+     * Blocks until every submitted task, including those submitted by tasks,
+     *   has finished.
+     */
+    void wait();
+
+    /*
+     * Returns the number of worker threads running, 0 if none started.
+     */
+    const int getThreads() const;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * Vectorized primitives for scanning the text data files. The scanner
+ *   classifies 64 bytes at a time into bitmaps of newlines and field
+ *   delimiters, using AVX2 or SSE2 when the processor provides them and a
+ *   scalar loop otherwise. The bitmaps drive both line splitting and field
+ *   splitting so the parsers touch each byte of a file only a few times.
+ *
+ * LineReader uses the scanner to hand out lines of an input stream in place,
+ *   straight out of a large block buffer, instead of copying each line out
+ *   with getline.
+ *
+ * Modified: 10/19/26
+ * Notes:    --splitFields reports fields past maxFields
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+#include <istream>
+#include <cstddef>
+#include <stdint.h>
+
+#include <crsCorr/global.h>
+
+#ifndef CRSCORR_TEXTSCAN_H
+#define CRSCORR_TEXTSCAN_H
+
+#define TEXTSCAN_BLOCK 64               // bytes classified at once
+#define LINEREADER_BLOCK_SIZE 1048576   // default LineReader buffer size
+
+class TextScan {
+  public:
+    /*
+     * Classifies one TEXTSCAN_BLOCK sized block. Bit i of each bitmap
+     *   describes byte i of the block.
+     *
+     * Param:
+     *   const char* block -- TEXTSCAN_BLOCK readable bytes
+     *   const bool slash -- treat '/' as a delimiter as well
+     *   uint64_t& newlines -- (out) '\n' bytes
+     *   uint64_t& delimiters -- (out) ' ', '\t', '\r', '\n', and maybe '/'
+     */
+    static void classify( const char* block,
+                          const bool slash,
+                          uint64_t& newlines,
+                          uint64_t& delimiters );
+
+    /*
+     * Returns the first newline in [begin, end) or NULL.
+     */
+    static const char* findNewline( const char* begin, const char* end );
+
+    /*
+     * Returns the first occurrence of the null terminated needle in
+     *   [begin, end) or NULL.
+     */
+    static const char* findString( const char* begin,
+                                   const char* end,
+                                   const char* needle );
+
+    /*
+     * Splits a line into fields in place, much like repeated calls to strtok
+     *   but from the delimiter bitmaps. The delimiter following each field is
+     *   replaced by a null character so every field is a C string.
+     *
+     * Param:
+     *   char* line -- line to split, modified
+     *   const int length -- bytes in the line
+     *   char** fields -- (out) start of each field
+     *   const int maxFields -- capacity of fields
+     *   const bool slash -- treat '/' as a delimiter as well
+     *   bool* more -- (out, optional) set when more than maxFields fields
+     *                 were present
+     *
+     * Return: number of fields found, at most maxFields
+     */
+    static const int splitFields( char* line,
+                                  const int length,
+                                  char** fields,
+                                  const int maxFields,
+                                  const bool slash = false,
+                                  bool* more = NULL );
+
+    /*
+     * Returns the name of the implementation selected for this processor:
+     *   "avx2", "sse2", or "scalar".
+     */
+    static const char* getImplementation();
+};
+
+
+class LineReader {
+
+/*****< PRIVATE >**************************************************************/
+  private:
+    //----< DATA MEMBERS >------------------------------------------------------
+    std::istream& stream;       // source of the lines
+    char* buffer;               // block buffer, one extra byte for a null
+    size_t capacity;            // usable bytes in buffer
+    size_t begin;               // start of the next line
+    size_t end;                 // end of the valid bytes
+    size_t maskBase;            // offset of the block described by mask
+    uint64_t mask;              // newlines of that block
+    bool maskValid;             // mask describes the current buffer
+    bool exhausted;             // stream has no more bytes
+
+    /*
+     * Moves the unread bytes to the front of the buffer, growing it if the
+     *   current line fills it, and reads more from the stream.
+     *
+     * Return: false if no bytes could be added
+     */
+    const bool refill();
+
+    /*
+     * Locates the next newline at or after begin using the newline bitmaps.
+     *   Returns the offset of the newline or end if there is none.
+     */
+    const size_t nextNewline();
+
+    // no copies
+    LineReader( const LineReader& copy );
+    LineReader& operator=( const LineReader& copy );
+
+/*****< PUBLIC >***************************************************************/
+  public:
+    //----< (DE)(CON)STRUCTORS >------------------------------------------------
+    LineReader( std::istream& stream,
+                const size_t blockSize = LINEREADER_BLOCK_SIZE );
+    ~LineReader();
+
+    //----< DATA METHODS >------------------------------------------------------
+    /*
+     * Returns the next line, null terminated in place of its newline (and of
+     *   a trailing '\r'). The line remains valid and may be modified until
+     *   the next call. Returns NULL once the stream is exhausted.
+     *
+     * Param:
+     *   int* length -- (out, optional) bytes in the line
+     */
+    char* nextLine( int* length = NULL );
+};
+
+#endif
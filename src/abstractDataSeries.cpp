@@ -1,4 +1,7 @@
 /*
+ * Modified:  10/19/26
+ * Notes:     --Added the validity bitmap
+ *
  * Modified:  08/12/10
  * Notes:     --Initial creation
  */
@@ -21,6 +24,7 @@ AbstractDataSeries::AbstractDataSeries( const string descriptor,
   collecting = false;
   final = false;
   length = 0;
+  validity = NULL;
 
   if( reso >= 0 )
     resolution = reso;
@@ -46,6 +50,8 @@ AbstractDataSeries::AbstractDataSeries( const AbstractDataSeries& copy )
   length = copy.length;
   resolution = copy.resolution;
   startTime = copy.startTime;
+  validity = NULL;
+  setValidity( copy.validity );
 
   // increment ref count
   AbstractDataSeries::refCount++;
@@ -54,6 +60,11 @@ AbstractDataSeries::AbstractDataSeries( const AbstractDataSeries& copy )
 AbstractDataSeries::~AbstractDataSeries() {
   LOG_DEBUG( 2, "(): " << --AbstractDataSeries::refCount << " left" )
 
+  if( validity != NULL ) {
+    delete[] validity;
+    validity = NULL;
+  }
+
 }// end AbstractDataSeries::~AbstractDataSeries()
 
 //----<ACCESSOR METHODS>--------------------------------------------------------
@@ -87,6 +98,122 @@ void AbstractDataSeries::incrementLength() {
   length++;
 }// end void AbstractDataSeries::incrementLength() {
 
+const uint64_t* AbstractDataSeries::getValidity() const {
+  //LOG_DEBUG( 2, "()" )
+
+  return validity;
+}// end const uint64_t* AbstractDataSeries::getValidity() const
+
+const bool AbstractDataSeries::isValid( const int cell ) const {
+  //LOG_DEBUG( 2, "( " << cell << " )" )
+
+  return cell >= 0 && cell < length && isValidCell( validity, cell );
+}// end const bool AbstractDataSeries::isValid( const int ) const
+
+const int AbstractDataSeries::getValidCount() const {
+  LOG_DEBUG( 2, "()" )
+
+  if( validity == NULL ) {
+    return length;
+  }
+  int count = 0;
+  for( int word = 0; word < ( length + 63 ) / 64; word++ ) {
+    count += __builtin_popcountll( validity[word] );
+  }
+  return count;
+}// end const int AbstractDataSeries::getValidCount() const
+
+void AbstractDataSeries::invalidate( const int first, const int count ) {
+  LOG_DEBUG( 2, "( " << first << ", " << count << " )" )
+
+  if( first < 0 || count <= 0 || first + count > length ) {
+    LOG_ERR( "Cells " << first << " + " << count << " outside series " \
+             << "of length " << length )
+    return;
+  }
+
+  // materialize an all valid bitmap before clearing cells
+  if( validity == NULL ) {
+    int words = ( length + 63 ) / 64;
+    validity = new uint64_t[ words ];
+    memset( validity, 0xff, words * sizeof( uint64_t ));
+    if( length % 64 != 0 ) {
+      validity[ words - 1 ] = ( (uint64_t)1 << ( length % 64 )) - 1;
+    }
+  }
+  for( int cell = first; cell < first + count; cell++ ) {
+    validity[ cell >> 6 ] &= ~( (uint64_t)1 << ( cell & 63 ));
+  }
+}// end void AbstractDataSeries::invalidate( const int, const int )
+
+void AbstractDataSeries::setValidity( const uint64_t* const words ) {
+  LOG_DEBUG( 2, "( words )" )
+
+  if( validity != NULL ) {
+    delete[] validity;
+    validity = NULL;
+  }
+  if( words != NULL && length > 0 ) {
+    int wordCount = ( length + 63 ) / 64;
+    validity = new uint64_t[ wordCount ];
+    memcpy( validity, words, wordCount * sizeof( uint64_t ));
+  }
+}// end void AbstractDataSeries::setValidity( const uint64_t* const )
+
+void AbstractDataSeries::sampleValidity( const AbstractDataSeries& source,
+                                         const int step,
+                                         const int offset )
+{
+  LOG_DEBUG( 2, "( source, " << step << ", " << offset << " )" )
+
+  setValidity( NULL );
+  if( source.validity == NULL ) {
+    return;
+  }
+  for( int cell = 0; cell < length; cell++ ) {
+    if( !source.isValid( cell * step + offset )) {
+      invalidate( cell, 1 );
+    }
+  }
+}// end void AbstractDataSeries::sampleValidity( const AbstractDataSeries&, ... )
+
+void AbstractDataSeries::concatValidity( const uint64_t* const first,
+                                         const int firstLength,
+                                         const uint64_t* const second,
+                                         const int secondLength )
+{
+  LOG_DEBUG( 2, "( first, " << firstLength << ", second, " \
+                << secondLength << " )" )
+
+  // copy the inputs first; either may be this series' own bitmap
+  uint64_t* firstCopy = NULL;
+  uint64_t* secondCopy = NULL;
+  if( first != NULL ) {
+    firstCopy = new uint64_t[ ( firstLength + 63 ) / 64 ];
+    memcpy( firstCopy, first, (( firstLength + 63 ) / 64 ) * sizeof( uint64_t ));
+  }
+  if( second != NULL ) {
+    secondCopy = new uint64_t[ ( secondLength + 63 ) / 64 ];
+    memcpy( secondCopy, second,
+            (( secondLength + 63 ) / 64 ) * sizeof( uint64_t ));
+  }
+
+  setValidity( NULL );
+  for( int cell = 0; firstCopy != NULL && cell < firstLength; cell++ ) {
+    if( !(( firstCopy[ cell >> 6 ] >> ( cell & 63 )) & 1 )) {
+      invalidate( cell, 1 );
+    }
+  }
+  for( int cell = 0; secondCopy != NULL && cell < secondLength; cell++ ) {
+    if( !(( secondCopy[ cell >> 6 ] >> ( cell & 63 )) & 1 )) {
+      invalidate( firstLength + cell, 1 );
+    }
+  }
+
+  delete[] firstCopy;
+  delete[] secondCopy;
+}// end void AbstractDataSeries::concatValidity( const uint64_t* const, ... )
+
 const bool AbstractDataSeries::isCollecting() const {
   //LOG_DEBUG( 2, "()" )
 
@@ -174,3 +301,34 @@ const bool AbstractDataSeries::setParams(
   }
   return false;
 }// end bool AbstractDataSeries::setParams( const int, const int, ... )
+
+const bool AbstractDataSeries::setGrid(
+    const int len,
+    const int start,
+    const int newRes )
+{
+  LOG_DEBUG( 2, "( " << len << ", " \
+                << start << ", " \
+                << newRes << " )" )
+
+  if( collecting || final ) {
+    LOG_ERR( "Series ('" << label << "') already holds data." )
+  } else if( len <= 0 ) {
+    LOG_ERR( "Bad length ( non-positive )." )
+  } else if( start < 0 ) {
+    LOG_ERR( "Bad start time (less than zero)." )
+  } else if( newRes <= 0 ) {
+    LOG_ERR( "Bad resolution ( non-positive )." )
+  } else {
+    length = len;
+    startTime = start;
+    resolution = newRes;
+    collecting = true;
+
+    // nothing has been placed yet
+    setValidity( NULL );
+    invalidate( 0, len );
+    return true;
+  }
+  return false;
+}// end const bool AbstractDataSeries::setGrid( const int, const int, ... )
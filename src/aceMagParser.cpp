@@ -1,4 +1,9 @@
 /*
+ * Modified:  10/19/26
+ * Notes:     Values are placed into the cell for their HHMM time. Missing
+ *              values and missing lines are left invalid instead of being
+ *              replaced or padded with zeros.
+ *
  * Modified:  07/16/10
  * Notes:     Expanding file parser to extract significant data from
  *              ace magnetometer readings
@@ -65,8 +70,7 @@ AceMagParser::AceMagParser( string fileName )
 {
   LOG_DEBUG( 11, "( " << fileName << " )" )
 
-  parseFile();
-  finalizeSeriesData();
+  loadFile();
 }// end AceMagParser::AceMagParser( string )
 
 
@@ -96,6 +100,9 @@ AceMagParser& AceMagParser::operator=( const AceMagParser& copy ) {
 void AceMagParser::parseFile() {
   LOG_DEBUG( 11, "()" )
 
+  // values are placed by their time of day
+  initGrid();
+
   // move to first data line
   if( findArtifact( "#-------------------------" )) {
     int year;
@@ -114,83 +121,35 @@ void AceMagParser::parseFile() {
 
     // load data into storage
     LOG_DEBUG( 10, ": Loading data" )
-    int curLine = 0;
     (*dataStream) >> year >> month >> day >> hourmin >> julianDay
                   >> sec >> status >> bx >> by >> bz >> bt
                   >> lat >> longitude;
     while( dataStream->good() && !dataStream->eof() ) {
-      curLine++;
-
-      int i = 0;
-      data[i++]->addValue( &year );
-      data[i++]->addValue( &month );
-      data[i++]->addValue( &day );
-      data[i++]->addValue( &hourmin );
-      data[i++]->addValue( &julianDay );
-      data[i++]->addValue( &sec );
-      data[i++]->addValue( &status );
-      if( bx == -999.9 ) {
-         bx = 0.0;
-      }
-      data[i++]->addValue( &bx );
-      if( by == -999.9 ) {
-         by = 0.0;
-      }
-      data[i++]->addValue( &by );
-      if( bz == -999.9 )  {
-        bz = 0.0;
-      }
-      data[i++]->addValue( &bz );
-      if( bt == -999.9 ) {
-        bt = 0.0;
+      int cell = getGridCell( 0, hourmin );
+      if( cell < 0 ) {
+        LOG_ERR( "Skipping line with time " << hourmin << " off the grid." )
+      } else {
+        // missing values (-999.9) are left invalid
+        int i = 0;
+        data[i++]->placeValue( &year, cell );
+        data[i++]->placeValue( &month, cell );
+        data[i++]->placeValue( &day, cell );
+        data[i++]->placeValue( &hourmin, cell );
+        data[i++]->placeValue( &julianDay, cell );
+        data[i++]->placeValue( &sec, cell );
+        data[i++]->placeValue( &status, cell );
+        double* values[] = { &bx, &by, &bz, &bt, &lat, &longitude };
+        for( int j = 0; j < 6; j++, i++ ) {
+          if( *values[j] != -999.9 ) {
+            data[i]->placeValue( values[j], cell );
+          }
+        }
       }
-      data[i++]->addValue( &bt );
-      if( lat == -999.9 ) {
-        lat = 0.0;
-      }
-      data[i++]->addValue( &lat );
-      if( longitude == -999.9 ) {
-        longitude = 0.0;
-      }
-      data[i++]->addValue( &longitude );
 
       (*dataStream) >> year >> month >> day >> hourmin >> julianDay
                     >> sec >> status >> bx >> by >> bz >> bt
                     >> lat >> longitude;
     }// finished iteration of a data line
-
-    while( curLine < 1440 ) {
-      curLine++;
-
-      year = 0;
-      month = 0;
-      day = 0;
-      hourmin = 0;
-      julianDay = 0;
-      sec = 0;
-      status = 0;
-      bx = 0.0;
-      by = 0.0;
-      bz = 0.0;
-      bt = 0.0;
-      lat = 0.0;
-      longitude = 0.0;
-
-      int i = 0;
-      data[i++]->addValue( &year );
-      data[i++]->addValue( &month );
-      data[i++]->addValue( &day );
-      data[i++]->addValue( &hourmin );
-      data[i++]->addValue( &julianDay );
-      data[i++]->addValue( &sec );
-      data[i++]->addValue( &status );
-      data[i++]->addValue( &bx );
-      data[i++]->addValue( &by );
-      data[i++]->addValue( &bz );
-      data[i++]->addValue( &bt );
-      data[i++]->addValue( &lat );
-      data[i++]->addValue( &longitude );
-    }
   } else {
     LOG_ERR( "Failed to find dataLine. Finalizing empty DataSeries." )
   }
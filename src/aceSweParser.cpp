@@ -1,4 +1,9 @@
 /*
+ * Modified:  10/19/26
+ * Notes:     Values are placed into the cell for their HHMM time. Missing
+ *              values and missing lines are left invalid instead of being
+ *              replaced with zeros.
+ *
  * Modified:  07/16/10
  * Notes:     Expanding file parser to extract significant data from
  *              ace solar wind electron proton alpha monitor readings
@@ -60,8 +65,7 @@ AceSweParser::AceSweParser( string fileName )
 {
   LOG_DEBUG( 11, "( " << fileName << " )" )
 
-  parseFile();
-  finalizeSeriesData();
+  loadFile();
 }// end AceSweParser::AceSweParser( string )
 
 
@@ -91,6 +95,9 @@ AceSweParser& AceSweParser::operator=( const AceSweParser& copy ) {
 void AceSweParser::parseFile() {
   LOG_DEBUG( 11, "()" )
 
+  // values are placed by their time of day
+  initGrid();
+
   // move to first data line
   LOG_DEBUG( 10, ": Locating separator line." )
   if( findArtifact( "#----------------------------" )) {
@@ -113,23 +120,27 @@ void AceSweParser::parseFile() {
 
     while( dataStream->good() && !dataStream->eof() ) {
       curLine++;
-      int i = 0;
-      data[i++]->addValue( &year );
-      data[i++]->addValue( &month );
-      data[i++]->addValue( &day );
-      data[i++]->addValue( &hourmin );
-      data[i++]->addValue( &julianDay );
-      data[i++]->addValue( &sec );
-      data[i++]->addValue( &status );
-      if( proton == -9999.9 )
-        proton = 0;
-      data[i++]->addValue( &proton );
-      if( speed == -9999.9 )
-        speed = 0;
-      data[i++]->addValue( &speed );
-      if( temp == -1.00e+05 )
-        temp = 0;
-      data[i++]->addValue( &temp );
+      int cell = getGridCell( 0, hourmin );
+      if( cell < 0 ) {
+        LOG_ERR( "Skipping line with time " << hourmin << " off the grid." )
+      } else {
+        // missing values are left invalid
+        int i = 0;
+        data[i++]->placeValue( &year, cell );
+        data[i++]->placeValue( &month, cell );
+        data[i++]->placeValue( &day, cell );
+        data[i++]->placeValue( &hourmin, cell );
+        data[i++]->placeValue( &julianDay, cell );
+        data[i++]->placeValue( &sec, cell );
+        data[i++]->placeValue( &status, cell );
+        double* values[] = { &proton, &speed, &temp };
+        const double missing[] = { -9999.9, -9999.9, -1.00e+05 };
+        for( int j = 0; j < 3; j++, i++ ) {
+          if( *values[j] != missing[j] ) {
+            data[i]->placeValue( values[j], cell );
+          }
+        }
+      }
 
       (*dataStream) >> year >> month >> day >> hourmin >> julianDay
                     >> sec >> status >> proton >> speed >> temp;
@@ -1,14 +1,38 @@
 /*
+ * Modified:  10/19/26
+ * Notes:     Tail mode no longer opens the data stream it never reads.
+ *
+ * Modified:  10/19/26
+ * Notes:     poll() reads a replaced file to its end before following the
+ *            new one, so lines written just before a rotation are kept.
+ *
+ * Modified:  10/19/26
+ * Notes:     Lines are read with LineReader and split with the vectorized
+ *              TextScan primitives instead of getline and strtok.
+ *
+ * Modified:  10/19/26
+ * Notes:     Split line processing into parseLine() and added the tail mode
+ *              (poll, follow, finishTail) for live clockstats files.
+ *
  * Modified:  07/17/10
  * Notes:     Expanding file parser to extract significant data from
  *              clockstats file generated by WWV NTP reference clock.
  */
 
 #include <crsCorr/clkStatsParser.h>
+#include <crsCorr/textScan.h>
 #include <string>
 #include <cstring>
 #include <cstdlib>
 #include <iostream>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#endif
 
     /*
      * Determines which values to extract from the given data file.
@@ -131,6 +155,12 @@ ClkStatsParser::ClkStatsParser()
 {
   LOG_DEBUG( 11, "()" )
 
+  sampleCallback = NULL;
+  sampleContext = NULL;
+  tailFile = -1;
+  tailOffset = 0;
+  tailStartTime = 0;
+  tailing = false;
 }// end ClkStatsParser::ClkStatsParser()
 
 ClkStatsParser::ClkStatsParser( string fileName )
@@ -138,21 +168,58 @@ ClkStatsParser::ClkStatsParser( string fileName )
 {
   LOG_DEBUG( 11, "( " << fileName << " )" )
 
-  parseFile();
-  finalizeSeriesData();
+  sampleCallback = NULL;
+  sampleContext = NULL;
+  tailFile = -1;
+  tailOffset = 0;
+  tailStartTime = 0;
+  tailing = false;
+
+  loadFile();
 }// end ClkStatsParser::ClkStatsParser( string )
 
 
+ClkStatsParser::ClkStatsParser( string fileName,
+                                SampleCallback callback,
+                                void* context )
+  : FileParser( fileName, ClkStatsParser::tags, false )
+{
+  LOG_DEBUG( 11, "( " << fileName << ", callback, context )" )
+
+  sampleCallback = callback;
+  sampleContext = context;
+  tailFile = -1;
+  tailOffset = 0;
+  tailStartTime = 0;
+  tailing = true;
+
+  if( !openTail() ) {
+    LOG_ERR( "Unable to open " << fileName << " for tailing." )
+  }
+}// end ClkStatsParser::ClkStatsParser( string, SampleCallback, void* )
+
+
 ClkStatsParser::ClkStatsParser( const ClkStatsParser& copy )
   : FileParser( copy )
 {
   LOG_DEBUG( 11, "( const ClkStatsParser& copy )" )
 
+  // copies never follow the file
+  sampleCallback = NULL;
+  sampleContext = NULL;
+  tailFile = -1;
+  tailOffset = 0;
+  tailStartTime = 0;
+  tailing = false;
 }// end ClkStatsParser::ClkStatsParser( const ClkStatsParser& )
 
 ClkStatsParser::~ClkStatsParser() {
   LOG_DEBUG( 11, "()" )
 
+  if( tailFile >= 0 ) {
+    close( tailFile );
+    tailFile = -1;
+  }
 }// end ClkStatsParser::~ClkStatsParser()
 
 //----< ACCESSOR METHODS >-----------------------------------------------------
@@ -170,86 +237,299 @@ void ClkStatsParser::parseFile() {
   LOG_DEBUG( 11, "()" )
 
   // begin parsing data lines
+  LineReader reader( *dataStream );
+  int startTime = 0;
+  int lineCount = 0;
+  int lineLength = 0;
+  char* dataLine = reader.nextLine( &lineLength );
+  while( dataLine != NULL ) {
+    // check for key label (wwv5)
+    if( parseLine( dataLine, lineLength, startTime )) {
+      lineCount++;
+
+      // increment startTime; wrap from 0 to 4 minutes UTC
+      startTime++;
+      if( startTime > 4 ) {
+        startTime = 0;
+      }
+    }// good data line
+
+    dataLine = reader.nextLine( &lineLength );
+  }// finished with data file
+}// end void ClkStatsParser::parseFile()
+
+
+const bool ClkStatsParser::parseLine( char* dataLine,
+                                      const int lineLength,
+                                      const int startTime )
+{
+  if( TextScan::findString( dataLine, dataLine + lineLength, "wwv5" )
+      == NULL )
+  {
+    return false;
+  }
+
   /*
    * This is somewhat complicated because each wwv5 line could contain a
    *   different data series. First, the data series is determined from the
    *   wwv5 line, and then the current index is offset to "move" to that series'
    *   set of slots.
    */
-  char dataLine[ WWV5_LINESIZE ];
-  int startTime = 0;
-  int lineCount = 0;
-  dataStream->getline( dataLine, WWV5_LINESIZE );
-  while( dataStream->good() && !dataStream->eof() ) {
-    // grab line and check for key label (wwv5)
-    if( dataLine != NULL && strstr( dataLine, "wwv5" )) {
-      lineCount++;
+  // iterate through line tokens and pull out data values
+  // --make sure to capture the start values on the first entries
+  char* asciiValues[ WWV5_VALUES ];
+  if( TextScan::splitFields( dataLine, lineLength, asciiValues,
+                             WWV5_VALUES, true ) < WWV5_VALUES )
+  {
+    LOG_ERR( "Short wwv5 line ignored." )
+    return false;
+  }
 
-      // iterate through line tokens and pull out data values
-      // --make sure to capture the start values on the first entries
-      char* asciiValues[ WWV5_VALUES ];
-      char* dataTok = strtok( dataLine, " /" );
-      for( int i = 0; i < WWV5_VALUES; i++ ) {
-        asciiValues[i] = dataTok;
-        dataTok = strtok( NULL, " /" );
-      }
+  // determine the start index for loading data into the series(es)
+  char* refId = asciiValues[WWV5_REFID_INDEX];
+  int dataIndex = 0;
+  if( !strcmp( refId, WWV5_LABEL_2 )) {
+    dataIndex = WWV5_START_2;
+  } else if( !strcmp( refId, WWV5_LABEL_5 )) {
+    dataIndex = WWV5_START_2 + WWV5_FREQ_VALS;
+  } else if( !strcmp( refId, WWV5_LABEL_10 )) {
+    dataIndex = WWV5_START_2 + WWV5_FREQ_VALS * 2;
+  } else if( !strcmp( refId, WWV5_LABEL_15 )) {
+    dataIndex = WWV5_START_2 + WWV5_FREQ_VALS * 3;
+  } else if( !strcmp( refId, WWV5_LABEL_20 )) {
+    dataIndex = WWV5_START_2 + WWV5_FREQ_VALS * 4;
+  } else {
+    LOG_ERR( "Unknown RefId token recovered: " << refId )
+    return false;
+  }
+
+  // extract the gain
+  int gain = atoi( asciiValues[ WWV5_AGC_INDEX ] );
 
-      // determine the start index for loading data into the series(es)
-      char* refId = asciiValues[WWV5_REFID_INDEX];
-      int dataIndex = 0;
-      if( !strcmp( refId, WWV5_LABEL_2 )) {
-        dataIndex = WWV5_START_2;
-      } else if( !strcmp( refId, WWV5_LABEL_5 )) {
-        dataIndex = WWV5_START_2 + WWV5_FREQ_VALS;
-      } else if( !strcmp( refId, WWV5_LABEL_10 )) {
-        dataIndex = WWV5_START_2 + WWV5_FREQ_VALS * 2;
-      } else if( !strcmp( refId, WWV5_LABEL_15 )) {
-        dataIndex = WWV5_START_2 + WWV5_FREQ_VALS * 3;
-      } else if( !strcmp( refId, WWV5_LABEL_20 )) {
-        dataIndex = WWV5_START_2 + WWV5_FREQ_VALS * 4;
+  // process data line and load in tokens
+  LOG_DEBUG( 9, ": Loading tokens" )
+  for( int tokenIndex = WWV5_REFID_INDEX + 1;
+       tokenIndex < WWV5_VALUES;
+       tokenIndex++ )
+  {
+    if( tokenIndex == WWV5_REFID_H_INDEX ) {
+      // no op -- wwvh identifier
+    } else {
+      if( tags[dataIndex].type == DATATYPE_DOUBLE ) {
+        double value = atof( asciiValues[tokenIndex] );
+        data[dataIndex]->addValue( &value, 5, startTime );
+        if( sampleCallback != NULL ) {
+          sampleCallback( *data[dataIndex], &value, sampleContext );
+        }
+      } else if( tags[dataIndex].type == DATATYPE_INT ) {
+        int value = atoi( asciiValues[tokenIndex] );
+        if( tags[dataIndex].label.find( "synmax" ) != string::npos ) {
+          value *= gain;
+        }
+        data[dataIndex]->addValue( &value, 5, startTime );
+        if( sampleCallback != NULL ) {
+          sampleCallback( *data[dataIndex], &value, sampleContext );
+        }
       } else {
-        LOG_ERR( "Unknown RefId token recovered: " << refId )
-        dataIndex = -1;
+        // ignore case
       }
+      dataIndex++;
+    }
+  }// finished with data line
+
+  return true;
+}// end const bool ClkStatsParser::parseLine( char*, const int, ... )
+
+
+//----< TAIL METHODS >---------------------------------------------------------
+const bool ClkStatsParser::openTail() {
+  LOG_DEBUG( 11, "()" )
+
+  if( tailFile >= 0 ) {
+    close( tailFile );
+  }
+  tailOffset = 0;
+  tailPartial.clear();
+  tailFile = open( getFileName().c_str(), O_RDONLY );
+
+  return tailFile >= 0;
+}// end const bool ClkStatsParser::openTail()
 
-      // extract the gain
-      int gain = atoi( asciiValues[ WWV5_AGC_INDEX ] );
-
-      // process data line and load in tokens
-      LOG_DEBUG( 9, ": Loading tokens" )
-      for( int tokenIndex = WWV5_REFID_INDEX + 1;
-           tokenIndex < WWV5_VALUES;
-           tokenIndex++ )
-      {
-        if( tokenIndex == WWV5_REFID_H_INDEX ) {
-          // no op -- wwvh identifier
-        } else {
-          if( tags[dataIndex].type == DATATYPE_DOUBLE ) {
-            double value = atof( asciiValues[tokenIndex] );
-            data[dataIndex]->addValue( &value, 5, startTime );
-          } else if( tags[dataIndex].type == DATATYPE_INT
-                  && tags[dataIndex].label.find( "synmax" ) != string::npos ) {
-            int value = atoi( asciiValues[tokenIndex] );
-            value *= gain;
-            data[dataIndex]->addValue( &value, 5, startTime );
-          } else if( tags[dataIndex].type == DATATYPE_INT ) {
-            int value = atoi( asciiValues[tokenIndex] );
-            data[dataIndex]->addValue( &value, 5, startTime );
-          } else {
-            // ignore case
+
+const int ClkStatsParser::poll() {
+  LOG_DEBUG( 11, "()" )
+
+  if( !tailing ) {
+    LOG_ERR( "Parser is not in tail mode." )
+    return -1;
+  }
+
+  // finish the open file first, restarting it if it was truncated, so that
+  // lines written just before a rotation are not lost
+  int lineCount = 0;
+  struct stat fileStat;
+  if( tailFile >= 0 ) {
+    if( fstat( tailFile, &fileStat ) == 0 && fileStat.st_size < tailOffset ) {
+      LOG_DEBUG( 10, ": File truncated, restarting." )
+      tailOffset = 0;
+      tailPartial.clear();
+    }
+    lineCount = readTail();
+    if( lineCount < 0 ) {
+      return -1;
+    }
+  }
+
+  // then switch to the file now carrying the name if it was replaced
+  struct stat pathStat;
+  if( stat( getFileName().c_str(), &pathStat ) != 0 ) {
+    // file is momentarily missing (rotating); try again later
+    return lineCount;
+  }
+  if( tailFile < 0
+      || fstat( tailFile, &fileStat ) != 0
+      || fileStat.st_ino != pathStat.st_ino
+      || fileStat.st_dev != pathStat.st_dev )
+  {
+    LOG_DEBUG( 10, ": File replaced, reopening." )
+    if( !openTail() ) {
+      return -1;
+    }
+    int count = readTail();
+    if( count < 0 ) {
+      return -1;
+    }
+    lineCount += count;
+  }
+
+  return lineCount;
+}// end const int ClkStatsParser::poll()
+
+
+const int ClkStatsParser::readTail() {
+  LOG_DEBUG( 11, "()" )
+
+  // consume the new bytes a line at a time
+  int lineCount = 0;
+  char chunk[ WWV5_TAIL_CHUNK ];
+  ssize_t count = pread( tailFile, chunk, sizeof( chunk ), tailOffset );
+  while( count > 0 ) {
+    tailOffset += count;
+    const char* lineStart = chunk;
+    const char* chunkEnd = chunk + count;
+    const char* lineEnd = TextScan::findNewline( lineStart, chunkEnd );
+    while( lineEnd != NULL ) {
+      tailPartial.append( lineStart, lineEnd - lineStart );
+      if( tailPartial.size() < WWV5_LINESIZE ) {
+        char dataLine[ WWV5_LINESIZE ];
+        memcpy( dataLine, tailPartial.c_str(), tailPartial.size() + 1 );
+        if( parseLine( dataLine, tailPartial.size(), tailStartTime )) {
+          lineCount++;
+          tailStartTime++;
+          if( tailStartTime > 4 ) {
+            tailStartTime = 0;
           }
-          dataIndex++;
         }
-      }// finished with data line
+      } else {
+        LOG_ERR( "Overlong clockstats line ignored." )
+      }
+      tailPartial.clear();
+      lineStart = lineEnd + 1;
+      lineEnd = TextScan::findNewline( lineStart, chunkEnd );
+    }
+    tailPartial.append( lineStart, chunkEnd - lineStart );
+    count = pread( tailFile, chunk, sizeof( chunk ), tailOffset );
+  }
+  if( count < 0 ) {
+    LOG_ERR( "Read failed: " << strerror( errno ))
+    return -1;
+  }
 
-      // increment startTime; wrap from 0 to 4 minutes UTC
-      startTime++;
-      if( startTime > 4 ) {
-        startTime = 0;
+  return lineCount;
+}// end const int ClkStatsParser::readTail()
+
+
+const bool ClkStatsParser::follow( const int interval,
+                                   volatile bool* const stop )
+{
+  LOG_DEBUG( 11, "( " << interval << ", stop )" )
+
+  if( stop == NULL || poll() < 0 ) {
+    return false;
+  }
+
+  // prefer change notices; fall back to sleeping for the interval
+  int notify = -1;
+#ifdef __linux__
+  notify = inotify_init1( IN_NONBLOCK );
+  if( notify >= 0
+      && inotify_add_watch( notify, getFileName().c_str(),
+                            IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF ) < 0 )
+  {
+    close( notify );
+    notify = -1;
+  }
+#endif
+
+  while( !*stop ) {
+    if( notify >= 0 ) {
+#ifdef __linux__
+      struct pollfd watch = { notify, POLLIN, 0 };
+      if( ::poll( &watch, 1, interval ) > 0 ) {
+        char events[ 4096 ];
+        bool replaced = false;
+        ssize_t count = read( notify, events, sizeof( events ));
+        for( ssize_t i = 0; i < count; ) {
+          const struct inotify_event* event =
+              (const struct inotify_event*)( events + i );
+          if( event->mask & ( IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED )) {
+            replaced = true;
+          }
+          i += sizeof( struct inotify_event ) + event->len;
+        }
+        if( replaced ) {
+          // watch whatever now carries the name
+          close( notify );
+          notify = inotify_init1( IN_NONBLOCK );
+          if( notify >= 0
+              && inotify_add_watch( notify, getFileName().c_str(),
+                                    IN_MODIFY | IN_MOVE_SELF
+                                    | IN_DELETE_SELF ) < 0 )
+          {
+            close( notify );
+            notify = -1;
+          }
+        }
       }
-    }// good data line
+#endif
+    } else {
+      usleep( interval * 1000 );
+    }
 
-    // grab next line for processing, should trigger any flags
-    dataStream->getline( dataLine, WWV5_LINESIZE );
-  }// finished with data file
-}// end void ClkStatsParser::parseFile()
\ No newline at end of file
+    if( poll() < 0 ) {
+      LOG_ERR( "Stopped following " << getFileName() )
+      break;
+    }
+  }
+
+  if( notify >= 0 ) {
+    close( notify );
+  }
+  return *stop;
+}// end const bool ClkStatsParser::follow( const int, volatile bool* const )
+
+
+void ClkStatsParser::finishTail() {
+  LOG_DEBUG( 11, "()" )
+
+  if( !tailing ) {
+    return;
+  }
+  tailing = false;
+  if( tailFile >= 0 ) {
+    close( tailFile );
+    tailFile = -1;
+  }
+  tailPartial.clear();
+  finalizeSeriesData();
+}// end void ClkStatsParser::finishTail()
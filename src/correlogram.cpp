@@ -0,0 +1,362 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    --Validity is built after the workers join; threads sharing a
+ *             bitmap word raced on it
+ *           Initial creation.
+ */
+
+#include <crsCorr/correlogram.h>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <pthread.h>
+#include <unistd.h>
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+/*
+ * The six running sums of every lag.
+ */
+typedef struct LagSums {
+  std::vector<double> count;
+  std::vector<double> sumA;
+  std::vector<double> sumB;
+  std::vector<double> squaresA;
+  std::vector<double> squaresB;
+  std::vector<double> products;
+
+  LagSums( const int lags )
+    : count( lags ), sumA( lags ), sumB( lags ), squaresA( lags ),
+      squaresB( lags ), products( lags )
+  {}
+
+  void clear() {
+    std::fill( count.begin(), count.end(), 0.0 );
+    std::fill( sumA.begin(), sumA.end(), 0.0 );
+    std::fill( sumB.begin(), sumB.end(), 0.0 );
+    std::fill( squaresA.begin(), squaresA.end(), 0.0 );
+    std::fill( squaresB.begin(), squaresB.end(), 0.0 );
+    std::fill( products.begin(), products.end(), 0.0 );
+  }
+} LagSums;
+
+
+/*
+ * Adds ( sign 1 ) or removes ( sign -1 ) cells first to last - 1 of a at
+ *   every lag. Padded b cell i + l pairs a cell i with lag minLag + l.
+ */
+static void slide( LagSums& sums,
+                   const double* a,
+                   const double* aMask,
+                   const double* b,
+                   const double* bMask,
+                   const int first,
+                   const int last,
+                   const int lags,
+                   const double sign )
+{
+  double* count = &sums.count[0];
+  double* sumA = &sums.sumA[0];
+  double* sumB = &sums.sumB[0];
+  double* squaresA = &sums.squaresA[0];
+  double* squaresB = &sums.squaresB[0];
+  double* products = &sums.products[0];
+  for( int i = first; i < last; i++ ) {
+    if( aMask[i] == 0.0 ) {
+      continue;
+    }
+    const double x = sign * a[i];
+    const double xx = x * a[i];
+    const double* bRow = b + i;
+    const double* maskRow = bMask + i;
+    for( int l = 0; l < lags; l++ ) {
+      const double y = bRow[l];
+      count[l] += sign * maskRow[l];
+      sumA[l] += x * maskRow[l];
+      sumB[l] += sign * y;
+      squaresA[l] += xx * maskRow[l];
+      squaresB[l] += sign * y * y;
+      products[l] += x * y;
+    }
+  }
+}// end static void slide( LagSums&, const double*, ... )
+
+//----< CORRELOGRAM >-----------------------------------------------------------
+Correlogram::Correlogram( const int windows,
+                          const int window,
+                          const int hop,
+                          const int minLag,
+                          const int lags,
+                          const int resolution,
+                          const int startTime )
+  : windows( windows ), window( window ), hop( hop ), minLag( minLag ),
+    lags( lags ), resolution( resolution ), startTime( startTime )
+{
+  LOG_DEBUG( 12, "( " << windows << ", " << window << ", " << hop << ", " \
+                 << minLag << ", " << lags << " )" )
+
+  const size_t entries = (size_t)( windows > 0 ? windows : 0 ) * lags;
+  values = new double[ entries ];
+  counts = new int[ entries ];
+  validity = new uint64_t[ ( entries + 63 ) / 64 ];
+  memset( values, 0, entries * sizeof( double ));
+  memset( counts, 0, entries * sizeof( int ));
+  memset( validity, 0, (( entries + 63 ) / 64 ) * sizeof( uint64_t ));
+}// end Correlogram::Correlogram( const int, const int, ... )
+
+
+Correlogram::~Correlogram() {
+  delete[] values;
+  delete[] counts;
+  delete[] validity;
+}// end Correlogram::~Correlogram()
+
+
+void* Correlogram::run( void* block ) {
+  Block* work = (Block*)block;
+  work->correlogram->computeBlock( *work );
+  return NULL;
+}// end static void* Correlogram::run( void* )
+
+
+void Correlogram::computeBlock( const Block& block ) {
+  LOG_DEBUG( 13, "( " << block.first << " to " << block.last << " )" )
+
+  LagSums sums( lags );
+  int previous = -1;                    // start of the window in the sums
+  for( int w = block.first; w < block.last; w++ ) {
+    const int start = w * hop;
+    if( previous < 0 || start - previous >= window
+        || ( w - block.first ) % CORRELOGRAM_REFRESH == 0 )
+    {
+      sums.clear();
+      slide( sums, block.a, block.aMask, block.b, block.bMask,
+             start, start + window, lags, 1.0 );
+    } else {
+      slide( sums, block.a, block.aMask, block.b, block.bMask,
+             previous, start, lags, -1.0 );
+      slide( sums, block.a, block.aMask, block.b, block.bMask,
+             previous + window, start + window, lags, 1.0 );
+    }
+    previous = start;
+
+    for( int l = 0; l < lags; l++ ) {
+      const size_t entry = (size_t)w * lags + l;
+      const double n = sums.count[l];
+      const int pairs = (int)( n + 0.5 );
+      counts[ entry ] = pairs;
+
+      // NaN marks an undefined entry until compute() builds the validity
+      values[ entry ] = NAN;
+      if( pairs < 2 ) {
+        continue;
+      }
+      // removed cells can leave rounding residue where a side is constant
+      double varianceA = sums.squaresA[l] - sums.sumA[l] * sums.sumA[l] / n;
+      double varianceB = sums.squaresB[l] - sums.sumB[l] * sums.sumB[l] / n;
+      if( varianceA <= 1e-12 * sums.squaresA[l]
+          || varianceB <= 1e-12 * sums.squaresB[l] )
+      {
+        continue;
+      }
+      double covariance = sums.products[l] - sums.sumA[l] * sums.sumB[l] / n;
+      double r = covariance / sqrt( varianceA * varianceB );
+      values[ entry ] = r > 1.0 ? 1.0 : ( r < -1.0 ? -1.0 : r );
+    }
+  }
+}// end void Correlogram::computeBlock( const Block& )
+
+
+const bool Correlogram::compute( const double* a,
+                                 const uint64_t* aValid,
+                                 const int aLength,
+                                 const double* b,
+                                 const uint64_t* bValid,
+                                 const int bLength,
+                                 const int threads )
+{
+  LOG_DEBUG( 12, "( a, aValid, " << aLength << ", b, bValid, " << bLength \
+                 << ", " << threads << " )" )
+
+  if( a == NULL || b == NULL || windows < 1
+      || ( windows - 1 ) * hop + window > aLength )
+  {
+    LOG_ERR( windows << " windows of " << window << " cells every " << hop \
+             << " do not fit " << aLength << " cells." )
+    return false;
+  }
+
+  // centering keeps the running sums small
+  double meanA = 0.0;
+  double meanB = 0.0;
+  int validA = 0;
+  int validB = 0;
+  for( int i = 0; i < aLength; i++ ) {
+    if( isValidCell( aValid, i )) {
+      meanA += a[i];
+      validA++;
+    }
+  }
+  for( int i = 0; i < bLength; i++ ) {
+    if( isValidCell( bValid, i )) {
+      meanB += b[i];
+      validB++;
+    }
+  }
+  meanA = validA > 0 ? meanA / validA : 0.0;
+  meanB = validB > 0 ? meanB / validB : 0.0;
+
+  std::vector<double> centeredA( aLength );
+  std::vector<double> maskA( aLength );
+  for( int i = 0; i < aLength; i++ ) {
+    maskA[i] = isValidCell( aValid, i ) ? 1.0 : 0.0;
+    centeredA[i] = maskA[i] * ( a[i] - meanA );
+  }
+
+  // padded cell k holds b cell k + minLag, so a cell i meets b at i + l
+  const int padded = aLength + lags;
+  std::vector<double> centeredB( padded, 0.0 );
+  std::vector<double> maskB( padded, 0.0 );
+  for( int k = 0; k < padded; k++ ) {
+    int cell = k + minLag;
+    if( cell >= 0 && cell < bLength && isValidCell( bValid, cell )) {
+      maskB[k] = 1.0;
+      centeredB[k] = b[ cell ] - meanB;
+    }
+  }
+
+  int workers = threads > 0 ? threads : (int)sysconf( _SC_NPROCESSORS_ONLN );
+  workers = workers < 1 ? 1 : ( workers > windows ? windows : workers );
+  std::vector<Block> blocks( workers );
+  std::vector<pthread_t> handles( workers );
+  std::vector<bool> started( workers, false );
+  for( int t = 0; t < workers; t++ ) {
+    Block& block = blocks[t];
+    block.correlogram = this;
+    block.a = &centeredA[0];
+    block.aMask = &maskA[0];
+    block.b = &centeredB[0];
+    block.bMask = &maskB[0];
+    block.first = (int)( (long long)windows * t / workers );
+    block.last = (int)( (long long)windows * ( t + 1 ) / workers );
+  }
+
+  // the calling thread takes the first block itself
+  bool good = true;
+  for( int t = 1; t < workers; t++ ) {
+    if( pthread_create( &handles[t], NULL, Correlogram::run, &blocks[t] ) != 0 )
+    {
+      LOG_ERR( "Unable to start correlogram thread " << t )
+      good = false;
+      break;
+    }
+    started[t] = true;
+  }
+  if( good ) {
+    computeBlock( blocks[0] );
+  }
+  for( int t = 1; t < workers; t++ ) {
+    if( started[t] ) {
+      pthread_join( handles[t], NULL );
+    }
+  }
+
+  // blocks may share a validity word, so the bits are set here alone
+  const size_t entries = (size_t)windows * lags;
+  memset( validity, 0, (( entries + 63 ) / 64 ) * sizeof( uint64_t ));
+  for( size_t entry = 0; entry < entries; entry++ ) {
+    if( std::isnan( values[ entry ] )) {
+      values[ entry ] = 0.0;
+    } else {
+      validity[ entry >> 6 ] |= (uint64_t)1 << ( entry & 63 );
+    }
+  }
+  return good;
+}// end const bool Correlogram::compute( const double*, ... )
+
+//----< ACCESSORS >-------------------------------------------------------------
+const double* Correlogram::getRow( const int index ) const {
+  return values + (size_t)index * lags;
+}// end const double* Correlogram::getRow( const int ) const
+
+
+const int* Correlogram::getCounts( const int index ) const {
+  return counts + (size_t)index * lags;
+}// end const int* Correlogram::getCounts( const int ) const
+
+
+const bool Correlogram::isDefined( const int index, const int lag ) const {
+  if( index < 0 || index >= windows || lag < 0 || lag >= lags ) {
+    return false;
+  }
+  const size_t entry = (size_t)index * lags + lag;
+  return ( validity[ entry >> 6 ] >> ( entry & 63 )) & 1;
+}// end const bool Correlogram::isDefined( const int, const int ) const
+
+
+const int Correlogram::getPeakLag( const int index ) const {
+  int peak = -1;
+  const double* row = getRow( index );
+  for( int l = 0; l < lags; l++ ) {
+    if( isDefined( index, l ) && ( peak < 0 || row[l] > row[ peak ] )) {
+      peak = l;
+    }
+  }
+  return peak;
+}// end const int Correlogram::getPeakLag( const int ) const
+
+//----< OUTPUT >----------------------------------------------------------------
+const bool Correlogram::writeBinary( const string path ) const {
+  LOG_DEBUG( 12, "( " << path << " )" )
+
+  std::ofstream out( path.c_str(), std::ios::out | std::ios::binary
+                                   | std::ios::trunc );
+  if( !out.is_open() ) {
+    LOG_ERR( "Unable to open correlogram file " << path )
+    return false;
+  }
+  const size_t entries = (size_t)windows * lags;
+  const int header[] = { CORRELOGRAM_VERSION, windows, lags, window, hop,
+                         minLag, resolution, startTime };
+  out.write( "CGRM", 4 );
+  out.write( (const char*)header, sizeof( header ));
+  out.write( (const char*)values, entries * sizeof( double ));
+  out.write( (const char*)counts, entries * sizeof( int ));
+  out.write( (const char*)validity,
+             (( entries + 63 ) / 64 ) * sizeof( uint64_t ));
+  out.close();
+  if( out.fail() ) {
+    LOG_ERR( "Unable to write correlogram file " << path )
+    return false;
+  }
+  return true;
+}// end const bool Correlogram::writeBinary( const string ) const
+
+
+const bool Correlogram::writeColumns( const string path ) const {
+  LOG_DEBUG( 12, "( " << path << " )" )
+
+  std::ofstream out( path.c_str(), std::ios::out | std::ios::trunc );
+  if( !out.is_open() ) {
+    LOG_ERR( "Unable to open correlogram file " << path )
+    return false;
+  }
+  out << "# start lag correlation pairs" << std::endl;
+  out.precision( 10 );
+  for( int w = 0; w < windows; w++ ) {
+    const double* row = getRow( w );
+    const int* pairs = getCounts( w );
+    for( int l = 0; l < lags; l++ ) {
+      if( isDefined( w, l )) {
+        out << w * hop * resolution << " " << ( minLag + l ) * resolution
+            << " " << row[l] << " " << pairs[l] << "\n";
+      }
+    }
+  }
+  out.close();
+  if( out.fail() ) {
+    LOG_ERR( "Unable to write correlogram file " << path )
+    return false;
+  }
+  return true;
+}// end const bool Correlogram::writeColumns( const string ) const
@@ -0,0 +1,207 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Initial creation. Holds the untemplated masked correlation
+ *           kernels; the typed entry points remain in the header.
+ */
+
+#include <crsCorr/crsCorr.h>
+#include <crsCorr/fft.h>
+#include <complex>
+#include <cmath>
+#include <cstring>
+
+using std::complex;
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+/*
+ * Splits the transform of a + i b, two real sequences packed into one
+ *   complex sequence, into the transforms of a and b.
+ */
+static void unpackSpectra( const complex<double>* packed,
+                           const int n,
+                           complex<double>* first,
+                           complex<double>* second )
+{
+  for( int k = 0; k < n; k++ ) {
+    complex<double> mirror = std::conj( packed[ ( n - k ) % n ] );
+    first[k] = 0.5 * ( packed[k] + mirror );
+    second[k] = complex<double>( 0.0, -0.5 ) * ( packed[k] - mirror );
+  }
+}// end static void unpackSpectra( const complex<double>*, const int, ... )
+
+
+/*
+ * Accumulated sums of the jointly valid samples at one delay.
+ */
+typedef struct JointSums {
+  double xy;
+  double x;
+  double y;
+  double xx;
+  double yy;
+  double count;
+} JointSums;
+
+
+/*
+ * Pearson correlation from joint sums. Returns false when it is undefined:
+ *   fewer than two samples, or either side constant within rounding.
+ */
+static bool normalize( const JointSums& sums, double* result ) {
+  double n = sums.count;
+  if( n < 2.0 ) {
+    return false;
+  }
+  double covariance = sums.xy - sums.x * sums.y / n;
+  double varianceX = sums.xx - sums.x * sums.x / n;
+  double varianceY = sums.yy - sums.y * sums.y / n;
+  if( varianceX <= 1e-10 * sums.xx || varianceY <= 1e-10 * sums.yy ) {
+    return false;
+  }
+  *result = covariance / sqrt( varianceX * varianceY );
+  if( *result > 1.0 ) {
+    *result = 1.0;
+  } else if( *result < -1.0 ) {
+    *result = -1.0;
+  }
+  return true;
+}// end static bool normalize( const JointSums&, double* )
+
+//----< KERNELS >---------------------------------------------------------------
+void crsCorr::maskedCorrelation( const double* shortData,
+                                 const uint64_t* shortValid,
+                                 const int shortLen,
+                                 const double* longData,
+                                 const uint64_t* longValid,
+                                 const int longLen,
+                                 double* sums,
+                                 int* counts,
+                                 double* normalized,
+                                 uint64_t* normalizedValid,
+                                 const int method )
+{
+  LOG_DEBUG( 14, "( ..., " << shortLen << ", ..., " << longLen << ", ..., " \
+                 << method << " )" )
+
+  int length = longLen - shortLen + 1;
+  if( shortLen <= 0 || length <= 0 ) {
+    LOG_ERR( "Bad lengths " << shortLen << " and " << longLen )
+    return;
+  }
+
+  bool useFft = ( method == CRSCORR_METHOD_FFT );
+  if( method == CRSCORR_METHOD_AUTO ) {
+    useFft = (double)shortLen * length > CRSCORR_FFT_THRESHOLD;
+  }
+
+  // joint sums per delay, indexed by the offset into the long data
+  JointSums* joint = new JointSums[ length ];
+  if( !useFft ) {
+    LOG_DEBUG( 13, ": Direct sums." )
+    for( int offset = 0; offset < length; offset++ ) {
+      JointSums& terms = joint[offset];
+      memset( &terms, 0, sizeof( JointSums ));
+      for( int i = 0; i < shortLen; i++ ) {
+        if( isValidCell( shortValid, i )
+            && isValidCell( longValid, offset + i ))
+        {
+          double x = shortData[i];
+          double y = longData[ offset + i ];
+          terms.xy += x * y;
+          terms.x += x;
+          terms.y += y;
+          terms.xx += x * x;
+          terms.yy += y * y;
+          terms.count += 1.0;
+        }
+      }
+    }
+  } else {
+    // Each sum is a correlation of a masked sequence from each side:
+    //   xy = (x m) * (y n), x = (x m) * n, y = m * (y n),
+    //   xx = (x^2 m) * n, yy = m * (y^2 n), count = m * n
+    //   Three forward transforms carry the six sequences two at a time and
+    //   three inverse transforms return the six correlations two at a time.
+    LOG_DEBUG( 13, ": FFT sums." )
+    int n = Fft::getSize( longLen + shortLen );
+    complex<double>* work = new complex<double>[ 9 * n ];
+    complex<double>* packed[3] = { work, work + n, work + 2 * n };
+    complex<double>* spectra = work + 3 * n;   // x m, m, x^2 m, y n, n, y^2 n
+    for( int i = 0; i < 3 * n; i++ ) {
+      work[i] = 0.0;
+    }
+    for( int i = 0; i < shortLen; i++ ) {
+      if( isValidCell( shortValid, i )) {
+        double x = shortData[i];
+        packed[0][i] = complex<double>( x, 1.0 );
+        packed[1][i] = complex<double>( x * x, 0.0 );
+      }
+    }
+    for( int i = 0; i < longLen; i++ ) {
+      if( isValidCell( longValid, i )) {
+        double y = longData[i];
+        packed[1][i] += complex<double>( 0.0, y );
+        packed[2][i] = complex<double>( 1.0, y * y );
+      }
+    }
+    for( int j = 0; j < 3; j++ ) {
+      Fft::transform( packed[j], n );
+    }
+    unpackSpectra( packed[0], n, spectra, spectra + n );
+    unpackSpectra( packed[1], n, spectra + 2 * n, spectra + 3 * n );
+    unpackSpectra( packed[2], n, spectra + 4 * n, spectra + 5 * n );
+
+    // correlation of a with b is the inverse of conj( A ) B
+    const complex<double>* xm = spectra;
+    const complex<double>* m = spectra + n;
+    const complex<double>* xxm = spectra + 2 * n;
+    const complex<double>* yn = spectra + 3 * n;
+    const complex<double>* mn = spectra + 4 * n;
+    const complex<double>* yyn = spectra + 5 * n;
+    complex<double> i1( 0.0, 1.0 );
+    for( int k = 0; k < n; k++ ) {
+      packed[0][k] = std::conj( xm[k] ) * yn[k]
+                     + i1 * std::conj( xm[k] ) * mn[k];
+      packed[1][k] = std::conj( m[k] ) * yn[k]
+                     + i1 * std::conj( xxm[k] ) * mn[k];
+      packed[2][k] = std::conj( m[k] ) * yyn[k]
+                     + i1 * std::conj( m[k] ) * mn[k];
+    }
+    for( int j = 0; j < 3; j++ ) {
+      Fft::transform( packed[j], n, true );
+    }
+    for( int offset = 0; offset < length; offset++ ) {
+      joint[offset].xy = packed[0][offset].real();
+      joint[offset].x = packed[0][offset].imag();
+      joint[offset].y = packed[1][offset].real();
+      joint[offset].xx = packed[1][offset].imag();
+      joint[offset].yy = packed[2][offset].real();
+      joint[offset].count = floor( packed[2][offset].imag() + 0.5 );
+    }
+    delete[] work;
+  }
+
+  // delay 0 aligns the short data with the end of the long data
+  if( normalizedValid != NULL ) {
+    memset( normalizedValid, 0, (( length + 63 ) / 64 ) * sizeof( uint64_t ));
+  }
+  for( int delay = 0; delay < length; delay++ ) {
+    const JointSums& terms = joint[ length - delay - 1 ];
+    if( sums != NULL ) {
+      sums[delay] = terms.count > 0.0 ? terms.xy : 0.0;
+    }
+    if( counts != NULL ) {
+      counts[delay] = (int)terms.count;
+    }
+    double value = 0.0;
+    bool defined = normalize( terms, &value );
+    if( normalized != NULL ) {
+      normalized[delay] = defined ? value : 0.0;
+    }
+    if( normalizedValid != NULL && defined ) {
+      normalizedValid[ delay >> 6 ] |= (uint64_t)1 << ( delay & 63 );
+    }
+  }
+
+  delete[] joint;
+}// end void crsCorr::maskedCorrelation( const double*, const uint64_t*, ... )
@@ -0,0 +1,636 @@
+/*
+ * crsCorrBatch -- correlates every pair of a pairing spec over a range of
+ *   days in one process, replacing the chain of per pair driver runs.
+ *
+ *   crsCorrBatch -d dataDir -o resultDir -s YYYYMMDD -e YYYYMMDD -p pairFile
+ *                [-j threads] [-l maxLagMinutes] [-b] [-m manifest [-H]]
+ *
+ * Each line of the pair file names two series by source and label,
+ *
+ *     # sourceA labelA sourceB labelB
+ *     clockstats hsynmax10 ace_swepam_1m SPEED
+ *
+ *   where a source is one of the kinds in sources[] below and determines both
+ *   the parser and the data file name for a day. Every data file a day needs
+ *   is parsed once by a task; the correlations that depend on it are queued
+ *   as soon as both of their files are parsed, and a parser is released when
+ *   its last correlation is written. All tasks run on a work stealing
+ *   TaskPool, so the run is bound by the cores and the disks rather than by
+ *   process start up.
+ *
+ * Both series are resampled to the coarser of their resolutions and
+ *   correlated over the whole day at every lag up to maxLagMinutes either
+ *   way. Results go to resultDir/YYYYMMDD/, named as the old driver named
+ *   them, e.g. hsynmax10_SPEED__clockstats.txt__ace_swepam_1m.txt, with one
+ *   line per defined lag:
+ *
+ *     date lagMinutes pairs correlation delay
+ *
+ *   so genPlots.sh can keep plotting "using 5:4", delay in cells. With -b
+ *   the same columns are written as a ResultWriter binary table instead, to
+ *   the same name with BATCH_BINARY_SUFFIX appended; its header's lag offset
+ *   is the delay of the first row, and the delay column gives every row's
+ *   lag since undefined lags are skipped.
+ *
+ * With -m, a JobManifest records the signature of every result written:
+ *   the fingerprints of its two data files and the settings that shape it.
+ *   A later run skips each correlation whose result exists with an
+ *   unchanged signature, and parses a data file only if some correlation
+ *   still needs it, so a nightly run over a long window redoes just the days
+ *   whose files changed. Fingerprints are sizes and modification times, or
+ *   content hashes with -H.
+ *
+ * Modified: 10/19/26
+ * Notes:    --The binary lag offset is the delay of the first written row
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added the job manifest (-m, -H) to skip current results
+ *
+ * Modified: 10/19/26
+ * Notes:    --Results are written through ResultWriter; -b selects binary
+ *
+ * Modified: 10/19/26
+ * Notes:    --Initial creation
+ */
+
+#include <crsCorr/global.h>
+#include <crsCorr/fileParser.h>
+#include <crsCorr/aceMagParser.h>
+#include <crsCorr/aceSweParser.h>
+#include <crsCorr/clkStatsParser.h>
+#include <crsCorr/gpMagParser.h>
+#include <crsCorr/gpXrayParser.h>
+#include <crsCorr/gpPartParser.h>
+#include <crsCorr/gsMagParser.h>
+#include <crsCorr/gsPartParser.h>
+#include <crsCorr/loopStatsParser.h>
+#include <crsCorr/peerStatsParser.h>
+#include <crsCorr/correlogram.h>
+#include <crsCorr/taskPool.h>
+#include <crsCorr/resultWriter.h>
+#include <crsCorr/jobManifest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+#define BATCH_MAX_LAG 720             // default lag limit, minutes
+#define BATCH_BINARY_SUFFIX ".crsr"   // appended to binary result names
+#define BATCH_STAGE_VERSION 2         // bump when results change meaning
+
+//----< SOURCES >---------------------------------------------------------------
+/*
+ * Source
+ *
+ * A kind of data file: its name in pair files, the file name pattern of a
+ *   day (%s is YYYYMMDD), and its parser.
+ */
+typedef struct Source {
+  const char* name;
+  const char* pattern;
+  FileParser* (*open)( const string& path );
+} Source;
+
+template<typename Parser>
+static FileParser* openParser( const string& path ) {
+  return new Parser( path );
+}// end static FileParser* openParser( const string& )
+
+static const Source sources[] = {
+  { "clockstats", "%s_clockstats.txt", openParser<ClkStatsParser> },
+  { "loopstats", "loopstats.%s", openParser<LoopStatsParser> },
+  { "peerstats", "peerstats.%s", openParser<PeerStatsParser> },
+  { "ace_mag_1m", "%s_ace_mag_1m.txt", openParser<AceMagParser> },
+  { "ace_swepam_1m", "%s_ace_swepam_1m.txt", openParser<AceSweParser> },
+  { "Gp_mag_1m", "%s_Gp_mag_1m.txt", openParser<GpMagParser> },
+  { "Gs_mag_1m", "%s_Gs_mag_1m.txt", openParser<GsMagParser> },
+  { "Gp_xr_1m", "%s_Gp_xr_1m.txt", openParser<GpXrayParser> },
+  { "Gp_part_5m", "%s_Gp_part_5m.txt", openParser<GpPartParser> },
+  { "Gs_part_5m", "%s_Gs_part_5m.txt", openParser<GsPartParser> },
+  { NULL, NULL, NULL } };
+
+static const Source* findSource( const string& name ) {
+  for( int i = 0; sources[i].name != NULL; i++ ) {
+    if( !name.compare( sources[i].name )) {
+      return &sources[i];
+    }
+  }
+  return NULL;
+}// end static const Source* findSource( const string& )
+
+//----< JOBS >------------------------------------------------------------------
+/*
+ * Options
+ *
+ * Settings shared by every task.
+ */
+typedef struct Options {
+  string dataDirectory;
+  string resultDirectory;
+  int maxLag;                         // minutes either way
+  int format;                         // RESULTWRITER_TEXT or _BINARY
+  JobManifest* manifest;              // NULL unless tracking results
+} Options;
+
+/*
+ * PairSpec
+ *
+ * One line of the pair file.
+ */
+typedef struct PairSpec {
+  const Source* sourceA;
+  string labelA;
+  const Source* sourceB;
+  string labelB;
+} PairSpec;
+
+struct PairJob;
+
+/*
+ * DayFile
+ *
+ * The data file of one source on one day. The parser is shared by the jobs
+ *   that read it, one at a time through the lock since its resample cache is
+ *   not synchronized, and deleted once users drops to 0.
+ */
+typedef struct DayFile {
+  const Source* source;
+  string path;
+  FileParser* parser;                 // NULL until parsed or if missing
+  int users;                          // jobs yet to finish with the parser
+  std::vector<PairJob*> dependents;   // one entry per use
+  pthread_mutex_t lock;
+} DayFile;
+
+/*
+ * PairJob
+ *
+ * The correlation of one pair on one day, queued once waiting reaches 0.
+ */
+typedef struct PairJob {
+  const Options* options;
+  const PairSpec* spec;
+  string date;
+  DayFile* fileA;
+  DayFile* fileB;
+  string output;                      // result file
+  uint64_t signature;                 // inputs and settings, for the manifest
+  int waiting;                        // files not yet parsed
+  bool written;
+} PairJob;
+
+/*
+ * Releases one use of a day file, deleting its parser after the last.
+ */
+static void releaseFile( DayFile* file ) {
+  if( __sync_sub_and_fetch( &file->users, 1 ) == 0 ) {
+    delete file->parser;
+    file->parser = NULL;
+  }
+}// end static void releaseFile( DayFile* )
+
+
+/*
+ * Returns the tag of a label in a parser's table, or NULL.
+ */
+static const FileParser::DataTag* findTag( FileParser* parser,
+                                           const string& label )
+{
+  const FileParser::DataTag* tags = parser->getTags();
+  for( int i = 0; i < parser->getLength(); i++ ) {
+    if(( tags[i].type == DATATYPE_INT || tags[i].type == DATATYPE_DOUBLE )
+       && !label.compare( tags[i].label ))
+    {
+      return &tags[i];
+    }
+  }
+  return NULL;
+}// end static const FileParser::DataTag* findTag( FileParser*, ... )
+
+
+/*
+ * Correlates two series and writes the defined lags of the result.
+ */
+template<typename TypeA, typename TypeB>
+static const bool correlateSeries( const PairJob* job,
+                                   const DataSeries<TypeA>* a,
+                                   const DataSeries<TypeB>* b,
+                                   const string& path )
+{
+  const int resolution = a->getResolution();
+  const int minutes = a->getLength() * resolution;
+  Correlogram* correlogram = Correlogram::correlate( *a, *b, minutes,
+                                                     minutes,
+                                                     -job->options->maxLag,
+                                                     job->options->maxLag,
+                                                     1 );
+  if( correlogram == NULL ) {
+    return false;
+  }
+
+  // one row per defined lag
+  const int lags = correlogram->getLags();
+  const double* row = correlogram->getRow( 0 );
+  const int* counts = correlogram->getCounts( 0 );
+  const int date = atoi( job->date.c_str() );
+  std::vector<int> dates, lagMinutes, pairs, delays;
+  std::vector<double> correlations;
+  for( int lag = 0; lag < lags; lag++ ) {
+    if( correlogram->isDefined( 0, lag )) {
+      int delay = correlogram->getMinLag() + lag;
+      dates.push_back( date );
+      lagMinutes.push_back( delay * resolution );
+      pairs.push_back( counts[lag] );
+      correlations.push_back( row[lag] );
+      delays.push_back( delay );
+    }
+  }
+  // a spare entry keeps the column pointers valid when no lag is defined
+  const int rows = delays.size();
+  dates.resize( rows + 1 );
+  lagMinutes.resize( rows + 1 );
+  pairs.resize( rows + 1 );
+  correlations.resize( rows + 1 );
+  delays.resize( rows + 1 );
+
+  // undefined lags are left out, so the first row need not be the min lag
+  ResultHeader header = { job->spec->labelA, job->spec->labelB, resolution,
+                          rows > 0 ? delays[0] : correlogram->getMinLag() };
+  const ResultColumn columns[] = {
+    { "date", DATATYPE_INT, &dates[0], NULL },
+    { "lagMinutes", DATATYPE_INT, &lagMinutes[0], NULL },
+    { "pairs", DATATYPE_INT, &pairs[0], NULL },
+    { "correlation", DATATYPE_DOUBLE, NULL, &correlations[0] },
+    { "delay", DATATYPE_INT, &delays[0], NULL } };
+
+  // a day's table is small enough for one chunk, written on close
+  ResultWriter writer( path, job->options->format, false,
+                       lags * 128 + 4096 );
+  bool good = writer.writeTable( header, columns, 5, rows );
+  good = writer.close() && good;
+  delete correlogram;
+  return good;
+}// end static const bool correlateSeries( const PairJob*, ... )
+
+
+/*
+ * Fetches a series of a day file at a resolution. Holds the file's lock
+ *   while the parser's resample cache is consulted.
+ */
+template<typename DataType>
+static const DataSeries<DataType>* fetchSeries( DayFile* file,
+                                                const FileParser::DataTag* tag,
+                                                const int resolution )
+{
+  FileParser::DataTag resampled = { tag->label, tag->type, resolution, 0 };
+  pthread_mutex_lock( &file->lock );
+  const DataSeries<DataType>* series =
+      file->parser->getSeries<DataType>( &resampled );
+  pthread_mutex_unlock( &file->lock );
+  return series;
+}// end static const DataSeries<DataType>* fetchSeries( DayFile*, ... )
+
+
+template<typename TypeA>
+static const bool correlateWith( const PairJob* job,
+                                 const DataSeries<TypeA>* a,
+                                 const FileParser::DataTag* tagB,
+                                 const int resolution,
+                                 const string& path )
+{
+  if( a == NULL ) {
+    return false;
+  } else if( tagB->type == DATATYPE_INT ) {
+    const DataSeries<int>* b = fetchSeries<int>( job->fileB, tagB,
+                                                 resolution );
+    return b != NULL && correlateSeries( job, a, b, path );
+  }
+  const DataSeries<double>* b = fetchSeries<double>( job->fileB, tagB,
+                                                     resolution );
+  return b != NULL && correlateSeries( job, a, b, path );
+}// end static const bool correlateWith( const PairJob*, ... )
+
+
+static void correlateTask( TaskPool* pool, void* argument ) {
+  PairJob* job = (PairJob*)argument;
+  const PairSpec* spec = job->spec;
+
+  if( job->fileA->parser == NULL || job->fileB->parser == NULL ) {
+    LOG_ERR( job->date << ": missing data for " << spec->labelA << " and " \
+             << spec->labelB )
+  } else {
+    const FileParser::DataTag* tagA = findTag( job->fileA->parser,
+                                               spec->labelA );
+    const FileParser::DataTag* tagB = findTag( job->fileB->parser,
+                                               spec->labelB );
+    if( tagA == NULL || tagB == NULL ) {
+      LOG_ERR( "Unknown label " << ( tagA == NULL ? spec->labelA \
+                                                  : spec->labelB ))
+    } else {
+      const int resolution = tagA->reso > tagB->reso ? tagA->reso
+                                                      : tagB->reso;
+      string directory = job->options->resultDirectory + "/" + job->date;
+      mkdir( directory.c_str(), 0755 );
+      if( tagA->type == DATATYPE_INT ) {
+        job->written = correlateWith( job,
+            fetchSeries<int>( job->fileA, tagA, resolution ), tagB,
+            resolution, job->output );
+      } else {
+        job->written = correlateWith( job,
+            fetchSeries<double>( job->fileA, tagA, resolution ), tagB,
+            resolution, job->output );
+      }
+      if( !job->written ) {
+        LOG_ERR( job->date << ": unable to correlate " << job->output )
+        if( job->options->manifest != NULL ) {
+          job->options->manifest->forget( job->output );
+        }
+      } else if( job->options->manifest != NULL ) {
+        job->options->manifest->record( job->output, job->signature );
+      }
+    }
+  }
+
+  releaseFile( job->fileA );
+  releaseFile( job->fileB );
+}// end static void correlateTask( TaskPool*, void* )
+
+
+static void parseTask( TaskPool* pool, void* argument ) {
+  DayFile* file = (DayFile*)argument;
+
+  struct stat fileStat;
+  if( stat( file->path.c_str(), &fileStat ) == 0 ) {
+    file->parser = file->source->open( file->path );
+  }
+
+  // queue each correlation once both of its files are ready
+  for( size_t i = 0; i < file->dependents.size(); i++ ) {
+    PairJob* job = file->dependents[i];
+    if( __sync_sub_and_fetch( &job->waiting, 1 ) == 0 ) {
+      pool->submit( correlateTask, job );
+    }
+  }
+}// end static void parseTask( TaskPool*, void* )
+
+//----< SET UP >----------------------------------------------------------------
+/*
+ * Returns the result file of a pair on a day.
+ */
+static string resultPath( const Options& options,
+                          const PairSpec& spec,
+                          const string& date )
+{
+  string path = options.resultDirectory + "/" + date + "/" + spec.labelA
+                + "_" + spec.labelB + "__" + spec.sourceA->name + ".txt__"
+                + spec.sourceB->name + ".txt";
+  return options.format == RESULTWRITER_BINARY ? path + BATCH_BINARY_SUFFIX
+                                               : path;
+}// end static string resultPath( const Options&, const PairSpec&, ... )
+
+
+/*
+ * Returns the signature of a pair's result: what it reads at each stage,
+ *   from the data files parsed through the lags correlated to the format
+ *   written.
+ */
+static const uint64_t resultSignature( JobManifest* manifest,
+                                       const Options& options,
+                                       const PairSpec& spec,
+                                       const string& pathA,
+                                       const string& pathB )
+{
+  uint64_t signature = JobManifest::hashValue( BATCH_STAGE_VERSION );
+  signature = JobManifest::hashValue( manifest->fingerprint( pathA ),
+                                      signature );
+  signature = JobManifest::hashValue( manifest->fingerprint( pathB ),
+                                      signature );
+  signature = JobManifest::hashText( spec.sourceA->name, signature );
+  signature = JobManifest::hashText( spec.labelA, signature );
+  signature = JobManifest::hashText( spec.sourceB->name, signature );
+  signature = JobManifest::hashText( spec.labelB, signature );
+  signature = JobManifest::hashValue( options.maxLag, signature );
+  return JobManifest::hashValue( options.format, signature );
+}// end static const uint64_t resultSignature( JobManifest*, ... )
+
+
+/*
+ * Reads the pair file. Returns false on an unknown source or a short line.
+ */
+static const bool readPairs( const string& path, std::vector<PairSpec>& pairs )
+{
+  std::ifstream in( path.c_str() );
+  if( !in.is_open() ) {
+    LOG_ERR( "Unable to open pair file " << path )
+    return false;
+  }
+
+  string line;
+  int lineNumber = 0;
+  while( std::getline( in, line )) {
+    lineNumber++;
+    std::istringstream fields( line.substr( 0, line.find( '#' )));
+    string sourceA, labelA, sourceB, labelB;
+    if( !( fields >> sourceA )) {
+      continue;
+    }
+    PairSpec spec;
+    fields >> labelA >> sourceB >> labelB;
+    spec.sourceA = findSource( sourceA );
+    spec.sourceB = findSource( sourceB );
+    spec.labelA = labelA;
+    spec.labelB = labelB;
+    if( labelB.empty() || spec.sourceA == NULL || spec.sourceB == NULL ) {
+      LOG_ERR( path << ":" << lineNumber << ": expected sourceA labelA " \
+               << "sourceB labelB with known sources" )
+      return false;
+    }
+    pairs.push_back( spec );
+  }
+  return true;
+}// end static const bool readPairs( const string&, ... )
+
+
+/*
+ * Converts YYYYMMDD to seconds since the epoch at midnight UTC, or -1.
+ */
+static const time_t parseDate( const char* date ) {
+  struct tm fields;
+  memset( &fields, 0, sizeof( fields ));
+  if( date == NULL || strlen( date ) != 8
+      || sscanf( date, "%4d%2d%2d", &fields.tm_year, &fields.tm_mon,
+                 &fields.tm_mday ) != 3 )
+  {
+    return -1;
+  }
+  fields.tm_year -= 1900;
+  fields.tm_mon -= 1;
+  return timegm( &fields );
+}// end static const time_t parseDate( const char* )
+
+
+static void usage() {
+  cerr << "usage: crsCorrBatch -d dataDir -o resultDir -s YYYYMMDD"
+       << " -e YYYYMMDD -p pairFile [-j threads] [-l maxLagMinutes] [-b]"
+       << " [-m manifest [-H]]" << endl;
+}// end static void usage()
+
+
+int main( int argc, char** argv ) {
+  Options options;
+  options.maxLag = BATCH_MAX_LAG;
+  options.format = RESULTWRITER_TEXT;
+  options.manifest = NULL;
+  string manifestPath;
+  int fingerprintMode = JOBMANIFEST_MTIME;
+  string pairPath;
+  time_t first = -1;
+  time_t last = -1;
+  int threads = 0;
+
+  int option;
+  while(( option = getopt( argc, argv, "d:o:s:e:p:j:l:bm:H" )) != -1 ) {
+    switch( option ) {
+      case 'd': options.dataDirectory = optarg; break;
+      case 'o': options.resultDirectory = optarg; break;
+      case 's': first = parseDate( optarg ); break;
+      case 'e': last = parseDate( optarg ); break;
+      case 'p': pairPath = optarg; break;
+      case 'j': threads = atoi( optarg ); break;
+      case 'l': options.maxLag = atoi( optarg ); break;
+      case 'b': options.format = RESULTWRITER_BINARY; break;
+      case 'm': manifestPath = optarg; break;
+      case 'H': fingerprintMode = JOBMANIFEST_CONTENT; break;
+      default: usage(); return 2;
+    }
+  }
+  if( options.dataDirectory.empty() || options.resultDirectory.empty()
+      || pairPath.empty() || first < 0 || last < first
+      || options.maxLag < 0 )
+  {
+    usage();
+    return 2;
+  }
+
+  std::vector<PairSpec> pairs;
+  if( !readPairs( pairPath, pairs ) || pairs.empty() ) {
+    return 2;
+  }
+  mkdir( options.resultDirectory.c_str(), 0755 );
+  JobManifest* manifest = NULL;
+  if( !manifestPath.empty() ) {
+    manifest = new JobManifest( manifestPath, fingerprintMode );
+    if( !manifest->load() ) {
+      delete manifest;
+      return 2;
+    }
+    options.manifest = manifest;
+  }
+
+  // a day file per source and day that some pair reads
+  std::vector<DayFile*> files;
+  std::vector<PairJob*> jobs;
+  int current = 0;
+  for( time_t day = first; day <= last; day += 24 * 60 * 60 ) {
+    char date[ 16 ];
+    strftime( date, sizeof( date ), "%Y%m%d", gmtime( &day ));
+    size_t dayStart = files.size();
+    for( size_t p = 0; p < pairs.size(); p++ ) {
+      DayFile* pairFiles[2] = { NULL, NULL };
+      const Source* pairSources[2] = { pairs[p].sourceA, pairs[p].sourceB };
+      string dataPaths[2];
+      for( int side = 0; side < 2; side++ ) {
+        char name[ 64 ];
+        snprintf( name, sizeof( name ), pairSources[side]->pattern, date );
+        dataPaths[side] = options.dataDirectory + "/" + name;
+      }
+
+      // a current result needs neither the correlation nor its files
+      string output = resultPath( options, pairs[p], date );
+      uint64_t signature = 0;
+      if( manifest != NULL ) {
+        struct stat outputStat;
+        signature = resultSignature( manifest, options, pairs[p],
+                                     dataPaths[0], dataPaths[1] );
+        if( manifest->isCurrent( output, signature )
+            && stat( output.c_str(), &outputStat ) == 0 )
+        {
+          current++;
+          continue;
+        }
+      }
+
+      for( int side = 0; side < 2; side++ ) {
+        for( size_t f = dayStart; f < files.size(); f++ ) {
+          if( files[f]->source == pairSources[side] ) {
+            pairFiles[side] = files[f];
+          }
+        }
+        if( pairFiles[side] == NULL ) {
+          DayFile* file = new DayFile();
+          file->source = pairSources[side];
+          file->path = dataPaths[side];
+          file->parser = NULL;
+          file->users = 0;
+          pthread_mutex_init( &file->lock, NULL );
+          files.push_back( file );
+          pairFiles[side] = file;
+        }
+      }
+
+      PairJob* job = new PairJob();
+      job->options = &options;
+      job->spec = &pairs[p];
+      job->date = date;
+      job->output = output;
+      job->signature = signature;
+      job->fileA = pairFiles[0];
+      job->fileB = pairFiles[1];
+      job->waiting = 2;
+      job->written = false;
+      for( int side = 0; side < 2; side++ ) {
+        pairFiles[side]->users++;
+        pairFiles[side]->dependents.push_back( job );
+      }
+      jobs.push_back( job );
+    }
+  }
+
+  {
+    TaskPool pool( threads );
+    for( size_t f = 0; f < files.size(); f++ ) {
+      pool.submit( parseTask, files[f] );
+    }
+    pool.wait();
+  }
+
+  int written = 0;
+  for( size_t j = 0; j < jobs.size(); j++ ) {
+    written += jobs[j]->written ? 1 : 0;
+    delete jobs[j];
+  }
+  for( size_t f = 0; f < files.size(); f++ ) {
+    pthread_mutex_destroy( &files[f]->lock );
+    delete files[f];
+  }
+  cout << written << " of " << jobs.size() << " correlations written from "
+       << files.size() << " data files";
+  if( manifest != NULL ) {
+    cout << ", " << current << " already current";
+  }
+  cout << "." << endl;
+
+  bool saved = manifest == NULL || manifest->save();
+  delete manifest;
+  return written == (int)jobs.size() && saved ? 0 : 1;
+}// end int main( int, char** )
@@ -0,0 +1,392 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    --Bytes after the last gzip member that do not begin another
+ *             member are ignored with a warning, as gzip -d does.
+ *
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/decompressBuf.h>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+#ifdef CRSCORR_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+//----< (DE)(CON)STRUCTORS >----------------------------------------------------
+DecompressBuf::DecompressBuf( const string file,
+                              const int format,
+                              const size_t chunkSize,
+                              const int chunkCount )
+  : fileName( file ),
+    format( format ),
+    chunkSize( chunkSize > 0 ? chunkSize : DECOMPRESS_CHUNK_SIZE ),
+    chunkCount( chunkCount > 1 ? chunkCount : 2 )
+{
+  LOG_DEBUG( 7, "( " << file << ", " << format << ", " << chunkSize \
+                << ", " << chunkCount << " )" )
+
+  filled = 0;
+  readIndex = -1;
+  writeIndex = 0;
+  finished = false;
+  stopping = false;
+  failed = false;
+  started = false;
+  setg( NULL, NULL, NULL );
+
+  pthread_mutex_init( &lock, NULL );
+  pthread_cond_init( &chunkReady, NULL );
+  pthread_cond_init( &chunkFree, NULL );
+
+  chunks = new Chunk[ this->chunkCount ];
+  for( int i = 0; i < this->chunkCount; i++ ) {
+    chunks[i].bytes = new char[ this->chunkSize ];
+    chunks[i].count = 0;
+  }
+
+#ifndef CRSCORR_HAVE_ZSTD
+  if( format == COMPRESSION_ZSTD ) {
+    LOG_ERR( "Built without zstd support: " << fileName )
+    failed = true;
+    finished = true;
+    return;
+  }
+#endif
+
+  // open the file here so failures are visible to the caller at once
+  int fileHandle = open( fileName.c_str(), O_RDONLY );
+  if( fileHandle < 0 ) {
+    LOG_ERR( "Unable to open " << fileName << ": " << strerror( errno ))
+    failed = true;
+    finished = true;
+    return;
+  }
+
+  // the thread owns the descriptor from here on
+  fileDescriptor = fileHandle;
+  if( pthread_create( &thread, NULL, DecompressBuf::run, this ) != 0 ) {
+    LOG_ERR( "Unable to start decompression thread." )
+    close( fileHandle );
+    failed = true;
+    finished = true;
+    return;
+  }
+  started = true;
+}// end DecompressBuf::DecompressBuf( const string, const int, ... )
+
+
+DecompressBuf::~DecompressBuf() {
+  LOG_DEBUG( 7, "()" )
+
+  // release the thread if it is waiting on a full ring
+  pthread_mutex_lock( &lock );
+  stopping = true;
+  pthread_cond_broadcast( &chunkFree );
+  pthread_mutex_unlock( &lock );
+  if( started ) {
+    pthread_join( thread, NULL );
+  }
+
+  for( int i = 0; i < chunkCount; i++ ) {
+    delete[] chunks[i].bytes;
+  }
+  delete[] chunks;
+  chunks = NULL;
+
+  pthread_cond_destroy( &chunkFree );
+  pthread_cond_destroy( &chunkReady );
+  pthread_mutex_destroy( &lock );
+}// end DecompressBuf::~DecompressBuf()
+
+//----< ACCESSOR METHODS >------------------------------------------------------
+const bool DecompressBuf::good() {
+  pthread_mutex_lock( &lock );
+  bool isGood = !failed;
+  pthread_mutex_unlock( &lock );
+
+  return isGood;
+}// end const bool DecompressBuf::good()
+
+//----< STREAMBUF METHODS >-----------------------------------------------------
+DecompressBuf::int_type DecompressBuf::underflow() {
+  if( gptr() < egptr() ) {
+    return traits_type::to_int_type( *gptr() );
+  }
+
+  pthread_mutex_lock( &lock );
+
+  // hand the consumed chunk back to the thread
+  if( readIndex >= 0 ) {
+    readIndex = -1;
+    pthread_cond_signal( &chunkFree );
+  }
+
+  while( filled == 0 && !finished ) {
+    pthread_cond_wait( &chunkReady, &lock );
+  }
+  if( filled == 0 ) {
+    pthread_mutex_unlock( &lock );
+    setg( NULL, NULL, NULL );
+    return traits_type::eof();
+  }
+
+  // take the oldest filled chunk
+  readIndex = ( writeIndex - filled + chunkCount ) % chunkCount;
+  filled--;
+  pthread_mutex_unlock( &lock );
+
+  Chunk* chunk = &chunks[ readIndex ];
+  setg( chunk->bytes, chunk->bytes, chunk->bytes + chunk->count );
+  return traits_type::to_int_type( *gptr() );
+}// end DecompressBuf::int_type DecompressBuf::underflow()
+
+//----< THREAD METHODS >--------------------------------------------------------
+void* DecompressBuf::run( void* buffer ) {
+  DecompressBuf* self = (DecompressBuf*)buffer;
+  LOG_DEBUG( 7, "( " << self->fileName << " )" )
+
+  bool success;
+  if( self->format == COMPRESSION_ZSTD ) {
+    success = self->inflateZstd( self->fileDescriptor );
+  } else {
+    success = self->inflateGzip( self->fileDescriptor );
+  }
+  close( self->fileDescriptor );
+
+  pthread_mutex_lock( &self->lock );
+  self->finished = true;
+  if( !success ) {
+    self->failed = true;
+  }
+  pthread_cond_broadcast( &self->chunkReady );
+  pthread_mutex_unlock( &self->lock );
+
+  return NULL;
+}// end void* DecompressBuf::run( void* )
+
+
+DecompressBuf::Chunk* DecompressBuf::acquireChunk() {
+  pthread_mutex_lock( &lock );
+  while( !stopping
+         && filled + ( readIndex >= 0 ? 1 : 0 ) >= chunkCount )
+  {
+    pthread_cond_wait( &chunkFree, &lock );
+  }
+  Chunk* chunk = stopping ? NULL : &chunks[ writeIndex ];
+  pthread_mutex_unlock( &lock );
+
+  if( chunk != NULL ) {
+    chunk->count = 0;
+  }
+  return chunk;
+}// end DecompressBuf::Chunk* DecompressBuf::acquireChunk()
+
+
+void DecompressBuf::publishChunk() {
+  pthread_mutex_lock( &lock );
+  filled++;
+  writeIndex = ( writeIndex + 1 ) % chunkCount;
+  pthread_cond_signal( &chunkReady );
+  pthread_mutex_unlock( &lock );
+}// end void DecompressBuf::publishChunk()
+
+
+const bool DecompressBuf::inflateGzip( int file ) {
+  LOG_DEBUG( 7, "( " << file << " )" )
+
+  z_stream stream;
+  memset( &stream, 0, sizeof( stream ));
+  // 15 + 32: largest window, accept both gzip and zlib headers
+  if( inflateInit2( &stream, 15 + 32 ) != Z_OK ) {
+    LOG_ERR( "Unable to initialize zlib." )
+    return false;
+  }
+
+  // one spare byte lets a split gzip magic be joined to the next read
+  char* input = new char[ chunkSize + 1 ];
+  Chunk* output = acquireChunk();
+  bool success = true;
+  bool inMember = false;            // inside an unfinished gzip member
+  int members = 0;                  // gzip members finished
+  if( output != NULL ) {
+    stream.next_out = (Bytef*)output->bytes;
+    stream.avail_out = chunkSize;
+  }
+
+  while( output != NULL ) {
+    // refill the input
+    if( stream.avail_in == 0 ) {
+      ssize_t count = read( file, input, chunkSize );
+      if( count < 0 ) {
+        LOG_ERR( "Read failed on " << fileName << ": " << strerror( errno ))
+        success = false;
+        break;
+      } else if( count == 0 ) {
+        if( inMember ) {
+          LOG_ERR( "Truncated gzip file: " << fileName )
+          success = false;
+        }
+        break;
+      }
+      stream.next_in = (Bytef*)input;
+      stream.avail_in = count;
+    }
+
+    // after a member only another member may follow; stop at anything else
+    if( !inMember && members > 0 ) {
+      if( stream.avail_in == 1 && stream.next_in[0] == 0x1f ) {
+        // the second magic byte is in the next read
+        input[0] = 0x1f;
+        ssize_t count = read( file, input + 1, chunkSize );
+        if( count < 0 ) {
+          LOG_ERR( "Read failed on " << fileName << ": " << strerror( errno ))
+          success = false;
+          break;
+        }
+        stream.next_in = (Bytef*)input;
+        stream.avail_in = 1 + count;
+      }
+      if( stream.next_in[0] != 0x1f || stream.avail_in < 2
+          || stream.next_in[1] != 0x8b )
+      {
+        LOG_ERR( "Warning: trailing garbage ignored in " << fileName )
+        break;
+      }
+    }
+
+    inMember = true;
+    int result = inflate( &stream, Z_NO_FLUSH );
+    if( result == Z_STREAM_END ) {
+      // concatenated members are legal gzip; start on the next one
+      inMember = false;
+      members++;
+      inflateReset( &stream );
+    } else if( result != Z_OK && result != Z_BUF_ERROR ) {
+      LOG_ERR( "Corrupt gzip data in " << fileName << ": " \
+               << ( stream.msg != NULL ? stream.msg : "unknown" ))
+      success = false;
+      break;
+    }
+
+    // pass full chunks to the reader
+    if( stream.avail_out == 0 ) {
+      output->count = chunkSize;
+      publishChunk();
+      output = acquireChunk();
+      if( output != NULL ) {
+        stream.next_out = (Bytef*)output->bytes;
+        stream.avail_out = chunkSize;
+      }
+    }
+  }
+
+  // publish whatever remains
+  if( output != NULL && stream.avail_out < chunkSize ) {
+    output->count = chunkSize - stream.avail_out;
+    publishChunk();
+  }
+
+  inflateEnd( &stream );
+  delete[] input;
+  return success;
+}// end const bool DecompressBuf::inflateGzip( int )
+
+
+const bool DecompressBuf::inflateZstd( int file ) {
+  LOG_DEBUG( 7, "( " << file << " )" )
+
+#ifdef CRSCORR_HAVE_ZSTD
+  ZSTD_DStream* stream = ZSTD_createDStream();
+  if( stream == NULL ) {
+    LOG_ERR( "Unable to initialize zstd." )
+    return false;
+  }
+  ZSTD_initDStream( stream );
+
+  char* inputBytes = new char[ chunkSize ];
+  ZSTD_inBuffer input = { inputBytes, 0, 0 };
+  Chunk* output = acquireChunk();
+  ZSTD_outBuffer outBuffer = { NULL, chunkSize, 0 };
+  if( output != NULL ) {
+    outBuffer.dst = output->bytes;
+  }
+  bool success = true;
+  size_t pending = 0;               // nonzero while a frame is unfinished
+
+  while( output != NULL ) {
+    if( input.pos == input.size ) {
+      ssize_t count = read( file, inputBytes, chunkSize );
+      if( count < 0 ) {
+        LOG_ERR( "Read failed on " << fileName << ": " << strerror( errno ))
+        success = false;
+        break;
+      } else if( count == 0 ) {
+        if( pending != 0 ) {
+          LOG_ERR( "Truncated zstd file: " << fileName )
+          success = false;
+        }
+        break;
+      }
+      input.size = count;
+      input.pos = 0;
+    }
+
+    pending = ZSTD_decompressStream( stream, &outBuffer, &input );
+    if( ZSTD_isError( pending )) {
+      LOG_ERR( "Corrupt zstd data in " << fileName << ": " \
+               << ZSTD_getErrorName( pending ))
+      success = false;
+      break;
+    }
+
+    if( outBuffer.pos == outBuffer.size ) {
+      output->count = chunkSize;
+      publishChunk();
+      output = acquireChunk();
+      if( output != NULL ) {
+        outBuffer.dst = output->bytes;
+        outBuffer.pos = 0;
+      }
+    }
+  }
+
+  if( output != NULL && outBuffer.pos > 0 ) {
+    output->count = outBuffer.pos;
+    publishChunk();
+  }
+
+  ZSTD_freeDStream( stream );
+  delete[] inputBytes;
+  return success;
+#else
+  LOG_ERR( "Built without zstd support." )
+  return false;
+#endif
+}// end const bool DecompressBuf::inflateZstd( int )
+
+//----< UTILITIES >-------------------------------------------------------------
+const int DecompressBuf::detectFormat( const string file ) {
+  LOG_DEBUG( 7, "( " << file << " )" )
+
+  unsigned char magic[4];
+  int fileHandle = open( file.c_str(), O_RDONLY );
+  if( fileHandle < 0 ) {
+    return COMPRESSION_NONE;
+  }
+  ssize_t count = read( fileHandle, magic, sizeof( magic ));
+  close( fileHandle );
+
+  if( count >= 2 && magic[0] == 0x1f && magic[1] == 0x8b ) {
+    return COMPRESSION_GZIP;
+  } else if( count == 4 && magic[0] == 0x28 && magic[1] == 0xb5
+             && magic[2] == 0x2f && magic[3] == 0xfd )
+  {
+    return COMPRESSION_ZSTD;
+  }
+  return COMPRESSION_NONE;
+}// end static const int DecompressBuf::detectFormat( const string )
@@ -0,0 +1,109 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Moved the rank window to RankWindow, shared with RollingStats.
+ *
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/despike.h>
+#include <crsCorr/rankWindow.h>
+#include <cmath>
+#include <cstring>
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+/*
+ * k-th smallest absolute deviation from median, k from 1. The window's
+ *   values of order 1 through split lie at or below the median, so read
+ *   downward from split their deviations ascend, as do those of the values
+ *   above split read upward; the k-th of the two merged runs is found by
+ *   bisecting how many come from the lower run.
+ */
+static double selectDeviation( const RankWindow& window,
+                               const double median,
+                               const int split,
+                               const int k )
+{
+  const int lowerCount = split;
+  const int upperCount = window.getSize() - split;
+  int lo = k - upperCount > 0 ? k - upperCount : 0;
+  int hi = k < lowerCount ? k : lowerCount;
+  while( lo < hi ) {
+    int fromLower = ( lo + hi ) / 2;
+    double nextLower = median - window.select( split - fromLower );
+    double lastUpper = window.select( split + k - fromLower ) - median;
+    if( nextLower < lastUpper ) {
+      lo = fromLower + 1;
+    } else {
+      hi = fromLower;
+    }
+  }
+
+  double deviation = 0.0;
+  if( lo > 0 ) {
+    deviation = median - window.select( split - lo + 1 );
+  }
+  if( k - lo > 0 ) {
+    double upper = window.select( split + k - lo ) - median;
+    deviation = upper > deviation ? upper : deviation;
+  }
+  return deviation;
+}// end static double selectDeviation( const RankWindow&, ... )
+
+//----< DESPIKING >-------------------------------------------------------------
+const int Despike::hampel( const double* values,
+                           const uint64_t* validity,
+                           const int count,
+                           const int halfWidth,
+                           const double threshold,
+                           uint64_t* spikes,
+                           double* medians )
+{
+  LOG_DEBUG( 12, "( values, validity, " << count << ", " << halfWidth \
+                 << ", " << threshold << " )" )
+
+  if( values == NULL || spikes == NULL || count < 0 || halfWidth < 1
+      || !( threshold > 0.0 ))
+  {
+    LOG_ERR( "Bad Hampel parameters: " << count << " samples, half width " \
+             << halfWidth << ", threshold " << threshold )
+    return -1;
+  }
+  memset( spikes, 0, (( count + 63 ) / 64 ) * sizeof( uint64_t ));
+
+  RankWindow window( values, validity, count );
+  for( int i = 0; i < halfWidth && i < count; i++ ) {
+    window.insert( i );
+  }
+
+  int found = 0;
+  for( int i = 0; i < count; i++ ) {
+    window.insert( i + halfWidth );
+    window.remove( i - halfWidth - 1 );
+    const int n = window.getSize();
+    if( !window.isRanked( i ) || n < 3 ) {
+      continue;
+    }
+
+    // median, and the MAD from the middle two deviations when n is even
+    const int split = ( n + 1 ) / 2;
+    double median = window.select( split );
+    if( n % 2 == 0 ) {
+      median = ( median + window.select( split + 1 )) / 2.0;
+    }
+    double mad = selectDeviation( window, median, split, split );
+    if( n % 2 == 0 ) {
+      mad = ( mad + selectDeviation( window, median, split, split + 1 )) / 2.0;
+    }
+
+    double limit = threshold * DESPIKE_MAD_SCALE * mad;
+    if( limit > 0.0 && fabs( values[i] - median ) > limit ) {
+      spikes[ i >> 6 ] |= (uint64_t)1 << ( i & 63 );
+      if( medians != NULL ) {
+        medians[i] = median;
+      }
+      found++;
+    }
+  }
+  return found;
+}// end static const int Despike::hampel( const double*, ... )
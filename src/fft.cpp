@@ -0,0 +1,219 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Added plans, Bluestein transforms, and realTransform.
+ *
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/fft.h>
+#include <cmath>
+
+std::map<int, Fft::Plan*> Fft::plans;
+pthread_mutex_t Fft::planLock = PTHREAD_MUTEX_INITIALIZER;
+
+//----< PLANS >-----------------------------------------------------------------
+const Fft::Plan* Fft::getPlan( const int n ) {
+  LOG_DEBUG( 14, "( " << n << " )" )
+
+  pthread_mutex_lock( &planLock );
+  std::map<int, Plan*>::iterator found = plans.find( n );
+  if( found != plans.end() ) {
+    Plan* plan = found->second;
+    pthread_mutex_unlock( &planLock );
+    return plan;
+  }
+  pthread_mutex_unlock( &planLock );
+
+  // built unlocked, since a Bluestein plan needs the plan of its padding
+  Plan* plan = new Plan;
+  plan->n = n;
+  plan->padded = 0;
+  plan->twiddles.resize( n / 2 );
+  for( int k = 0; k < n / 2; k++ ) {
+    double angle = -2.0 * M_PI * k / n;
+    plan->twiddles[k] = std::complex<double>( cos( angle ), sin( angle ));
+  }
+
+  if(( n & ( n - 1 )) == 0 ) {
+    plan->reversal.resize( n );
+    for( int i = 0, j = 0; i < n; i++ ) {
+      plan->reversal[i] = j;
+      int bit = n >> 1;
+      for( ; j & bit; bit >>= 1 ) {
+        j ^= bit;
+      }
+      j ^= bit;
+    }
+  } else {
+    // k^2 is reduced modulo 2n so large lengths keep their angles exact
+    plan->padded = getSize( 2 * n - 1 );
+    plan->chirp.resize( n );
+    for( int k = 0; k < n; k++ ) {
+      double angle = -M_PI * (double)(( (long long)k * k ) % ( 2 * n )) / n;
+      plan->chirp[k] = std::complex<double>( cos( angle ), sin( angle ));
+    }
+    plan->chirpSpectrum.assign( plan->padded, 0.0 );
+    plan->chirpSpectrum[0] = std::conj( plan->chirp[0] );
+    for( int k = 1; k < n; k++ ) {
+      plan->chirpSpectrum[k] = std::conj( plan->chirp[k] );
+      plan->chirpSpectrum[ plan->padded - k ] = std::conj( plan->chirp[k] );
+    }
+    radix2( &plan->chirpSpectrum[0], getPlan( plan->padded ), false );
+  }
+
+  pthread_mutex_lock( &planLock );
+  found = plans.find( n );
+  if( found != plans.end() ) {
+    delete plan;
+    plan = found->second;
+  } else {
+    plans[n] = plan;
+  }
+  pthread_mutex_unlock( &planLock );
+  return plan;
+}// end static const Fft::Plan* Fft::getPlan( const int )
+
+
+const int Fft::getPlanCount() {
+  pthread_mutex_lock( &planLock );
+  int count = plans.size();
+  pthread_mutex_unlock( &planLock );
+  return count;
+}// end static const int Fft::getPlanCount()
+
+//----< TRANSFORMS >------------------------------------------------------------
+const int Fft::getSize( const int minLength ) {
+  LOG_DEBUG( 14, "( " << minLength << " )" )
+
+  int n = 1;
+  while( n < minLength ) {
+    n <<= 1;
+  }
+  return n;
+}// end const int Fft::getSize( const int )
+
+
+void Fft::radix2( std::complex<double>* values,
+                  const Plan* plan,
+                  const bool inverse )
+{
+  const int n = plan->n;
+  for( int i = 1; i < n; i++ ) {
+    int j = plan->reversal[i];
+    if( i < j ) {
+      std::swap( values[i], values[j] );
+    }
+  }
+
+  // span s reads every ( n / s )-th twiddle of the full length table
+  for( int span = 2; span <= n; span <<= 1 ) {
+    const int half = span / 2;
+    const int stride = n / span;
+    for( int block = 0; block < n; block += span ) {
+      for( int k = 0; k < half; k++ ) {
+        std::complex<double> twiddle = plan->twiddles[ k * stride ];
+        if( inverse ) {
+          twiddle = std::conj( twiddle );
+        }
+        std::complex<double> even = values[ block + k ];
+        std::complex<double> odd = values[ block + k + half ] * twiddle;
+        values[ block + k ] = even + odd;
+        values[ block + k + half ] = even - odd;
+      }
+    }
+  }
+}// end static void Fft::radix2( std::complex<double>*, const Plan*, ... )
+
+
+void Fft::bluestein( std::complex<double>* values,
+                     const Plan* plan,
+                     const bool inverse )
+{
+  // X[k] = chirp[k] * sum_j ( x[j] chirp[j] ) conj( chirp[k - j] ); the
+  //   inverse conjugates its input and output around the forward transform
+  const int n = plan->n;
+  const int padded = plan->padded;
+  const Plan* inner = getPlan( padded );
+  std::vector< std::complex<double> > work( padded, 0.0 );
+  for( int k = 0; k < n; k++ ) {
+    work[k] = ( inverse ? std::conj( values[k] ) : values[k] ) * plan->chirp[k];
+  }
+  radix2( &work[0], inner, false );
+  for( int k = 0; k < padded; k++ ) {
+    work[k] *= plan->chirpSpectrum[k];
+  }
+  radix2( &work[0], inner, true );
+  for( int k = 0; k < n; k++ ) {
+    std::complex<double> value = work[k] * plan->chirp[k] / (double)padded;
+    values[k] = inverse ? std::conj( value ) : value;
+  }
+}// end static void Fft::bluestein( std::complex<double>*, const Plan*, ... )
+
+
+void Fft::transform( std::complex<double>* values,
+                     const int n,
+                     const bool inverse )
+{
+  LOG_DEBUG( 14, "( values, " << n << ", " << inverse << " )" )
+
+  if( n <= 1 ) {
+    if( n < 0 ) {
+      LOG_ERR( "Transform length " << n << " is negative." )
+    }
+    return;
+  }
+
+  const Plan* plan = getPlan( n );
+  if( plan->padded == 0 ) {
+    radix2( values, plan, inverse );
+  } else {
+    bluestein( values, plan, inverse );
+  }
+
+  if( inverse ) {
+    for( int i = 0; i < n; i++ ) {
+      values[i] /= n;
+    }
+  }
+}// end void Fft::transform( std::complex<double>*, const int, const bool )
+
+
+void Fft::realTransform( const double* values,
+                         const int n,
+                         std::complex<double>* bins )
+{
+  LOG_DEBUG( 14, "( values, " << n << ", bins )" )
+
+  if( n <= 0 ) {
+    LOG_ERR( "Transform length " << n << " is not positive." )
+    return;
+  } else if( n % 2 == 1 ) {
+    std::vector< std::complex<double> > work( values, values + n );
+    transform( &work[0], n );
+    for( int k = 0; k <= n / 2; k++ ) {
+      bins[k] = work[k];
+    }
+    return;
+  }
+
+  // even samples in the real part, odd in the imaginary, then untangled:
+  //   X[k] = E[k] + e^( -2 pi i k / n ) O[k]
+  const int half = n / 2;
+  std::vector< std::complex<double> > packed( half );
+  for( int j = 0; j < half; j++ ) {
+    packed[j] = std::complex<double>( values[ 2 * j ], values[ 2 * j + 1 ] );
+  }
+  transform( &packed[0], half );
+
+  const Plan* plan = getPlan( n );
+  for( int k = 0; k <= half; k++ ) {
+    std::complex<double> z = packed[ k % half ];
+    std::complex<double> mirror = std::conj( packed[ ( half - k ) % half ] );
+    std::complex<double> even = ( z + mirror ) * 0.5;
+    std::complex<double> odd = ( z - mirror ) * std::complex<double>( 0.0, -0.5 );
+    std::complex<double> twiddle = k < half ? plan->twiddles[k]
+                                            : std::complex<double>( -1.0, 0.0 );
+    bins[k] = even + twiddle * odd;
+  }
+}// end static void Fft::realTransform( const double*, const int, ... )
@@ -1,4 +1,42 @@
 /*
+ * Modified: 10/19/26
+ * Notes:    --The parameterized constructor may leave the file unopened
+ *
+ * Modified: 10/19/26
+ * Notes:    --initGrid takes a day count; added getStampCell, placeMeans, and
+ *             placeStampedRows
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added the despiking stage (despikeSeriesData, setDespikeMode)
+ *
+ * Modified: 10/19/26
+ * Notes:    --Sidecar values are encoded with SeriesCodec (setCacheEncoding)
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added initGrid and getGridCell for timestamp driven placement.
+ *             Padding added by finalizeSeriesData is marked invalid, and the
+ *             sidecar stores each series' validity bitmap.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added getTable
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added the per tag table label index (getLabelIndex, findIndex)
+ *
+ * Modified: 10/19/26
+ * Notes:    --Replaced the resample linked list with a memoizing cache with
+ *             an optional memory budget
+ *
+ * Modified: 10/19/26
+ * Notes:    --findArtifact searches with TextScan::findString
+ *
+ * Modified: 10/19/26
+ * Notes:    --Data files are opened through openStream(), which handles
+ *             compressed files
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added the sidecar cache (loadFile, loadCache, storeCache)
+ *
  * Modified: 08/19/10
  * Notes:    --Added findArtifact function to help with locating significant
  *             markings in a datafile
@@ -16,10 +54,63 @@
  */
 
 #include <crsCorr/fileParser.h>
+#include <crsCorr/textScan.h>
 #include <cstring>
+#include <cmath>
+#include <cstdio>
 #include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
 
 //----< CONSTANTS >-------------------------------------------------------------
+size_t FileParser::streamChunkSize = DECOMPRESS_CHUNK_SIZE;
+int FileParser::streamChunkCount = DECOMPRESS_CHUNK_COUNT;
+size_t FileParser::resampleBudget = 0;
+FileParser::LabelIndexes FileParser::labelIndexes;
+pthread_mutex_t FileParser::labelIndexLock = PTHREAD_MUTEX_INITIALIZER;
+bool FileParser::caching = true;
+string FileParser::cacheDirectory;
+int FileParser::cacheEncoding = SERIESCODEC_PACKED;
+int FileParser::despikeMode = DESPIKE_FLAG;
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+/*
+ * FNV-1a hash used for both the schema hash and the sidecar checksum.
+ */
+static unsigned int fnvHash( const void* bytes,
+                             const size_t count,
+                             unsigned int hash = 2166136261u )
+{
+  const unsigned char* byte = (const unsigned char*)bytes;
+  for( size_t i = 0; i < count; i++ ) {
+    hash ^= byte[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}// end static unsigned int fnvHash( const void*, const size_t, ... )
+
+/*
+ * Appends the raw bytes of a value to a byte buffer.
+ */
+template<typename ValueType>
+static void putValue( string& buffer, const ValueType value ) {
+  buffer.append( (const char*)&value, sizeof( ValueType ));
+}// end static void putValue( string&, const ValueType )
+
+/*
+ * Reads a value from the byte buffer and advances the position. Returns false
+ *   if the buffer does not hold enough bytes.
+ */
+template<typename ValueType>
+static bool getValue( const string& buffer, size_t& pos, ValueType& value ) {
+  if( pos + sizeof( ValueType ) > buffer.size() ) {
+    return false;
+  }
+  memcpy( &value, buffer.data() + pos, sizeof( ValueType ));
+  pos += sizeof( ValueType );
+  return true;
+}// end static bool getValue( const string&, size_t&, ValueType& )
 
 
 
@@ -37,6 +128,75 @@ const FileParser::DataTag* const FileParser::getTags() const {
   return dataTags;
 }// end const FileParser::DataTag* const FileParser::getTags()
 
+const string& FileParser::getFileName() const {
+  LOG_DEBUG( 7, "()" )
+
+  return localFileName;
+}// end const string& FileParser::getFileName() const
+
+
+void FileParser::setCaching( const bool enabled ) {
+  LOG_DEBUG( 7, "( " << enabled << " )" )
+
+  caching = enabled;
+}// end void FileParser::setCaching( const bool )
+
+
+void FileParser::setCacheDirectory( const string directory ) {
+  LOG_DEBUG( 7, "( " << directory << " )" )
+
+  cacheDirectory = directory;
+}// end void FileParser::setCacheDirectory( const string )
+
+
+void FileParser::setCacheEncoding( const int encoding ) {
+  LOG_DEBUG( 7, "( " << encoding << " )" )
+
+  if( encoding != SERIESCODEC_RAW && encoding != SERIESCODEC_PACKED ) {
+    LOG_ERR( "Unknown cache encoding " << encoding )
+    return;
+  }
+  cacheEncoding = encoding;
+}// end void FileParser::setCacheEncoding( const int )
+
+
+void FileParser::setDespikeMode( const int mode ) {
+  LOG_DEBUG( 7, "( " << mode << " )" )
+
+  if( mode != DESPIKE_OFF && mode != DESPIKE_FLAG && mode != DESPIKE_REPLACE ) {
+    LOG_ERR( "Unknown despike mode " << mode )
+    return;
+  }
+  despikeMode = mode;
+}// end void FileParser::setDespikeMode( const int )
+
+void FileParser::setStreamBuffers( const size_t chunkSize,
+                                  const int chunkCount )
+{
+  LOG_DEBUG( 7, "( " << chunkSize << ", " << chunkCount << " )" )
+
+  if( chunkSize == 0 || chunkCount < 2 ) {
+    LOG_ERR( "Chunk size must be positive with at least two chunks." )
+    return;
+  }
+  streamChunkSize = chunkSize;
+  streamChunkCount = chunkCount;
+}// end void FileParser::setStreamBuffers( const size_t, const int )
+
+
+void FileParser::setResampleBudget( const size_t bytes ) {
+  LOG_DEBUG( 7, "( " << bytes << " )" )
+
+  resampleBudget = bytes;
+}// end void FileParser::setResampleBudget( const size_t )
+
+
+const size_t FileParser::getResampleBytes() const {
+  LOG_DEBUG( 7, "()" )
+
+  return resampleBytes;
+}// end const size_t FileParser::getResampleBytes() const
+
 //----< (DE)(CON)STRUCTORS >----------------------------------------------------
 FileParser::FileParser()
   : localFileName( "EMPTY" ),
@@ -46,29 +206,44 @@ FileParser::FileParser()
 
   length = 0;
   dataStream = NULL;
+  decompressBuf = NULL;
+  streamBuffer = NULL;
+  streamOpen = false;
   data = NULL;
-  resamples = NULL;
-  resamplesEnd = NULL;
+  labelIndex = NULL;
+  table = NULL;
+  resampleBytes = 0;
+  resampleClock = 0;
 }// end FileParser::FileParser()
 
 
 FileParser::FileParser( string fileName,
-                        const DataTag* const dataTags )
+                        const DataTag* const dataTags,
+                        const bool openFile )
   : localFileName( fileName ),
     dataTags( dataTags )
 {
-  LOG_DEBUG( 8, "( " << fileName << ", labelSet )" )
+  LOG_DEBUG( 8, "( " << fileName << ", labelSet, " << openFile << " )" )
 
   length = 0;
   while( dataTags[(length++) + 1 ].type != DATATYPE_END );
 
-  dataStream = new std::ifstream( localFileName.c_str() );
+  if( openFile ) {
+    openStream();
+  } else {
+    dataStream = NULL;
+    decompressBuf = NULL;
+    streamBuffer = NULL;
+    streamOpen = false;
+  }
   data = NULL;
-  resamples = NULL;
-  resamplesEnd = NULL;
+  labelIndex = getLabelIndex( dataTags, length );
+  table = NULL;
+  resampleBytes = 0;
+  resampleClock = 0;
 
   initDataSeries();
-}// end FileParser::FileParser( std::ifstream, int, const char* [] )
+}// end FileParser::FileParser( string, const DataTag* const, const bool )
 
 
 FileParser::FileParser( const FileParser& copy )
@@ -79,7 +254,11 @@ FileParser::FileParser( const FileParser& copy )
 
   data = NULL;
   length = copy.length;
-  dataStream = new std::ifstream( localFileName.c_str() );
+  labelIndex = copy.labelIndex;
+  table = NULL;
+  resampleBytes = 0;
+  resampleClock = 0;
+  openStream();
   copyDataSeries( &data, copy.data, copy.length );
 }// end FileParser::FileParser( const FileParser& )
 
@@ -89,10 +268,17 @@ FileParser::~FileParser() {
 
   // clean up the data stream
   if( dataStream != NULL ) {
-    dataStream->close();
     delete dataStream;
     dataStream = NULL;
   }
+  if( decompressBuf != NULL ) {
+    delete decompressBuf;
+    decompressBuf = NULL;
+  }
+  if( streamBuffer != NULL ) {
+    delete[] streamBuffer;
+    streamBuffer = NULL;
+  }
 
   // clean up the data
   if( data != NULL ) {
@@ -106,23 +292,160 @@ FileParser::~FileParser() {
     data = NULL;
   }
 
-  // clean up any lingering resamples
-  if( resamples != NULL ) {
-    resamplesEnd = resamples->next;
-    while( resamplesEnd != NULL ) {
-      delete resamples->series;
-      delete resamples;
-      resamples = resamplesEnd;
-      resamplesEnd = resamplesEnd->next;
-    }
-    delete resamples->series;
-    delete resamples;
-    resamples = NULL;
-    resamplesEnd = NULL;
+  // clean up any lingering resamples and the table
+  clearResamples();
+  if( table != NULL ) {
+    delete table;
+    table = NULL;
   }
 }// end FileParser::~FileParser()
 
 
+//----< DATA METHODS >----------------------------------------------------------
+const SeriesTable* FileParser::getTable() {
+  LOG_DEBUG( 8, "()" )
+
+  if( table == NULL && data != NULL ) {
+    table = new SeriesTable( data, length );
+  }
+  return table;
+}// end const SeriesTable* FileParser::getTable()
+
+
+//----< LABEL INDEX >-----------------------------------------------------------
+const FileParser::LabelIndex* FileParser::getLabelIndex(
+    const DataTag* const tags,
+    const int tagCount )
+{
+  LOG_DEBUG( 8, "( tags, " << tagCount << " )" )
+
+  pthread_mutex_lock( &labelIndexLock );
+  LabelIndexes::iterator entry = labelIndexes.find( tags );
+  if( entry != labelIndexes.end() ) {
+    pthread_mutex_unlock( &labelIndexLock );
+    return entry->second;
+  }
+
+  // at most half full keeps the probe sequences short
+  unsigned int slotCount = 16;
+  while( slotCount < (unsigned int)tagCount * 2 ) {
+    slotCount *= 2;
+  }
+  LabelIndex* index = new LabelIndex;
+  index->slots = new int[ slotCount ];
+  index->mask = slotCount - 1;
+  for( unsigned int i = 0; i < slotCount; i++ ) {
+    index->slots[i] = -1;
+  }
+
+  for( int i = 0; i < tagCount; i++ ) {
+    if( tags[i].type != DATATYPE_INT && tags[i].type != DATATYPE_DOUBLE ) {
+      continue;
+    }
+    unsigned int slot = fnvHash( tags[i].label.data(),
+                                 tags[i].label.size() ) & index->mask;
+    while( index->slots[slot] >= 0
+           && tags[ index->slots[slot] ].label != tags[i].label )
+    {
+      slot = ( slot + 1 ) & index->mask;
+    }
+    if( index->slots[slot] < 0 ) {
+      index->slots[slot] = i;
+    }
+  }
+
+  labelIndexes[tags] = index;
+  pthread_mutex_unlock( &labelIndexLock );
+  return index;
+}// end static const FileParser::LabelIndex* FileParser::getLabelIndex( ... )
+
+
+const int FileParser::findIndex( const string& label ) const {
+  if( labelIndex == NULL ) {
+    return -1;
+  }
+
+  unsigned int slot = fnvHash( label.data(), label.size() ) & labelIndex->mask;
+  while( labelIndex->slots[slot] >= 0 ) {
+    if( dataTags[ labelIndex->slots[slot] ].label == label ) {
+      return labelIndex->slots[slot];
+    }
+    slot = ( slot + 1 ) & labelIndex->mask;
+  }
+  return -1;
+}// end const int FileParser::findIndex( const string& ) const
+
+
+//----< RESAMPLE CACHE >--------------------------------------------------------
+AbstractDataSeries* FileParser::findResample( const int index,
+                                              const int reso,
+                                              const int start )
+{
+  LOG_DEBUG( 8, "( " << index << ", " << reso << ", " << start << " )" )
+
+  ResampleKey key = { index, reso, start };
+  ResampleCache::iterator entry = resamples.find( key );
+  if( entry == resamples.end() ) {
+    return NULL;
+  }
+
+  entry->second.lastUse = ++resampleClock;
+  return entry->second.series;
+}// end AbstractDataSeries* FileParser::findResample( const int, ... )
+
+
+void FileParser::addResample( const int index,
+                              const int reso,
+                              const int start,
+                              AbstractDataSeries* series )
+{
+  LOG_DEBUG( 8, "( " << index << ", " << reso << ", " << start \
+                << ", series )" )
+
+  ResampleKey key = { index, reso, start };
+  Resample entry = { series,
+                     (size_t)series->getLength() * series->getValueSize(),
+                     ++resampleClock };
+  resamples[key] = entry;
+  resampleBytes += entry.bytes;
+
+  // evict the least recently requested resamples until within budget
+  while( resampleBudget > 0
+         && resampleBytes > resampleBudget
+         && resamples.size() > FILEPARSER_RESAMPLE_KEEP )
+  {
+    ResampleCache::iterator oldest = resamples.begin();
+    for( ResampleCache::iterator it = resamples.begin();
+         it != resamples.end(); it++ )
+    {
+      if( it->second.lastUse < oldest->second.lastUse ) {
+        oldest = it;
+      }
+    }
+
+    LOG_DEBUG( 7, ": Evicting resample of " \
+                  << oldest->second.series->getLabel() << " holding " \
+                  << oldest->second.bytes << " bytes" )
+    resampleBytes -= oldest->second.bytes;
+    delete oldest->second.series;
+    resamples.erase( oldest );
+  }
+}// end void FileParser::addResample( const int, const int, ... )
+
+
+void FileParser::clearResamples() {
+  LOG_DEBUG( 8, "()" )
+
+  for( ResampleCache::iterator it = resamples.begin();
+       it != resamples.end(); it++ )
+  {
+    delete it->second.series;
+  }
+  resamples.clear();
+  resampleBytes = 0;
+}// end void FileParser::clearResamples()
+
+
 //----< UTILITIES >-------------------------------------------------------------
 void FileParser::copyDataSeries( AbstractDataSeries*** store,
                      const AbstractDataSeries * const * const copy,
@@ -167,7 +490,9 @@ void FileParser::finalizeSeriesData() {
   double zeroDouble = 0.0;
   for( int i = 0; i < length; i++ ) {
     if( data[i] != NULL ) {
-      int addData = ( minutesPerDay / dataTags[i].reso ) - data[i]->getLength();
+      int validLength = data[i]->getLength();
+      int addData = ( minutesPerDay / dataTags[i].reso ) - validLength;
+      int padding = addData > 0 ? addData : 0;
       if( dataTags[i].type == DATATYPE_DOUBLE ) {
         while( addData > 0 ) {
           data[i]->addValue( &zeroDouble );
@@ -182,11 +507,186 @@ void FileParser::finalizeSeriesData() {
          //no-op, unknown data type
       }
       data[i]->finalizeData();
+
+      // the padding fills out the day but is not data
+      if( padding > 0 && data[i]->isFinal() ) {
+        data[i]->invalidate( validLength, padding );
+      }
     }
   }
+
+  despikeSeriesData();
 }// end void FileParser::finalizeDataSeries()
 
 
+void FileParser::despikeSeriesData() {
+  LOG_DEBUG( 8, "()" )
+
+  if( despikeMode == DESPIKE_OFF ) {
+    return;
+  }
+  for( int i = 0; i < length; i++ ) {
+    if( data[i] == NULL || !data[i]->isFinal()
+        || dataTags[i].despikeWindow <= 0 )
+    {
+      continue;
+    }
+    double threshold = dataTags[i].despikeThreshold > 0.0
+                       ? dataTags[i].despikeThreshold : DESPIKE_THRESHOLD;
+    int spikes = 0;
+    if( dataTags[i].type == DATATYPE_DOUBLE ) {
+      spikes = Despike::despike( *static_cast<DataSeries<double>*>( data[i] ),
+                                 dataTags[i].despikeWindow, threshold,
+                                 despikeMode );
+    } else if( dataTags[i].type == DATATYPE_INT ) {
+      spikes = Despike::despike( *static_cast<DataSeries<int>*>( data[i] ),
+                                 dataTags[i].despikeWindow, threshold,
+                                 despikeMode );
+    }
+    LOG_DEBUG( 7, ": " << spikes << " spikes in " << dataTags[i].label )
+  }
+}// end void FileParser::despikeSeriesData()
+
+
+void FileParser::initGrid( const int days ) {
+  LOG_DEBUG( 8, "( " << days << " )" )
+
+  int minutesPerDay = 60 * 24;
+  for( int i = 0; i < length; i++ ) {
+    if( data[i] != NULL ) {
+      data[i]->initGrid( days * minutesPerDay / dataTags[i].reso,
+                         dataTags[i].reso,
+                         dataTags[i].start );
+    }
+  }
+}// end void FileParser::initGrid( const int )
+
+
+const int FileParser::getGridCell( const int index, const int hourMin ) const {
+  //LOG_DEBUG( 8, "( " << index << ", " << hourMin << " )" )
+
+  if( index < 0 || index >= length || data[index] == NULL ) {
+    return -1;
+  }
+  int minutes = ( hourMin / 100 ) * 60 + hourMin % 100
+                - data[index]->getStartTime();
+  int reso = data[index]->getResolution();
+  if( minutes < 0 || hourMin % 100 >= 60 || minutes % reso != 0
+      || minutes / reso >= data[index]->getLength() )
+  {
+    return -1;
+  }
+  return minutes / reso;
+}// end const int FileParser::getGridCell( const int, const int ) const
+
+
+const int FileParser::getStampCell( const int index,
+                                    const int day,
+                                    const double seconds ) const
+{
+  if( index < 0 || index >= length || data[index] == NULL || day < 0
+      || !( seconds >= 0.0 ) || seconds >= 86400.0 )
+  {
+    return -1;
+  }
+  int minutes = day * 60 * 24 + (int)( seconds / 60.0 )
+                - data[index]->getStartTime();
+  int cell = minutes < 0 ? -1 : minutes / data[index]->getResolution();
+  return cell < data[index]->getLength() ? cell : -1;
+}// end const int FileParser::getStampCell( const int, const int, ... ) const
+
+
+void FileParser::placeMeans( const int index,
+                             const int* cells,
+                             const double* values,
+                             const int count,
+                             const int stride )
+{
+  LOG_DEBUG( 8, "( " << index << ", cells, values, " << count << ", " \
+                << stride << " )" )
+
+  if( index < 0 || index >= length || data[index] == NULL ) {
+    return;
+  }
+  const int cellCount = data[index]->getLength();
+  std::vector<double> sums( cellCount, 0.0 );
+  std::vector<int> counts( cellCount, 0 );
+  for( int i = 0; i < count; i++ ) {
+    if( cells[i] >= 0 && cells[i] < cellCount ) {
+      sums[ cells[i] ] += values[ (size_t)i * stride ];
+      counts[ cells[i] ]++;
+    }
+  }
+
+  for( int cell = 0; cell < cellCount; cell++ ) {
+    if( counts[cell] == 0 ) {
+      continue;
+    }
+    double mean = sums[cell] / counts[cell];
+    if( dataTags[index].type == DATATYPE_INT ) {
+      int value = (int)floor( mean + 0.5 );
+      data[index]->placeValue( &value, cell );
+    } else {
+      data[index]->placeValue( &mean, cell );
+    }
+  }
+}// end void FileParser::placeMeans( const int, const int*, ... )
+
+
+const bool FileParser::placeStampedRows( const std::vector<double>& rows ) {
+  LOG_DEBUG( 8, "( " << rows.size() / length << " rows )" )
+
+  const int count = rows.size() / length;
+  if( count == 0 ) {
+    initGrid();
+    return true;
+  }
+
+  int firstDay = (int)rows[0];
+  int lastDay = firstDay;
+  for( int row = 1; row < count; row++ ) {
+    int day = (int)rows[ (size_t)row * length ];
+    firstDay = day < firstDay ? day : firstDay;
+    lastDay = day > lastDay ? day : lastDay;
+  }
+  return placeStampedRows( rows, firstDay, lastDay );
+}// end const bool FileParser::placeStampedRows( const std::vector<double>& )
+
+
+const bool FileParser::placeStampedRows( const std::vector<double>& rows,
+                                         const int firstDay,
+                                         const int lastDay )
+{
+  LOG_DEBUG( 8, "( " << rows.size() / length << " rows, " << firstDay \
+                << ", " << lastDay << " )" )
+
+  const int count = rows.size() / length;
+  if( lastDay < firstDay || lastDay - firstDay >= FILEPARSER_MAX_DAYS ) {
+    LOG_ERR( "Days " << firstDay << " to " << lastDay << " do not make a " \
+             << "span of at most " << FILEPARSER_MAX_DAYS << " days." )
+    initGrid();
+    return false;
+  }
+  initGrid( lastDay - firstDay + 1 );
+  if( count == 0 ) {
+    return true;
+  }
+
+  std::vector<int> cells( count );
+  for( int i = 0; i < length; i++ ) {
+    if( data[i] == NULL ) {
+      continue;
+    }
+    for( int row = 0; row < count; row++ ) {
+      const double* values = &rows[ (size_t)row * length ];
+      cells[row] = getStampCell( i, (int)values[0] - firstDay, values[1] );
+    }
+    placeMeans( i, &cells[0], &rows[i], count, length );
+  }
+  return true;
+}// end const bool FileParser::placeStampedRows( const vector<double>&, ... )
+
+
 bool FileParser::findArtifact( const char* artifact ) {
   LOG_DEBUG( 8, "( " << artifact << " )" )
   string dataLine;
@@ -194,7 +694,10 @@ bool FileParser::findArtifact( const char* artifact ) {
 
   while( !found && dataStream->good() && !dataStream->eof() ) {
     std::getline( *dataStream, dataLine );
-    if( dataLine.find( artifact ) != string::npos ) {
+    if( TextScan::findString( dataLine.data(),
+                              dataLine.data() + dataLine.size(),
+                              artifact ) != NULL )
+    {
       found = true;
     }
   }
@@ -203,6 +706,37 @@ bool FileParser::findArtifact( const char* artifact ) {
 }// end bool FileParser::findArtifact( const char* )
 
 
+void FileParser::openStream() {
+  LOG_DEBUG( 8, "()" )
+
+  decompressBuf = NULL;
+  streamBuffer = NULL;
+
+  int format = DecompressBuf::detectFormat( localFileName );
+  if( format != COMPRESSION_NONE ) {
+    LOG_DEBUG( 7, ": Decompressing " << localFileName )
+    decompressBuf = new DecompressBuf( localFileName,
+                                       format,
+                                       streamChunkSize,
+                                       streamChunkCount );
+    dataStream = new std::istream( decompressBuf );
+    streamOpen = decompressBuf->good();
+  } else {
+    // the buffer must be installed before the file is opened
+    std::ifstream* fileStream = new std::ifstream();
+    streamBuffer = new char[ streamChunkSize ];
+    fileStream->rdbuf()->pubsetbuf( streamBuffer, streamChunkSize );
+    fileStream->open( localFileName.c_str() );
+    streamOpen = fileStream->is_open();
+    dataStream = fileStream;
+  }
+
+  if( !streamOpen ) {
+    dataStream->setstate( std::ios::badbit );
+  }
+}// end void FileParser::openStream()
+
+
 void FileParser::initDataSeries() {
   LOG_DEBUG( 8, "()" )
 
@@ -234,4 +768,319 @@ void FileParser::initDataSeries() {
   }// finished iterating
 }// end void FileParser::FileParser initDataSeries()
 
+
+void FileParser::loadFile() {
+  LOG_DEBUG( 8, "()" )
+
+  // stat before parsing so a file modified mid-parse is re-parsed next time
+  struct stat fileStat;
+  bool cacheable = caching
+                   && streamOpen
+                   && stat( localFileName.c_str(), &fileStat ) == 0;
+  long long size = 0;
+  long long mtime = 0;
+  if( cacheable ) {
+    size = fileStat.st_size;
+    mtime = (long long)fileStat.st_mtim.tv_sec * 1000000000LL
+            + fileStat.st_mtim.tv_nsec;
+    if( loadCache( size, mtime )) {
+      LOG_DEBUG( 7, ": Loaded " << localFileName << " from sidecar." )
+      return;
+    }
+  }
+
+  parseFile();
+  finalizeSeriesData();
+
+  // a damaged compressed file must not be remembered as parsed
+  if( cacheable && ( decompressBuf == NULL || decompressBuf->good() )) {
+    storeCache( size, mtime );
+  }
+}// end void FileParser::loadFile()
+
+
+const string FileParser::getCachePath() const {
+  LOG_DEBUG( 8, "()" )
+
+  if( cacheDirectory.empty() ) {
+    return localFileName + FILEPARSER_CACHE_EXT;
+  }
+
+  // flatten the full path so files of the same name do not collide
+  string flattened = localFileName;
+  for( size_t i = 0; i < flattened.size(); i++ ) {
+    if( flattened[i] == '/' ) {
+      flattened[i] = '_';
+    }
+  }
+  return cacheDirectory + "/" + flattened + FILEPARSER_CACHE_EXT;
+}// end const string FileParser::getCachePath() const
+
+
+const unsigned int FileParser::getSchemaHash() const {
+  LOG_DEBUG( 8, "()" )
+
+  int version = FILEPARSER_CACHE_VERSION;
+  unsigned int hash = fnvHash( &version, sizeof( version ));
+  for( int i = 0; i < length; i++ ) {
+    hash = fnvHash( dataTags[i].label.data(), dataTags[i].label.size(), hash );
+    hash = fnvHash( &dataTags[i].type, sizeof( int ), hash );
+    hash = fnvHash( &dataTags[i].reso, sizeof( int ), hash );
+    hash = fnvHash( &dataTags[i].start, sizeof( int ), hash );
+    if( dataTags[i].despikeWindow > 0 && despikeMode != DESPIKE_OFF ) {
+      hash = fnvHash( &dataTags[i].despikeWindow, sizeof( int ), hash );
+      hash = fnvHash( &dataTags[i].despikeThreshold, sizeof( double ), hash );
+      hash = fnvHash( &despikeMode, sizeof( int ), hash );
+    }
+  }
+  return hash;
+}// end const unsigned int FileParser::getSchemaHash() const
+
+
+const bool FileParser::loadCache( const long long size,
+                                  const long long mtime )
+{
+  LOG_DEBUG( 8, "( " << size << ", " << mtime << " )" )
+
+  // read the entire sidecar
+  string cachePath = getCachePath();
+  std::ifstream cacheStream( cachePath.c_str(), std::ios::binary );
+  if( !cacheStream.is_open() ) {
+    return false;
+  }
+  string buffer;
+  cacheStream.seekg( 0, std::ios::end );
+  std::streamoff cacheSize = cacheStream.tellg();
+  if( cacheSize <= (std::streamoff)sizeof( unsigned int )) {
+    LOG_DEBUG( 7, ": Sidecar too small -- " << cachePath )
+    return false;
+  }
+  buffer.resize( cacheSize );
+  cacheStream.seekg( 0, std::ios::beg );
+  cacheStream.read( &buffer[0], cacheSize );
+  if( cacheStream.gcount() != cacheSize ) {
+    return false;
+  }
+
+  // verify the checksum trailer before trusting anything else
+  size_t bodySize = buffer.size() - sizeof( unsigned int );
+  unsigned int checksum;
+  memcpy( &checksum, buffer.data() + bodySize, sizeof( unsigned int ));
+  if( checksum != fnvHash( buffer.data(), bodySize )) {
+    LOG_ERR( "Corrupt sidecar ignored: " << cachePath )
+    return false;
+  }
+  buffer.resize( bodySize );
+
+  // verify the key
+  size_t pos = strlen( FILEPARSER_CACHE_MAGIC );
+  if( buffer.compare( 0, pos, FILEPARSER_CACHE_MAGIC ) != 0 ) {
+    return false;
+  }
+  unsigned int schema;
+  int columns;
+  long long cachedSize;
+  long long cachedTime;
+  unsigned int pathLength;
+  if( !getValue( buffer, pos, schema )
+      || !getValue( buffer, pos, columns )
+      || !getValue( buffer, pos, cachedSize )
+      || !getValue( buffer, pos, cachedTime )
+      || !getValue( buffer, pos, pathLength )
+      || pos + pathLength > buffer.size() )
+  {
+    return false;
+  }
+  if( schema != getSchemaHash()
+      || columns != length
+      || cachedSize != size
+      || cachedTime != mtime
+      || buffer.compare( pos, pathLength, localFileName ) != 0 )
+  {
+    LOG_DEBUG( 7, ": Stale sidecar -- " << cachePath )
+    return false;
+  }
+  pos += pathLength;
+
+  // validate every column before loading any of them, decoding packed
+  //   values along the way
+  size_t columnStart = pos;
+  std::vector< std::vector<char> > decoded( length );
+  for( int i = 0; i < length; i++ ) {
+    int type;
+    int len;
+    int reso;
+    int start;
+    if( !getValue( buffer, pos, type )
+        || !getValue( buffer, pos, len )
+        || !getValue( buffer, pos, reso )
+        || !getValue( buffer, pos, start )
+        || type != dataTags[i].type
+        || len < 0 )
+    {
+      return false;
+    }
+    if( data[i] != NULL ) {
+      if( data[i]->isCollecting() || data[i]->isFinal() ) {
+        return false;
+      }
+      int encoding;
+      unsigned int bytes;
+      if( !getValue( buffer, pos, encoding )
+          || !getValue( buffer, pos, bytes )
+          || pos + bytes > buffer.size() )
+      {
+        return false;
+      }
+      if( encoding == SERIESCODEC_RAW ) {
+        if( bytes != (size_t)len * data[i]->getValueSize() ) {
+          return false;
+        }
+      } else if( encoding != SERIESCODEC_PACKED ) {
+        return false;
+      } else if( len > 0 ) {
+        decoded[i].resize( (size_t)len * data[i]->getValueSize() );
+        if( !SeriesCodec::decode( buffer.data() + pos, bytes, type, len,
+                                  &decoded[i][0] ))
+        {
+          LOG_DEBUG( 7, ": Corrupt column in sidecar -- " << cachePath )
+          return false;
+        }
+      }
+      pos += bytes;
+
+      int hasValidity;
+      if( !getValue( buffer, pos, hasValidity )) {
+        return false;
+      }
+      if( hasValidity ) {
+        size_t words = ( len + 63 ) / 64;
+        if( len == 0 || pos + words * sizeof( uint64_t ) > buffer.size() ) {
+          return false;
+        }
+        pos += words * sizeof( uint64_t );
+      }
+    }
+  }
+  if( pos != buffer.size() ) {
+    return false;
+  }
+
+  // load the columns
+  pos = columnStart;
+  for( int i = 0; i < length; i++ ) {
+    int type;
+    int len;
+    int reso;
+    int start;
+    getValue( buffer, pos, type );
+    getValue( buffer, pos, len );
+    getValue( buffer, pos, reso );
+    getValue( buffer, pos, start );
+    if( data[i] != NULL ) {
+      int encoding;
+      unsigned int bytes;
+      getValue( buffer, pos, encoding );
+      getValue( buffer, pos, bytes );
+      const char* values = buffer.data() + pos;
+      if( !decoded[i].empty() ) {
+        values = &decoded[i][0];
+      }
+      if( len > 0 ) {
+        data[i]->loadRawData( values, len, reso, start );
+      }
+      pos += bytes;
+
+      int hasValidity;
+      getValue( buffer, pos, hasValidity );
+      if( hasValidity ) {
+        size_t words = ( len + 63 ) / 64;
+        uint64_t* validity = new uint64_t[ words ];
+        memcpy( validity, buffer.data() + pos, words * sizeof( uint64_t ));
+        data[i]->setValidity( validity );
+        delete[] validity;
+        pos += words * sizeof( uint64_t );
+      }
+    }
+  }
+
+  return true;
+}// end const bool FileParser::loadCache( const long long, const long long )
+
+
+void FileParser::storeCache( const long long size,
+                             const long long mtime ) const
+{
+  LOG_DEBUG( 8, "( " << size << ", " << mtime << " )" )
+
+  // serialize the key and the columns
+  string buffer( FILEPARSER_CACHE_MAGIC );
+  putValue( buffer, getSchemaHash() );
+  putValue( buffer, length );
+  putValue( buffer, size );
+  putValue( buffer, mtime );
+  putValue( buffer, (unsigned int)localFileName.size() );
+  buffer += localFileName;
+  for( int i = 0; i < length; i++ ) {
+    putValue( buffer, dataTags[i].type );
+    if( data[i] != NULL && data[i]->isFinal() ) {
+      putValue( buffer, data[i]->getLength() );
+      putValue( buffer, data[i]->getResolution() );
+      putValue( buffer, data[i]->getStartTime() );
+      string values;
+      int encoding = cacheEncoding;
+      if( encoding == SERIESCODEC_PACKED
+          && !SeriesCodec::encode( data[i]->getRawData(),
+                                   data[i]->getLength(),
+                                   dataTags[i].type,
+                                   values ))
+      {
+        encoding = SERIESCODEC_RAW;
+      }
+      if( encoding == SERIESCODEC_RAW ) {
+        values.assign( (const char*)data[i]->getRawData(),
+                       (size_t)data[i]->getLength() * data[i]->getValueSize() );
+      }
+      putValue( buffer, encoding );
+      putValue( buffer, (unsigned int)values.size() );
+      buffer += values;
+      const uint64_t* validity = data[i]->getValidity();
+      putValue( buffer, validity != NULL ? 1 : 0 );
+      if( validity != NULL ) {
+        buffer.append( (const char*)validity,
+                       (( data[i]->getLength() + 63 ) / 64 )
+                       * sizeof( uint64_t ));
+      }
+    } else if( data[i] != NULL ) {
+      // an unfinalized series cannot be restored faithfully
+      LOG_DEBUG( 7, ": Not caching, series not final -- " \
+                    << dataTags[i].label )
+      return;
+    } else {
+      putValue( buffer, 0 );
+      putValue( buffer, dataTags[i].reso );
+      putValue( buffer, dataTags[i].start );
+    }
+  }
+  putValue( buffer, fnvHash( buffer.data(), buffer.size() ));
+
+  // write to a temporary file and rename so readers never see a partial file
+  string cachePath = getCachePath();
+  char pid[ 16 ];
+  snprintf( pid, sizeof( pid ), ".%d", (int)getpid() );
+  string tempPath = cachePath + pid;
+  std::ofstream cacheStream( tempPath.c_str(),
+                             std::ios::binary | std::ios::trunc );
+  if( !cacheStream.is_open() ) {
+    LOG_DEBUG( 7, ": Unable to write sidecar -- " << cachePath )
+    return;
+  }
+  cacheStream.write( buffer.data(), buffer.size() );
+  cacheStream.close();
+  if( cacheStream.fail() || rename( tempPath.c_str(), cachePath.c_str() )) {
+    LOG_DEBUG( 7, ": Unable to write sidecar -- " << cachePath )
+    remove( tempPath.c_str() );
+  }
+}// end void FileParser::storeCache( const long long, const long long ) const
+
 //----< DATA METHODS >----------------------------------------------------------
\ No newline at end of file
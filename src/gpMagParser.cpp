@@ -1,4 +1,9 @@
 /*
+ * Modified:  10/19/26
+ * Notes:     Values are placed into the cell for their HHMM time. Missing
+ *              values and missing lines are left invalid instead of being
+ *              replaced with zeros.
+ *
  * Modified:  07/16/10
  * Notes:     Expanding file parser to extract significant data from
  *              ace magnetometer readings
@@ -58,8 +63,7 @@ GpMagParser::GpMagParser( string fileName )
 {
   LOG_DEBUG( 11, "( " << fileName << " )" )
 
-  parseFile();
-  finalizeSeriesData();
+  loadFile();
 }// end GpMagParser::GpMagParser( string )
 
 
@@ -87,6 +91,9 @@ GpMagParser& GpMagParser::operator=( const GpMagParser& copy ) {
 void GpMagParser::parseFile() {
   LOG_DEBUG( 11, "()" )
 
+  // values are placed by their time of day
+  initGrid();
+
   // move to first data line
   if( findArtifact( "#-------------------" )) {
     int year;
@@ -108,22 +115,25 @@ void GpMagParser::parseFile() {
 
     while( dataStream->good() && !dataStream->eof() ) {
       curLine++;
-
-      int i = 0;
-      data[i++]->addValue( &year );
-      data[i++]->addValue( &month );
-      data[i++]->addValue( &day );
-      data[i++]->addValue( &hourmin );
-      data[i++]->addValue( &julianDay );
-      data[i++]->addValue( &sec );
-      if( hp == -1.00e+05 ) hp = 0.0;
-      data[i++]->addValue( &hp );
-      if( he == -1.00e+05 ) he = 0.0;
-      data[i++]->addValue( &he );
-      if( hn == -1.00e+05 ) hn = 0.0;
-      data[i++]->addValue( &hn );
-      if( total == -1.00e+05 ) total = 0.0;
-      data[i++]->addValue( &total );
+      int cell = getGridCell( 0, hourmin );
+      if( cell < 0 ) {
+        LOG_ERR( "Skipping line with time " << hourmin << " off the grid." )
+      } else {
+        // missing values (-1.00e+05) are left invalid
+        int i = 0;
+        data[i++]->placeValue( &year, cell );
+        data[i++]->placeValue( &month, cell );
+        data[i++]->placeValue( &day, cell );
+        data[i++]->placeValue( &hourmin, cell );
+        data[i++]->placeValue( &julianDay, cell );
+        data[i++]->placeValue( &sec, cell );
+        double* values[] = { &hp, &he, &hn, &total };
+        for( int j = 0; j < 4; j++, i++ ) {
+          if( *values[j] != -1.00e+05 ) {
+            data[i]->placeValue( values[j], cell );
+          }
+        }
+      }
 
       (*dataStream) >> year >> month >> day >> hourmin >> julianDay
                     >> sec >> hp >> he >> hn >> total;
@@ -1,4 +1,13 @@
 /*
+ * Modified:  10/19/26
+ * Notes:     The particle columns request Hampel despiking over
+ *              an hour window.
+ *
+ * Modified:  10/19/26
+ * Notes:     Values are placed into the cell for their HHMM time. Missing
+ *              values and missing lines are left invalid instead of being
+ *              replaced with zeros.
+ *
  * Modified:  07/16/10
  * Notes:     Expanding file parser to extract significant data from
  *              ace magnetometer readings
@@ -35,6 +44,8 @@
      *  E0.8         Electrons at >0.8Mev                Double
      *  E2.0         Electrons at >2.0Mev                Double
      *  E4.0         Electrons at >4.0Mev                Double
+     *
+     * The particle columns are despiked over an hour once parsed.
      */
 const FileParser::DataTag GpPartParser::tags[] = {
  { "YR", DATATYPE_INT, 5, 0 },
@@ -43,15 +54,15 @@ const FileParser::DataTag GpPartParser::tags[] = {
  { "HHMM", DATATYPE_INT, 5, 0 },
  { "DAY", DATATYPE_INT, 5, 0 },
  { "SEC", DATATYPE_INT, 5, 0 },
- { "P1", DATATYPE_DOUBLE, 5, 0 },
- { "P5", DATATYPE_DOUBLE, 5, 0 },
- { "P10", DATATYPE_DOUBLE, 5, 0 },
- { "P30", DATATYPE_DOUBLE, 5, 0 },
- { "P50", DATATYPE_DOUBLE, 5, 0 },
- { "P100", DATATYPE_DOUBLE, 5, 0 },
- { "E08", DATATYPE_DOUBLE, 5, 0 },
- { "E20", DATATYPE_DOUBLE, 5, 0 },
- { "E40", DATATYPE_DOUBLE, 5, 0 },
+ { "P1", DATATYPE_DOUBLE, 5, 0, 60 },
+ { "P5", DATATYPE_DOUBLE, 5, 0, 60 },
+ { "P10", DATATYPE_DOUBLE, 5, 0, 60 },
+ { "P30", DATATYPE_DOUBLE, 5, 0, 60 },
+ { "P50", DATATYPE_DOUBLE, 5, 0, 60 },
+ { "P100", DATATYPE_DOUBLE, 5, 0, 60 },
+ { "E08", DATATYPE_DOUBLE, 5, 0, 60 },
+ { "E20", DATATYPE_DOUBLE, 5, 0, 60 },
+ { "E40", DATATYPE_DOUBLE, 5, 0, 60 },
  { "END", DATATYPE_END, -1, -1 } };
 
 //----< (DE)(CON)STRUCTORS >---------------------------------------------------
@@ -67,8 +78,7 @@ GpPartParser::GpPartParser( string fileName )
 {
   LOG_DEBUG( 11, "( " << fileName << " )" )
 
-  parseFile();
-  finalizeSeriesData();
+  loadFile();
 }// end GpPartParser::GpPartParser( string )
 
 
@@ -96,6 +106,9 @@ GpPartParser& GpPartParser::operator=( const GpPartParser& copy ) {
 void GpPartParser::parseFile() {
   LOG_DEBUG( 11, "()" )
 
+  // values are placed by their time of day
+  initGrid();
+
   // move to first data line
   if( findArtifact( "#-------------------" )) {
     int year;
@@ -123,41 +136,26 @@ void GpPartParser::parseFile() {
                   >> e08 >> e20 >> e40;
     while( dataStream->good() && !dataStream->eof() ) {
       curLine++;
-
-      int i = 0;
-      data[i++]->addValue( &year );
-      data[i++]->addValue( &month );
-      data[i++]->addValue( &day );
-      data[i++]->addValue( &hourmin );
-      data[i++]->addValue( &julianDay );
-      data[i++]->addValue( &sec );
-
-      if( p1 == -1.00e+05 ) p1 = 0.0;
-      data[i++]->addValue( &p1 );
-
-      if( p5 == -1.00e+05 ) p5 = 0.0;
-      data[i++]->addValue( &p5 );
-
-      if( p10 == -1.00e+05 ) p10 = 0.0;
-      data[i++]->addValue( &p10 );
-
-      if( p30 == -1.00e+05 ) p30 = 0.0;
-      data[i++]->addValue( &p30 );
-
-      if( p50 == -1.00e+05 ) p50 = 0.0;
-      data[i++]->addValue( &p50 );
-
-      if( p100 == -1.00e+05 ) p100 = 0.0;
-      data[i++]->addValue( &p100 );
-
-      if( e08 == -1.00e+05 ) e08 = 0.0;
-      data[i++]->addValue( &e08 );
-
-      if( e20 == -1.00e+05 ) e20 = 0.0;
-      data[i++]->addValue( &e20 );
-
-      if( e40 == -1.00e+05 ) e40 = 0.0;
-      data[i++]->addValue( &e40 );
+      int cell = getGridCell( 0, hourmin );
+      if( cell < 0 ) {
+        LOG_ERR( "Skipping line with time " << hourmin << " off the grid." )
+      } else {
+        // missing values (-1.00e+05) are left invalid
+        int i = 0;
+        data[i++]->placeValue( &year, cell );
+        data[i++]->placeValue( &month, cell );
+        data[i++]->placeValue( &day, cell );
+        data[i++]->placeValue( &hourmin, cell );
+        data[i++]->placeValue( &julianDay, cell );
+        data[i++]->placeValue( &sec, cell );
+        double* values[] = { &p1, &p5, &p10, &p30, &p50,
+                             &p100, &e08, &e20, &e40 };
+        for( int j = 0; j < 9; j++, i++ ) {
+          if( *values[j] != -1.00e+05 ) {
+            data[i]->placeValue( values[j], cell );
+          }
+        }
+      }
 
       (*dataStream) >> year >> month >> day >> hourmin >> julianDay
                     >> sec >> p1 >> p5 >> p10 >> p30 >> p50 >> p100
@@ -1,4 +1,13 @@
 /*
+ * Modified:  10/19/26
+ * Notes:     The xray columns request Hampel despiking over a
+ *              15 minute window.
+ *
+ * Modified:  10/19/26
+ * Notes:     Values are placed into the cell for their HHMM time. Missing
+ *              values and missing lines are left invalid instead of being
+ *              replaced with zeros.
+ *
  * Modified:  07/16/10
  * Notes:     Expanding file parser to extract significant data from
  *              ace magnetometer readings
@@ -30,6 +39,8 @@
      *  SEC          Seconds of the day                  Int
      *  SHORT        Short xray power, 0.05 - 0.4 nm     Double
      *  LONG         Long xray power, 0.1 - 0.8 nm       Double
+     *
+     * The xray columns are despiked over 15 minutes once parsed.
      */
 const FileParser::DataTag GpXrayParser::tags[] = {
  { "YR", DATATYPE_INT, 1, 0 },
@@ -38,8 +49,8 @@ const FileParser::DataTag GpXrayParser::tags[] = {
  { "HHMM", DATATYPE_INT, 1, 0 },
  { "DAY", DATATYPE_INT, 1, 0 },
  { "SEC", DATATYPE_INT, 1, 0 },
- { "SHORT", DATATYPE_DOUBLE, 1, 0 },
- { "LONG", DATATYPE_DOUBLE, 1, 0 },
+ { "SHORT", DATATYPE_DOUBLE, 1, 0, 15 },
+ { "LONG", DATATYPE_DOUBLE, 1, 0, 15 },
  { "END", DATATYPE_END, -1, -1 } };
 
 //----< (DE)(CON)STRUCTORS >---------------------------------------------------
@@ -55,8 +66,7 @@ GpXrayParser::GpXrayParser( string fileName )
 {
   LOG_DEBUG( 11, "( " << fileName << " )" )
 
-  parseFile();
-  finalizeSeriesData();
+  loadFile();
 }// end GpXrayParser::GpXrayParser( string )
 
 
@@ -86,6 +96,9 @@ GpXrayParser& GpXrayParser::operator=( const GpXrayParser& copy ) {
 void GpXrayParser::parseFile() {
   LOG_DEBUG( 11, "()" )
 
+  // values are placed by their time of day
+  initGrid();
+
   // move to first data line
   if( findArtifact( "#----------------------" )) {
     int year;
@@ -105,17 +118,25 @@ void GpXrayParser::parseFile() {
 
     while( dataStream->good() && !dataStream->eof() ) {
       curLine++;
-      int i = 0;
-      data[i++]->addValue( &year );
-      data[i++]->addValue( &month );
-      data[i++]->addValue( &day );
-      data[i++]->addValue( &hourmin );
-      data[i++]->addValue( &julianDay );
-      data[i++]->addValue( &sec );
-      if( shortData == -1.00e+05 ) shortData = 0.0;
-      data[i++]->addValue( &shortData );
-      if( longData == -1.00e+05 ) longData = 0.0;
-      data[i++]->addValue( &longData );
+      int cell = getGridCell( 0, hourmin );
+      if( cell < 0 ) {
+        LOG_ERR( "Skipping line with time " << hourmin << " off the grid." )
+      } else {
+        // missing values (-1.00e+05) are left invalid
+        int i = 0;
+        data[i++]->placeValue( &year, cell );
+        data[i++]->placeValue( &month, cell );
+        data[i++]->placeValue( &day, cell );
+        data[i++]->placeValue( &hourmin, cell );
+        data[i++]->placeValue( &julianDay, cell );
+        data[i++]->placeValue( &sec, cell );
+        double* values[] = { &shortData, &longData };
+        for( int j = 0; j < 2; j++, i++ ) {
+          if( *values[j] != -1.00e+05 ) {
+            data[i]->placeValue( values[j], cell );
+          }
+        }
+      }
 
       (*dataStream) >> year >> month >> day >> hourmin >> julianDay
                     >> sec >> shortData >> longData;
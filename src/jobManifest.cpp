@@ -0,0 +1,237 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/jobManifest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define JOBMANIFEST_READ_SIZE 65536     // bytes per read when hashing
+
+//----< (DE)(CON)STRUCTORS >----------------------------------------------------
+JobManifest::JobManifest( const string fileName, const int mode )
+  : fileName( fileName ), mode( mode )
+{
+  LOG_DEBUG( 12, "( " << fileName << ", " << mode << " )" )
+
+  changed = false;
+  pthread_mutex_init( &lock, NULL );
+}// end JobManifest::JobManifest( const string, const int )
+
+
+JobManifest::~JobManifest() {
+  pthread_mutex_destroy( &lock );
+}// end JobManifest::~JobManifest()
+
+//----< FILE METHODS >----------------------------------------------------------
+const bool JobManifest::load() {
+  LOG_DEBUG( 12, "( " << fileName << " )" )
+
+  std::ifstream in( fileName.c_str() );
+  if( !in.is_open() ) {
+    struct stat fileStat;
+    if( stat( fileName.c_str(), &fileStat ) == 0 ) {
+      LOG_ERR( "Unable to read manifest " << fileName )
+      return false;
+    }
+    return true;
+  }
+
+  string line;
+  int version = 0;
+  if( !std::getline( in, line )
+      || sscanf( line.c_str(), "# crsCorr job manifest %d", &version ) != 1 )
+  {
+    LOG_ERR( "Not a job manifest: " << fileName )
+    return false;
+  } else if( version != JOBMANIFEST_VERSION ) {
+    // an old layout only costs one full run
+    LOG_ERR( "WARNING: Ignoring version " << version << " manifest " \
+             << fileName )
+    changed = true;
+    return true;
+  }
+
+  pthread_mutex_lock( &lock );
+  entries.clear();
+  while( std::getline( in, line )) {
+    char* end = NULL;
+    uint64_t signature = strtoull( line.c_str(), &end, 16 );
+    if( end == line.c_str() || *end != ' ' || end[1] == '\0' ) {
+      LOG_ERR( "Skipping malformed manifest line: " << line )
+      changed = true;
+      continue;
+    }
+    entries[ string( end + 1 ) ] = signature;
+  }
+  pthread_mutex_unlock( &lock );
+  return true;
+}// end const bool JobManifest::load()
+
+
+const bool JobManifest::save() {
+  LOG_DEBUG( 12, "( " << fileName << " )" )
+
+  pthread_mutex_lock( &lock );
+  if( !changed ) {
+    pthread_mutex_unlock( &lock );
+    return true;
+  }
+
+  // write to a temporary file and rename so readers never see a partial file
+  char pid[ 16 ];
+  snprintf( pid, sizeof( pid ), ".%d", (int)getpid() );
+  string tempPath = fileName + pid;
+  std::ofstream out( tempPath.c_str(), std::ios::trunc );
+  out << "# crsCorr job manifest " << JOBMANIFEST_VERSION << '\n';
+  char signature[ 20 ];
+  for( Entries::const_iterator entry = entries.begin();
+       out.good() && entry != entries.end(); entry++ )
+  {
+    snprintf( signature, sizeof( signature ), "%016llx",
+              (unsigned long long)entry->second );
+    out << signature << ' ' << entry->first << '\n';
+  }
+  out.close();
+  bool saved = !out.fail() && rename( tempPath.c_str(), fileName.c_str() ) == 0;
+  if( saved ) {
+    changed = false;
+  } else {
+    LOG_ERR( "Unable to write manifest " << fileName << ": " \
+             << strerror( errno ))
+    remove( tempPath.c_str() );
+  }
+  pthread_mutex_unlock( &lock );
+  return saved;
+}// end const bool JobManifest::save()
+
+//----< FINGERPRINTS >----------------------------------------------------------
+const uint64_t JobManifest::hashContents( const string& path ) const {
+  int file = open( path.c_str(), O_RDONLY );
+  if( file < 0 ) {
+    return JOBMANIFEST_MISSING;
+  }
+
+  char* buffer = new char[ JOBMANIFEST_READ_SIZE ];
+  uint64_t value = JOBMANIFEST_SEED;
+  uint64_t size = 0;
+  ssize_t count;
+  while(( count = read( file, buffer, JOBMANIFEST_READ_SIZE )) != 0 ) {
+    if( count < 0 ) {
+      if( errno == EINTR ) {
+        continue;
+      }
+      LOG_ERR( "Read failed on " << path << ": " << strerror( errno ))
+      value = JOBMANIFEST_MISSING;
+      break;
+    }
+    value = hash( buffer, count, value );
+    size += count;
+  }
+  delete[] buffer;
+  close( file );
+  return value == JOBMANIFEST_MISSING ? value : hashValue( size, value );
+}// end const uint64_t JobManifest::hashContents( const string& ) const
+
+
+const uint64_t JobManifest::fingerprint( const string& path ) {
+  pthread_mutex_lock( &lock );
+  Entries::const_iterator found = fingerprints.find( path );
+  if( found != fingerprints.end() ) {
+    uint64_t value = found->second;
+    pthread_mutex_unlock( &lock );
+    return value;
+  }
+  pthread_mutex_unlock( &lock );
+
+  // examine the file outside the lock; a racing duplicate is harmless
+  uint64_t value = JOBMANIFEST_MISSING;
+  struct stat fileStat;
+  if( stat( path.c_str(), &fileStat ) == 0 ) {
+    if( mode == JOBMANIFEST_CONTENT ) {
+      value = hashContents( path );
+    } else {
+      value = hashValue( (uint64_t)fileStat.st_size );
+      value = hashValue( (uint64_t)fileStat.st_mtim.tv_sec, value );
+      value = hashValue( (uint64_t)fileStat.st_mtim.tv_nsec, value );
+    }
+  }
+
+  pthread_mutex_lock( &lock );
+  fingerprints[ path ] = value;
+  pthread_mutex_unlock( &lock );
+  return value;
+}// end const uint64_t JobManifest::fingerprint( const string& )
+
+//----< ENTRIES >---------------------------------------------------------------
+const bool JobManifest::isCurrent( const string& key,
+                                   const uint64_t signature )
+{
+  pthread_mutex_lock( &lock );
+  Entries::const_iterator found = entries.find( key );
+  bool current = found != entries.end() && found->second == signature;
+  pthread_mutex_unlock( &lock );
+  return current;
+}// end const bool JobManifest::isCurrent( const string&, const uint64_t )
+
+
+void JobManifest::record( const string& key, const uint64_t signature ) {
+  pthread_mutex_lock( &lock );
+  Entries::iterator found = entries.find( key );
+  if( found == entries.end() || found->second != signature ) {
+    entries[ key ] = signature;
+    changed = true;
+  }
+  pthread_mutex_unlock( &lock );
+}// end void JobManifest::record( const string&, const uint64_t )
+
+
+void JobManifest::forget( const string& key ) {
+  pthread_mutex_lock( &lock );
+  changed = entries.erase( key ) > 0 || changed;
+  pthread_mutex_unlock( &lock );
+}// end void JobManifest::forget( const string& )
+
+
+const int JobManifest::getEntries() {
+  pthread_mutex_lock( &lock );
+  int count = entries.size();
+  pthread_mutex_unlock( &lock );
+  return count;
+}// end const int JobManifest::getEntries()
+
+//----< HASHING >---------------------------------------------------------------
+const uint64_t JobManifest::hash( const void* bytes,
+                                  const size_t count,
+                                  const uint64_t seed )
+{
+  const unsigned char* byte = (const unsigned char*)bytes;
+  uint64_t value = seed;
+  for( size_t i = 0; i < count; i++ ) {
+    value ^= byte[i];
+    value *= 1099511628211ULL;
+  }
+  return value;
+}// end static const uint64_t JobManifest::hash( const void*, ... )
+
+
+const uint64_t JobManifest::hashText( const string& text,
+                                      const uint64_t seed )
+{
+  return hash( text.data(), text.size(),
+               hashValue( (uint64_t)text.size(), seed ));
+}// end static const uint64_t JobManifest::hashText( const string&, ... )
+
+
+const uint64_t JobManifest::hashValue( const uint64_t value,
+                                       const uint64_t seed )
+{
+  return hash( &value, sizeof( value ), seed );
+}// end static const uint64_t JobManifest::hashValue( const uint64_t, ... )
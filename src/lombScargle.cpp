@@ -0,0 +1,149 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/lombScargle.h>
+#include <crsCorr/fft.h>
+#include <cmath>
+#include <complex>
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+/*
+ * Adds value to the periodic grid so that a function sampled on the grid and
+ *   interpolated by Lagrange polynomials through the LOMBSCARGLE_SPREAD
+ *   points around x sums to value times its interpolant at x.
+ */
+static void extirpolate( const double value,
+                         const double x,
+                         std::vector<double>& grid )
+{
+  const int n = grid.size();
+  const int nearest = (int)floor( x + 0.5 );
+  if( fabs( x - nearest ) < 1e-12 ) {
+    grid[ nearest % n ] += value;
+    return;
+  }
+
+  const int first = (int)floor( x ) - LOMBSCARGLE_SPREAD / 2 + 1;
+  for( int j = 0; j < LOMBSCARGLE_SPREAD; j++ ) {
+    double weight = 1.0;
+    for( int i = 0; i < LOMBSCARGLE_SPREAD; i++ ) {
+      if( i != j ) {
+        weight *= ( x - ( first + i )) / ( j - i );
+      }
+    }
+    grid[ (( first + j ) % n + n ) % n ] += value * weight;
+  }
+}// end static void extirpolate( const double, const double, ... )
+
+//----< PERIODOGRAMS >----------------------------------------------------------
+PowerSpectrum* LombScargle::periodogram( const double* times,
+                                         const double* values,
+                                         const int count,
+                                         const double oversampling,
+                                         const double nyquistFactor )
+{
+  LOG_DEBUG( 12, "( times, values, " << count << ", " << oversampling \
+                 << ", " << nyquistFactor << " )" )
+
+  if( times == NULL || values == NULL || count < 3 || !( oversampling >= 1.0 )
+      || !( nyquistFactor > 0.0 ))
+  {
+    LOG_ERR( "Bad Lomb-Scargle parameters: " << count << " samples, " \
+             << "oversampling " << oversampling << ", Nyquist factor " \
+             << nyquistFactor )
+    return NULL;
+  }
+
+  double mean = 0.0;
+  double first = times[0];
+  double last = times[0];
+  for( int j = 0; j < count; j++ ) {
+    mean += values[j];
+    first = times[j] < first ? times[j] : first;
+    last = times[j] > last ? times[j] : last;
+  }
+  mean /= count;
+  double variance = 0.0;
+  for( int j = 0; j < count; j++ ) {
+    variance += ( values[j] - mean ) * ( values[j] - mean );
+  }
+  variance /= count - 1;
+  const double span = last - first;
+  if( !( span > 0.0 ) || !( variance > 0.0 )) {
+    LOG_ERR( "Samples span " << span << " days with variance " << variance )
+    return NULL;
+  }
+
+  // the grid oversamples the highest doubled frequency by the spread
+  const int outputs = (int)( 0.5 * oversampling * nyquistFactor * count );
+  if( outputs < 1 ) {
+    LOG_ERR( "No frequencies below " << nyquistFactor << " times Nyquist." )
+    return NULL;
+  }
+  const double wanted = oversampling * nyquistFactor * count
+                        * LOMBSCARGLE_SPREAD;
+  int gridSize = 64;
+  while( gridSize < wanted ) {
+    gridSize <<= 1;
+  }
+  gridSize <<= 1;
+
+  // grid index k is frequency k / ( oversampling * span )
+  const double scale = gridSize / ( span * oversampling );
+  std::vector<double> shifted( gridSize, 0.0 );
+  std::vector<double> doubled( gridSize, 0.0 );
+  for( int j = 0; j < count; j++ ) {
+    double x = fmod(( times[j] - first ) * scale, (double)gridSize );
+    extirpolate( values[j] - mean, x, shifted );
+    extirpolate( 1.0, fmod( 2.0 * x, (double)gridSize ), doubled );
+  }
+  std::vector< std::complex<double> > sums( gridSize / 2 + 1 );
+  std::vector< std::complex<double> > doubleSums( gridSize / 2 + 1 );
+  Fft::realTransform( &shifted[0], gridSize, &sums[0] );
+  Fft::realTransform( &doubled[0], gridSize, &doubleSums[0] );
+
+  // the forward transform sums cos - i sin
+  double* power = new double[ outputs + 1 ];
+  power[0] = 0.0;
+  for( int k = 1; k <= outputs; k++ ) {
+    double cosSum = sums[k].real();
+    double sinSum = -sums[k].imag();
+    double cos2Sum = doubleSums[k].real();
+    double sin2Sum = -doubleSums[k].imag();
+
+    // cos and sin of 2 w tau, then of w tau by half angles
+    double hypotenuse = sqrt( cos2Sum * cos2Sum + sin2Sum * sin2Sum );
+    double cos2Tau = hypotenuse > 0.0 ? cos2Sum / hypotenuse : 1.0;
+    double sin2Tau = hypotenuse > 0.0 ? sin2Sum / hypotenuse : 0.0;
+    double cosTau = sqrt( 0.5 * ( 1.0 + cos2Tau ));
+    double sinTau = ( sin2Tau < 0.0 ? -1.0 : 1.0 )
+                    * sqrt( 0.5 * ( 1.0 - cos2Tau ));
+
+    // sum cos^2 w( t - tau ) = n / 2 + ( cos 2wtau C2 + sin 2wtau S2 ) / 2
+    double cosSquares = 0.5 * count
+                        + 0.5 * ( cos2Tau * cos2Sum + sin2Tau * sin2Sum );
+    double sinSquares = count - cosSquares;
+    double cosTerm = cosTau * cosSum + sinTau * sinSum;
+    double sinTerm = cosTau * sinSum - sinTau * cosSum;
+    power[k] = 0.0;
+    if( cosSquares > 0.0 ) {
+      power[k] += cosTerm * cosTerm / cosSquares;
+    }
+    if( sinSquares > 0.0 ) {
+      power[k] += sinTerm * sinTerm / sinSquares;
+    }
+    power[k] /= 2.0 * variance;
+  }
+  return new PowerSpectrum( power, outputs + 1, 1.0 / ( oversampling * span ),
+                            1 );
+}// end static PowerSpectrum* LombScargle::periodogram( const double*, ... )
+
+
+const double LombScargle::falseAlarm( const double power,
+                                      const double independent )
+{
+  // 1 - ( 1 - p )^m, kept accurate when p is tiny
+  return -expm1( independent * log1p( -exp( -power )));
+}// end static const double LombScargle::falseAlarm( const double, ... )
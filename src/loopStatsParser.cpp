@@ -0,0 +1,115 @@
+/*
+ * Modified:  10/19/26
+ * Notes:     Lines with more than LOOPSTATS_VALUES fields are skipped.
+ *
+ * Modified:  10/19/26
+ * Notes:     Initial creation.
+ */
+
+#include <crsCorr/loopStatsParser.h>
+#include <crsCorr/textScan.h>
+#include <string>
+#include <cstdlib>
+#include <vector>
+
+    /*
+     * Determines which values to extract from the given data file.
+     *
+     * Label        Value                               Suggested Type
+     *-------------------------------------------------------------------------
+     *  mjd          Modified Julian Day of the line     Int
+     *  sec          Seconds past midnight UTC           Double
+     *  offset       Clock offset, seconds               Double
+     *  freq         Frequency offset, ppm               Double
+     *  jitter       RMS offset jitter, seconds          Double
+     *  wander       RMS frequency wander, ppm           Double
+     *  poll         Poll interval, log2 seconds         Int
+     */
+const FileParser::DataTag LoopStatsParser::tags[] = {
+ { "mjd", DATATYPE_INT, 1, 0 },
+ { "sec", DATATYPE_DOUBLE, 1, 0 },
+ { "offset", DATATYPE_DOUBLE, 1, 0 },
+ { "freq", DATATYPE_DOUBLE, 1, 0 },
+ { "jitter", DATATYPE_DOUBLE, 1, 0 },
+ { "wander", DATATYPE_DOUBLE, 1, 0 },
+ { "poll", DATATYPE_INT, 1, 0 },
+ { "END", DATATYPE_END, -1, -1 } };
+
+//----< (DE)(CON)STRUCTORS >---------------------------------------------------
+LoopStatsParser::LoopStatsParser()
+    : FileParser( NULL, LoopStatsParser::tags )
+{
+  LOG_DEBUG( 11, "()" )
+
+}// end LoopStatsParser::LoopStatsParser()
+
+LoopStatsParser::LoopStatsParser( string fileName )
+  : FileParser( fileName, LoopStatsParser::tags )
+{
+  LOG_DEBUG( 11, "( " << fileName << " )" )
+
+  loadFile();
+}// end LoopStatsParser::LoopStatsParser( string )
+
+
+LoopStatsParser::LoopStatsParser( const LoopStatsParser& copy )
+  : FileParser( copy )
+{
+  LOG_DEBUG( 11, "( const LoopStatsParser& copy )" )
+
+}// end LoopStatsParser::LoopStatsParser( const LoopStatsParser& )
+
+LoopStatsParser::~LoopStatsParser() {
+  LOG_DEBUG( 11, "()" )
+
+}// end LoopStatsParser::~LoopStatsParser()
+
+//----< ACCESSOR METHODS >-----------------------------------------------------
+
+//----< OPERATORS >------------------------------------------------------------
+LoopStatsParser& LoopStatsParser::operator=( const LoopStatsParser& copy ) {
+  LOG_DEBUG( 11, "( const LoopStatsParser& copy )" )
+
+  return *this;
+}// end LoopStatsParser& LoopStatsParser::operator=( const LoopStatsParser& )
+
+
+//----< FILE METHODS >---------------------------------------------------------
+void LoopStatsParser::parseFile() {
+  LOG_DEBUG( 11, "()" )
+
+  // collect the lines first; the grid spans the days they cover
+  std::vector<double> rows;
+  LineReader reader( *dataStream );
+  int lineLength = 0;
+  char* dataLine = reader.nextLine( &lineLength );
+  while( dataLine != NULL ) {
+    // one spare field shows a line that runs long
+    char* fields[ LOOPSTATS_VALUES + 1 ];
+    int fieldCount = TextScan::splitFields( dataLine, lineLength, fields,
+                                            LOOPSTATS_VALUES + 1, false );
+    if( fieldCount == LOOPSTATS_VALUES ) {
+      char* end = NULL;
+      double row[ LOOPSTATS_VALUES ];
+      bool good = true;
+      for( int i = 0; i < LOOPSTATS_VALUES && good; i++ ) {
+        row[i] = strtod( fields[i], &end );
+        good = end != fields[i] && *end == '\0';
+      }
+      if( good && row[1] >= 0.0 && row[1] < 86400.0 ) {
+        rows.insert( rows.end(), row, row + LOOPSTATS_VALUES );
+      } else {
+        LOG_ERR( "Skipping malformed loopstats line." )
+      }
+    } else if( fieldCount > LOOPSTATS_VALUES ) {
+      LOG_ERR( "Skipping long loopstats line." )
+    } else if( fieldCount > 0 ) {
+      LOG_ERR( "Skipping short loopstats line." )
+    }
+
+    dataLine = reader.nextLine( &lineLength );
+  }// finished with data file
+
+  LOG_DEBUG( 10, ": Placing " << rows.size() / LOOPSTATS_VALUES << " lines" )
+  placeStampedRows( rows );
+}// end void LoopStatsParser::parseFile()
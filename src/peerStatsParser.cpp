@@ -0,0 +1,330 @@
+/*
+ * Modified:  10/19/26
+ * Notes:     Lines with more than PEERSTATS_VALUES fields are skipped.
+ *
+ * Modified:  10/19/26
+ * Notes:     Lines are converted by parseLine() and, when demultiplexing,
+ *              routed to a child parser per peer.
+ *
+ * Modified:  10/19/26
+ * Notes:     Initial creation.
+ */
+
+#include <crsCorr/peerStatsParser.h>
+#include <crsCorr/textScan.h>
+#include <string>
+#include <cstdlib>
+#include <vector>
+
+    /*
+     * Determines which values to extract from the given data file.
+     *
+     * Label        Value                               Suggested Type
+     *-------------------------------------------------------------------------
+     *  mjd          Modified Julian Day of the line     Int
+     *  sec          Seconds past midnight UTC           Double
+     *  address      Peer address                        (ignore)
+     *  status       Peer status word, hex               (ignore)
+     *  offset       Peer clock offset, seconds          Double
+     *  delay        Roundtrip delay, seconds            Double
+     *  dispersion   Dispersion, seconds                 Double
+     *  jitter       RMS jitter, seconds                 Double
+     */
+const FileParser::DataTag PeerStatsParser::tags[] = {
+ { "mjd", DATATYPE_INT, 1, 0 },
+ { "sec", DATATYPE_DOUBLE, 1, 0 },
+ { "address", DATATYPE_IGNORE, 1, 0 },
+ { "status", DATATYPE_IGNORE, 1, 0 },
+ { "offset", DATATYPE_DOUBLE, 1, 0 },
+ { "delay", DATATYPE_DOUBLE, 1, 0 },
+ { "dispersion", DATATYPE_DOUBLE, 1, 0 },
+ { "jitter", DATATYPE_DOUBLE, 1, 0 },
+ { "END", DATATYPE_END, -1, -1 } };
+
+//----< (DE)(CON)STRUCTORS >---------------------------------------------------
+PeerStatsParser::PeerStatsParser()
+    : FileParser( NULL, PeerStatsParser::tags )
+{
+  LOG_DEBUG( 11, "()" )
+
+  demultiplexing = false;
+}// end PeerStatsParser::PeerStatsParser()
+
+PeerStatsParser::PeerStatsParser( string fileName )
+  : FileParser( fileName, PeerStatsParser::tags )
+{
+  LOG_DEBUG( 11, "( " << fileName << " )" )
+
+  demultiplexing = false;
+  loadFile();
+}// end PeerStatsParser::PeerStatsParser( string )
+
+
+PeerStatsParser::PeerStatsParser( string fileName, const bool demultiplex )
+  : FileParser( fileName, PeerStatsParser::tags )
+{
+  LOG_DEBUG( 11, "( " << fileName << ", " << demultiplex << " )" )
+
+  demultiplexing = demultiplex;
+  if( demultiplexing ) {
+    // the sidecar cannot restore the children
+    parseFile();
+    finalizeSeriesData();
+    demultiplexing = false;
+  } else {
+    loadFile();
+  }
+}// end PeerStatsParser::PeerStatsParser( string, const bool )
+
+
+PeerStatsParser::PeerStatsParser( const string& fileName,
+                                  const string& address,
+                                  const std::vector<double>& rows,
+                                  const int firstDay,
+                                  const int lastDay )
+  : FileParser( fileName, PeerStatsParser::tags, false ),
+    address( address )
+{
+  LOG_DEBUG( 11, "( " << fileName << ", " << address << ", rows, " \
+                 << firstDay << ", " << lastDay << " )" )
+
+  demultiplexing = false;
+  placeStampedRows( rows, firstDay, lastDay );
+  finalizeSeriesData();
+}// end PeerStatsParser::PeerStatsParser( const string&, const string&, ... )
+
+
+PeerStatsParser::PeerStatsParser( const PeerStatsParser& copy )
+  : FileParser( copy ),
+    address( copy.address )
+{
+  LOG_DEBUG( 11, "( const PeerStatsParser& copy )" )
+
+  demultiplexing = false;
+}// end PeerStatsParser::PeerStatsParser( const PeerStatsParser& )
+
+PeerStatsParser::~PeerStatsParser() {
+  LOG_DEBUG( 11, "()" )
+
+  for( size_t i = 0; i < peers.size(); i++ ) {
+    delete peers[i];
+  }
+  peers.clear();
+}// end PeerStatsParser::~PeerStatsParser()
+
+//----< ACCESSOR METHODS >-----------------------------------------------------
+
+//----< OPERATORS >------------------------------------------------------------
+PeerStatsParser& PeerStatsParser::operator=( const PeerStatsParser& copy ) {
+  LOG_DEBUG( 11, "( const PeerStatsParser& copy )" )
+
+  return *this;
+}// end PeerStatsParser& PeerStatsParser::operator=( const PeerStatsParser& )
+
+
+//----< FILE METHODS >---------------------------------------------------------
+void PeerStatsParser::parseFile() {
+  LOG_DEBUG( 11, "()" )
+
+  /*
+   * The grid spans the days of every line, so lines are collected first: the
+   *   system peer's into rows and, when demultiplexing, each peer's into its
+   *   own rows.
+   */
+  std::vector<double> rows;
+  std::vector< std::vector<double> > peerRows;
+  int firstDay = 0;
+  int lastDay = -1;
+  LineReader reader( *dataStream );
+  int lineLength = 0;
+  char* dataLine = reader.nextLine( &lineLength );
+  while( dataLine != NULL ) {
+    double row[ PEERSTATS_VALUES ];
+    char* peerAddress = NULL;
+    long status = parseLine( dataLine, lineLength, row, &peerAddress,
+                             !demultiplexing );
+    if( status >= 0 ) {
+      int day = (int)row[0];
+      if( lastDay < firstDay ) {
+        firstDay = day;
+        lastDay = day;
+      } else {
+        firstDay = day < firstDay ? day : firstDay;
+        lastDay = day > lastDay ? day : lastDay;
+      }
+
+      if((( status >> PEERSTATS_SELECT_SHIFT ) & PEERSTATS_SELECT_MASK )
+         == PEERSTATS_SELECT_SYSPEER )
+      {
+        rows.insert( rows.end(), row, row + PEERSTATS_VALUES );
+      }
+      if( demultiplexing ) {
+        unsigned int hash = hashAddress( peerAddress );
+        int peer = findPeerIndex( peerAddress, hash );
+        if( peer < 0 ) {
+          peer = addPeer( peerAddress, hash );
+          peerRows.resize( peer + 1 );
+        }
+        peerRows[peer].insert( peerRows[peer].end(), row,
+                               row + PEERSTATS_VALUES );
+      }
+    }
+
+    dataLine = reader.nextLine( &lineLength );
+  }// finished with data file
+
+  LOG_DEBUG( 10, ": Placing " << rows.size() / PEERSTATS_VALUES << " lines" )
+  if( lastDay < firstDay ) {
+    placeStampedRows( rows );
+    return;
+  }
+  placeStampedRows( rows, firstDay, lastDay );
+
+  // each child's rows are released once placed
+  for( size_t peer = 0; peer < peerRows.size(); peer++ ) {
+    LOG_DEBUG( 10, ": Placing " << peerRows[peer].size() / PEERSTATS_VALUES \
+                   << " lines of " << peerAddresses[peer] )
+    peers.push_back( new PeerStatsParser( getFileName(), peerAddresses[peer],
+                                          peerRows[peer], firstDay,
+                                          lastDay ));
+    std::vector<double>().swap( peerRows[peer] );
+  }
+}// end void PeerStatsParser::parseFile()
+
+
+const long PeerStatsParser::parseLine( char* dataLine,
+                                       const int lineLength,
+                                       double* row,
+                                       char** address,
+                                       const bool systemPeerOnly )
+{
+  // one spare field shows a line that runs long
+  char* fields[ PEERSTATS_VALUES + 1 ];
+  int fieldCount = TextScan::splitFields( dataLine, lineLength, fields,
+                                          PEERSTATS_VALUES + 1, false );
+  if( fieldCount > PEERSTATS_VALUES ) {
+    LOG_ERR( "Skipping long peerstats line." )
+    return -1;
+  } else if( fieldCount < PEERSTATS_VALUES ) {
+    if( fieldCount > 0 ) {
+      LOG_ERR( "Skipping short peerstats line." )
+    }
+    return -1;
+  }
+
+  char* end = NULL;
+  long status = strtol( fields[ PEERSTATS_STATUS_INDEX ], &end, 16 );
+  bool good = end != fields[ PEERSTATS_STATUS_INDEX ] && *end == '\0'
+              && status >= 0;
+  if( good && systemPeerOnly
+      && (( status >> PEERSTATS_SELECT_SHIFT ) & PEERSTATS_SELECT_MASK )
+         != PEERSTATS_SELECT_SYSPEER )
+  {
+    return -1;
+  }
+  for( int i = 0; i < PEERSTATS_VALUES && good; i++ ) {
+    if( i == PEERSTATS_ADDRESS_INDEX || i == PEERSTATS_STATUS_INDEX ) {
+      row[i] = 0.0;
+    } else {
+      row[i] = strtod( fields[i], &end );
+      good = end != fields[i] && *end == '\0';
+    }
+  }
+  if( !good || !( row[1] >= 0.0 ) || row[1] >= 86400.0 ) {
+    LOG_ERR( "Skipping malformed peerstats line." )
+    return -1;
+  }
+
+  *address = fields[ PEERSTATS_ADDRESS_INDEX ];
+  return status;
+}// end static const long PeerStatsParser::parseLine( char*, const int, ... )
+
+
+//----< PEER METHODS >---------------------------------------------------------
+const int PeerStatsParser::getPeerCount() const {
+  return peers.size();
+}// end const int PeerStatsParser::getPeerCount() const
+
+
+PeerStatsParser* PeerStatsParser::getPeer( const int index ) const {
+  if( index < 0 || index >= (int)peers.size() ) {
+    return NULL;
+  }
+  return peers[index];
+}// end PeerStatsParser* PeerStatsParser::getPeer( const int ) const
+
+
+PeerStatsParser* PeerStatsParser::findPeer( const string& address ) const {
+  LOG_DEBUG( 11, "( " << address << " )" )
+
+  int index = findPeerIndex( address.c_str(), hashAddress( address.c_str() ));
+  return getPeer( index );
+}// end PeerStatsParser* PeerStatsParser::findPeer( const string& ) const
+
+
+const string& PeerStatsParser::getAddress() const {
+  return address;
+}// end const string& PeerStatsParser::getAddress() const
+
+
+const int PeerStatsParser::findPeerIndex( const char* address,
+                                          const unsigned int hash ) const
+{
+  if( peerSlots.empty() ) {
+    return -1;
+  }
+
+  unsigned int mask = peerSlots.size() - 1;
+  for( unsigned int slot = hash & mask; ; slot = ( slot + 1 ) & mask ) {
+    int index = peerSlots[slot];
+    if( index < 0 ) {
+      return -1;
+    } else if( peerHashes[index] == hash
+               && !peerAddresses[index].compare( address ))
+    {
+      return index;
+    }
+  }
+}// end const int PeerStatsParser::findPeerIndex( const char*, ... ) const
+
+
+const int PeerStatsParser::addPeer( const char* address,
+                                    const unsigned int hash )
+{
+  LOG_DEBUG( 11, "( " << address << ", " << hash << " )" )
+
+  int index = peerAddresses.size();
+  peerAddresses.push_back( address );
+  peerHashes.push_back( hash );
+
+  // keep the table at most half full so probes stay short
+  if( peerSlots.size() < 2 * peerAddresses.size() ) {
+    size_t slots = peerSlots.empty() ? PEERSTATS_PEER_SLOTS
+                                     : 2 * peerSlots.size();
+    peerSlots.assign( slots, -1 );
+    for( int i = 0; i < index; i++ ) {
+      unsigned int slot = peerHashes[i] & ( slots - 1 );
+      while( peerSlots[slot] >= 0 ) {
+        slot = ( slot + 1 ) & ( slots - 1 );
+      }
+      peerSlots[slot] = i;
+    }
+  }
+
+  unsigned int mask = peerSlots.size() - 1;
+  unsigned int slot = hash & mask;
+  while( peerSlots[slot] >= 0 ) {
+    slot = ( slot + 1 ) & mask;
+  }
+  peerSlots[slot] = index;
+  return index;
+}// end const int PeerStatsParser::addPeer( const char*, const unsigned int )
+
+
+const unsigned int PeerStatsParser::hashAddress( const char* address ) {
+  unsigned int hash = 2166136261u;
+  for( const char* c = address; *c != '\0'; c++ ) {
+    hash = ( hash ^ (unsigned char)*c ) * 16777619u;
+  }
+  return hash;
+}// end static const unsigned int PeerStatsParser::hashAddress( const char* )
@@ -0,0 +1,79 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Initial creation. Shared by the rolling quantile and the Hampel
+ *           despiker.
+ */
+
+#include <crsCorr/rankWindow.h>
+#include <crsCorr/abstractDataSeries.h>
+#include <algorithm>
+#include <utility>
+
+//----< (DE)(CON)STRUCTORS >----------------------------------------------------
+RankWindow::RankWindow( const double* values,
+                        const uint64_t* validity,
+                        const int count )
+  : rankOf( count > 0 ? count : 0, -1 ), top( 1 ), size( 0 )
+{
+  std::vector< std::pair<double, int> > ordered;
+  for( int i = 0; i < count; i++ ) {
+    if( isValidCell( validity, i )) {
+      ordered.push_back( std::make_pair( values[i], i ));
+    }
+  }
+  std::sort( ordered.begin(), ordered.end() );
+  sorted.resize( ordered.size() );
+  for( size_t r = 0; r < ordered.size(); r++ ) {
+    sorted[r] = ordered[r].first;
+    rankOf[ ordered[r].second ] = r;
+  }
+  tree.assign( sorted.size() + 1, 0 );
+  while( top * 2 <= (int)sorted.size() ) {
+    top *= 2;
+  }
+}// end RankWindow::RankWindow( const double*, const uint64_t*, const int )
+
+//----< ACCESSOR METHODS >------------------------------------------------------
+const bool RankWindow::isRanked( const int cell ) const {
+  return cell >= 0 && cell < (int)rankOf.size() && rankOf[cell] >= 0;
+}// end const bool RankWindow::isRanked( const int ) const
+
+
+const int RankWindow::getSize() const {
+  return size;
+}// end const int RankWindow::getSize() const
+
+
+const double RankWindow::select( int k ) const {
+  // descend the tree by halving steps, skipping every subtree whose count
+  //   still falls short of k
+  int rank = 0;
+  for( int step = top; step > 0; step >>= 1 ) {
+    if( rank + step < (int)tree.size() && tree[ rank + step ] < k ) {
+      rank += step;
+      k -= tree[ rank ];
+    }
+  }
+  return sorted[ rank ];
+}// end const double RankWindow::select( int ) const
+
+//----< WINDOW METHODS >--------------------------------------------------------
+void RankWindow::insert( const int cell ) {
+  update( cell, 1 );
+}// end void RankWindow::insert( const int )
+
+
+void RankWindow::remove( const int cell ) {
+  update( cell, -1 );
+}// end void RankWindow::remove( const int )
+
+
+void RankWindow::update( const int cell, const int change ) {
+  if( !isRanked( cell )) {
+    return;
+  }
+  size += change;
+  for( int r = rankOf[cell] + 1; r < (int)tree.size(); r += r & -r ) {
+    tree[r] += change;
+  }
+}// end void RankWindow::update( const int, const int )
@@ -0,0 +1,336 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/resultWriter.h>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+/*
+ * Formats value into text, returning the characters used. Without
+ *   std::to_chars, "%.17g" still reads back exactly and snprintf uses the
+ *   "C" locale unless the program calls setlocale.
+ */
+static inline int formatNumber( char* text, const double value ) {
+#if defined( __cpp_lib_to_chars )
+  return std::to_chars( text, text + RESULTWRITER_NUMBER_SIZE, value ).ptr
+         - text;
+#else
+  return snprintf( text, RESULTWRITER_NUMBER_SIZE, "%.17g", value );
+#endif
+}// end static inline int formatNumber( char*, const double )
+
+
+static inline int formatNumber( char* text, const int value ) {
+#if __cplusplus >= 201703L
+  return std::to_chars( text, text + RESULTWRITER_NUMBER_SIZE, value ).ptr
+         - text;
+#else
+  return snprintf( text, RESULTWRITER_NUMBER_SIZE, "%d", value );
+#endif
+}// end static inline int formatNumber( char*, const int )
+
+//----< (DE)(CON)STRUCTORS >----------------------------------------------------
+ResultWriter::ResultWriter( const string fileName,
+                            const int format,
+                            const bool asynchronous,
+                            const size_t chunkSize,
+                            const int chunkCount )
+  : fileName( fileName ),
+    format( format ),
+    asynchronous( asynchronous ),
+    chunkSize( chunkSize >= RESULTWRITER_NUMBER_SIZE * 4
+               ? chunkSize : RESULTWRITER_CHUNK_SIZE ),
+    chunkCount( !asynchronous ? 1 : chunkCount > 1 ? chunkCount : 2 )
+{
+  LOG_DEBUG( 14, "( " << fileName << ", " << format << ", " << asynchronous \
+                 << ", " << chunkSize << ", " << chunkCount << " )" )
+
+  fillIndex = 0;
+  writeIndex = 0;
+  filled = 0;
+  stopping = false;
+  failed = false;
+  started = false;
+  closed = false;
+
+  pthread_mutex_init( &lock, NULL );
+  pthread_cond_init( &chunkReady, NULL );
+  pthread_cond_init( &chunkFree, NULL );
+
+  chunks = new Chunk[ this->chunkCount ];
+  for( int i = 0; i < this->chunkCount; i++ ) {
+    chunks[i].bytes = new char[ this->chunkSize ];
+    chunks[i].count = 0;
+  }
+
+  if( format != RESULTWRITER_TEXT && format != RESULTWRITER_BINARY ) {
+    LOG_ERR( "Unknown result format " << format << " for " << fileName )
+    fileDescriptor = -1;
+    failed = true;
+    return;
+  }
+  fileDescriptor = open( fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                         0644 );
+  if( fileDescriptor < 0 ) {
+    LOG_ERR( "Unable to open " << fileName << ": " << strerror( errno ))
+    failed = true;
+    return;
+  }
+
+  if( asynchronous ) {
+    if( pthread_create( &thread, NULL, ResultWriter::run, this ) != 0 ) {
+      LOG_ERR( "Unable to start result writing thread." )
+      failed = true;
+      return;
+    }
+    started = true;
+  }
+}// end ResultWriter::ResultWriter( const string, const int, ... )
+
+
+ResultWriter::~ResultWriter() {
+  LOG_DEBUG( 14, "()" )
+
+  close();
+  for( int i = 0; i < chunkCount; i++ ) {
+    delete[] chunks[i].bytes;
+  }
+  delete[] chunks;
+  pthread_cond_destroy( &chunkFree );
+  pthread_cond_destroy( &chunkReady );
+  pthread_mutex_destroy( &lock );
+}// end ResultWriter::~ResultWriter()
+
+//----< THREAD METHODS >--------------------------------------------------------
+void* ResultWriter::run( void* writer ) {
+  ResultWriter* self = (ResultWriter*)writer;
+  LOG_DEBUG( 14, "( " << self->fileName << " )" )
+
+  pthread_mutex_lock( &self->lock );
+  while( true ) {
+    while( self->filled == 0 && !self->stopping ) {
+      pthread_cond_wait( &self->chunkReady, &self->lock );
+    }
+    if( self->filled == 0 ) {
+      break;
+    }
+    Chunk& chunk = self->chunks[ self->writeIndex ];
+    pthread_mutex_unlock( &self->lock );
+
+    // after a failure chunks are only drained so the caller never blocks
+    bool written = self->failed || self->writeBytes( chunk.bytes,
+                                                     chunk.count );
+    chunk.count = 0;
+
+    pthread_mutex_lock( &self->lock );
+    self->failed = self->failed || !written;
+    self->writeIndex = ( self->writeIndex + 1 ) % self->chunkCount;
+    self->filled--;
+    pthread_cond_signal( &self->chunkFree );
+  }
+  pthread_mutex_unlock( &self->lock );
+  return NULL;
+}// end void* ResultWriter::run( void* )
+
+
+const bool ResultWriter::writeBytes( const char* bytes, const size_t count ) {
+  size_t done = 0;
+  while( done < count ) {
+    ssize_t written = write( fileDescriptor, bytes + done, count - done );
+    if( written < 0 ) {
+      if( errno == EINTR ) {
+        continue;
+      }
+      LOG_ERR( "Write failed on " << fileName << ": " << strerror( errno ))
+      return false;
+    }
+    done += written;
+  }
+  return true;
+}// end const bool ResultWriter::writeBytes( const char*, const size_t )
+
+//----< BUFFER METHODS >--------------------------------------------------------
+void ResultWriter::flushChunk() {
+  Chunk& chunk = chunks[ fillIndex ];
+  if( chunk.count == 0 ) {
+    return;
+  }
+
+  if( !started ) {
+    if( !failed && !writeBytes( chunk.bytes, chunk.count )) {
+      failed = true;
+    }
+    chunk.count = 0;
+    return;
+  }
+
+  pthread_mutex_lock( &lock );
+  filled++;
+  pthread_cond_signal( &chunkReady );
+  while( filled == chunkCount ) {
+    pthread_cond_wait( &chunkFree, &lock );
+  }
+  pthread_mutex_unlock( &lock );
+  fillIndex = ( fillIndex + 1 ) % chunkCount;
+}// end void ResultWriter::flushChunk()
+
+
+char* ResultWriter::reserve( const size_t count ) {
+  if( chunks[ fillIndex ].count + count > chunkSize ) {
+    flushChunk();
+  }
+  Chunk& chunk = chunks[ fillIndex ];
+  char* room = chunk.bytes + chunk.count;
+  chunk.count += count;
+  return room;
+}// end char* ResultWriter::reserve( const size_t )
+
+
+void ResultWriter::append( const void* bytes, const size_t count ) {
+  const char* next = (const char*)bytes;
+  size_t left = count;
+  while( left > 0 ) {
+    size_t room = chunkSize - chunks[ fillIndex ].count;
+    if( room == 0 ) {
+      flushChunk();
+      continue;
+    }
+    size_t piece = left < room ? left : room;
+    memcpy( reserve( piece ), next, piece );
+    next += piece;
+    left -= piece;
+  }
+}// end void ResultWriter::append( const void*, const size_t )
+
+
+void ResultWriter::appendLabel( const string& label ) {
+  int length = label.size();
+  append( &length, sizeof( int ));
+  append( label.data(), length );
+}// end void ResultWriter::appendLabel( const string& )
+
+//----< WRITING >---------------------------------------------------------------
+const bool ResultWriter::writeTable( const ResultHeader& header,
+                                     const ResultColumn* columns,
+                                     const int columnCount,
+                                     const int rows )
+{
+  LOG_DEBUG( 14, "( " << header.labelA << ", " << header.labelB << ", " \
+                 << columnCount << ", " << rows << " )" )
+
+  if( closed || !good() ) {
+    LOG_ERR( "Result file " << fileName << " is not writable." )
+    return false;
+  }
+  if( columnCount < 1 || rows < 0 ) {
+    LOG_ERR( "Bad table of " << columnCount << " columns by " << rows \
+             << " rows" )
+    return false;
+  }
+  for( int c = 0; c < columnCount; c++ ) {
+    const ResultColumn& column = columns[c];
+    if( !( column.type == DATATYPE_INT && column.ints != NULL )
+        && !( column.type == DATATYPE_DOUBLE && column.doubles != NULL ))
+    {
+      LOG_ERR( "Column '" << column.label << "' has no values of type " \
+               << column.type )
+      return false;
+    }
+  }
+
+  if( format == RESULTWRITER_BINARY ) {
+    const int fields[] = { RESULTWRITER_VERSION, header.resolution,
+                           header.lagOffset, rows, columnCount };
+    append( RESULTWRITER_MAGIC, 4 );
+    append( fields, sizeof( fields ));
+    appendLabel( header.labelA );
+    appendLabel( header.labelB );
+    for( int c = 0; c < columnCount; c++ ) {
+      const ResultColumn& column = columns[c];
+      append( &column.type, sizeof( int ));
+      appendLabel( column.label );
+      if( column.type == DATATYPE_INT ) {
+        append( column.ints, rows * sizeof( int ));
+      } else {
+        append( column.doubles, rows * sizeof( double ));
+      }
+    }
+    return good();
+  }
+
+  // a comment line gnuplot skips, then one line per row
+  string comment = "# " + header.labelA + " " + header.labelB;
+  for( int c = 0; c < columnCount; c++ ) {
+    comment += " " + columns[c].label;
+  }
+  comment += "\n";
+  append( comment.data(), comment.size() );
+
+  const size_t lineSize = columnCount * ( RESULTWRITER_NUMBER_SIZE + 1 );
+  if( lineSize > chunkSize ) {
+    LOG_ERR( "A row of " << columnCount << " columns exceeds the chunk size" )
+    return false;
+  }
+  for( int r = 0; r < rows; r++ ) {
+    char* line = reserve( lineSize );
+    char* next = line;
+    for( int c = 0; c < columnCount; c++ ) {
+      const ResultColumn& column = columns[c];
+      if( column.type == DATATYPE_INT ) {
+        next += formatNumber( next, column.ints[r] );
+      } else {
+        next += formatNumber( next, column.doubles[r] );
+      }
+      *next++ = c + 1 < columnCount ? ' ' : '\n';
+    }
+    // give back what the line did not use
+    chunks[ fillIndex ].count -= lineSize - ( next - line );
+  }
+  return good();
+}// end const bool ResultWriter::writeTable( const ResultHeader&, ... )
+
+
+const bool ResultWriter::close() {
+  if( closed ) {
+    return good();
+  }
+  LOG_DEBUG( 14, "( " << fileName << " )" )
+  closed = true;
+
+  if( fileDescriptor >= 0 ) {
+    flushChunk();
+  }
+  if( started ) {
+    pthread_mutex_lock( &lock );
+    stopping = true;
+    pthread_cond_broadcast( &chunkReady );
+    pthread_mutex_unlock( &lock );
+    pthread_join( thread, NULL );
+    started = false;
+  }
+  if( fileDescriptor >= 0 ) {
+    if( ::close( fileDescriptor ) != 0 ) {
+      LOG_ERR( "Unable to close " << fileName << ": " << strerror( errno ))
+      failed = true;
+    }
+    fileDescriptor = -1;
+  }
+  return good();
+}// end const bool ResultWriter::close()
+
+
+const bool ResultWriter::good() const {
+  pthread_mutex_lock( (pthread_mutex_t*)&lock );
+  bool ok = !failed;
+  pthread_mutex_unlock( (pthread_mutex_t*)&lock );
+  return ok;
+}// end const bool ResultWriter::good() const
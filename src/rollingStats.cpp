@@ -0,0 +1,199 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Quantiles use RankWindow, shared with Despike.
+ *
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/rollingStats.h>
+#include <crsCorr/rankWindow.h>
+#include <cstring>
+#include <deque>
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+static inline void setResult( double* out,
+                              uint64_t* outValid,
+                              const int cell,
+                              const bool defined,
+                              const double value )
+{
+  out[cell] = defined ? value : 0.0;
+  if( outValid != NULL && defined ) {
+    outValid[ cell >> 6 ] |= (uint64_t)1 << ( cell & 63 );
+  }
+}// end static inline void setResult( double*, uint64_t*, ... )
+
+//----< ROLLING STATISTICS >----------------------------------------------------
+const bool RollingStats::compute( const double* values,
+                                  const uint64_t* validity,
+                                  const int count,
+                                  const int window,
+                                  const int statistic,
+                                  const double quantile,
+                                  const int minValid,
+                                  double* out,
+                                  uint64_t* outValid )
+{
+  LOG_DEBUG( 12, "( values, validity, " << count << ", " << window << ", " \
+                 << statistic << ", " << quantile << ", " << minValid << " )" )
+
+  if( values == NULL || out == NULL || count < 0 ) {
+    LOG_ERR( "No values to roll." )
+    return false;
+  } else if( window < 1 ) {
+    LOG_ERR( "Window of " << window << " cells must be positive." )
+    return false;
+  } else if( statistic == ROLLING_QUANTILE
+             && !( quantile >= 0.0 && quantile <= 1.0 ))
+  {
+    LOG_ERR( "Quantile " << quantile << " outside 0 to 1." )
+    return false;
+  }
+
+  if( outValid != NULL ) {
+    memset( outValid, 0, (( count + 63 ) / 64 ) * sizeof( uint64_t ));
+  }
+  int needed = minValid < 1 ? 1 : minValid;
+  switch( statistic ) {
+    case ROLLING_MEAN:
+      rollMoments( values, validity, count, window, false, needed,
+                   out, outValid );
+      break;
+    case ROLLING_VARIANCE:
+      rollMoments( values, validity, count, window, true,
+                   needed < 2 ? 2 : needed, out, outValid );
+      break;
+    case ROLLING_MIN:
+      rollExtreme( values, validity, count, window, false, needed,
+                   out, outValid );
+      break;
+    case ROLLING_MAX:
+      rollExtreme( values, validity, count, window, true, needed,
+                   out, outValid );
+      break;
+    case ROLLING_QUANTILE:
+      rollQuantile( values, validity, count, window, quantile, needed,
+                    out, outValid );
+      break;
+    default:
+      LOG_ERR( "Unknown rolling statistic " << statistic )
+      return false;
+  }
+  return true;
+}// end static const bool RollingStats::compute( const double*, ... )
+
+
+void RollingStats::rollMoments( const double* values,
+                                const uint64_t* validity,
+                                const int count,
+                                const int window,
+                                const bool variance,
+                                const int minValid,
+                                double* out,
+                                uint64_t* outValid )
+{
+  int n = 0;
+  double mean = 0.0;
+  double squares = 0.0;                 // sum of squared deviations
+  for( int i = 0; i < count; i++ ) {
+    // the cell leaving the window
+    int leaving = i - window;
+    if( leaving >= 0 && isValidCell( validity, leaving )) {
+      double x = values[ leaving ];
+      if( --n == 0 ) {
+        mean = 0.0;
+        squares = 0.0;
+      } else {
+        double delta = x - mean;
+        mean -= delta / n;
+        squares -= delta * ( x - mean );
+      }
+    }
+
+    // the cell entering it
+    if( isValidCell( validity, i )) {
+      double x = values[i];
+      double delta = x - mean;
+      mean += delta / ++n;
+      squares += delta * ( x - mean );
+    }
+    if( squares < 0.0 ) {
+      squares = 0.0;
+    }
+
+    setResult( out, outValid, i, n >= minValid,
+               variance ? squares / ( n - 1 ) : mean );
+  }
+}// end static void RollingStats::rollMoments( const double*, ... )
+
+
+void RollingStats::rollExtreme( const double* values,
+                                const uint64_t* validity,
+                                const int count,
+                                const int window,
+                                const bool maximum,
+                                const int minValid,
+                                double* out,
+                                uint64_t* outValid )
+{
+  // cells that may yet be the extreme, their values monotonic front to back
+  std::deque<int> candidates;
+  int n = 0;
+  for( int i = 0; i < count; i++ ) {
+    int leaving = i - window;
+    if( leaving >= 0 && isValidCell( validity, leaving )) {
+      n--;
+      if( !candidates.empty() && candidates.front() == leaving ) {
+        candidates.pop_front();
+      }
+    }
+
+    if( isValidCell( validity, i )) {
+      n++;
+      double x = values[i];
+      while( !candidates.empty()
+             && ( maximum ? values[ candidates.back() ] <= x
+                          : values[ candidates.back() ] >= x ))
+      {
+        candidates.pop_back();
+      }
+      candidates.push_back( i );
+    }
+
+    setResult( out, outValid, i, n >= minValid && !candidates.empty(),
+               candidates.empty() ? 0.0 : values[ candidates.front() ] );
+  }
+}// end static void RollingStats::rollExtreme( const double*, ... )
+
+
+void RollingStats::rollQuantile( const double* values,
+                                 const uint64_t* validity,
+                                 const int count,
+                                 const int window,
+                                 const double quantile,
+                                 const int minValid,
+                                 double* out,
+                                 uint64_t* outValid )
+{
+  RankWindow ranks( values, validity, count );
+  for( int i = 0; i < count; i++ ) {
+    ranks.remove( i - window );
+    ranks.insert( i );
+    const int n = ranks.getSize();
+
+    if( n < minValid || n == 0 ) {
+      setResult( out, outValid, i, false, 0.0 );
+      continue;
+    }
+
+    // the k-th smallest present rank for each side of the interpolation
+    double position = quantile * ( n - 1 );
+    int lower = (int)position;
+    int upper = lower + 1 < n ? lower + 1 : lower;
+    double bounds[2] = { ranks.select( lower + 1 ),
+                         ranks.select( upper + 1 ) };
+    setResult( out, outValid, i, true,
+               bounds[0] + ( position - lower ) * ( bounds[1] - bounds[0] ));
+  }
+}// end static void RollingStats::rollQuantile( const double*, ... )
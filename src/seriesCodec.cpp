@@ -0,0 +1,453 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/seriesCodec.h>
+#include <cstddef>
+#include <cstring>
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+/*
+ * Appends bits to a string, least significant bit first.
+ */
+class BitWriter {
+  private:
+    string& out;
+    uint64_t pending;                   // bits not yet appended
+    int pendingBits;
+
+  public:
+    BitWriter( string& out ) : out( out ), pending( 0 ), pendingBits( 0 ) {}
+
+    void write( const uint64_t value, const int bits ) {
+      if( bits == 0 ) {
+        return;
+      }
+      uint64_t masked = bits == 64 ? value : value & (( (uint64_t)1 << bits ) - 1 );
+      pending |= masked << pendingBits;
+      int used = 64 - pendingBits;
+      if( bits >= used ) {
+        out.append( (const char*)&pending, sizeof( uint64_t ));
+        pending = used == 64 ? 0 : masked >> used;
+        pendingBits = bits - used;
+      } else {
+        pendingBits += bits;
+      }
+    }
+
+    void flush() {
+      out.append( (const char*)&pending, ( pendingBits + 7 ) / 8 );
+      pending = 0;
+      pendingBits = 0;
+    }
+};
+
+
+/*
+ * Reads bits written by BitWriter. Reads past the end return zeros and set
+ *   the overrun flag.
+ */
+class BitReader {
+  private:
+    const unsigned char* in;
+    size_t size;
+    size_t position;                    // bit position
+
+  public:
+    bool overrun;
+
+    BitReader( const char* in, const size_t size )
+      : in( (const unsigned char*)in ), size( size ), position( 0 ),
+        overrun( false ) {}
+
+    uint64_t read( const int bits ) {
+      if( bits == 0 ) {
+        return 0;
+      }
+      if( position + bits > size * 8 ) {
+        overrun = true;
+        position += bits;
+        return 0;
+      }
+      uint64_t value = 0;
+      int done = 0;
+      while( done < bits ) {
+        size_t byte = position >> 3;
+        int shift = position & 7;
+        int take = 8 - shift;
+        if( take > bits - done ) {
+          take = bits - done;
+        }
+        uint64_t chunk = ( in[byte] >> shift ) & (( 1u << take ) - 1 );
+        value |= chunk << done;
+        done += take;
+        position += take;
+      }
+      return value;
+    }
+};
+
+
+static inline uint64_t zigzag( const int64_t value ) {
+  return ( (uint64_t)value << 1 ) ^ (uint64_t)( value >> 63 );
+}// end static inline uint64_t zigzag( const int64_t )
+
+
+static inline int64_t unzigzag( const uint64_t value ) {
+  return (int64_t)( value >> 1 ) ^ -(int64_t)( value & 1 );
+}// end static inline int64_t unzigzag( const uint64_t )
+
+
+static inline int leadingZeros( const uint64_t value ) {
+  return value == 0 ? 64 : __builtin_clzll( value );
+}// end static inline int leadingZeros( const uint64_t )
+
+
+static inline int trailingZeros( const uint64_t value ) {
+  return value == 0 ? 64 : __builtin_ctzll( value );
+}// end static inline int trailingZeros( const uint64_t )
+
+//----< BLOCK ENCODINGS >-------------------------------------------------------
+/*
+ * Returns the bytes of value as a base 128 varint.
+ */
+static inline int varintBytes( uint64_t value ) {
+  int bytes = 1;
+  while( value >= 0x80 ) {
+    value >>= 7;
+    bytes++;
+  }
+  return bytes;
+}// end static inline int varintBytes( uint64_t )
+
+
+/*
+ * Integer payload: first value (32 bits), width byte, a 16 bit exception
+ *   count, the zigzag mapped delta-of-delta of each later value packed at
+ *   width bits, then the exceptions. A delta-of-delta wider than width is
+ *   packed as 0 and listed as an exception: a 16 bit index and the zigzag
+ *   value as a varint. The width is chosen to minimize the payload, so the
+ *   rare jumps of a timestamp column do not widen every other field.
+ */
+static void encodeInts( const int* values, const int count, string& out ) {
+  out.append( (const char*)&values[0], sizeof( int ));
+
+  // bytes needed by the exceptions of each width
+  uint64_t* fields = new uint64_t[ count ];
+  int widthBytes[ 65 ] = { 0 };
+  int64_t delta = 0;
+  for( int i = 1; i < count; i++ ) {
+    int64_t next = (int64_t)values[i] - values[ i - 1 ];
+    fields[i] = zigzag( next - delta );
+    delta = next;
+    int bits = 64 - leadingZeros( fields[i] );
+    widthBytes[bits] += sizeof( uint16_t ) + varintBytes( fields[i] );
+  }
+  unsigned char width = 0;
+  size_t best = (size_t)-1;
+  int widerBytes = 0;
+  for( int bits = 64; bits >= 0; bits-- ) {
+    if( bits <= SERIESCODEC_MAX_WIDTH ) {
+      size_t size = ( (size_t)( count - 1 ) * bits + 7 ) / 8 + widerBytes;
+      if( size <= best ) {
+        best = size;
+        width = bits;
+      }
+    }
+    widerBytes += widthBytes[bits];
+  }
+  out.append( (const char*)&width, 1 );
+
+  uint64_t limit = (uint64_t)1 << width;
+  uint16_t exceptions = 0;
+  for( int i = 1; i < count; i++ ) {
+    exceptions += fields[i] >= limit;
+  }
+  out.append( (const char*)&exceptions, sizeof( uint16_t ));
+
+  BitWriter writer( out );
+  for( int i = 1; i < count; i++ ) {
+    writer.write( fields[i] < limit ? fields[i] : 0, width );
+  }
+  writer.flush();
+
+  for( int i = 1; i < count; i++ ) {
+    if( fields[i] >= limit ) {
+      uint16_t index = i;
+      out.append( (const char*)&index, sizeof( uint16_t ));
+      uint64_t field = fields[i];
+      while( field >= 0x80 ) {
+        out += (char)( field | 0x80 );
+        field >>= 7;
+      }
+      out += (char)field;
+    }
+  }
+  delete[] fields;
+}// end static void encodeInts( const int*, const int, string& )
+
+
+static bool decodeInts( const char* in,
+                        const size_t size,
+                        const int count,
+                        int* values )
+{
+  size_t headerSize = sizeof( int ) + 1 + sizeof( uint16_t );
+  if( size < headerSize ) {
+    return false;
+  }
+  memcpy( &values[0], in, sizeof( int ));
+  unsigned char width = in[ sizeof( int ) ];
+  uint16_t exceptions;
+  memcpy( &exceptions, in + sizeof( int ) + 1, sizeof( uint16_t ));
+  const unsigned char* packed = (const unsigned char*)in + headerSize;
+  size_t packedSize = ( (uint64_t)( count - 1 ) * width + 7 ) / 8;
+  if( width > SERIESCODEC_MAX_WIDTH || headerSize + packedSize > size ) {
+    return false;
+  }
+
+  // every field fits one unaligned 64 bit load, so the fields unpack
+  //   independently of each other; only the final running sums are serial
+  uint64_t mask = ( (uint64_t)1 << width ) - 1;
+  size_t safe = packedSize >= 8 ? packedSize - 8 : 0;
+  int i = 1;
+  for( ; packedSize >= 8 && i < count
+         && (( (size_t)( i - 1 ) * width ) >> 3 ) <= safe; i++ )
+  {
+    size_t bit = (size_t)( i - 1 ) * width;
+    uint64_t word;
+    memcpy( &word, packed + ( bit >> 3 ), sizeof( uint64_t ));
+    values[i] = (int)(uint32_t)unzigzag(( word >> ( bit & 7 )) & mask );
+  }
+  for( ; i < count; i++ ) {
+    size_t bit = (size_t)( i - 1 ) * width;
+    uint64_t word = 0;
+    memcpy( &word, packed + ( bit >> 3 ), packedSize - ( bit >> 3 ));
+    values[i] = (int)(uint32_t)unzigzag(( word >> ( bit & 7 )) & mask );
+  }
+
+  // patch in the exceptions
+  const unsigned char* next = packed + packedSize;
+  const unsigned char* end = (const unsigned char*)in + size;
+  for( int e = 0; e < exceptions; e++ ) {
+    uint16_t index;
+    if( end - next < (ptrdiff_t)sizeof( uint16_t )) {
+      return false;
+    }
+    memcpy( &index, next, sizeof( uint16_t ));
+    next += sizeof( uint16_t );
+    uint64_t field = 0;
+    int shift = 0;
+    do {
+      if( next == end || shift > 63 ) {
+        return false;
+      }
+      field |= (uint64_t)( *next & 0x7f ) << shift;
+      shift += 7;
+    } while( *next++ & 0x80 );
+    if( index == 0 || index >= count ) {
+      return false;
+    }
+    values[index] = (int)(uint32_t)unzigzag( field );
+  }
+  if( next != end ) {
+    return false;
+  }
+
+  // the values are sums of the deltas-of-deltas, so the sums may wrap at 32
+  //   bits and still reproduce every value exactly
+  uint32_t delta = 0;
+  uint32_t value = values[0];
+  for( i = 1; i < count; i++ ) {
+    delta += (uint32_t)values[i];
+    value += delta;
+    values[i] = (int)value;
+  }
+  return true;
+}// end static bool decodeInts( const char*, const size_t, const int, int* )
+
+
+/*
+ * Double payload: the first value in full, then per value a control bit of 0
+ *   when it repeats the previous value; otherwise 1 followed by 0 to reuse the
+ *   previous window of meaningful bits, or 1 and a new window (6 bits of
+ *   leading zeros, 6 bits of length minus one) before the meaningful bits.
+ */
+static void encodeDoubles( const double* values,
+                           const int count,
+                           string& out )
+{
+  BitWriter writer( out );
+  uint64_t previous;
+  memcpy( &previous, &values[0], sizeof( uint64_t ));
+  writer.write( previous, 64 );
+
+  int windowLeading = -1;
+  int windowLength = 0;
+  for( int i = 1; i < count; i++ ) {
+    uint64_t current;
+    memcpy( &current, &values[i], sizeof( uint64_t ));
+    uint64_t xored = current ^ previous;
+    previous = current;
+    if( xored == 0 ) {
+      writer.write( 0, 1 );
+      continue;
+    }
+    writer.write( 1, 1 );
+
+    int leading = leadingZeros( xored );
+    int trailing = trailingZeros( xored );
+    if( windowLeading >= 0 && leading >= windowLeading
+        && trailing >= 64 - windowLeading - windowLength )
+    {
+      writer.write( 0, 1 );
+      writer.write( xored >> ( 64 - windowLeading - windowLength ),
+                    windowLength );
+    } else {
+      windowLeading = leading;
+      windowLength = 64 - leading - trailing;
+      writer.write( 1, 1 );
+      writer.write( windowLeading, 6 );
+      writer.write( windowLength - 1, 6 );
+      writer.write( xored >> trailing, windowLength );
+    }
+  }
+  writer.flush();
+}// end static void encodeDoubles( const double*, const int, string& )
+
+
+static bool decodeDoubles( const char* in,
+                           const size_t size,
+                           const int count,
+                           double* values )
+{
+  BitReader reader( in, size );
+  uint64_t previous = reader.read( 64 );
+  memcpy( &values[0], &previous, sizeof( double ));
+
+  int windowLeading = -1;
+  int windowLength = 0;
+  for( int i = 1; i < count && !reader.overrun; i++ ) {
+    if( reader.read( 1 ) != 0 ) {
+      if( reader.read( 1 ) != 0 ) {
+        windowLeading = (int)reader.read( 6 );
+        windowLength = (int)reader.read( 6 ) + 1;
+        if( windowLeading + windowLength > 64 ) {
+          return false;
+        }
+      } else if( windowLeading < 0 ) {
+        return false;
+      }
+      previous ^= reader.read( windowLength )
+                  << ( 64 - windowLeading - windowLength );
+    }
+    memcpy( &values[i], &previous, sizeof( double ));
+  }
+  return !reader.overrun;
+}// end static bool decodeDoubles( const char*, const size_t, const int, ... )
+
+//----< CODEC >-----------------------------------------------------------------
+const bool SeriesCodec::encode( const void* values,
+                                const int count,
+                                const int type,
+                                string& out )
+{
+  LOG_DEBUG( 8, "( values, " << count << ", " << type << ", out )" )
+
+  if( type != DATATYPE_INT && type != DATATYPE_DOUBLE ) {
+    LOG_ERR( "Cannot encode values of type " << type )
+    return false;
+  }
+
+  for( int first = 0; first < count; first += SERIESCODEC_BLOCK ) {
+    BlockHeader header;
+    header.count = count - first < SERIESCODEC_BLOCK ? count - first
+                                                     : SERIESCODEC_BLOCK;
+    size_t headerPos = out.size();
+    out.append( (const char*)&header, sizeof( BlockHeader ));
+    if( type == DATATYPE_INT ) {
+      encodeInts( (const int*)values + first, header.count, out );
+    } else {
+      encodeDoubles( (const double*)values + first, header.count, out );
+    }
+    header.bytes = out.size() - headerPos - sizeof( BlockHeader );
+    out.replace( headerPos, sizeof( BlockHeader ),
+                 (const char*)&header, sizeof( BlockHeader ));
+  }
+  return true;
+}// end static const bool SeriesCodec::encode( const void*, const int, ... )
+
+
+const size_t SeriesCodec::decodeBlock( const char* in,
+                                       const size_t size,
+                                       const int type,
+                                       void* values,
+                                       int* decoded )
+{
+  BlockHeader header;
+  if( size < sizeof( BlockHeader )) {
+    return 0;
+  }
+  memcpy( &header, in, sizeof( BlockHeader ));
+  if( header.count == 0 || header.count > SERIESCODEC_BLOCK
+      || header.bytes > size - sizeof( BlockHeader ))
+  {
+    return 0;
+  }
+
+  const char* payload = in + sizeof( BlockHeader );
+  bool good = false;
+  if( type == DATATYPE_INT ) {
+    good = decodeInts( payload, header.bytes, header.count, (int*)values );
+  } else if( type == DATATYPE_DOUBLE ) {
+    good = decodeDoubles( payload, header.bytes, header.count,
+                          (double*)values );
+  }
+  if( !good ) {
+    return 0;
+  }
+  *decoded = header.count;
+  return sizeof( BlockHeader ) + header.bytes;
+}// end static const size_t SeriesCodec::decodeBlock( const char*, ... )
+
+
+const bool SeriesCodec::decode( const char* in,
+                                const size_t size,
+                                const int type,
+                                const int count,
+                                void* values )
+{
+  LOG_DEBUG( 8, "( in, " << size << ", " << type << ", " << count << " )" )
+
+  int valueSize = type == DATATYPE_INT ? sizeof( int ) : sizeof( double );
+  int filled = 0;
+  size_t pos = 0;
+  while( pos < size ) {
+    if( count - filled < SERIESCODEC_BLOCK ) {
+      // decode a final short block through scratch space
+      char scratch[ SERIESCODEC_BLOCK * sizeof( double ) ];
+      int decoded = 0;
+      size_t used = decodeBlock( in + pos, size - pos, type, scratch,
+                                 &decoded );
+      if( used == 0 || decoded > count - filled ) {
+        return false;
+      }
+      memcpy( (char*)values + (size_t)filled * valueSize, scratch,
+              (size_t)decoded * valueSize );
+      filled += decoded;
+      pos += used;
+      continue;
+    }
+    int decoded = 0;
+    size_t used = decodeBlock( in + pos, size - pos, type,
+                               (char*)values + (size_t)filled * valueSize,
+                               &decoded );
+    if( used == 0 ) {
+      return false;
+    }
+    filled += decoded;
+    pos += used;
+  }
+  return filled == count;
+}// end static const bool SeriesCodec::decode( const char*, const size_t, ... )
@@ -0,0 +1,386 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/seriesFilter.h>
+#include <crsCorr/fft.h>
+#include <cmath>
+
+//----< SERIESFILTER >----------------------------------------------------------
+DataSeries<double>* SeriesFilter::makeSeries( const AbstractDataSeries& source,
+                                              double* values,
+                                              const string label )
+{
+  LOG_DEBUG( 12, "( " << source.getLabel() << ", values, " << label << " )" )
+
+  DataSeries<double>* series = new DataSeries<double>( label );
+  if( !series->adoptData( values, source.getLength(),
+                          source.getResolution(), source.getStartTime() ))
+  {
+    delete series;
+    return NULL;
+  }
+  series->setValidity( source.getValidity() );
+  return series;
+}// end DataSeries<double>* SeriesFilter::makeSeries( const AbstractDataSeries&, ... )
+
+
+const bool SeriesFilter::removeMean( double* values,
+                                     const uint64_t* validity,
+                                     const int count )
+{
+  LOG_DEBUG( 12, "( values, validity, " << count << " )" )
+
+  double sum = 0.0;
+  int valid = 0;
+  for( int i = 0; i < count; i++ ) {
+    if( isValidCell( validity, i )) {
+      sum += values[i];
+      valid++;
+    }
+  }
+  if( valid == 0 ) {
+    return false;
+  }
+  double mean = sum / valid;
+  for( int i = 0; i < count; i++ ) {
+    values[i] -= mean;
+  }
+  return true;
+}// end static const bool SeriesFilter::removeMean( double*, ... )
+
+
+const bool SeriesFilter::detrend( double* values,
+                                  const uint64_t* validity,
+                                  const int count,
+                                  const int order )
+{
+  LOG_DEBUG( 12, "( values, validity, " << count << ", " << order << " )" )
+
+  if( order < 0 || order > SERIESFILTER_MAX_ORDER ) {
+    LOG_ERR( "Detrend order " << order << " outside 0 to " \
+             << SERIESFILTER_MAX_ORDER )
+    return false;
+  } else if( order == 0 ) {
+    return removeMean( values, validity, count );
+  }
+
+  // normal equations of the fit in t = -1 to 1, which keeps them well
+  //   conditioned for long records
+  const int terms = order + 1;
+  double gram[ SERIESFILTER_MAX_ORDER + 1 ][ SERIESFILTER_MAX_ORDER + 2 ];
+  double moments[ 2 * SERIESFILTER_MAX_ORDER + 1 ];
+  memset( gram, 0, sizeof( gram ));
+  memset( moments, 0, sizeof( moments ));
+  double scale = count > 1 ? 2.0 / ( count - 1 ) : 0.0;
+  int valid = 0;
+  for( int i = 0; i < count; i++ ) {
+    if( !isValidCell( validity, i )) {
+      continue;
+    }
+    valid++;
+    double t = i * scale - 1.0;
+    double power = 1.0;
+    for( int j = 0; j <= 2 * order; j++ ) {
+      moments[j] += power;
+      if( j < terms ) {
+        gram[j][terms] += power * values[i];
+      }
+      power *= t;
+    }
+  }
+  if( valid <= order ) {
+    LOG_ERR( valid << " valid samples cannot fit order " << order )
+    return false;
+  }
+  for( int j = 0; j < terms; j++ ) {
+    for( int k = 0; k < terms; k++ ) {
+      gram[j][k] = moments[ j + k ];
+    }
+  }
+
+  // gaussian elimination with partial pivoting
+  for( int col = 0; col < terms; col++ ) {
+    int pivot = col;
+    for( int row = col + 1; row < terms; row++ ) {
+      if( fabs( gram[row][col] ) > fabs( gram[pivot][col] )) {
+        pivot = row;
+      }
+    }
+    if( fabs( gram[pivot][col] ) < 1e-12 * valid ) {
+      LOG_ERR( "Valid samples cannot determine order " << order )
+      return false;
+    }
+    for( int k = 0; k <= terms; k++ ) {
+      double swap = gram[col][k];
+      gram[col][k] = gram[pivot][k];
+      gram[pivot][k] = swap;
+    }
+    for( int row = col + 1; row < terms; row++ ) {
+      double factor = gram[row][col] / gram[col][col];
+      for( int k = col; k <= terms; k++ ) {
+        gram[row][k] -= factor * gram[col][k];
+      }
+    }
+  }
+  double coefficients[ SERIESFILTER_MAX_ORDER + 1 ];
+  for( int row = terms - 1; row >= 0; row-- ) {
+    double sum = gram[row][terms];
+    for( int k = row + 1; k < terms; k++ ) {
+      sum -= gram[row][k] * coefficients[k];
+    }
+    coefficients[row] = sum / gram[row][row];
+  }
+
+  for( int i = 0; i < count; i++ ) {
+    double t = i * scale - 1.0;
+    double fit = coefficients[ order ];
+    for( int j = order - 1; j >= 0; j-- ) {
+      fit = fit * t + coefficients[j];
+    }
+    values[i] -= fit;
+  }
+  return true;
+}// end static const bool SeriesFilter::detrend( double*, ... )
+
+//----< FIRFILTER >-------------------------------------------------------------
+FirFilter::FirFilter( const double* kernel,
+                      const int count,
+                      const bool useFft )
+  : fftSize( 0 )
+{
+  LOG_DEBUG( 12, "( kernel, " << count << ", " << useFft << " )" )
+
+  if( kernel == NULL || count <= 0 ) {
+    LOG_ERR( "FIR kernel must hold at least one tap." )
+    taps.assign( 1, 1.0 );
+  } else {
+    taps.assign( kernel, kernel + count );
+  }
+  history.assign( taps.size() - 1, 0.0 );
+
+  if( useFft && (int)taps.size() >= SERIESFILTER_FFT_TAPS ) {
+    fftSize = Fft::getSize( 4 * taps.size() );
+    spectrum.assign( fftSize, 0.0 );
+    for( size_t k = 0; k < taps.size(); k++ ) {
+      spectrum[k] = taps[k];
+    }
+    Fft::transform( &spectrum[0], fftSize );
+    work.resize( fftSize );
+  }
+}// end FirFilter::FirFilter( const double*, const int, const bool )
+
+
+void FirFilter::reset() {
+  LOG_DEBUG( 12, "()" )
+
+  history.assign( taps.size() - 1, 0.0 );
+}// end void FirFilter::reset()
+
+
+void FirFilter::process( const double* in, double* out, const int count ) {
+  LOG_DEBUG( 12, "( in, out, " << count << " )" )
+
+  if( count <= 0 ) {
+    return;
+  }
+  if( fftSize > 0 ) {
+    processFft( in, out, count );
+  } else {
+    processDirect( in, out, count );
+  }
+}// end void FirFilter::process( const double*, double*, const int )
+
+
+void FirFilter::processDirect( const double* in,
+                               double* out,
+                               const int count )
+{
+  // the previous inputs followed by these; copied so in may equal out
+  const int held = history.size();
+  std::vector<double> extended( history );
+  extended.insert( extended.end(), in, in + count );
+
+  const int tapCount = taps.size();
+  for( int n = 0; n < count; n++ ) {
+    const double* newest = &extended[ held + n ];
+    double sum = 0.0;
+    for( int k = 0; k < tapCount; k++ ) {
+      sum += taps[k] * newest[ -k ];
+    }
+    out[n] = sum;
+  }
+  updateHistory( &extended[0], held + count );
+}// end void FirFilter::processDirect( const double*, double*, const int )
+
+
+void FirFilter::processFft( const double* in, double* out, const int count ) {
+  const int held = history.size();
+  std::vector<double> extended( history );
+  extended.insert( extended.end(), in, in + count );
+
+  // each segment of fftSize inputs yields step outputs; the kernel is real,
+  //   so two segments share a transform as its real and imaginary parts
+  const int step = fftSize - held;
+  for( int first = 0; first < count; first += 2 * step ) {
+    for( int i = 0; i < fftSize; i++ ) {
+      double real = first + i < held + count ? extended[ first + i ] : 0.0;
+      double imag = first + step + i < held + count
+                    ? extended[ first + step + i ] : 0.0;
+      work[i] = std::complex<double>( real, imag );
+    }
+    Fft::transform( &work[0], fftSize );
+    for( int i = 0; i < fftSize; i++ ) {
+      work[i] *= spectrum[i];
+    }
+    Fft::transform( &work[0], fftSize, true );
+
+    for( int i = 0; i < step && first + i < count; i++ ) {
+      out[ first + i ] = work[ held + i ].real();
+    }
+    for( int i = 0; i < step && first + step + i < count; i++ ) {
+      out[ first + step + i ] = work[ held + i ].imag();
+    }
+  }
+  updateHistory( &extended[0], held + count );
+}// end void FirFilter::processFft( const double*, double*, const int )
+
+
+void FirFilter::updateHistory( const double* extended, const int count ) {
+  const int held = history.size();
+  for( int i = 0; i < held; i++ ) {
+    history[i] = extended[ count - held + i ];
+  }
+}// end void FirFilter::updateHistory( const double*, const int )
+
+//----< BIQUADFILTER >----------------------------------------------------------
+void BiquadFilter::addSection( const double b0,
+                               const double b1,
+                               const double b2,
+                               const double a1,
+                               const double a2 )
+{
+  LOG_DEBUG( 12, "( " << b0 << ", " << b1 << ", " << b2 << ", " << a1 \
+                 << ", " << a2 << " )" )
+
+  Section section = { b0, b1, b2, a1, a2, 0.0, 0.0 };
+  sections.push_back( section );
+}// end void BiquadFilter::addSection( const double, ... )
+
+
+const bool BiquadFilter::addLowPass( const double cutoff, const double q ) {
+  LOG_DEBUG( 12, "( " << cutoff << ", " << q << " )" )
+
+  if( cutoff <= 0.0 || cutoff >= 0.5 || q <= 0.0 ) {
+    LOG_ERR( "Low pass cutoff " << cutoff << " or Q " << q << " invalid." )
+    return false;
+  }
+  double w0 = 2.0 * M_PI * cutoff;
+  double alpha = sin( w0 ) / ( 2.0 * q );
+  double a0 = 1.0 + alpha;
+  double c = cos( w0 );
+  addSection( ( 1.0 - c ) / 2.0 / a0, ( 1.0 - c ) / a0, ( 1.0 - c ) / 2.0 / a0,
+              -2.0 * c / a0, ( 1.0 - alpha ) / a0 );
+  return true;
+}// end const bool BiquadFilter::addLowPass( const double, const double )
+
+
+const bool BiquadFilter::addHighPass( const double cutoff, const double q ) {
+  LOG_DEBUG( 12, "( " << cutoff << ", " << q << " )" )
+
+  if( cutoff <= 0.0 || cutoff >= 0.5 || q <= 0.0 ) {
+    LOG_ERR( "High pass cutoff " << cutoff << " or Q " << q << " invalid." )
+    return false;
+  }
+  double w0 = 2.0 * M_PI * cutoff;
+  double alpha = sin( w0 ) / ( 2.0 * q );
+  double a0 = 1.0 + alpha;
+  double c = cos( w0 );
+  addSection( ( 1.0 + c ) / 2.0 / a0, -( 1.0 + c ) / a0, ( 1.0 + c ) / 2.0 / a0,
+              -2.0 * c / a0, ( 1.0 - alpha ) / a0 );
+  return true;
+}// end const bool BiquadFilter::addHighPass( const double, const double )
+
+
+void BiquadFilter::reset() {
+  LOG_DEBUG( 12, "()" )
+
+  for( size_t s = 0; s < sections.size(); s++ ) {
+    sections[s].z1 = 0.0;
+    sections[s].z2 = 0.0;
+  }
+}// end void BiquadFilter::reset()
+
+
+void BiquadFilter::process( const double* in, double* out, const int count ) {
+  LOG_DEBUG( 12, "( in, out, " << count << " )" )
+
+  if( in != out ) {
+    memcpy( out, in, count * sizeof( double ));
+  }
+
+  // a whole block per section keeps each section's state in registers
+  for( size_t s = 0; s < sections.size(); s++ ) {
+    Section& section = sections[s];
+    double z1 = section.z1;
+    double z2 = section.z2;
+    for( int n = 0; n < count; n++ ) {
+      double x = out[n];
+      double y = section.b0 * x + z1;
+      z1 = section.b1 * x - section.a1 * y + z2;
+      z2 = section.b2 * x - section.a2 * y;
+      out[n] = y;
+    }
+    section.z1 = z1;
+    section.z2 = z2;
+  }
+}// end void BiquadFilter::process( const double*, double*, const int )
+
+//----< MOVINGAVERAGE >---------------------------------------------------------
+MovingAverage::MovingAverage( const int width )
+  : next( 0 ), filled( 0 ), sum( 0.0 )
+{
+  LOG_DEBUG( 12, "( " << width << " )" )
+
+  if( width <= 0 ) {
+    LOG_ERR( "Moving average width must be positive." )
+    window.assign( 1, 0.0 );
+  } else {
+    window.assign( width, 0.0 );
+  }
+}// end MovingAverage::MovingAverage( const int )
+
+
+void MovingAverage::reset() {
+  LOG_DEBUG( 12, "()" )
+
+  window.assign( window.size(), 0.0 );
+  next = 0;
+  filled = 0;
+  sum = 0.0;
+}// end void MovingAverage::reset()
+
+
+void MovingAverage::process( const double* in, double* out, const int count ) {
+  LOG_DEBUG( 12, "( in, out, " << count << " )" )
+
+  const int width = window.size();
+  for( int n = 0; n < count; n++ ) {
+    double x = in[n];
+    sum += x - window[next];
+    window[next] = x;
+    if( filled < width ) {
+      filled++;
+    }
+    if( ++next == width ) {
+      // resum once per pass over the ring so rounding cannot accumulate
+      next = 0;
+      sum = 0.0;
+      for( int k = 0; k < width; k++ ) {
+        sum += window[k];
+      }
+    }
+    out[n] = sum / filled;
+  }
+}// end void MovingAverage::process( const double*, double*, const int )
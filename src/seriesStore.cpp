@@ -0,0 +1,541 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    --Re-based segments so days before the first stored year can be
+ *             stored.
+ *
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/seriesStore.h>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+/*
+ * Creates a directory and any missing parents.
+ */
+static bool makeDirectory( const string& path ) {
+  for( size_t pos = 1; pos <= path.size(); pos++ ) {
+    if( pos == path.size() || path[pos] == '/' ) {
+      string prefix = path.substr( 0, pos );
+      if( mkdir( prefix.c_str(), 0755 ) != 0 && errno != EEXIST ) {
+        LOG_ERR( "Unable to create " << prefix << ": " << strerror( errno ))
+        return false;
+      }
+    }
+  }
+  return true;
+}// end static bool makeDirectory( const string& )
+
+
+/*
+ * Writes an entire buffer at an offset.
+ */
+static bool writeAt( const int fd,
+                     const void* buffer,
+                     const size_t size,
+                     const off_t offset )
+{
+  size_t written = 0;
+  while( written < size ) {
+    ssize_t count = pwrite( fd, (const char*)buffer + written,
+                            size - written, offset + written );
+    if( count < 0 && errno == EINTR ) {
+      continue;
+    } else if( count <= 0 ) {
+      LOG_ERR( "Write failed: " << strerror( errno ))
+      return false;
+    }
+    written += count;
+  }
+  return true;
+}// end static bool writeAt( const int, const void*, const size_t, ... )
+
+
+/*
+ * Copies size bytes from one file offset to an offset of another file.
+ */
+static bool copyAt( const int fromFd,
+                    const off_t fromOffset,
+                    const int toFd,
+                    const off_t toOffset,
+                    const size_t size )
+{
+  const size_t bufferSize = 1 << 20;
+  char* buffer = new char[ bufferSize ];
+  size_t copied = 0;
+  while( copied < size ) {
+    size_t chunk = size - copied < bufferSize ? size - copied : bufferSize;
+    ssize_t count = pread( fromFd, buffer, chunk, fromOffset + copied );
+    if( count < 0 && errno == EINTR ) {
+      continue;
+    } else if( count <= 0 ) {
+      LOG_ERR( "Read failed: " << strerror( errno ))
+      delete[] buffer;
+      return false;
+    } else if( !writeAt( toFd, buffer, count, toOffset + copied )) {
+      delete[] buffer;
+      return false;
+    }
+    copied += count;
+  }
+  delete[] buffer;
+  return true;
+}// end static bool copyAt( const int, const off_t, const int, ... )
+
+//----< (DE)(CON)STRUCTORS >----------------------------------------------------
+SeriesStore::SeriesStore( const string rootDir )
+  : root( rootDir )
+{
+  LOG_DEBUG( 5, "( " << rootDir << " )" )
+
+}// end SeriesStore::SeriesStore( const string )
+
+
+SeriesStore::~SeriesStore() {
+  LOG_DEBUG( 5, "()" )
+
+  for( Segments::iterator it = segments.begin(); it != segments.end(); ++it ) {
+    Segment* segment = it->second;
+    if( segment->values != NULL ) {
+      munmap( segment->values, segment->valuesSize );
+    }
+    if( segment->validity != NULL ) {
+      munmap( segment->validity, segment->validitySize );
+    }
+    close( segment->valueFd );
+    close( segment->validityFd );
+    delete segment;
+  }
+  segments.clear();
+
+  for( size_t i = 0; i < retired.size(); i++ ) {
+    munmap( retired[i].first, retired[i].second );
+  }
+  retired.clear();
+}// end SeriesStore::~SeriesStore()
+
+//----< DATE UTILITIES >--------------------------------------------------------
+const int SeriesStore::dateToDay( const int date ) {
+  int year = date / 10000;
+  int month = ( date / 100 ) % 100;
+  int day = date % 100;
+  if( year < 1970 || month < 1 || month > 12 || day < 1 || day > 31 ) {
+    LOG_ERR( "Malformed date " << date )
+    return -1;
+  }
+
+  // days from the civil calendar, counted from March so leap days fall last
+  int y = year - ( month <= 2 ? 1 : 0 );
+  int era = y / 400;
+  int yearOfEra = y - era * 400;
+  int dayOfYear = ( 153 * ( month + ( month > 2 ? -3 : 9 )) + 2 ) / 5 + day - 1;
+  int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}// end static const int SeriesStore::dateToDay( const int )
+
+
+const int SeriesStore::dayToDate( const int day ) {
+  int z = day + 719468;
+  int era = z / 146097;
+  int dayOfEra = z - era * 146097;
+  int yearOfEra = ( dayOfEra - dayOfEra / 1460 + dayOfEra / 36524
+                    - dayOfEra / 146096 ) / 365;
+  int dayOfYear = dayOfEra - ( 365 * yearOfEra + yearOfEra / 4
+                               - yearOfEra / 100 );
+  int mp = ( 5 * dayOfYear + 2 ) / 153;
+  int dayOfMonth = dayOfYear - ( 153 * mp + 2 ) / 5 + 1;
+  int month = mp < 10 ? mp + 3 : mp - 9;
+  int year = yearOfEra + era * 400 + ( month <= 2 ? 1 : 0 );
+  return year * 10000 + month * 100 + dayOfMonth;
+}// end static const int SeriesStore::dayToDate( const int )
+
+//----< SEGMENT METHODS >-------------------------------------------------------
+SeriesStore::Segment* SeriesStore::openSegment(
+    const string& source,
+    const string& label,
+    const AbstractDataSeries* layout,
+    const int day )
+{
+  LOG_DEBUG( 5, "( " << source << ", " << label << ", layout, " << day << " )" )
+
+  string directory = root + "/" + source;
+  string key = directory + "/" + label;
+  Segments::iterator found = segments.find( key );
+  if( found != segments.end() ) {
+    return found->second;
+  }
+
+  Segment* segment = new Segment;
+  memset( segment, 0, sizeof( Segment ));
+  string valuePath = key + ".dat";
+  string validityPath = key + ".vld";
+  segment->valueFd = open( valuePath.c_str(), O_RDWR );
+  if( segment->valueFd >= 0 ) {
+    // existing label, verify its header
+    segment->validityFd = open( validityPath.c_str(), O_RDWR );
+    ssize_t count = pread( segment->valueFd, &segment->header,
+                           sizeof( Header ), 0 );
+    if( segment->validityFd < 0 || count != (ssize_t)sizeof( Header )
+        || memcmp( segment->header.magic, SERIESSTORE_MAGIC, 4 ) != 0
+        || segment->header.version != SERIESSTORE_VERSION
+        || segment->header.cellsPerDay <= 0 )
+    {
+      LOG_ERR( "Unreadable store files for " << key )
+      close( segment->valueFd );
+      if( segment->validityFd >= 0 ) {
+        close( segment->validityFd );
+      }
+      delete segment;
+      return NULL;
+    }
+  } else if( layout != NULL ) {
+    // new label, laid out after the first series stored
+    if( !makeDirectory( directory )) {
+      delete segment;
+      return NULL;
+    }
+    segment->valueFd = open( valuePath.c_str(), O_RDWR | O_CREAT, 0644 );
+    segment->validityFd = open( validityPath.c_str(), O_RDWR | O_CREAT, 0644 );
+    if( segment->valueFd < 0 || segment->validityFd < 0 ) {
+      LOG_ERR( "Unable to create store files for " << key )
+      if( segment->valueFd >= 0 ) {
+        close( segment->valueFd );
+      }
+      if( segment->validityFd >= 0 ) {
+        close( segment->validityFd );
+      }
+      delete segment;
+      return NULL;
+    }
+
+    Header& header = segment->header;
+    memcpy( header.magic, SERIESSTORE_MAGIC, 4 );
+    header.version = SERIESSTORE_VERSION;
+    header.type = layout->getDataType();
+    header.valueSize = layout->getValueSize();
+    header.resolution = layout->getResolution();
+    header.startTime = layout->getStartTime();
+    header.cellsPerDay = ( 60 * 24 ) / header.resolution;
+    header.baseDay = dateToDay( ( dayToDate( day ) / 10000 ) * 10000 + 101 );
+    header.dayCount = 0;
+    if( ftruncate( segment->valueFd, SERIESSTORE_HEADER_SIZE ) != 0
+        || !writeAt( segment->valueFd, &header, sizeof( Header ), 0 ))
+    {
+      close( segment->valueFd );
+      close( segment->validityFd );
+      delete segment;
+      return NULL;
+    }
+  } else {
+    LOG_DEBUG( 4, ": Not stored -- " << key )
+    delete segment;
+    return NULL;
+  }
+
+  segments[key] = segment;
+  return segment;
+}// end SeriesStore::Segment* SeriesStore::openSegment( const string&, ... )
+
+
+const bool SeriesStore::growSegment( Segment* segment, const int slot ) {
+  LOG_DEBUG( 5, "( segment, " << slot << " )" )
+
+  Header& header = segment->header;
+  int dayCount = slot + 1;
+  off_t valueBytes = SERIESSTORE_HEADER_SIZE
+                     + (off_t)dayCount * header.cellsPerDay * header.valueSize;
+  off_t validityBytes = (off_t)dayCount * (( header.cellsPerDay + 7 ) / 8 );
+  if( ftruncate( segment->valueFd, valueBytes ) != 0
+      || ftruncate( segment->validityFd, validityBytes ) != 0 )
+  {
+    LOG_ERR( "Unable to grow store files: " << strerror( errno ))
+    return false;
+  }
+  header.dayCount = dayCount;
+  if( !writeAt( segment->valueFd, &header, sizeof( Header ), 0 )) {
+    return false;
+  }
+
+  // earlier views keep the old mappings
+  if( segment->values != NULL ) {
+    retired.push_back( std::make_pair( (void*)segment->values,
+                                       segment->valuesSize ));
+    segment->values = NULL;
+  }
+  if( segment->validity != NULL ) {
+    retired.push_back( std::make_pair( (void*)segment->validity,
+                                       segment->validitySize ));
+    segment->validity = NULL;
+  }
+  return true;
+}// end const bool SeriesStore::growSegment( Segment*, const int )
+
+
+const bool SeriesStore::rebaseSegment( Segment* segment,
+                                       const string& key,
+                                       const int day )
+{
+  LOG_DEBUG( 5, "( segment, " << key << ", " << day << " )" )
+
+  Header header = segment->header;
+  int baseDay = dateToDay( ( dayToDate( day ) / 10000 ) * 10000 + 101 );
+  int shift = header.baseDay - baseDay;
+  if( shift <= 0 ) {
+    return true;
+  }
+  size_t valueBytes = (size_t)header.cellsPerDay * header.valueSize;
+  size_t validityBytes = ( header.cellsPerDay + 7 ) / 8;
+  header.baseDay = baseDay;
+  header.dayCount += shift;
+
+  // write shifted copies beside the files; the new leading slots stay zero
+  string valuePath = key + ".dat";
+  string validityPath = key + ".vld";
+  string newValuePath = valuePath + ".rebase";
+  string newValidityPath = validityPath + ".rebase";
+  int valueFd = open( newValuePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+  int validityFd = open( newValidityPath.c_str(),
+                         O_RDWR | O_CREAT | O_TRUNC, 0644 );
+  bool result = valueFd >= 0 && validityFd >= 0;
+  if( !result ) {
+    LOG_ERR( "Unable to create store files for " << key )
+  } else if( ftruncate( valueFd, SERIESSTORE_HEADER_SIZE
+                                 + (off_t)header.dayCount * valueBytes ) != 0
+             || ftruncate( validityFd,
+                           (off_t)header.dayCount * validityBytes ) != 0 )
+  {
+    LOG_ERR( "Unable to grow store files: " << strerror( errno ))
+    result = false;
+  } else {
+    const Header& old = segment->header;
+    result = writeAt( valueFd, &header, sizeof( Header ), 0 )
+             && copyAt( segment->valueFd, SERIESSTORE_HEADER_SIZE, valueFd,
+                        SERIESSTORE_HEADER_SIZE + (off_t)shift * valueBytes,
+                        (size_t)old.dayCount * valueBytes )
+             && copyAt( segment->validityFd, 0, validityFd,
+                        (off_t)shift * validityBytes,
+                        (size_t)old.dayCount * validityBytes );
+  }
+
+  // the copies replace the files; earlier views keep the old mappings
+  if( result && ( rename( newValidityPath.c_str(), validityPath.c_str() ) != 0
+                  || rename( newValuePath.c_str(), valuePath.c_str() ) != 0 ))
+  {
+    LOG_ERR( "Unable to replace store files for " << key << ": " \
+             << strerror( errno ))
+    result = false;
+  }
+  if( !result ) {
+    if( valueFd >= 0 ) {
+      close( valueFd );
+      unlink( newValuePath.c_str() );
+    }
+    if( validityFd >= 0 ) {
+      close( validityFd );
+      unlink( newValidityPath.c_str() );
+    }
+    return false;
+  }
+
+  close( segment->valueFd );
+  close( segment->validityFd );
+  segment->valueFd = valueFd;
+  segment->validityFd = validityFd;
+  segment->header = header;
+  if( segment->values != NULL ) {
+    retired.push_back( std::make_pair( (void*)segment->values,
+                                       segment->valuesSize ));
+    segment->values = NULL;
+  }
+  if( segment->validity != NULL ) {
+    retired.push_back( std::make_pair( (void*)segment->validity,
+                                       segment->validitySize ));
+    segment->validity = NULL;
+  }
+  return true;
+}// end const bool SeriesStore::rebaseSegment( Segment*, const string&, ... )
+
+
+const bool SeriesStore::mapSegment( Segment* segment ) {
+  LOG_DEBUG( 5, "( segment )" )
+
+  const Header& header = segment->header;
+  if( segment->values != NULL ) {
+    return true;
+  } else if( header.dayCount <= 0 ) {
+    return false;
+  }
+
+  size_t valuesSize = SERIESSTORE_HEADER_SIZE
+      + (size_t)header.dayCount * header.cellsPerDay * header.valueSize;
+  size_t validitySize = (size_t)header.dayCount
+                        * (( header.cellsPerDay + 7 ) / 8 );
+  void* values = mmap( NULL, valuesSize, PROT_READ, MAP_SHARED,
+                       segment->valueFd, 0 );
+  void* validity = mmap( NULL, validitySize, PROT_READ, MAP_SHARED,
+                         segment->validityFd, 0 );
+  if( values == MAP_FAILED || validity == MAP_FAILED ) {
+    LOG_ERR( "Unable to map store files: " << strerror( errno ))
+    if( values != MAP_FAILED ) {
+      munmap( values, valuesSize );
+    }
+    if( validity != MAP_FAILED ) {
+      munmap( validity, validitySize );
+    }
+    return false;
+  }
+
+  segment->values = (char*)values;
+  segment->valuesSize = valuesSize;
+  segment->validity = (unsigned char*)validity;
+  segment->validitySize = validitySize;
+  return true;
+}// end const bool SeriesStore::mapSegment( Segment* )
+
+
+SeriesStore::Segment* SeriesStore::findRange( const string& source,
+                                              const string& label,
+                                              const int fromDate,
+                                              const int toDate,
+                                              int* firstSlot,
+                                              int* dayCount )
+{
+  LOG_DEBUG( 5, "( " << source << ", " << label << ", " << fromDate \
+                << ", " << toDate << " )" )
+
+  int firstDay = dateToDay( fromDate );
+  int lastDay = dateToDay( toDate );
+  if( firstDay < 0 || lastDay < firstDay ) {
+    LOG_ERR( "Bad date range " << fromDate << " to " << toDate )
+    return NULL;
+  }
+
+  Segment* segment = openSegment( source, label, NULL, 0 );
+  if( segment == NULL || !mapSegment( segment )) {
+    return NULL;
+  }
+
+  const Header& header = segment->header;
+  int first = firstDay - header.baseDay;
+  int last = lastDay - header.baseDay;
+  if( first < 0 || first >= header.dayCount ) {
+    LOG_DEBUG( 4, ": " << fromDate << " not stored for " << label )
+    return NULL;
+  }
+  if( last >= header.dayCount ) {
+    last = header.dayCount - 1;
+  }
+  *firstSlot = first;
+  *dayCount = last - first + 1;
+  return segment;
+}// end SeriesStore::Segment* SeriesStore::findRange( const string&, ... )
+
+//----< STORAGE METHODS >-------------------------------------------------------
+const bool SeriesStore::storeDay( const string& source,
+                                  const AbstractDataSeries* series,
+                                  const int date )
+{
+  LOG_DEBUG( 5, "( " << source << ", series, " << date << " )" )
+
+  if( series == NULL || !series->isFinal() || series->getRawData() == NULL ) {
+    LOG_ERR( "Only finalized series can be stored." )
+    return false;
+  } else if( series->getDataType() != DATATYPE_INT
+             && series->getDataType() != DATATYPE_DOUBLE )
+  {
+    LOG_ERR( "Series " << series->getLabel() << " has no storable type." )
+    return false;
+  }
+  int day = dateToDay( date );
+  if( day < 0 ) {
+    return false;
+  }
+
+  Segment* segment = openSegment( source, series->getLabel(), series, day );
+  if( segment == NULL ) {
+    return false;
+  }
+  const Header& header = segment->header;
+  if( header.type != series->getDataType()
+      || header.resolution != series->getResolution()
+      || header.startTime != series->getStartTime() )
+  {
+    LOG_ERR( "Series " << series->getLabel() << " does not match the " \
+             << "layout it was first stored with." )
+    return false;
+  }
+  if( day < header.baseDay
+      && !rebaseSegment( segment,
+                         root + "/" + source + "/" + series->getLabel(), day ))
+  {
+    LOG_ERR( "Cannot store " << date << " before the first stored year of " \
+             << series->getLabel() )
+    return false;
+  }
+  int slot = day - header.baseDay;
+  if( slot >= header.dayCount && !growSegment( segment, slot )) {
+    return false;
+  }
+
+  // build the day's slots; cells past the series stay zero and invalid
+  int cells = series->getLength();
+  if( cells > header.cellsPerDay ) {
+    LOG_ERR( "Series " << series->getLabel() << " holds more than a day; " \
+             << "storing the first " << header.cellsPerDay << " cells." )
+    cells = header.cellsPerDay;
+  }
+  size_t valueBytes = (size_t)header.cellsPerDay * header.valueSize;
+  int validityBytes = ( header.cellsPerDay + 7 ) / 8;
+  char* values = new char[ valueBytes ];
+  unsigned char* validity = new unsigned char[ validityBytes ];
+  memset( values, 0, valueBytes );
+  memset( validity, 0, validityBytes );
+  memcpy( values, series->getRawData(), (size_t)cells * header.valueSize );
+  for( int cell = 0; cell < cells; cell++ ) {
+    if( series->isValid( cell )) {
+      validity[ cell >> 3 ] |= 1 << ( cell & 7 );
+    }
+  }
+
+  bool result = writeAt( segment->valueFd, values, valueBytes,
+                         SERIESSTORE_HEADER_SIZE + (off_t)slot * valueBytes )
+                && writeAt( segment->validityFd, validity, validityBytes,
+                            (off_t)slot * validityBytes );
+  delete[] values;
+  delete[] validity;
+  return result;
+}// end const bool SeriesStore::storeDay( const string&, ... )
+
+
+const int SeriesStore::storeParser( const string& source,
+                                    const FileParser* parser,
+                                    const int date )
+{
+  LOG_DEBUG( 5, "( " << source << ", parser, " << date << " )" )
+
+  if( parser == NULL ) {
+    return 0;
+  }
+
+  int stored = 0;
+  const FileParser::DataTag* const tags = parser->getTags();
+  for( int i = 0; i < parser->getLength(); i++ ) {
+    const AbstractDataSeries* series = NULL;
+    if( tags[i].type == DATATYPE_INT ) {
+      series = parser->getSeries( parser->getHandle<int>( tags[i].label ));
+    } else if( tags[i].type == DATATYPE_DOUBLE ) {
+      series = parser->getSeries( parser->getHandle<double>( tags[i].label ));
+    }
+    if( series != NULL && storeDay( source, series, date )) {
+      stored++;
+    }
+  }
+  return stored;
+}// end const int SeriesStore::storeParser( const string&, ... )
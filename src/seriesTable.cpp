@@ -0,0 +1,194 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Align series whose start time differs from the first by whole
+ *           cells instead of dropping them.
+ *
+ * Modified: 10/19/26
+ * Notes:    Copy each series' own validity instead of marking every cell it
+ *           covers.
+ *
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/seriesTable.h>
+#include <cstring>
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+/*
+ * Rounds a byte count up to the column alignment.
+ */
+static size_t alignUp( const size_t bytes ) {
+  return ( bytes + SERIESTABLE_ALIGNMENT - 1 )
+         & ~(size_t)( SERIESTABLE_ALIGNMENT - 1 );
+}// end static size_t alignUp( const size_t )
+
+//----< (DE)(CON)STRUCTORS >----------------------------------------------------
+SeriesTable::SeriesTable( const AbstractDataSeries* const * series,
+                          const int seriesCount )
+{
+  LOG_DEBUG( 5, "( series, " << seriesCount << " )" )
+
+  memory = NULL;
+  arena = NULL;
+  arenaSize = 0;
+  columns = NULL;
+  columnCount = 0;
+  length = 0;
+  resolution = DEFAULT_RESOLUTION;
+  startTime = DEFAULT_START_TIME;
+
+  // fix the resolution and the earliest start shared by whole cells
+  int firstStart = 0;
+  bool axisSet = false;
+  bool* included = new bool[ seriesCount > 0 ? seriesCount : 1 ];
+  for( int i = 0; i < seriesCount; i++ ) {
+    included[i] = false;
+    if( series[i] == NULL || !series[i]->isFinal() ) {
+      continue;
+    }
+    if( !axisSet ) {
+      resolution = series[i]->getResolution();
+      startTime = series[i]->getStartTime();
+      firstStart = startTime;
+      axisSet = true;
+    } else if( series[i]->getResolution() != resolution ) {
+      LOG_ERR( "Series " << series[i]->getLabel() << " does not share the " \
+               << "resolution of the table; column dropped." )
+      continue;
+    } else if(( series[i]->getStartTime() - firstStart ) % resolution != 0 ) {
+      LOG_ERR( "Series " << series[i]->getLabel() << " starts between the " \
+               << "cells of the table; column dropped." )
+      continue;
+    }
+    included[i] = true;
+    columnCount++;
+    if( series[i]->getStartTime() < startTime ) {
+      startTime = series[i]->getStartTime();
+    }
+  }
+
+  // the table spans every column from the earliest start
+  for( int i = 0; i < seriesCount; i++ ) {
+    if( included[i] ) {
+      int end = ( series[i]->getStartTime() - startTime ) / resolution
+                + series[i]->getLength();
+      if( end > length ) {
+        length = end;
+      }
+    }
+  }
+
+  // lay out the arena: each column's values then its bitmap, both aligned
+  int validityWords = ( length + 63 ) / 64;
+  columns = new Column[ columnCount > 0 ? columnCount : 1 ];
+  int column = 0;
+  for( int i = 0; i < seriesCount; i++ ) {
+    if( !included[i] ) {
+      continue;
+    }
+    columns[column].label = series[i]->getLabel();
+    columns[column].type = series[i]->getDataType();
+    columns[column].valueOffset = arenaSize;
+    arenaSize += alignUp( (size_t)length * series[i]->getValueSize() );
+    columns[column].validityOffset = arenaSize;
+    arenaSize += alignUp( validityWords * sizeof( uint64_t ));
+    columns[column].validCount = 0;
+    column++;
+  }
+
+  memory = new char[ arenaSize + SERIESTABLE_ALIGNMENT ];
+  arena = (char*)alignUp( (size_t)memory );
+  memset( arena, 0, arenaSize );
+
+  // copy the values at each series' offset and mark the cells it holds
+  column = 0;
+  for( int i = 0; i < seriesCount; i++ ) {
+    if( !included[i] ) {
+      continue;
+    }
+    int seriesLength = series[i]->getLength();
+    int offset = ( series[i]->getStartTime() - startTime ) / resolution;
+    if( series[i]->getRawData() != NULL ) {
+      memcpy( arena + columns[column].valueOffset
+                  + (size_t)offset * series[i]->getValueSize(),
+              series[i]->getRawData(),
+              (size_t)seriesLength * series[i]->getValueSize() );
+    }
+
+    uint64_t* validity = (uint64_t*)( arena + columns[column].validityOffset );
+    for( int cell = 0; cell < seriesLength; cell++ ) {
+      if( series[i]->isValid( cell )) {
+        int tableCell = cell + offset;
+        validity[ tableCell >> 6 ] |= (uint64_t)1 << ( tableCell & 63 );
+      }
+    }
+    columns[column].validCount = series[i]->getValidCount();
+    column++;
+  }
+
+  delete[] included;
+}// end SeriesTable::SeriesTable( const AbstractDataSeries* const *, ... )
+
+
+SeriesTable::~SeriesTable() {
+  LOG_DEBUG( 5, "()" )
+
+  delete[] columns;
+  columns = NULL;
+  delete[] memory;
+  memory = NULL;
+  arena = NULL;
+}// end SeriesTable::~SeriesTable()
+
+//----< ACCESSOR METHODS >------------------------------------------------------
+const int SeriesTable::getColumnCount() const {
+  return columnCount;
+}// end const int SeriesTable::getColumnCount() const
+
+
+const int SeriesTable::getLength() const {
+  return length;
+}// end const int SeriesTable::getLength() const
+
+
+const int SeriesTable::getResolution() const {
+  return resolution;
+}// end const int SeriesTable::getResolution() const
+
+
+const int SeriesTable::getStartTime() const {
+  return startTime;
+}// end const int SeriesTable::getStartTime() const
+
+
+const size_t SeriesTable::getArenaSize() const {
+  return arenaSize;
+}// end const size_t SeriesTable::getArenaSize() const
+
+
+const string& SeriesTable::getLabel( const int column ) const {
+  return columns[column].label;
+}// end const string& SeriesTable::getLabel( const int ) const
+
+
+const int SeriesTable::getType( const int column ) const {
+  return columns[column].type;
+}// end const int SeriesTable::getType( const int ) const
+
+
+const int SeriesTable::getValidCount( const int column ) const {
+  return columns[column].validCount;
+}// end const int SeriesTable::getValidCount( const int ) const
+
+
+const int SeriesTable::findColumn( const string& label ) const {
+  LOG_DEBUG( 5, "( " << label << " )" )
+
+  for( int i = 0; i < columnCount; i++ ) {
+    if( columns[i].label == label ) {
+      return i;
+    }
+  }
+  return -1;
+}// end const int SeriesTable::findColumn( const string& ) const
@@ -0,0 +1,361 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Added cross spectra over shared segment transforms.
+ *
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/spectrum.h>
+#include <crsCorr/fft.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//----< POWER SPECTRUM >--------------------------------------------------------
+PowerSpectrum::PowerSpectrum( double* power,
+                              const int bins,
+                              const double binWidth,
+                              const int segments )
+  : power( power ), bins( bins ), binWidth( binWidth ), segments( segments )
+{
+  LOG_DEBUG( 12, "( power, " << bins << ", " << binWidth << ", " \
+                 << segments << " )" )
+}// end PowerSpectrum::PowerSpectrum( double*, const int, ... )
+
+
+PowerSpectrum::~PowerSpectrum() {
+  delete[] power;
+}// end PowerSpectrum::~PowerSpectrum()
+
+
+const double PowerSpectrum::getTotalPower() const {
+  double total = 0.0;
+  for( int k = 0; k < bins; k++ ) {
+    total += power[k];
+  }
+  return total * binWidth;
+}// end const double PowerSpectrum::getTotalPower() const
+
+
+const int PowerSpectrum::getPeakBin() const {
+  int peak = bins > 1 ? 1 : 0;
+  for( int k = 2; k < bins; k++ ) {
+    if( power[k] > power[ peak ] ) {
+      peak = k;
+    }
+  }
+  return peak;
+}// end const int PowerSpectrum::getPeakBin() const
+
+
+void PowerSpectrum::normalize() {
+  double total = 0.0;
+  for( int k = 1; k < bins; k++ ) {
+    total += power[k];
+  }
+  if( total <= 0.0 ) {
+    LOG_ERR( "Spectrum holds no power to normalize." )
+    return;
+  }
+  power[0] = 0.0;
+  for( int k = 1; k < bins; k++ ) {
+    power[k] /= total;
+  }
+}// end void PowerSpectrum::normalize()
+
+//----< CROSS SPECTRUM >--------------------------------------------------------
+CrossSpectrum::CrossSpectrum( std::complex<double>* csd,
+                              double* coherence,
+                              const int bins,
+                              const double binWidth,
+                              const int segments )
+  : csd( csd ), coherence( coherence ), bins( bins ), binWidth( binWidth ),
+    segments( segments )
+{
+  LOG_DEBUG( 12, "( csd, coherence, " << bins << ", " << binWidth << ", " \
+                 << segments << " )" )
+}// end CrossSpectrum::CrossSpectrum( std::complex<double>*, double*, ... )
+
+
+CrossSpectrum::~CrossSpectrum() {
+  delete[] csd;
+  delete[] coherence;
+}// end CrossSpectrum::~CrossSpectrum()
+
+
+const double CrossSpectrum::getPhase( const int bin ) const {
+  return std::arg( csd[ bin ] );
+}// end const double CrossSpectrum::getPhase( const int ) const
+
+
+const double CrossSpectrum::getLag( const int bin ) const {
+  if( bin <= 0 ) {
+    return 0.0;
+  }
+  // a lag of tau days turns the phase by -2 pi f tau
+  return -getPhase( bin ) / ( 2.0 * M_PI * getFrequency( bin )) * 1440.0;
+}// end const double CrossSpectrum::getLag( const int ) const
+
+//----< SEGMENT SPECTRA >-------------------------------------------------------
+SegmentSpectra::SegmentSpectra( const int segment,
+                                const int step,
+                                const int window,
+                                const int resolution,
+                                const int startTime )
+  : segment( segment ), step( step ), window( window ),
+    resolution( resolution ), startTime( startTime )
+{
+  LOG_DEBUG( 12, "( " << segment << ", " << step << ", " << window << ", " \
+                 << resolution << ", " << startTime << " )" )
+}// end SegmentSpectra::SegmentSpectra( const int, const int, ... )
+
+
+const bool SegmentSpectra::isCompatible( const SegmentSpectra& other ) const {
+  return segment == other.segment && step == other.step
+         && window == other.window && resolution == other.resolution
+         && startTime == other.startTime;
+}// end const bool SegmentSpectra::isCompatible( const SegmentSpectra& ) const
+
+//----< SPECTRAL ESTIMATES >----------------------------------------------------
+const bool Spectrum::makeWindow( const int window, const int n, double* out ) {
+  LOG_DEBUG( 13, "( " << window << ", " << n << ", out )" )
+
+  for( int j = 0; j < n; j++ ) {
+    double phase = 2.0 * M_PI * j / n;
+    switch( window ) {
+      case SPECTRUM_WINDOW_RECTANGULAR:
+        out[j] = 1.0;
+        break;
+      case SPECTRUM_WINDOW_HANN:
+        out[j] = 0.5 - 0.5 * cos( phase );
+        break;
+      case SPECTRUM_WINDOW_HAMMING:
+        out[j] = 0.54 - 0.46 * cos( phase );
+        break;
+      case SPECTRUM_WINDOW_BLACKMAN:
+        out[j] = 0.42 - 0.5 * cos( phase ) + 0.08 * cos( 2.0 * phase );
+        break;
+      default:
+        LOG_ERR( "Unknown spectral window " << window )
+        return false;
+    }
+  }
+  return true;
+}// end static const bool Spectrum::makeWindow( const int, const int, double* )
+
+
+const int Spectrum::transformSegments( const double* values,
+                                      const uint64_t* validity,
+                                      const int count,
+                                      SegmentSpectra& segments )
+{
+  const int segment = segments.segment;
+  const int step = segments.step;
+  LOG_DEBUG( 12, "( values, validity, " << count << ", " << segment << ", " \
+                 << step << ", " << segments.window << " )" )
+
+  segments.transforms.clear();
+  segments.energy.clear();
+  if( values == NULL || segment < 2 || segment > count || step < 1 ) {
+    LOG_ERR( "Bad segment parameters: " << count << " samples, segments of " \
+             << segment << " every " << step )
+    return -1;
+  }
+  std::vector<double> weights( segment );
+  if( !makeWindow( segments.window, segment, &weights[0] )) {
+    return -1;
+  }
+
+  const int bins = getBins( segment );
+  const int total = ( count - segment ) / step + 1;
+  std::vector<double> tapered( segment );
+  segments.transforms.assign( (size_t)total * bins, 0.0 );
+  segments.energy.assign( total, 0.0 );
+
+  int usable = 0;
+  for( int s = 0; s < total; s++ ) {
+    const int start = s * step;
+    int valid = 0;
+    double mean = 0.0;
+    double energy = 0.0;
+    for( int j = 0; j < segment; j++ ) {
+      if( isValidCell( validity, start + j )) {
+        valid++;
+        mean += values[ start + j ];
+        energy += weights[j] * weights[j];
+      }
+    }
+    if( valid < SPECTRUM_MIN_COVERAGE * segment || valid < 2
+        || energy <= 0.0 )
+    {
+      continue;
+    }
+    mean /= valid;
+
+    for( int j = 0; j < segment; j++ ) {
+      tapered[j] = isValidCell( validity, start + j )
+                   ? ( values[ start + j ] - mean ) * weights[j] : 0.0;
+    }
+    Fft::realTransform( &tapered[0], segment,
+                        &segments.transforms[ (size_t)s * bins ] );
+    segments.energy[s] = energy;
+    usable++;
+  }
+
+  if( usable == 0 ) {
+    LOG_ERR( "No segment of " << segment << " cells has enough valid data." )
+    return -1;
+  }
+  return usable;
+}// end static const int Spectrum::transformSegments( const double*, ... )
+
+
+const int Spectrum::accumulate( const SegmentSpectra& a,
+                                const SegmentSpectra& b,
+                                std::complex<double>* cross,
+                                double* autoA,
+                                double* autoB )
+{
+  const int bins = a.getBins();
+  for( int k = 0; k < bins; k++ ) {
+    if( cross != NULL ) {
+      cross[k] = 0.0;
+    }
+    if( autoA != NULL ) {
+      autoA[k] = 0.0;
+    }
+    if( autoB != NULL ) {
+      autoB[k] = 0.0;
+    }
+  }
+
+  // one sided: every bin but zero and Nyquist stands for two
+  const int total = std::min( a.getSegmentCount(), b.getSegmentCount() );
+  int shared = 0;
+  for( int s = 0; s < total; s++ ) {
+    if( a.energy[s] <= 0.0 || b.energy[s] <= 0.0 ) {
+      continue;
+    }
+    const std::complex<double>* transformA = &a.transforms[ (size_t)s * bins ];
+    const std::complex<double>* transformB = &b.transforms[ (size_t)s * bins ];
+    const double scale = 1.0 / sqrt( a.energy[s] * b.energy[s] );
+    for( int k = 0; k < bins; k++ ) {
+      double sides = ( k == 0 || 2 * k == a.segment ) ? 1.0 : 2.0;
+      if( cross != NULL ) {
+        cross[k] += sides * scale * std::conj( transformA[k] ) * transformB[k];
+      }
+      if( autoA != NULL ) {
+        autoA[k] += sides * std::norm( transformA[k] ) / a.energy[s];
+      }
+      if( autoB != NULL ) {
+        autoB[k] += sides * std::norm( transformB[k] ) / b.energy[s];
+      }
+    }
+    shared++;
+  }
+  return shared;
+}// end static const int Spectrum::accumulate( const SegmentSpectra&, ... )
+
+
+PowerSpectrum* Spectrum::autoSpectrum( const SegmentSpectra& segments ) {
+  LOG_DEBUG( 12, "( segments )" )
+
+  const int bins = segments.getBins();
+  double* power = new double[ bins ];
+  int count = accumulate( segments, segments, NULL, power, NULL );
+  if( count == 0 ) {
+    LOG_ERR( "No usable segments to average." )
+    delete[] power;
+    return NULL;
+  }
+
+  // per cycle per sample to per cycle per day
+  const double samplesPerDay = 1440.0 / segments.resolution;
+  for( int k = 0; k < bins; k++ ) {
+    power[k] /= count * samplesPerDay;
+  }
+  return new PowerSpectrum( power, bins, samplesPerDay / segments.segment,
+                            count );
+}// end static PowerSpectrum* Spectrum::autoSpectrum( const SegmentSpectra& )
+
+
+CrossSpectrum* Spectrum::crossSpectrum( const SegmentSpectra& a,
+                                        const SegmentSpectra& b )
+{
+  LOG_DEBUG( 12, "( a, b )" )
+
+  if( !a.isCompatible( b )) {
+    LOG_ERR( "Segments of " << a.segment << " and " << b.segment \
+             << " cells do not share a time grid and window." )
+    return NULL;
+  }
+
+  const int bins = a.getBins();
+  std::complex<double>* csd = new std::complex<double>[ bins ];
+  double* coherence = new double[ bins ];
+  std::vector<double> autoA( bins );
+  std::vector<double> autoB( bins );
+  int count = accumulate( a, b, csd, &autoA[0], &autoB[0] );
+  if( count == 0 ) {
+    LOG_ERR( "The series share no usable segment." )
+    delete[] csd;
+    delete[] coherence;
+    return NULL;
+  }
+
+  // the averaging count cancels in the coherence
+  const double samplesPerDay = 1440.0 / a.resolution;
+  for( int k = 0; k < bins; k++ ) {
+    double denominator = autoA[k] * autoB[k];
+    coherence[k] = denominator > 0.0 ? std::norm( csd[k] ) / denominator : 0.0;
+    csd[k] /= count * samplesPerDay;
+  }
+  return new CrossSpectrum( csd, coherence, bins, samplesPerDay / a.segment,
+                            count );
+}// end static CrossSpectrum* Spectrum::crossSpectrum( const SegmentSpectra&, ... )
+
+
+std::vector<CrossSpectrum*> Spectrum::crossBatch(
+                             const std::vector<const SegmentSpectra*>& rows,
+                             const std::vector<const SegmentSpectra*>& cols )
+{
+  LOG_DEBUG( 12, "( " << rows.size() << " rows, " << cols.size() << " cols )" )
+
+  std::vector<CrossSpectrum*> spectra( rows.size() * cols.size(), NULL );
+  for( size_t r = 0; r < rows.size(); r++ ) {
+    for( size_t c = 0; c < cols.size(); c++ ) {
+      if( rows[r] != NULL && cols[c] != NULL ) {
+        spectra[ r * cols.size() + c ] = crossSpectrum( *rows[r], *cols[c] );
+      }
+    }
+  }
+  return spectra;
+}// end static std::vector<CrossSpectrum*> Spectrum::crossBatch( ... )
+
+
+const int Spectrum::welch( const double* values,
+                           const uint64_t* validity,
+                           const int count,
+                           const int segment,
+                           const int step,
+                           const int window,
+                           double* power )
+{
+  LOG_DEBUG( 12, "( values, validity, " << count << ", " << segment << ", " \
+                 << step << ", " << window << ", power )" )
+
+  if( power == NULL ) {
+    LOG_ERR( "No buffer for the Welch estimate." )
+    return -1;
+  }
+  SegmentSpectra segments( segment, step, window, 1, 0 );
+  if( transformSegments( values, validity, count, segments ) < 0 ) {
+    return -1;
+  }
+  int used = accumulate( segments, segments, NULL, power, NULL );
+  for( int k = 0; k < segments.getBins(); k++ ) {
+    power[k] /= used;
+  }
+  return used;
+}// end static const int Spectrum::welch( const double*, ... )
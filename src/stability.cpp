@@ -0,0 +1,257 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/stability.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+//----< LOCAL UTILITIES >-------------------------------------------------------
+/*
+ * Extremes of the windows of 2^level samples starting at each sample, built
+ *   by doubling: a window of twice the width is two windows side by side.
+ */
+typedef struct WindowExtremes {
+  std::vector<double> highs;
+  std::vector<double> lows;
+  int level;
+
+  void reset( const double* phase, const int count ) {
+    highs.assign( phase, phase + count );
+    lows.assign( phase, phase + count );
+    level = 0;
+  }
+
+  void widen( const int count ) {
+    const int width = 1 << level;
+    double* high = &highs[0];
+    double* low = &lows[0];
+    for( int i = 0; i + 2 * width <= count; i++ ) {
+      high[i] = high[i] > high[ i + width ] ? high[i] : high[ i + width ];
+      low[i] = low[i] < low[ i + width ] ? low[i] : low[ i + width ];
+    }
+    level++;
+  }
+} WindowExtremes;
+
+
+/*
+ * Largest peak to peak excursion over windows of span + 1 samples that are
+ *   all valid. Any window of length L is covered by the two windows of the
+ *   largest width 2^k <= L at its ends, so each span costs one pass once the
+ *   extremes are widened to that level.
+ */
+static double windowExcursion( WindowExtremes& extremes,
+                               const double* phase,
+                               const std::vector<int>& validPrefix,
+                               const int count,
+                               const int span,
+                               int& windows )
+{
+  const int length = span + 1;
+  if( extremes.highs.empty() || ( 1 << extremes.level ) > length ) {
+    extremes.reset( phase, count );
+  }
+  while(( 2 << extremes.level ) <= length ) {
+    extremes.widen( count );
+  }
+
+  const int tail = length - ( 1 << extremes.level );
+  const double* high = &extremes.highs[0];
+  const double* low = &extremes.lows[0];
+  double widest = 0.0;
+  windows = 0;
+  for( int i = 0; i + length <= count; i++ ) {
+    if( !validPrefix.empty()
+        && validPrefix[ i + length ] - validPrefix[i] != length )
+    {
+      continue;
+    }
+    double top = high[i] > high[ i + tail ] ? high[i] : high[ i + tail ];
+    double bottom = low[i] < low[ i + tail ] ? low[i] : low[ i + tail ];
+    widest = top - bottom > widest ? top - bottom : widest;
+    windows++;
+  }
+  return widest;
+}// end static double windowExcursion( WindowExtremes&, const double*, ... )
+
+//----< STABILITY CURVE >-------------------------------------------------------
+StabilityCurve::StabilityCurve( double* taus,
+                                double* deviations,
+                                int* terms,
+                                const int points,
+                                const int statistic )
+  : taus( taus ), deviations( deviations ), terms( terms ), points( points ),
+    statistic( statistic )
+{
+  LOG_DEBUG( 12, "( taus, deviations, terms, " << points << ", " \
+                 << statistic << " )" )
+}// end StabilityCurve::StabilityCurve( double*, double*, ... )
+
+
+StabilityCurve::~StabilityCurve() {
+  delete[] taus;
+  delete[] deviations;
+  delete[] terms;
+}// end StabilityCurve::~StabilityCurve()
+
+//----< STABILITY >-------------------------------------------------------------
+const int Stability::getMaxFactor( const int statistic, const int count ) {
+  switch( statistic ) {
+    case STABILITY_ADEV:
+      return ( count - 1 ) / 2;
+    case STABILITY_MDEV:
+    case STABILITY_TDEV:
+      return count / 3;
+    case STABILITY_MTIE:
+      return count - 1;
+    default:
+      LOG_ERR( "Unknown stability statistic " << statistic )
+      return 0;
+  }
+}// end static const int Stability::getMaxFactor( const int, const int )
+
+
+const int Stability::octaveFactors( const int statistic,
+                                    const int count,
+                                    std::vector<int>& factors )
+{
+  factors.clear();
+  const int largest = getMaxFactor( statistic, count );
+  for( int m = 1; m >= 1 && m <= largest; m <<= 1 ) {
+    factors.push_back( m );
+  }
+  return factors.size();
+}// end static const int Stability::octaveFactors( const int, ... )
+
+
+void Stability::frequencyToPhase( const double* frequency,
+                                  const uint64_t* frequencyValid,
+                                  const int count,
+                                  const double tau0,
+                                  double* phase,
+                                  uint64_t* phaseValid )
+{
+  LOG_DEBUG( 13, "( frequency, frequencyValid, " << count << ", " << tau0 \
+                 << ", phase, phaseValid )" )
+
+  if( phaseValid != NULL ) {
+    memset( phaseValid, 0, (( count + 64 ) / 64 ) * sizeof( uint64_t ));
+    phaseValid[0] = 1;
+  }
+  phase[0] = 0.0;
+  for( int i = 0; i < count; i++ ) {
+    bool valid = isValidCell( frequencyValid, i );
+    phase[ i + 1 ] = phase[i] + ( valid ? frequency[i] * tau0 : 0.0 );
+    if( phaseValid != NULL && valid ) {
+      phaseValid[ ( i + 1 ) >> 6 ] |= (uint64_t)1 << (( i + 1 ) & 63 );
+    }
+  }
+}// end static void Stability::frequencyToPhase( const double*, ... )
+
+
+const bool Stability::compute( const double* phase,
+                               const uint64_t* validity,
+                               const int count,
+                               const double tau0,
+                               const int statistic,
+                               const int* factors,
+                               const int factorCount,
+                               double* deviations,
+                               int* terms )
+{
+  LOG_DEBUG( 12, "( phase, validity, " << count << ", " << tau0 << ", " \
+                 << statistic << ", factors, " << factorCount << " )" )
+
+  if( phase == NULL || factors == NULL || deviations == NULL || count < 2
+      || !( tau0 > 0.0 ) || statistic < STABILITY_ADEV
+      || statistic > STABILITY_MTIE )
+  {
+    LOG_ERR( "Bad stability parameters: " << count << " samples every " \
+             << tau0 << " seconds, statistic " << statistic )
+    return false;
+  }
+
+  // validPrefix[i] counts the valid samples before i; empty if all are
+  std::vector<int> validPrefix;
+  if( validity != NULL ) {
+    validPrefix.resize( count + 1, 0 );
+    for( int i = 0; i < count; i++ ) {
+      validPrefix[ i + 1 ] = validPrefix[i] + isValidCell( validity, i );
+    }
+  }
+
+  // long double keeps the differences of large prefix sums exact enough
+  std::vector<long double> phasePrefix;
+  if( statistic == STABILITY_MDEV || statistic == STABILITY_TDEV ) {
+    phasePrefix.resize( count + 1, 0.0 );
+    for( int i = 0; i < count; i++ ) {
+      phasePrefix[ i + 1 ] = phasePrefix[i]
+                             + ( isValidCell( validity, i ) ? phase[i] : 0.0 );
+    }
+  }
+
+  WindowExtremes extremes;
+  for( int f = 0; f < factorCount; f++ ) {
+    const int m = factors[f];
+    const double tau = m * tau0;
+    double sum = 0.0;
+    int used = 0;
+    if( m < 1 || m > getMaxFactor( statistic, count )) {
+      LOG_ERR( "Averaging factor " << m << " does not fit " << count \
+               << " samples." )
+      return false;
+    }
+
+    switch( statistic ) {
+      case STABILITY_ADEV:
+        for( int i = 0; i + 2 * m < count; i++ ) {
+          if( validPrefix.empty()
+              || validPrefix[ i + 2 * m + 1 ] - validPrefix[i] == 2 * m + 1 )
+          {
+            double difference = phase[ i + 2 * m ] - 2.0 * phase[ i + m ]
+                                + phase[i];
+            sum += difference * difference;
+            used++;
+          }
+        }
+        deviations[f] = used > 0 ? sqrt( sum / ( 2.0 * tau * tau * used ))
+                                 : 0.0;
+        break;
+
+      case STABILITY_MDEV:
+      case STABILITY_TDEV:
+        for( int j = 0; j + 3 * m <= count; j++ ) {
+          if( validPrefix.empty()
+              || validPrefix[ j + 3 * m ] - validPrefix[j] == 3 * m )
+          {
+            double inner = (double)( phasePrefix[ j + 3 * m ]
+                                     - 3.0L * phasePrefix[ j + 2 * m ]
+                                     + 3.0L * phasePrefix[ j + m ]
+                                     - phasePrefix[j] );
+            sum += inner * inner;
+            used++;
+          }
+        }
+        deviations[f] = used > 0
+                        ? sqrt( sum / ( 2.0 * (double)m * m * tau * tau
+                                        * used ))
+                        : 0.0;
+        if( statistic == STABILITY_TDEV ) {
+          deviations[f] *= tau / sqrt( 3.0 );
+        }
+        break;
+
+      case STABILITY_MTIE:
+        deviations[f] = windowExcursion( extremes, phase, validPrefix, count,
+                                         m, used );
+        break;
+    }
+    if( terms != NULL ) {
+      terms[f] = used;
+    }
+  }
+  return true;
+}// end static const bool Stability::compute( const double*, ... )
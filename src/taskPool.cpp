@@ -0,0 +1,203 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    The destructor joins every worker before freeing any, since an
+ *           exiting worker may still be looking into the others' deques.
+ *
+ * Modified: 10/19/26
+ * Notes:    wait() runs the tasks itself when no worker thread started,
+ *           rather than waiting on tasks nothing would run.
+ *
+ * Modified: 10/19/26
+ * Notes:    Initial creation.
+ */
+
+#include <crsCorr/taskPool.h>
+#include <unistd.h>
+
+//----< (DE)(CON)STRUCTORS >----------------------------------------------------
+TaskPool::TaskPool( const int threads ) {
+  LOG_DEBUG( 12, "( " << threads << " )" )
+
+  queued = 0;
+  pending = 0;
+  running = 0;
+  nextWorker = 0;
+  stopping = false;
+  pthread_key_create( &currentWorker, NULL );
+  pthread_mutex_init( &stateLock, NULL );
+  pthread_cond_init( &workAvailable, NULL );
+  pthread_cond_init( &allFinished, NULL );
+
+  int count = threads > 0 ? threads : (int)sysconf( _SC_NPROCESSORS_ONLN );
+  count = count < 1 ? 1 : count;
+  for( int i = 0; i < count; i++ ) {
+    Worker* worker = new Worker();
+    worker->pool = this;
+    worker->index = i;
+    worker->started = false;
+    pthread_mutex_init( &worker->lock, NULL );
+    workers.push_back( worker );
+  }
+
+  // start the threads only once every deque exists, since they steal
+  for( int i = 0; i < count; i++ ) {
+    if( pthread_create( &workers[i]->thread, NULL, TaskPool::run,
+                        workers[i] ) == 0 )
+    {
+      workers[i]->started = true;
+      running++;
+    } else {
+      LOG_ERR( "Unable to start task thread " << i )
+    }
+  }
+  if( running == 0 ) {
+    LOG_ERR( "Warning: no task threads started; tasks will run in wait()" )
+  }
+}// end TaskPool::TaskPool( const int )
+
+
+TaskPool::~TaskPool() {
+  LOG_DEBUG( 12, "()" )
+
+  wait();
+  pthread_mutex_lock( &stateLock );
+  stopping = true;
+  pthread_cond_broadcast( &workAvailable );
+  pthread_mutex_unlock( &stateLock );
+
+  // a worker looks into every deque until it exits, so join them all first
+  for( size_t i = 0; i < workers.size(); i++ ) {
+    if( workers[i]->started ) {
+      pthread_join( workers[i]->thread, NULL );
+    }
+  }
+  for( size_t i = 0; i < workers.size(); i++ ) {
+    pthread_mutex_destroy( &workers[i]->lock );
+    delete workers[i];
+  }
+  workers.clear();
+
+  pthread_cond_destroy( &allFinished );
+  pthread_cond_destroy( &workAvailable );
+  pthread_mutex_destroy( &stateLock );
+  pthread_key_delete( currentWorker );
+}// end TaskPool::~TaskPool()
+
+//----< THREAD METHODS >--------------------------------------------------------
+void* TaskPool::run( void* worker ) {
+  Worker* self = (Worker*)worker;
+  TaskPool* pool = self->pool;
+  pthread_setspecific( pool->currentWorker, self );
+
+  Task task;
+  while( true ) {
+    if( pool->takeTask( self, task )) {
+      pool->runTask( task );
+      continue;
+    }
+
+    // sleep until a task is queued anywhere
+    pthread_mutex_lock( &pool->stateLock );
+    while( pool->queued == 0 && !pool->stopping ) {
+      pthread_cond_wait( &pool->workAvailable, &pool->stateLock );
+    }
+    bool exiting = pool->queued == 0 && pool->stopping;
+    pthread_mutex_unlock( &pool->stateLock );
+    if( exiting ) {
+      break;
+    }
+  }
+  return NULL;
+}// end static void* TaskPool::run( void* )
+
+
+const bool TaskPool::takeTask( Worker* worker, Task& task ) {
+  bool found = false;
+
+  // newest own task first, for locality with the task that submitted it
+  pthread_mutex_lock( &worker->lock );
+  if( !worker->tasks.empty() ) {
+    task = worker->tasks.back();
+    worker->tasks.pop_back();
+    found = true;
+  }
+  pthread_mutex_unlock( &worker->lock );
+
+  // otherwise the oldest task of the next busy worker
+  const int count = workers.size();
+  for( int i = 1; !found && i < count; i++ ) {
+    Worker* victim = workers[ ( worker->index + i ) % count ];
+    pthread_mutex_lock( &victim->lock );
+    if( !victim->tasks.empty() ) {
+      task = victim->tasks.front();
+      victim->tasks.pop_front();
+      found = true;
+    }
+    pthread_mutex_unlock( &victim->lock );
+  }
+
+  if( found ) {
+    pthread_mutex_lock( &stateLock );
+    queued--;
+    pthread_mutex_unlock( &stateLock );
+  }
+  return found;
+}// end const bool TaskPool::takeTask( Worker*, Task& )
+
+
+void TaskPool::runTask( const Task& task ) {
+  task.function( this, task.argument );
+
+  pthread_mutex_lock( &stateLock );
+  pending--;
+  if( pending == 0 ) {
+    pthread_cond_broadcast( &allFinished );
+  }
+  pthread_mutex_unlock( &stateLock );
+}// end void TaskPool::runTask( const Task& )
+
+//----< PUBLIC METHODS >--------------------------------------------------------
+void TaskPool::submit( TaskFunction function, void* argument ) {
+  Task task = { function, argument };
+
+  // count the task before it can be taken, so neither counter dips early
+  pthread_mutex_lock( &stateLock );
+  pending++;
+  queued++;
+  Worker* worker = (Worker*)pthread_getspecific( currentWorker );
+  if( worker == NULL || worker->pool != this ) {
+    worker = workers[ nextWorker++ % workers.size() ];
+  }
+  pthread_mutex_unlock( &stateLock );
+
+  pthread_mutex_lock( &worker->lock );
+  worker->tasks.push_back( task );
+  pthread_mutex_unlock( &worker->lock );
+
+  pthread_mutex_lock( &stateLock );
+  pthread_cond_signal( &workAvailable );
+  pthread_mutex_unlock( &stateLock );
+}// end void TaskPool::submit( TaskFunction, void* )
+
+
+void TaskPool::wait() {
+  LOG_DEBUG( 12, "()" )
+
+  // with no workers the caller runs every task, including those submitted
+  //   by the tasks it runs
+  Task task;
+  while( running == 0 && takeTask( workers[0], task )) {
+    runTask( task );
+  }
+
+  pthread_mutex_lock( &stateLock );
+  while( pending > 0 ) {
+    pthread_cond_wait( &allFinished, &stateLock );
+  }
+  pthread_mutex_unlock( &stateLock );
+}// end void TaskPool::wait()
+
+
+const int TaskPool::getThreads() const {
+  return running;
+}// end const int TaskPool::getThreads() const
@@ -0,0 +1,390 @@
+/*
+ * Modified: 10/19/26
+ * Notes:    --splitFields terminates the last field even when its delimiter
+ *             falls in a later block, and reports fields past maxFields
+ *           Initial creation.
+ */
+
+#include <crsCorr/textScan.h>
+#include <cstring>
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ))
+#define TEXTSCAN_X86
+#include <immintrin.h>
+#endif
+
+//----< CLASSIFIERS >-----------------------------------------------------------
+/*
+ * Scalar classifier, used when no vector unit is available.
+ */
+static void classifyScalar( const char* block,
+                            const bool slash,
+                            uint64_t& newlines,
+                            uint64_t& delimiters )
+{
+  uint64_t lines = 0;
+  uint64_t delims = 0;
+  for( int i = 0; i < TEXTSCAN_BLOCK; i++ ) {
+    char byte = block[i];
+    uint64_t bit = (uint64_t)1 << i;
+    if( byte == '\n' ) {
+      lines |= bit;
+      delims |= bit;
+    } else if( byte == ' ' || byte == '\t' || byte == '\r'
+               || ( slash && byte == '/' ))
+    {
+      delims |= bit;
+    }
+  }
+  newlines = lines;
+  delimiters = delims;
+}// end static void classifyScalar( const char*, const bool, ... )
+
+#ifdef TEXTSCAN_X86
+/*
+ * SSE2 classifier, 16 bytes per compare. SSE2 is present on every x86-64.
+ */
+__attribute__(( target( "sse2" )))
+static void classifySse2( const char* block,
+                          const bool slash,
+                          uint64_t& newlines,
+                          uint64_t& delimiters )
+{
+  const __m128i newline = _mm_set1_epi8( '\n' );
+  const __m128i space = _mm_set1_epi8( ' ' );
+  const __m128i tab = _mm_set1_epi8( '\t' );
+  const __m128i carriage = _mm_set1_epi8( '\r' );
+  const __m128i slashes = _mm_set1_epi8( slash ? '/' : '\n' );
+
+  uint64_t lines = 0;
+  uint64_t delims = 0;
+  for( int i = 0; i < TEXTSCAN_BLOCK; i += 16 ) {
+    __m128i bytes = _mm_loadu_si128( (const __m128i*)( block + i ));
+    __m128i isLine = _mm_cmpeq_epi8( bytes, newline );
+    __m128i isDelim = _mm_or_si128(
+        _mm_or_si128( isLine, _mm_cmpeq_epi8( bytes, space )),
+        _mm_or_si128( _mm_cmpeq_epi8( bytes, tab ),
+                      _mm_or_si128( _mm_cmpeq_epi8( bytes, carriage ),
+                                    _mm_cmpeq_epi8( bytes, slashes ))));
+    lines |= (uint64_t)(uint16_t)_mm_movemask_epi8( isLine ) << i;
+    delims |= (uint64_t)(uint16_t)_mm_movemask_epi8( isDelim ) << i;
+  }
+  newlines = lines;
+  delimiters = delims;
+}// end static void classifySse2( const char*, const bool, ... )
+
+/*
+ * AVX2 classifier, 32 bytes per compare.
+ */
+__attribute__(( target( "avx2" )))
+static void classifyAvx2( const char* block,
+                          const bool slash,
+                          uint64_t& newlines,
+                          uint64_t& delimiters )
+{
+  const __m256i newline = _mm256_set1_epi8( '\n' );
+  const __m256i space = _mm256_set1_epi8( ' ' );
+  const __m256i tab = _mm256_set1_epi8( '\t' );
+  const __m256i carriage = _mm256_set1_epi8( '\r' );
+  const __m256i slashes = _mm256_set1_epi8( slash ? '/' : '\n' );
+
+  uint64_t lines = 0;
+  uint64_t delims = 0;
+  for( int i = 0; i < TEXTSCAN_BLOCK; i += 32 ) {
+    __m256i bytes = _mm256_loadu_si256( (const __m256i*)( block + i ));
+    __m256i isLine = _mm256_cmpeq_epi8( bytes, newline );
+    __m256i isDelim = _mm256_or_si256(
+        _mm256_or_si256( isLine, _mm256_cmpeq_epi8( bytes, space )),
+        _mm256_or_si256( _mm256_cmpeq_epi8( bytes, tab ),
+                         _mm256_or_si256( _mm256_cmpeq_epi8( bytes, carriage ),
+                                          _mm256_cmpeq_epi8( bytes, slashes ))));
+    lines |= (uint64_t)(uint32_t)_mm256_movemask_epi8( isLine ) << i;
+    delims |= (uint64_t)(uint32_t)_mm256_movemask_epi8( isDelim ) << i;
+  }
+  newlines = lines;
+  delimiters = delims;
+}// end static void classifyAvx2( const char*, const bool, ... )
+#endif
+
+typedef void (*Classifier)( const char*, const bool, uint64_t&, uint64_t& );
+
+/*
+ * Selects the widest classifier the processor supports.
+ */
+static Classifier selectClassifier( const char** name ) {
+#ifdef TEXTSCAN_X86
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "avx2" )) {
+    *name = "avx2";
+    return classifyAvx2;
+  } else if( __builtin_cpu_supports( "sse2" )) {
+    *name = "sse2";
+    return classifySse2;
+  }
+#endif
+  *name = "scalar";
+  return classifyScalar;
+}// end static Classifier selectClassifier( const char** )
+
+static const char* implementation = "scalar";
+static const Classifier classifier = selectClassifier( &implementation );
+
+/*
+ * Classifies a block that may be shorter than TEXTSCAN_BLOCK. Bytes past the
+ *   end are reported as neither newlines nor delimiters.
+ */
+static inline void classifyPartial( const char* block,
+                                    const size_t count,
+                                    const bool slash,
+                                    uint64_t& newlines,
+                                    uint64_t& delimiters )
+{
+  if( count >= TEXTSCAN_BLOCK ) {
+    classifier( block, slash, newlines, delimiters );
+    return;
+  }
+
+  char padded[ TEXTSCAN_BLOCK ];
+  memcpy( padded, block, count );
+  memset( padded + count, 'x', TEXTSCAN_BLOCK - count );
+  classifier( padded, slash, newlines, delimiters );
+}// end static inline void classifyPartial( const char*, const size_t, ... )
+
+//----< TEXTSCAN >--------------------------------------------------------------
+void TextScan::classify( const char* block,
+                         const bool slash,
+                         uint64_t& newlines,
+                         uint64_t& delimiters )
+{
+  classifier( block, slash, newlines, delimiters );
+}// end void TextScan::classify( const char*, const bool, ... )
+
+
+const char* TextScan::findNewline( const char* begin, const char* end ) {
+  uint64_t newlines;
+  uint64_t delimiters;
+  while( begin < end ) {
+    classifyPartial( begin, end - begin, false, newlines, delimiters );
+    if( newlines != 0 ) {
+      return begin + __builtin_ctzll( newlines );
+    }
+    begin += TEXTSCAN_BLOCK;
+  }
+  return NULL;
+}// end const char* TextScan::findNewline( const char*, const char* )
+
+
+const char* TextScan::findString( const char* begin,
+                                  const char* end,
+                                  const char* needle )
+{
+  size_t needleLength = strlen( needle );
+  if( needleLength == 0 ) {
+    return begin;
+  }
+  if( begin + needleLength > end ) {
+    return NULL;
+  }
+
+  // candidates are positions matching both the first and last needle byte
+  const char* last = end - needleLength;    // last possible match
+  const char* position = begin;
+#ifdef TEXTSCAN_X86
+  const __m128i first = _mm_set1_epi8( needle[0] );
+  const __m128i final = _mm_set1_epi8( needle[ needleLength - 1 ] );
+  while( position + 16 <= last + 1 ) {
+    __m128i head = _mm_loadu_si128( (const __m128i*)position );
+    __m128i tail = _mm_loadu_si128(
+        (const __m128i*)( position + needleLength - 1 ));
+    unsigned int candidates = _mm_movemask_epi8(
+        _mm_and_si128( _mm_cmpeq_epi8( head, first ),
+                       _mm_cmpeq_epi8( tail, final )));
+    while( candidates != 0 ) {
+      int offset = __builtin_ctz( candidates );
+      if( !memcmp( position + offset, needle, needleLength )) {
+        return position + offset;
+      }
+      candidates &= candidates - 1;
+    }
+    position += 16;
+  }
+#endif
+  for( ; position <= last; position++ ) {
+    if( *position == needle[0]
+        && !memcmp( position, needle, needleLength ))
+    {
+      return position;
+    }
+  }
+  return NULL;
+}// end const char* TextScan::findString( const char*, const char*, ... )
+
+
+const int TextScan::splitFields( char* line,
+                                 const int length,
+                                 char** fields,
+                                 const int maxFields,
+                                 const bool slash,
+                                 bool* more )
+{
+  int count = 0;
+  bool extra = false;           // a field started past maxFields
+  uint64_t carry = 1;           // the line start acts as a delimiter
+
+  // the last field kept may end in a later block, so blocks are scanned
+  // until a field past maxFields shows up or the line ends
+  for( int base = 0; base < length && !extra; base += TEXTSCAN_BLOCK ) {
+    uint64_t newlines;
+    uint64_t delimiters;
+    size_t remaining = length - base;
+    classifyPartial( line + base, remaining, slash, newlines, delimiters );
+    if( remaining < TEXTSCAN_BLOCK ) {
+      // the end of the line terminates the last field
+      delimiters |= ~(uint64_t)0 << remaining;
+    }
+
+    // a field starts at each non-delimiter that follows a delimiter
+    uint64_t starts = ~delimiters & (( delimiters << 1 ) | carry );
+    carry = delimiters >> 63;
+
+    while( starts != 0 && count < maxFields ) {
+      fields[ count++ ] = line + base + __builtin_ctzll( starts );
+      starts &= starts - 1;
+    }
+    extra = starts != 0;
+
+    // terminate fields at their delimiters
+    uint64_t terminators = delimiters;
+    if( remaining < TEXTSCAN_BLOCK ) {
+      terminators &= ~( ~(uint64_t)0 << remaining );
+    }
+    while( terminators != 0 ) {
+      line[ base + __builtin_ctzll( terminators ) ] = '\0';
+      terminators &= terminators - 1;
+    }
+  }
+  if( more != NULL ) {
+    *more = extra;
+  }
+  return count;
+}// end const int TextScan::splitFields( char*, const int, char**, ... )
+
+
+const char* TextScan::getImplementation() {
+  return implementation;
+}// end const char* TextScan::getImplementation()
+
+//----< LINEREADER >------------------------------------------------------------
+LineReader::LineReader( std::istream& stream, const size_t blockSize )
+  : stream( stream )
+{
+  LOG_DEBUG( 8, "( stream, " << blockSize << " )" )
+
+  capacity = blockSize > TEXTSCAN_BLOCK ? blockSize : TEXTSCAN_BLOCK;
+  buffer = new char[ capacity + 1 ];
+  begin = 0;
+  end = 0;
+  maskBase = 0;
+  mask = 0;
+  maskValid = false;
+  exhausted = false;
+}// end LineReader::LineReader( std::istream&, const size_t )
+
+
+LineReader::~LineReader() {
+  LOG_DEBUG( 8, "()" )
+
+  delete[] buffer;
+  buffer = NULL;
+}// end LineReader::~LineReader()
+
+
+const bool LineReader::refill() {
+  if( exhausted ) {
+    return false;
+  }
+
+  // keep the partial line, growing the buffer if it is already full
+  size_t unread = end - begin;
+  if( unread == capacity ) {
+    char* larger = new char[ capacity * 2 + 1 ];
+    memcpy( larger, buffer + begin, unread );
+    delete[] buffer;
+    buffer = larger;
+    capacity *= 2;
+  } else if( begin > 0 ) {
+    memmove( buffer, buffer + begin, unread );
+  }
+  begin = 0;
+  end = unread;
+
+  // the bytes moved, so the cached bitmap no longer applies
+  maskValid = false;
+
+  stream.read( buffer + end, capacity - end );
+  std::streamsize count = stream.gcount();
+  if( count <= 0 ) {
+    exhausted = true;
+    return false;
+  }
+  end += count;
+  return true;
+}// end const bool LineReader::refill()
+
+
+const size_t LineReader::nextNewline() {
+  while( true ) {
+    // the cached block is usable if it ends past begin; there are never
+    //   newlines between begin and the start of that block
+    size_t next = begin;
+    if( maskValid && begin < maskBase + TEXTSCAN_BLOCK ) {
+      uint64_t pending = mask;
+      if( begin > maskBase ) {
+        pending &= ~(uint64_t)0 << ( begin - maskBase );
+      }
+      if( pending != 0 ) {
+        return maskBase + __builtin_ctzll( pending );
+      }
+      next = maskBase + TEXTSCAN_BLOCK;
+    }
+    if( next >= end ) {
+      return end;
+    }
+
+    uint64_t delimiters;
+    classifyPartial( buffer + next, end - next, false, mask, delimiters );
+    maskBase = next;
+    maskValid = true;
+  }
+}// end const size_t LineReader::nextNewline()
+
+
+char* LineReader::nextLine( int* length ) {
+  size_t newline = nextNewline();
+  while( newline == end ) {
+    if( !refill() ) {
+      // final line without a newline
+      if( begin == end ) {
+        return NULL;
+      }
+      newline = end;
+      break;
+    }
+    newline = nextNewline();
+  }
+
+  char* line = buffer + begin;
+  size_t lineLength = newline - begin;
+  buffer[ newline ] = '\0';
+  if( lineLength > 0 && line[ lineLength - 1 ] == '\r' ) {
+    line[ --lineLength ] = '\0';
+  }
+
+  // consume the line and its newline
+  begin = newline < end ? newline + 1 : end;
+
+  if( length != NULL ) {
+    *length = lineLength;
+  }
+  return line;
+}// end char* LineReader::nextLine( int* )
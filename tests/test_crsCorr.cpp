@@ -2,6 +2,48 @@
  * Test software included with the crsCorr library to ensure proper
  *   functioning of the DoubleDataSeries class.
  *
+ * Modified: 10/19/26
+ * Notes:    --Task pool tests cover a pool whose threads fail to start
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added rank window tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added job manifest tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added result writer tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added task pool tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added clock stability tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added sliding correlogram tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added Lomb-Scargle tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added cross spectrum and coherence tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added spectral analysis tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added despiking tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added rolling statistics tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added filter tests
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added masked correlation tests
+ *
  * Modified: 08/17/10
  * Notes:    --Initial Creation
  */
@@ -14,6 +56,20 @@
 * --crossCorr, double double  
 * --crossCorr, int double     
 * --crossCorr, double int     
+* --crossCorrMasked, direct   10/19/26
+* --crossCorrMasked, FFT      10/19/26
+* --SeriesFilter              10/19/26
+* --RollingStats              10/19/26
+* --RankWindow                10/19/26
+* --Despike                   10/19/26
+* --Fft, Spectrum             10/19/26
+* --CrossSpectrum             10/19/26
+* --LombScargle               10/19/26
+* --Correlogram               10/19/26
+* --Stability                 10/19/26
+* --TaskPool                  10/19/26
+* --ResultWriter              10/19/26
+* --JobManifest               10/19/26
 *
 * Valgrind:
 * --leak-check=full           08/12/10 - NF
@@ -23,6 +79,11 @@
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
 
 //----------------------Testing files-----------------------------------------
 
@@ -30,6 +91,26 @@
 #include <crsCorr/crsCorr.h>
 #include <crsCorr/clkStatsParser.h>
 #include <crsCorr/aceMagParser.h>
+#include <crsCorr/seriesFilter.h>
+#include <crsCorr/rollingStats.h>
+#include <crsCorr/rankWindow.h>
+#include <crsCorr/despike.h>
+#include <crsCorr/fft.h>
+#include <crsCorr/spectrum.h>
+#include <crsCorr/lombScargle.h>
+#include <crsCorr/correlogram.h>
+#include <crsCorr/stability.h>
+#include <crsCorr/taskPool.h>
+#include <crsCorr/resultWriter.h>
+#include <crsCorr/jobManifest.h>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 //----------------------Testing Vars------------------------------------------
 #define START_VALUE -20
@@ -42,6 +123,101 @@ DataType* loadSeries( const char* fileName );
 
 void passFail( bool result );
 
+/*
+ * Correlates gappy synthetic series with the requested method and checks
+ *   the sums, counts, and normalized values against a two pass reference
+ *   computed over the jointly valid samples.
+ */
+bool testMasked( const int method );
+
+/*
+ * Checks each filter against a direct computation, whole and streamed in
+ *   uneven blocks, and that detrending removes a fitted polynomial while
+ *   ignoring invalid samples.
+ */
+bool testFilters();
+
+/*
+ * Checks every rolling statistic of a gappy series against a naive pass
+ *   over each window.
+ */
+bool testRolling();
+
+/*
+ * Grows and shrinks a rank window over a gappy series with many ties and
+ *   checks every order statistic against the sorted window, and that cells
+ *   past either end or without data are ignored.
+ */
+bool testRankWindow();
+
+/*
+ * Checks Hampel spike detection on a gappy series with injected spikes
+ *   against medians and MADs computed by sorting each window, then checks
+ *   that flagging and replacing change only the spikes.
+ */
+bool testDespike();
+
+/*
+ * Checks complex and real transforms of daily and odd lengths against a
+ *   direct DFT and that repeated lengths reuse their plans, then checks
+ *   periodogram peaks, Parseval's theorem across windows and gaps, and the
+ *   level of a Welch estimate of white noise.
+ */
+bool testSpectrum();
+
+/*
+ * Checks that a noisy delayed copy of a series is coherent with it at the
+ *   delay's phase lag while independent noise is not, and that a batch of
+ *   pairs over shared segment transforms matches pairs estimated alone.
+ */
+bool testCrossSpectrum();
+
+/*
+ * Checks the fast Lomb-Scargle periodogram of a tone with long dropouts
+ *   against the direct sums and that its peak stands at the tone with a
+ *   negligible false alarm probability.
+ */
+bool testLombScargle();
+
+/*
+ * Checks every entry of a threaded sliding correlogram over gappy series
+ *   against correlations computed window by window, that it tracks a lag
+ *   which changes midway, and that its files are written. Over sparse series,
+ *   with a lag count that does not divide 64, the validity of a many
+ *   threaded correlogram must match a single threaded one bit for bit.
+ */
+bool testCorrelogram();
+
+/*
+ * Checks ADEV, MDEV, TDEV, and MTIE of gappy phase data against their
+ *   defining sums, the slopes white phase and white frequency noise give,
+ *   and that frequency input matches its integrated phase.
+ */
+bool testStability();
+
+/*
+ * Runs tasks that submit further tasks on a work stealing pool and checks
+ *   that wait() returns only once every one of them ran, exactly once, and
+ *   that more than one worker took part. Then, in a child process too small
+ *   to start a thread, checks that wait() and the destructor run every task
+ *   themselves rather than blocking.
+ */
+bool testTaskPool();
+
+/*
+ * Writes a table through small chunks as text, asynchronously and not, and
+ *   as binary, checking that the text reads back to the exact values and
+ *   the binary header and columns match.
+ */
+bool testResultWriter();
+
+/*
+ * Records job signatures built from input fingerprints, saves and reloads
+ *   the manifest, and checks that only jobs whose input changed, in either
+ *   fingerprint mode, stop being current.
+ */
+bool testJobManifest();
+
 template <class DataType>
 bool testSeries( const DataSeries<DataType>& series,
                  const char* label,
@@ -58,6 +234,20 @@ int main() {
   bool crsCorrIntDouble = false;
   bool crsCorrDoubleInt = false;
   bool crsCorrDoubleDouble = false;
+  bool crsCorrMaskedDirect = testMasked( CRSCORR_METHOD_DIRECT );
+  bool crsCorrMaskedFft = testMasked( CRSCORR_METHOD_FFT );
+  bool seriesFilters = testFilters();
+  bool rollingStats = testRolling();
+  bool rankWindow = testRankWindow();
+  bool despike = testDespike();
+  bool spectrum = testSpectrum();
+  bool crossSpectrum = testCrossSpectrum();
+  bool lombScargle = testLombScargle();
+  bool correlogram = testCorrelogram();
+  bool stability = testStability();
+  bool taskPool = testTaskPool();
+  bool resultWriter = testResultWriter();
+  bool jobManifest = testJobManifest();
 /*
   DataSeries<int> smallSeries( "SMALL" );
   for( int i = 2; i < 7; i++ ) {
@@ -155,10 +345,524 @@ int main() {
        passFail( crsCorrDoubleInt );
   cout << setw( 40 ) << " Cross Corr Double Double: ";
        passFail( crsCorrDoubleDouble );
+  cout << setw( 40 ) << " Masked Corr Direct: ";
+       passFail( crsCorrMaskedDirect );
+  cout << setw( 40 ) << " Masked Corr FFT: ";
+       passFail( crsCorrMaskedFft );
+  cout << setw( 40 ) << " Series Filters: ";
+       passFail( seriesFilters );
+  cout << setw( 40 ) << " Rolling Stats: ";
+       passFail( rollingStats );
+  cout << setw( 40 ) << " Rank Window: ";
+       passFail( rankWindow );
+  cout << setw( 40 ) << " Hampel Despike: ";
+       passFail( despike );
+  cout << setw( 40 ) << " Spectral Analysis: ";
+       passFail( spectrum );
+  cout << setw( 40 ) << " Cross Spectra: ";
+       passFail( crossSpectrum );
+  cout << setw( 40 ) << " Lomb-Scargle: ";
+       passFail( lombScargle );
+  cout << setw( 40 ) << " Sliding Correlogram: ";
+       passFail( correlogram );
+  cout << setw( 40 ) << " Clock Stability: ";
+       passFail( stability );
+  cout << setw( 40 ) << " Task Pool: ";
+       passFail( taskPool );
+  cout << setw( 40 ) << " Result Writer: ";
+       passFail( resultWriter );
+  cout << setw( 40 ) << " Job Manifest: ";
+       passFail( jobManifest );
 
   return 0;
 }// end int main()
 
+bool testMasked( const int method ) {
+  bool passed = true;
+  srand( 34 );
+
+  // short series with a dropout, long series with scattered gaps
+  const int shortLen = 96;
+  const int longLen = 288;
+  DataSeries<int> shortSeries( "SHORT" );
+  DataSeries<double> longSeries( "LONG" );
+  shortSeries.initGrid( shortLen, 5, 0 );
+  longSeries.initGrid( longLen, 5, 0 );
+  for( int i = 0; i < shortLen; i++ ) {
+    int value = rand() % 100 - 50;
+    if( i < 30 || i > 40 ) {
+      shortSeries.placeValue( &value, i );
+    }
+  }
+  for( int i = 0; i < longLen; i++ ) {
+    double value = sin( i / 7.0 ) * 40.0 + ( rand() % 100 ) / 10.0;
+    if( rand() % 5 != 0 ) {
+      longSeries.placeValue( &value, i );
+    }
+  }
+  shortSeries.finalizeData();
+  longSeries.finalizeData();
+
+  DataSeries<double>* sums = NULL;
+  DataSeries<int>* counts = NULL;
+  const DataSeries<double>* result = crsCorr::crossCorrMasked(
+      &shortSeries, &longSeries, &sums, &counts, method );
+  int length = longLen - shortLen + 1;
+  if( result == NULL || result->getLength() != length ) {
+    cout << "ERR: No result." << endl;
+    return false;
+  }
+
+  for( int delay = 0; delay < length && passed; delay++ ) {
+    int offset = length - delay - 1;
+    int n = 0;
+    double sumX = 0.0;
+    double sumY = 0.0;
+    double sumXY = 0.0;
+    for( int i = 0; i < shortLen; i++ ) {
+      if( shortSeries.isValid( i ) && longSeries.isValid( offset + i )) {
+        n++;
+        sumX += shortSeries.getData()[i];
+        sumY += longSeries.getData()[ offset + i ];
+        sumXY += shortSeries.getData()[i] * longSeries.getData()[ offset + i ];
+      }
+    }
+    double meanX = sumX / n;
+    double meanY = sumY / n;
+    double cov = 0.0;
+    double varX = 0.0;
+    double varY = 0.0;
+    for( int i = 0; i < shortLen; i++ ) {
+      if( shortSeries.isValid( i ) && longSeries.isValid( offset + i )) {
+        double dx = shortSeries.getData()[i] - meanX;
+        double dy = longSeries.getData()[ offset + i ] - meanY;
+        cov += dx * dy;
+        varX += dx * dx;
+        varY += dy * dy;
+      }
+    }
+    double expected = cov / sqrt( varX * varY );
+
+    if( counts->getData()[delay] != n
+        || fabs( sums->getData()[delay] - sumXY ) > 1e-6 * ( 1.0 + fabs( sumXY ))
+        || !result->isValid( delay )
+        || fabs( result->getData()[delay] - expected ) > 1e-9 )
+    {
+      cout << "ERR: Delay " << delay << " ( " << result->getData()[delay]
+           << ", " << counts->getData()[delay] << " ) expected: "
+           << expected << ", " << n << endl;
+      passed = false;
+    }
+  }
+
+  delete result;
+  delete sums;
+  delete counts;
+  return passed;
+}// end bool testMasked( const int )
+
+
+/*
+ * Runs a filter over values whole, then from a reset state in uneven blocks
+ *   in place, and compares both against expected.
+ */
+bool testStreaming( SeriesFilter& filter,
+                    const double* values,
+                    const double* expected,
+                    const int count,
+                    const char* name )
+{
+  double* whole = new double[ count ];
+  double* blocks = new double[ count ];
+  memcpy( blocks, values, count * sizeof( double ));
+  filter.reset();
+  filter.process( values, whole, count );
+  filter.reset();
+  for( int first = 0, size = 1; first < count; first += size, size += 37 ) {
+    filter.process( blocks + first, blocks + first,
+                    size < count - first ? size : count - first );
+  }
+
+  bool passed = true;
+  for( int i = 0; i < count && passed; i++ ) {
+    double tolerance = 1e-9 * ( 1.0 + fabs( expected[i] ));
+    if( fabs( whole[i] - expected[i] ) > tolerance
+        || fabs( blocks[i] - expected[i] ) > tolerance )
+    {
+      cout << "ERR: " << name << " sample " << i << " ( " << whole[i] << ", "
+           << blocks[i] << " ) expected: " << expected[i] << endl;
+      passed = false;
+    }
+  }
+  delete[] whole;
+  delete[] blocks;
+  return passed;
+}// end bool testStreaming( SeriesFilter&, const double*, ... )
+
+
+bool testFilters() {
+  bool passed = true;
+  srand( 38 );
+  const int count = 2000;
+  double* values = new double[ count ];
+  double* expected = new double[ count ];
+  for( int i = 0; i < count; i++ ) {
+    values[i] = sin( i / 11.0 ) * 30.0 + rand() % 100 / 10.0;
+  }
+
+  // short and long kernels against the convolution sum
+  const int tapCounts[] = { 5, 100 };
+  for( int t = 0; t < 2; t++ ) {
+    int taps = tapCounts[t];
+    double* kernel = new double[ taps ];
+    for( int k = 0; k < taps; k++ ) {
+      kernel[k] = ( rand() % 200 - 100 ) / 1000.0;
+    }
+    for( int n = 0; n < count; n++ ) {
+      expected[n] = 0.0;
+      for( int k = 0; k < taps && k <= n; k++ ) {
+        expected[n] += kernel[k] * values[ n - k ];
+      }
+    }
+    FirFilter direct( kernel, taps, false );
+    FirFilter fft( kernel, taps );
+    passed &= testStreaming( direct, values, expected, count, "FIR direct" );
+    passed &= testStreaming( fft, values, expected, count, "FIR FFT" );
+    delete[] kernel;
+  }
+
+  // a low pass section followed by a high pass section
+  BiquadFilter biquad;
+  passed &= biquad.addLowPass( 0.1 ) && biquad.addHighPass( 0.01, 0.5 )
+            && !biquad.addLowPass( 0.5 ) && biquad.getSectionCount() == 2;
+  double w0 = 2.0 * M_PI * 0.1;
+  double alpha = sin( w0 ) / ( 2.0 * 0.70710678 );
+  double low[5] = { ( 1.0 - cos( w0 )) / 2.0, 1.0 - cos( w0 ),
+                    ( 1.0 - cos( w0 )) / 2.0, -2.0 * cos( w0 ), 1.0 - alpha };
+  w0 = 2.0 * M_PI * 0.01;
+  alpha = sin( w0 ) / ( 2.0 * 0.5 );
+  double high[5] = { ( 1.0 + cos( w0 )) / 2.0, -( 1.0 + cos( w0 )),
+                     ( 1.0 + cos( w0 )) / 2.0, -2.0 * cos( w0 ), 1.0 - alpha };
+  double lowA0 = 1.0 + sin( 2.0 * M_PI * 0.1 ) / ( 2.0 * 0.70710678 );
+  double highA0 = 1.0 + alpha;
+  double* stage = new double[ count ];
+  for( int n = 0; n < count; n++ ) {
+    double y = low[0] * values[n];
+    for( int k = 1; k <= 2 && k <= n; k++ ) {
+      y += low[ k ] * values[ n - k ] - low[ k + 2 ] * stage[ n - k ];
+    }
+    stage[n] = y / lowA0;
+  }
+  for( int n = 0; n < count; n++ ) {
+    double y = high[0] * stage[n];
+    for( int k = 1; k <= 2 && k <= n; k++ ) {
+      y += high[ k ] * stage[ n - k ] - high[ k + 2 ] * expected[ n - k ];
+    }
+    expected[n] = y / highA0;
+  }
+  passed &= testStreaming( biquad, values, expected, count, "Biquad" );
+  delete[] stage;
+
+  // moving average of the last 60 samples
+  MovingAverage average( 60 );
+  for( int n = 0; n < count; n++ ) {
+    double sum = 0.0;
+    int first = n >= 59 ? n - 59 : 0;
+    for( int k = first; k <= n; k++ ) {
+      sum += values[k];
+    }
+    expected[n] = sum / ( n - first + 1 );
+  }
+  passed &= testStreaming( average, values, expected, count, "Average" );
+
+  // a quadratic trend is removed exactly, even with wild invalid samples
+  DataSeries<double> trended( "TREND" );
+  trended.initGrid( count, 1, 0 );
+  for( int i = 0; i < count; i++ ) {
+    double value = 3.0 + 0.01 * i - 2e-6 * i * i;
+    if( i % 7 == 3 ) {
+      value = 1e6;
+    } else {
+      trended.placeValue( &value, i );
+    }
+  }
+  trended.finalizeData();
+  DataSeries<double>* flat = SeriesFilter::detrend( trended, "FLAT", 2 );
+  if( flat == NULL || flat->getLength() != count || flat->isValid( 3 )
+      || !flat->isValid( 4 ) || flat->getLabel() != "FLAT" )
+  {
+    cout << "ERR: Detrended series malformed." << endl;
+    passed = false;
+  }
+  for( int i = 0; flat != NULL && i < count && passed; i++ ) {
+    if( flat->isValid( i ) && fabs( flat->getData()[i] ) > 1e-9 ) {
+      cout << "ERR: Detrend residual " << flat->getData()[i] << " at " << i
+           << endl;
+      passed = false;
+    }
+  }
+  delete flat;
+  passed &= SeriesFilter::detrend( trended, "BAD", SERIESFILTER_MAX_ORDER + 1 )
+            == NULL;
+
+  // the series filter carries validity and matches the array filter
+  DataSeries<double>* smoothed = average.apply( trended, "SMOOTH" );
+  if( smoothed == NULL || smoothed->isValid( 3 ) || !smoothed->isValid( 5 )
+      || fabs( smoothed->getData()[0] - 3.0 ) > 1e-12 )
+  {
+    cout << "ERR: Filtered series malformed." << endl;
+    passed = false;
+  }
+  delete smoothed;
+
+  delete[] values;
+  delete[] expected;
+  return passed;
+}// end bool testFilters()
+
+
+bool testRolling() {
+  bool passed = true;
+  srand( 39 );
+  const int count = 1000;
+  const int window = 15;
+  DataSeries<int> series( "ROLL" );
+  series.initGrid( count, 1, 0 );
+  for( int i = 0; i < count; i++ ) {
+    int value = rand() % 50;
+    if( rand() % 4 != 0 && ( i < 400 || i > 430 )) {
+      series.placeValue( &value, i );
+    }
+  }
+  series.finalizeData();
+
+  const int statistics[] = { ROLLING_MEAN, ROLLING_VARIANCE, ROLLING_MIN,
+                             ROLLING_MAX, ROLLING_QUANTILE, ROLLING_QUANTILE };
+  const double quantiles[] = { 0.0, 0.0, 0.0, 0.0, 0.5, 0.9 };
+  for( int s = 0; s < 6; s++ ) {
+    DataSeries<double>* result = RollingStats::rolling(
+        series, window, statistics[s], "RESULT", quantiles[s], 3 );
+    if( result == NULL || result->getLength() != count ) {
+      cout << "ERR: No rolling result for " << statistics[s] << endl;
+      passed = false;
+      delete result;
+      continue;
+    }
+
+    for( int i = 0; i < count && passed; i++ ) {
+      std::vector<double> inWindow;
+      for( int k = i - window + 1 > 0 ? i - window + 1 : 0; k <= i; k++ ) {
+        if( series.isValid( k )) {
+          inWindow.push_back( series.getData()[k] );
+        }
+      }
+      int n = inWindow.size();
+      bool defined = n >= 3;
+      double expected = 0.0;
+      if( defined ) {
+        std::sort( inWindow.begin(), inWindow.end() );
+        double mean = 0.0;
+        for( int k = 0; k < n; k++ ) {
+          mean += inWindow[k] / n;
+        }
+        double squares = 0.0;
+        for( int k = 0; k < n; k++ ) {
+          squares += ( inWindow[k] - mean ) * ( inWindow[k] - mean );
+        }
+        double position = quantiles[s] * ( n - 1 );
+        int lower = (int)position;
+        int upper = lower + 1 < n ? lower + 1 : lower;
+        switch( statistics[s] ) {
+          case ROLLING_MEAN: expected = mean; break;
+          case ROLLING_VARIANCE: expected = squares / ( n - 1 ); break;
+          case ROLLING_MIN: expected = inWindow[0]; break;
+          case ROLLING_MAX: expected = inWindow[ n - 1 ]; break;
+          default:
+            expected = inWindow[ lower ]
+                       + ( position - lower )
+                         * ( inWindow[ upper ] - inWindow[ lower ] );
+        }
+      }
+      if( result->isValid( i ) != defined
+          || ( defined && fabs( result->getData()[i] - expected )
+                          > 1e-9 * ( 1.0 + fabs( expected ))))
+      {
+        cout << "ERR: Statistic " << statistics[s] << " cell " << i << " ( "
+             << result->getData()[i] << ", " << result->isValid( i )
+             << " ) expected: " << expected << ", " << defined << endl;
+        passed = false;
+      }
+    }
+    delete result;
+  }
+
+  // windows must be whole cells and quantiles within 0 to 1
+  DataSeries<int> coarse( series, "COARSE", 5, 0 );
+  passed &= RollingStats::rolling( coarse, 12, ROLLING_MEAN, "BAD" ) == NULL
+            && RollingStats::rolling( series, 15, ROLLING_QUANTILE, "BAD",
+                                      1.5 ) == NULL;
+  return passed;
+}// end bool testRolling()
+
+
+bool testRankWindow() {
+  bool passed = true;
+  srand( 34 );
+  const int count = 700;
+  DataSeries<double> series( "TIED" );
+  series.initGrid( count, 1, 0 );
+  for( int i = 0; i < count; i++ ) {
+    double value = rand() % 25 - 12.0;
+    if( rand() % 5 != 0 ) {
+      series.placeValue( &value, i );
+    }
+  }
+  series.finalizeData();
+  const double* data = series.getData();
+
+  // the window covers cells first through last - 1; each step moves one end
+  RankWindow window( data, series.getValidity(), count );
+  int first = 0;
+  int last = 0;
+  for( int step = 0; step < 3 * count && passed; step++ ) {
+    if( last < count && ( first == last || rand() % 3 != 0 )) {
+      window.insert( last++ );
+    } else if( first < last ) {
+      window.remove( first++ );
+    }
+    window.insert( -1 - rand() % 5 );
+    window.remove( count + rand() % 5 );
+
+    std::vector<double> expected;
+    for( int i = first; i < last; i++ ) {
+      if( series.isValid( i )) {
+        expected.push_back( data[i] );
+      }
+      if( window.isRanked( i ) != series.isValid( i )) {
+        cout << "ERR: Cell " << i << " ranked " << window.isRanked( i )
+             << endl;
+        passed = false;
+      }
+    }
+    std::sort( expected.begin(), expected.end() );
+    if( window.getSize() != (int)expected.size() ) {
+      cout << "ERR: Window of " << first << " to " << last << " holds "
+           << window.getSize() << " samples, expected " << expected.size()
+           << endl;
+      passed = false;
+    }
+    for( int k = 1; k <= (int)expected.size() && passed; k++ ) {
+      if( window.select( k ) != expected[ k - 1 ] ) {
+        cout << "ERR: Window of " << first << " to " << last << " order "
+             << k << " is " << window.select( k ) << ", expected "
+             << expected[ k - 1 ] << endl;
+        passed = false;
+      }
+    }
+  }
+
+  RankWindow empty( data, series.getValidity(), 0 );
+  empty.insert( 0 );
+  passed &= empty.getSize() == 0 && !empty.isRanked( 0 );
+  return passed;
+}// end bool testRankWindow()
+
+
+/*
+ * Median of a vector, averaging the middle two of an even count.
+ */
+double medianOf( std::vector<double> values ) {
+  std::sort( values.begin(), values.end() );
+  int n = values.size();
+  return n % 2 ? values[ n / 2 ] : ( values[ n / 2 - 1 ] + values[ n / 2 ] ) / 2.0;
+}// end double medianOf( std::vector<double> )
+
+
+bool testDespike() {
+  bool passed = true;
+  srand( 40 );
+  const int count = 1500;
+  const int halfWidth = 6;
+  DataSeries<double> series( "SPIKY" );
+  series.initGrid( count, 5, 0 );
+  for( int i = 0; i < count; i++ ) {
+    double value = sin( i / 40.0 ) * 20.0 + rand() % 100 / 20.0;
+    if( i % 97 == 13 ) {
+      value += ( i % 2 ? 1 : -1 ) * ( 50.0 + rand() % 50 );
+    }
+    if( rand() % 6 != 0 ) {
+      series.placeValue( &value, i );
+    }
+  }
+  series.finalizeData();
+  const double* data = series.getData();
+
+  uint64_t* spikes = new uint64_t[ ( count + 63 ) / 64 ];
+  double* medians = new double[ count ];
+  int found = Despike::hampel( data, series.getValidity(), count, halfWidth,
+                               DESPIKE_THRESHOLD, spikes, medians );
+  int expectedFound = 0;
+  for( int i = 0; i < count && passed; i++ ) {
+    std::vector<double> window;
+    for( int k = i - halfWidth; k <= i + halfWidth; k++ ) {
+      if( k >= 0 && k < count && series.isValid( k )) {
+        window.push_back( data[k] );
+      }
+    }
+    bool spike = false;
+    double median = 0.0;
+    if( series.isValid( i ) && window.size() >= 3 ) {
+      median = medianOf( window );
+      std::vector<double> deviations;
+      for( size_t k = 0; k < window.size(); k++ ) {
+        deviations.push_back( fabs( window[k] - median ));
+      }
+      double limit = DESPIKE_THRESHOLD * DESPIKE_MAD_SCALE
+                     * medianOf( deviations );
+      spike = limit > 0.0 && fabs( data[i] - median ) > limit;
+    }
+    expectedFound += spike;
+    bool flagged = ( spikes[ i >> 6 ] >> ( i & 63 )) & 1;
+    if( flagged != spike || ( spike && fabs( medians[i] - median ) > 1e-12 )) {
+      cout << "ERR: Cell " << i << " flagged " << flagged << " expected "
+           << spike << endl;
+      passed = false;
+    }
+  }
+  if( found != expectedFound || found < 10 ) {
+    cout << "ERR: Found " << found << " spikes, expected " << expectedFound
+         << endl;
+    passed = false;
+  }
+
+  // flagging invalidates exactly the spikes; replacing keeps them valid
+  DataSeries<double> flagged( series );
+  DataSeries<double> replaced( series );
+  if( Despike::despike( flagged, 60 ) != found
+      || Despike::despike( replaced, 60, DESPIKE_THRESHOLD, DESPIKE_REPLACE )
+         != found
+      || flagged.getValidCount() != series.getValidCount() - found
+      || replaced.getValidCount() != series.getValidCount() )
+  {
+    cout << "ERR: Despiked series changed the wrong cells." << endl;
+    passed = false;
+  }
+  for( int i = 0; i < count && passed; i++ ) {
+    bool spike = ( spikes[ i >> 6 ] >> ( i & 63 )) & 1;
+    if( replaced.getData()[i] != ( spike ? medians[i] : data[i] )) {
+      cout << "ERR: Replaced cell " << i << " holds "
+           << replaced.getData()[i] << endl;
+      passed = false;
+    }
+  }
+  passed &= Despike::despike( flagged, 5 ) == -1;
+
+  delete[] spikes;
+  delete[] medians;
+  return passed;
+}// end bool testDespike()
+
+
 template<typename DataType>
 DataSeries<DataType>* loadSeries( const char* fileName ) {
   std::ifstream dataFile( fileName );
@@ -272,4 +976,1009 @@ bool testSeries( const DataSeries<DataType>& series,
     cout << "FAILED." << endl;
     return false;
   }
-}// end bool testSeries( const DoubleDataSeries&, const char* const, ... )
\ No newline at end of file
+}// end bool testSeries( const DoubleDataSeries&, const char* const, ... )
+
+bool testSpectrum() {
+  bool passed = true;
+  srand( 41 );
+  typedef std::complex<double> Complex;
+
+  // transforms against the direct sum
+  const int lengths[] = { 288, 1440, 1024, 45, 7 };
+  for( int t = 0; t < 5 && passed; t++ ) {
+    const int n = lengths[t];
+    std::vector<double> real( n );
+    std::vector<Complex> values( n );
+    for( int i = 0; i < n; i++ ) {
+      real[i] = rand() % 1000 / 100.0 - 5.0;
+      values[i] = Complex( real[i], rand() % 1000 / 100.0 - 5.0 );
+    }
+    std::vector<Complex> transformed( values );
+    Fft::transform( &transformed[0], n );
+    std::vector<Complex> bins( Spectrum::getBins( n ));
+    Fft::realTransform( &real[0], n, &bins[0] );
+
+    double error = 0.0;
+    for( int k = 0; k < n; k++ ) {
+      Complex direct = 0.0;
+      Complex directReal = 0.0;
+      for( int j = 0; j < n; j++ ) {
+        Complex twiddle = std::polar( 1.0, -2.0 * M_PI * (double)(
+                                           ( (long long)j * k ) % n ) / n );
+        direct += values[j] * twiddle;
+        directReal += real[j] * twiddle;
+      }
+      error = std::max( error, std::abs( transformed[k] - direct ));
+      if( k <= n / 2 ) {
+        error = std::max( error, std::abs( bins[k] - directReal ));
+      }
+    }
+    Fft::transform( &transformed[0], n, true );
+    for( int i = 0; i < n; i++ ) {
+      error = std::max( error, std::abs( transformed[i] - values[i] ));
+    }
+    if( error > 1e-8 ) {
+      cout << "ERR: Transform of " << n << " values is off by " << error
+           << endl;
+      passed = false;
+    }
+  }
+
+  int plans = Fft::getPlanCount();
+  std::vector<Complex> day( 1440, 1.0 );
+  Fft::transform( &day[0], 1440 );
+  Fft::transform( &day[0], 288 );
+  if( Fft::getPlanCount() != plans ) {
+    cout << "ERR: Repeated lengths built " << Fft::getPlanCount() - plans
+         << " new plans." << endl;
+    passed = false;
+  }
+
+  // a day of 5 minute cells holding a 3 cycle per day tone and some gaps
+  const int count = 288;
+  DataSeries<double> series( "TONE" );
+  series.initGrid( count, 5, 0 );
+  for( int i = 0; i < count; i++ ) {
+    double value = 10.0 + 4.0 * sin( 2.0 * M_PI * 3.0 * i / count )
+                   + rand() % 100 / 100.0;
+    if( i % 37 != 5 ) {
+      series.placeValue( &value, i );
+    }
+  }
+  series.finalizeData();
+  const double* data = series.getData();
+  double mean = 0.0;
+  for( int i = 0; i < count; i++ ) {
+    mean += series.isValid( i ) ? data[i] : 0.0;
+  }
+  mean /= series.getValidCount();
+
+  const int windows[] = { SPECTRUM_WINDOW_RECTANGULAR, SPECTRUM_WINDOW_HANN,
+                          SPECTRUM_WINDOW_HAMMING, SPECTRUM_WINDOW_BLACKMAN };
+  for( int w = 0; w < 4 && passed; w++ ) {
+    std::vector<double> weights( count );
+    Spectrum::makeWindow( windows[w], count, &weights[0] );
+    double energy = 0.0;
+    double variance = 0.0;
+    for( int i = 0; i < count; i++ ) {
+      if( series.isValid( i )) {
+        energy += weights[i] * weights[i];
+        variance += pow(( data[i] - mean ) * weights[i], 2 );
+      }
+    }
+    variance /= energy;
+
+    PowerSpectrum* spectrum = Spectrum::periodogram( series, windows[w] );
+    if( spectrum == NULL || spectrum->getBins() != count / 2 + 1
+        || spectrum->getSegments() != 1
+        || fabs( spectrum->getBinWidth() - 1.0 ) > 1e-12
+        || spectrum->getPeakBin() != 3
+        || fabs( spectrum->getTotalPower() - variance ) > 1e-9 * variance )
+    {
+      cout << "ERR: Periodogram with window " << windows[w] << " misplaced "
+           << "its peak or power." << endl;
+      passed = false;
+    } else {
+      spectrum->normalize();
+      double total = 0.0;
+      for( int k = 1; k < spectrum->getBins(); k++ ) {
+        total += spectrum->getPower()[k];
+      }
+      passed &= fabs( total - 1.0 ) < 1e-12;
+    }
+    delete spectrum;
+  }
+
+  // white noise of variance 1/12 is flat at twice that over the band
+  DataSeries<double> noise( "NOISE" );
+  noise.initGrid( 20 * 1440, 1, 0 );
+  for( int i = 0; i < 20 * 1440; i++ ) {
+    double value = rand() / (double)RAND_MAX;
+    noise.placeValue( &value, i );
+  }
+  noise.finalizeData();
+  plans = Fft::getPlanCount();
+  PowerSpectrum* welch = Spectrum::welch( noise, 1440 );
+  if( welch == NULL || welch->getSegments() != 39
+      || Fft::getPlanCount() != plans )
+  {
+    cout << "ERR: Welch estimate split the wrong segments." << endl;
+    passed = false;
+  } else {
+    double level = 0.0;
+    for( int k = 1; k < welch->getBins() - 1; k++ ) {
+      level += welch->getPower()[k];
+    }
+    level /= welch->getBins() - 2;
+    double expected = 2.0 / 12.0 / 1440.0;
+    if( fabs( level - expected ) > 0.05 * expected ) {
+      cout << "ERR: White noise level " << level << " expected " << expected
+           << endl;
+      passed = false;
+    }
+  }
+  delete welch;
+
+  passed &= Spectrum::welch( noise, 1 ) == NULL
+            && Spectrum::welch( noise, 1440, 9 ) == NULL;
+  return passed;
+}// end bool testSpectrum()
+
+
+bool testCrossSpectrum() {
+  bool passed = true;
+  srand( 42 );
+
+  // b repeats a three minutes later under a little noise; c is independent
+  const int count = 20 * 1440;
+  const int delay = 3;
+  std::vector<double> source( count );
+  for( int i = 0; i < count; i++ ) {
+    source[i] = rand() / (double)RAND_MAX - 0.5;
+  }
+  DataSeries<double> a( "A" );
+  DataSeries<double> b( "B" );
+  DataSeries<double> c( "C" );
+  a.initGrid( count, 1, 0 );
+  b.initGrid( count, 1, 0 );
+  c.initGrid( count, 1, 0 );
+  for( int i = 0; i < count; i++ ) {
+    double value = source[ i >= delay ? i - delay : 0 ]
+                   + 0.2 * ( rand() / (double)RAND_MAX - 0.5 );
+    double noise = rand() / (double)RAND_MAX - 0.5;
+    if( i % 500 > 20 ) {
+      a.placeValue( &source[i], i );
+    }
+    b.placeValue( &value, i );
+    c.placeValue( &noise, i );
+  }
+  a.finalizeData();
+  b.finalizeData();
+  c.finalizeData();
+
+  CrossSpectrum* coupled = Spectrum::crossSpectrum( a, b, 1440 );
+  CrossSpectrum* unrelated = Spectrum::crossSpectrum( a, c, 1440 );
+  if( coupled == NULL || unrelated == NULL ) {
+    cout << "ERR: Cross spectra could not be estimated." << endl;
+    delete coupled;
+    delete unrelated;
+    return false;
+  }
+  double coherent = 0.0;
+  double incoherent = 0.0;
+  double lag = 0.0;
+  // low bins turn too little phase to read a three minute lag
+  for( int k = 21; k <= 120; k++ ) {
+    coherent += coupled->getCoherence()[k] / 100;
+    incoherent += unrelated->getCoherence()[k] / 100;
+    lag += coupled->getLag( k ) / 100;
+  }
+  if( coupled->getSegments() != 39 || coherent < 0.9 || incoherent > 0.1
+      || fabs( lag - delay ) > 0.1 )
+  {
+    cout << "ERR: Coherence " << coherent << " and " << incoherent
+         << ", lag " << lag << " over " << coupled->getSegments()
+         << " segments." << endl;
+    passed = false;
+  }
+  for( int k = 0; k < coupled->getBins(); k++ ) {
+    passed &= coupled->getCoherence()[k] >= 0.0
+              && coupled->getCoherence()[k] <= 1.0 + 1e-12;
+  }
+
+  // the batch transforms each series once and matches the pairs alone
+  std::vector<const SegmentSpectra*> rows;
+  std::vector<const SegmentSpectra*> cols;
+  rows.push_back( Spectrum::transformSeries( a, 1440 ));
+  cols.push_back( Spectrum::transformSeries( b, 1440 ));
+  cols.push_back( Spectrum::transformSeries( c, 1440 ));
+  std::vector<CrossSpectrum*> batch = Spectrum::crossBatch( rows, cols );
+  CrossSpectrum* alone[] = { coupled, unrelated };
+  for( int pair = 0; pair < 2; pair++ ) {
+    if( batch[ pair ] == NULL ) {
+      passed = false;
+      continue;
+    }
+    for( int k = 0; k < alone[ pair ]->getBins(); k++ ) {
+      passed &= batch[ pair ]->getCsd()[k] == alone[ pair ]->getCsd()[k]
+                && batch[ pair ]->getCoherence()[k]
+                   == alone[ pair ]->getCoherence()[k];
+    }
+    delete batch[ pair ];
+  }
+
+  // segments of another length do not pair up
+  SegmentSpectra* shorter = Spectrum::transformSeries( c, 720 );
+  passed &= shorter != NULL
+            && Spectrum::crossSpectrum( *rows[0], *shorter ) == NULL;
+  delete shorter;
+  delete rows[0];
+  delete cols[0];
+  delete cols[1];
+  delete coupled;
+  delete unrelated;
+  return passed;
+}// end bool testCrossSpectrum()
+
+
+bool testLombScargle() {
+  bool passed = true;
+  srand( 43 );
+
+  // ten days of 5 minute cells, a 3.7 cycle per day tone, and dropouts of
+  //   up to six hours
+  const int count = 10 * 288;
+  DataSeries<double> series( "GAPPY" );
+  series.initGrid( count, 5, 0 );
+  std::vector<double> times;
+  std::vector<double> values;
+  int dropout = 0;
+  for( int i = 0; i < count; i++ ) {
+    if( dropout == 0 && rand() % 200 == 0 ) {
+      dropout = 12 + rand() % 60;
+    }
+    if( dropout > 0 ) {
+      dropout--;
+      continue;
+    }
+    double t = i * 5 / 1440.0;
+    double value = 7.0 + 2.0 * sin( 2.0 * M_PI * 3.7 * t + 0.4 )
+                   + rand() % 1000 / 250.0;
+    series.placeValue( &value, i );
+    times.push_back( t );
+    values.push_back( value );
+  }
+  series.finalizeData();
+
+  PowerSpectrum* fast = LombScargle::periodogram( series );
+  if( fast == NULL || (int)times.size() > count - 100 ) {
+    cout << "ERR: Periodogram of " << times.size() << " samples failed."
+         << endl;
+    delete fast;
+    return false;
+  }
+
+  // the direct sums at a sample of the bins
+  const int n = times.size();
+  double mean = 0.0;
+  for( int j = 0; j < n; j++ ) {
+    mean += values[j] / n;
+  }
+  double variance = 0.0;
+  for( int j = 0; j < n; j++ ) {
+    variance += ( values[j] - mean ) * ( values[j] - mean ) / ( n - 1 );
+  }
+  double error = 0.0;
+  for( int k = 1; k < fast->getBins(); k += 97 ) {
+    double w = 2.0 * M_PI * fast->getFrequency( k );
+    double sin2 = 0.0;
+    double cos2 = 0.0;
+    for( int j = 0; j < n; j++ ) {
+      sin2 += sin( 2.0 * w * times[j] );
+      cos2 += cos( 2.0 * w * times[j] );
+    }
+    double tau = atan2( sin2, cos2 ) / ( 2.0 * w );
+    double yc = 0.0, ys = 0.0, cc = 0.0, ss = 0.0;
+    for( int j = 0; j < n; j++ ) {
+      double c = cos( w * ( times[j] - tau ));
+      double s = sin( w * ( times[j] - tau ));
+      yc += ( values[j] - mean ) * c;
+      ys += ( values[j] - mean ) * s;
+      cc += c * c;
+      ss += s * s;
+    }
+    double direct = ( yc * yc / cc + ys * ys / ss ) / ( 2.0 * variance );
+    error = std::max( error, fabs( fast->getPower()[k] - direct ));
+  }
+
+  int peak = fast->getPeakBin();
+  double peakPower = fast->getPower()[ peak ];
+  double alarm = LombScargle::falseAlarm( peakPower,
+                                          fast->getBins() / 4.0 );
+  if( error > 1e-3 * peakPower
+      || fabs( fast->getFrequency( peak ) - 3.7 ) > fast->getBinWidth()
+      || alarm > 1e-12 )
+  {
+    cout << "ERR: Fast periodogram off by " << error << ", peak at "
+         << fast->getFrequency( peak ) << " with false alarm " << alarm
+         << endl;
+    passed = false;
+  }
+
+  // the same samples as pairs give the same periodogram
+  PowerSpectrum* pairs = LombScargle::periodogram( &times[0], &values[0], n );
+  passed &= pairs != NULL && pairs->getBins() == fast->getBins();
+  for( int k = 0; passed && k < fast->getBins(); k++ ) {
+    passed &= fabs( pairs->getPower()[k] - fast->getPower()[k] ) < 1e-9;
+  }
+  delete pairs;
+  delete fast;
+
+  passed &= LombScargle::periodogram( &times[0], &values[0], 2 ) == NULL
+            && fabs( LombScargle::falseAlarm( 0.0, 10.0 ) - 1.0 ) < 1e-12;
+  return passed;
+}// end bool testLombScargle()
+
+
+bool testCorrelogram() {
+  bool passed = true;
+  srand( 44 );
+
+  // b follows a two cells behind for the first half and five after
+  const int count = 3000;
+  std::vector<double> source( count );
+  for( int i = 0; i < count; i++ ) {
+    source[i] = rand() % 1000 / 100.0;
+  }
+  DataSeries<double> a( "A" );
+  DataSeries<double> b( "B" );
+  a.initGrid( count, 5, 0 );
+  b.initGrid( count, 5, 0 );
+  for( int i = 0; i < count; i++ ) {
+    int delay = i < count / 2 ? 2 : 5;
+    double value = source[ i >= delay ? i - delay : 0 ] + rand() % 100 / 50.0;
+    if( i % 211 > 15 ) {
+      a.placeValue( &source[i], i );
+    }
+    if( i % 157 > 9 ) {
+      b.placeValue( &value, i );
+    }
+  }
+  a.finalizeData();
+  b.finalizeData();
+
+  // 200 cell windows every 7 cells, lags -3 through 8 cells
+  Correlogram* threaded = Correlogram::correlate( a, b, 1000, 35, -15, 40, 4 );
+  Correlogram* single = Correlogram::correlate( a, b, 1000, 35, -15, 40, 1 );
+  if( threaded == NULL || single == NULL || threaded->getLags() != 12
+      || threaded->getWindows() != ( count - 200 ) / 7 + 1 )
+  {
+    cout << "ERR: Correlogram has the wrong shape." << endl;
+    delete threaded;
+    delete single;
+    return false;
+  }
+
+  double error = 0.0;
+  for( int w = 0; w < threaded->getWindows(); w++ ) {
+    for( int l = 0; l < threaded->getLags(); l++ ) {
+      int lag = l - 3;
+      double n = 0, sa = 0, sb = 0, saa = 0, sbb = 0, sab = 0;
+      for( int i = w * 7; i < w * 7 + 200; i++ ) {
+        int j = i + lag;
+        if( j >= 0 && j < count && a.isValid( i ) && b.isValid( j )) {
+          double x = a.getData()[i];
+          double y = b.getData()[j];
+          n++;
+          sa += x;
+          sb += y;
+          saa += x * x;
+          sbb += y * y;
+          sab += x * y;
+        }
+      }
+      double r = ( sab - sa * sb / n )
+                 / sqrt(( saa - sa * sa / n ) * ( sbb - sb * sb / n ));
+      error = std::max( error, fabs( threaded->getRow( w )[l] - r ));
+      passed &= threaded->isDefined( w, l )
+                && threaded->getCounts( w )[l] == (int)n
+                && fabs( threaded->getRow( w )[l] - single->getRow( w )[l] )
+                   < 1e-12;
+    }
+  }
+  int first = threaded->getPeakLag( 0 ) - 3;
+  int last = threaded->getPeakLag( threaded->getWindows() - 1 ) - 3;
+  if( error > 1e-9 || !passed || first != 2 || last != 5 ) {
+    cout << "ERR: Correlogram off by " << error << ", peak lags " << first
+         << " and " << last << endl;
+    passed = false;
+  }
+
+  std::ifstream written;
+  passed &= threaded->writeBinary( "correlogram.bin" )
+            && threaded->writeColumns( "correlogram.txt" );
+  written.open( "correlogram.bin", std::ios::binary );
+  char magic[4] = { 0 };
+  int header[8] = { 0 };
+  written.read( magic, 4 );
+  written.read( (char*)header, sizeof( header ));
+  passed &= strncmp( magic, "CGRM", 4 ) == 0
+            && header[1] == threaded->getWindows() && header[2] == 12
+            && header[5] == -3;
+  written.close();
+  remove( "correlogram.bin" );
+  remove( "correlogram.txt" );
+
+  passed &= Correlogram::correlate( a, b, 5, 35, 0, 10 ) == NULL;
+  delete threaded;
+  delete single;
+
+  // six cell windows every cell, 13 lags: blocks split validity words, and
+  // blocks restart their sums, so values agree only to rounding
+  DataSeries<double> sparseA( "SPARSEA" );
+  DataSeries<double> sparseB( "SPARSEB" );
+  sparseA.initGrid( 1000, 5, 0 );
+  sparseB.initGrid( 1000, 5, 0 );
+  for( int i = 0; i < 1000; i++ ) {
+    double x = rand() % 100;
+    double y = rand() % 3 == 0 ? 1.0 : x + rand() % 10;
+    if( rand() % 5 < 2 ) {
+      sparseA.placeValue( &x, i );
+    }
+    if( rand() % 5 < 2 ) {
+      sparseB.placeValue( &y, i );
+    }
+  }
+  sparseA.finalizeData();
+  sparseB.finalizeData();
+  int defined = 0;
+  int undefined = 0;
+  for( int run = 0; run < 20; run++ ) {
+    threaded = Correlogram::correlate( sparseA, sparseB, 30, 5, -30, 30, 7 );
+    single = Correlogram::correlate( sparseA, sparseB, 30, 5, -30, 30, 1 );
+    if( threaded == NULL || single == NULL || threaded->getLags() != 13 ) {
+      cout << "ERR: Sparse correlogram has the wrong shape." << endl;
+      delete threaded;
+      delete single;
+      return false;
+    }
+    for( int w = 0; w < single->getWindows(); w++ ) {
+      for( int l = 0; l < single->getLags(); l++ ) {
+        bool isSet = single->isDefined( w, l );
+        defined += isSet ? 1 : 0;
+        undefined += isSet ? 0 : 1;
+        if( threaded->isDefined( w, l ) != isSet
+            || fabs( threaded->getRow( w )[l] - single->getRow( w )[l] )
+               > 1e-9
+            || threaded->getCounts( w )[l] != single->getCounts( w )[l] )
+        {
+          cout << "ERR: Threaded entry ( " << w << ", " << l \
+               << " ) differs" << endl;
+          passed = false;
+          run = 20;
+          break;
+        }
+      }
+      if( !passed ) {
+        break;
+      }
+    }
+    delete threaded;
+    delete single;
+  }
+  if( defined == 0 || undefined == 0 ) {
+    cout << "ERR: Sparse correlogram entries are all " \
+         << ( defined == 0 ? "undefined" : "defined" ) << endl;
+    passed = false;
+  }
+  return passed;
+}// end bool testCorrelogram()
+
+
+/*
+ * Standard normal sample by the Box-Muller transform.
+ */
+double gaussian() {
+  double u = ( rand() + 1.0 ) / ( RAND_MAX + 2.0 );
+  double v = ( rand() + 1.0 ) / ( RAND_MAX + 2.0 );
+  return sqrt( -2.0 * log( u )) * cos( 2.0 * M_PI * v );
+}// end double gaussian()
+
+
+bool testStability() {
+  bool passed = true;
+  srand( 45 );
+
+  // a day of 64 second phase samples under white frequency noise, with gaps
+  const int count = 1350;
+  const double tau0 = 64.0;
+  std::vector<double> phase( count );
+  uint64_t validity[ ( count + 63 ) / 64 ];
+  memset( validity, 0, sizeof( validity ));
+  phase[0] = 0.0;
+  for( int i = 0; i < count; i++ ) {
+    if( i > 0 ) {
+      phase[i] = phase[ i - 1 ] + 1e-9 * tau0 * gaussian();
+    }
+    if( i % 300 > 6 ) {
+      validity[ i >> 6 ] |= (uint64_t)1 << ( i & 63 );
+    }
+  }
+
+  // the defining sums over terms whose span is all valid
+  const int statistics[] = { STABILITY_ADEV, STABILITY_MDEV, STABILITY_TDEV,
+                             STABILITY_MTIE };
+  for( int s = 0; s < 4; s++ ) {
+    std::vector<int> factors;
+    int points = Stability::octaveFactors( statistics[s], count, factors );
+    std::vector<double> deviations( points );
+    std::vector<int> terms( points );
+    Stability::compute( &phase[0], validity, count, tau0, statistics[s],
+                        &factors[0], points, &deviations[0], &terms[0] );
+    for( int p = 0; p < points; p++ ) {
+      const int m = factors[p];
+      const double tau = m * tau0;
+      const int span = statistics[s] == STABILITY_ADEV ? 2 * m + 1
+                       : ( statistics[s] == STABILITY_MTIE ? m + 1 : 3 * m );
+      double sum = 0.0;
+      int used = 0;
+      for( int j = 0; j + span <= count; j++ ) {
+        bool complete = true;
+        for( int i = j; i < j + span; i++ ) {
+          complete &= ( validity[ i >> 6 ] >> ( i & 63 )) & 1;
+        }
+        if( !complete ) {
+          continue;
+        }
+        used++;
+        if( statistics[s] == STABILITY_ADEV ) {
+          sum += pow( phase[ j + 2 * m ] - 2 * phase[ j + m ] + phase[j], 2 );
+        } else if( statistics[s] == STABILITY_MTIE ) {
+          double high = *std::max_element( &phase[j], &phase[j] + span );
+          double low = *std::min_element( &phase[j], &phase[j] + span );
+          sum = std::max( sum, high - low );
+        } else {
+          double inner = 0.0;
+          for( int i = j; i < j + m; i++ ) {
+            inner += phase[ i + 2 * m ] - 2 * phase[ i + m ] + phase[i];
+          }
+          sum += inner * inner;
+        }
+      }
+      double expected = sum;
+      if( statistics[s] == STABILITY_ADEV ) {
+        expected = sqrt( sum / ( 2 * tau * tau * used ));
+      } else if( statistics[s] != STABILITY_MTIE ) {
+        expected = sqrt( sum / ( 2.0 * m * m * tau * tau * used ));
+        expected *= statistics[s] == STABILITY_TDEV ? tau / sqrt( 3.0 ) : 1.0;
+      }
+      if( used == 0 ) {
+        expected = 0.0;
+      }
+      if( terms[p] != used
+          || fabs( deviations[p] - expected ) > 1e-9 * expected )
+      {
+        cout << "ERR: Statistic " << statistics[s] << " at m = " << m
+             << " gave " << deviations[p] << " over " << terms[p]
+             << " terms, expected " << expected << " over " << used << endl;
+        passed = false;
+      }
+    }
+  }
+
+  // white frequency noise falls as tau^-1/2 in ADEV; white phase noise as
+  //   tau^-1 in ADEV and tau^-3/2 in MDEV
+  const int length = 1 << 16;
+  DataSeries<double> frequency( "WHITEFM" );
+  DataSeries<double> white( "WHITEPM" );
+  frequency.initGrid( length, 1, 0 );
+  white.initGrid( length, 1, 0 );
+  for( int i = 0; i < length; i++ ) {
+    double y = 1e-10 * gaussian();
+    double x = 1e-8 * gaussian();
+    frequency.placeValue( &y, i );
+    white.placeValue( &x, i );
+  }
+  frequency.finalizeData();
+  white.finalizeData();
+  StabilityCurve* fm = Stability::octaves( frequency, STABILITY_ADEV, true );
+  StabilityCurve* pmAdev = Stability::octaves( white, STABILITY_ADEV );
+  StabilityCurve* pmMdev = Stability::octaves( white, STABILITY_MDEV );
+  if( fm == NULL || pmAdev == NULL || pmMdev == NULL ) {
+    cout << "ERR: Octave curves could not be computed." << endl;
+    passed = false;
+  } else {
+    double slopes[3];
+    StabilityCurve* curves[] = { fm, pmAdev, pmMdev };
+    for( int c = 0; c < 3; c++ ) {
+      const double* taus = curves[c]->getTaus();
+      const double* deviations = curves[c]->getDeviations();
+      slopes[c] = log( deviations[8] / deviations[2] ) / log( taus[8] / taus[2] );
+    }
+    if( fabs( slopes[0] + 0.5 ) > 0.1 || fabs( slopes[1] + 1.0 ) > 0.1
+        || fabs( slopes[2] + 1.5 ) > 0.1 || fm->getTaus()[0] != 60.0
+        || fabs( fm->getDeviations()[0] - 1e-10 ) > 0.05e-10 )
+    {
+      cout << "ERR: Noise slopes " << slopes[0] << ", " << slopes[1]
+           << ", " << slopes[2] << endl;
+      passed = false;
+    }
+  }
+  delete fm;
+  delete pmAdev;
+  delete pmMdev;
+
+  int factor = count;
+  passed &= !Stability::compute( &phase[0], NULL, count, tau0,
+                                 STABILITY_MDEV, &factor, 1, &phase[0], NULL );
+  return passed;
+}// end bool testStability()
+
+
+/*
+ * State shared by the task pool test's tasks.
+ */
+typedef struct PoolCounts {
+  int runs[ 3000 ];                     // times each task ran
+  pthread_t threads[ 3000 ];            // thread each task ran on
+} PoolCounts;
+
+typedef struct PoolTask {
+  PoolCounts* counts;
+  int index;
+} PoolTask;
+
+static PoolTask poolTasks[ 3000 ];
+
+/*
+ * Blocks on a held lock, occupying a thread stack until the lock is
+ *   released.
+ */
+static void* holdThread( void* lock ) {
+  pthread_mutex_lock( (pthread_mutex_t*)lock );
+  pthread_mutex_unlock( (pthread_mutex_t*)lock );
+  return NULL;
+}// end static void* holdThread( void* )
+
+static void countTask( TaskPool* pool, void* argument ) {
+  PoolTask* task = (PoolTask*)argument;
+  __sync_add_and_fetch( &task->counts->runs[ task->index ], 1 );
+  task->counts->threads[ task->index ] = pthread_self();
+
+  // the first thousand tasks each queue two children
+  if( task->index < 1000 ) {
+    pool->submit( countTask, &poolTasks[ 1000 + 2 * task->index ] );
+    pool->submit( countTask, &poolTasks[ 1001 + 2 * task->index ] );
+  }
+  volatile double spin = 0.0;
+  for( int i = 0; i < 2000; i++ ) {
+    spin += sqrt( (double)i );
+  }
+}// end static void countTask( TaskPool*, void* )
+
+
+bool testTaskPool() {
+  bool passed = true;
+  PoolCounts* counts = new PoolCounts();
+  memset( counts->runs, 0, sizeof( counts->runs ));
+  for( int i = 0; i < 3000; i++ ) {
+    poolTasks[i].counts = counts;
+    poolTasks[i].index = i;
+  }
+
+  {
+    TaskPool pool( 4 );
+    if( pool.getThreads() != 4 ) {
+      cout << "ERR: Pool has " << pool.getThreads() << " threads" << endl;
+      passed = false;
+    }
+    for( int i = 0; i < 1000; i++ ) {
+      pool.submit( countTask, &poolTasks[i] );
+    }
+    pool.wait();
+
+    // every task, children included, ran exactly once before wait returned
+    for( int i = 0; i < 3000; i++ ) {
+      if( counts->runs[i] != 1 ) {
+        cout << "ERR: Task " << i << " ran " << counts->runs[i] \
+             << " times" << endl;
+        passed = false;
+        break;
+      }
+    }
+    int others = 0;
+    for( int i = 1; i < 3000; i++ ) {
+      others += pthread_equal( counts->threads[i], counts->threads[0] ) ? 0
+                                                                         : 1;
+    }
+    if( others == 0 ) {
+      cout << "ERR: Only one worker ran tasks" << endl;
+      passed = false;
+    }
+
+    // the pool is reusable after a wait
+    pool.submit( countTask, &poolTasks[ 2999 ] );
+  }
+  if( counts->runs[ 2999 ] != 2 ) {
+    cout << "ERR: Destructor did not finish the queued task" << endl;
+    passed = false;
+  }
+
+  // leave the child's address space too little room for a thread stack
+  pid_t child = fork();
+  if( child == 0 ) {
+    long pages = 0;
+    FILE* statm = fopen( "/proc/self/statm", "r" );
+    if( statm == NULL || fscanf( statm, "%ld", &pages ) != 1 ) {
+      _exit( 2 );
+    }
+    fclose( statm );
+    pthread_attr_t attributes;
+    size_t stack = 0;
+    pthread_attr_init( &attributes );
+    pthread_attr_getstacksize( &attributes, &stack );
+    pthread_attr_destroy( &attributes );
+    struct rlimit limit;
+    limit.rlim_cur = pages * sysconf( _SC_PAGESIZE ) + stack / 2;
+    limit.rlim_max = limit.rlim_cur;
+    setrlimit( RLIMIT_AS, &limit );
+
+    // stacks cached from finished threads need no new memory, so take them
+    pthread_mutex_t hold = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_lock( &hold );
+    pthread_t holder;
+    for( int i = 0; i < 64; i++ ) {
+      if( pthread_create( &holder, NULL, holdThread, &hold ) != 0 ) {
+        break;
+      }
+    }
+
+    memset( counts->runs, 0, sizeof( counts->runs ));
+    bool good = true;
+    {
+      TaskPool pool( 4 );
+      for( int i = 0; i < 1000; i++ ) {
+        pool.submit( countTask, &poolTasks[i] );
+      }
+      pool.wait();
+      good = pool.getThreads() == 0;
+      for( int i = 0; i < 3000; i++ ) {
+        good &= counts->runs[i] == 1;
+      }
+      pool.submit( countTask, &poolTasks[ 2999 ] );
+    }
+    good &= counts->runs[ 2999 ] == 2;
+    _exit( good ? 0 : 1 );
+  }
+  int status = 0;
+  if( child < 0 || waitpid( child, &status, 0 ) != child
+      || !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 )
+  {
+    cout << "ERR: Pool without threads did not run its tasks" << endl;
+    passed = false;
+  }
+  delete counts;
+  return passed;
+}// end bool testTaskPool()
+
+
+bool testResultWriter() {
+  bool passed = true;
+  srand( 49 );
+
+  // enough rows to cross many 4 KB chunks
+  const int rows = 20000;
+  std::vector<int> lags( rows );
+  std::vector<int> pairs( rows );
+  std::vector<double> correlations( rows );
+  for( int i = 0; i < rows; i++ ) {
+    lags[i] = i - rows / 2;
+    pairs[i] = rand() % 1440;
+    correlations[i] = 2.0 * rand() / RAND_MAX - 1.0;
+  }
+  correlations[0] = 1e-300;
+  correlations[1] = -0.1;
+  ResultHeader header = { "hsynmax10", "SPEED", 5, -rows / 2 };
+  const ResultColumn columns[] = {
+    { "lagMinutes", DATATYPE_INT, &lags[0], NULL },
+    { "pairs", DATATYPE_INT, &pairs[0], NULL },
+    { "correlation", DATATYPE_DOUBLE, NULL, &correlations[0] } };
+
+  const char* paths[] = { "results.txt", "resultsAsync.txt", "results.bin" };
+  for( int w = 0; w < 3; w++ ) {
+    ResultWriter writer( paths[w], w < 2 ? RESULTWRITER_TEXT
+                                         : RESULTWRITER_BINARY,
+                         w == 1, 4096, 3 );
+    passed &= writer.writeTable( header, columns, 3, rows );
+    passed &= writer.close();
+  }
+  if( !passed ) {
+    cout << "ERR: Unable to write results" << endl;
+  }
+
+  // text: a comment line, then rows that read back exactly
+  std::ifstream text( paths[0] );
+  string line;
+  std::getline( text, line );
+  if( line.compare( "# hsynmax10 SPEED lagMinutes pairs correlation" )) {
+    cout << "ERR: Text header '" << line << "'" << endl;
+    passed = false;
+  }
+  int read = 0;
+  while( std::getline( text, line ) && read < rows ) {
+    char* end = NULL;
+    long lag = strtol( line.c_str(), &end, 10 );
+    long pair = strtol( end, &end, 10 );
+    double correlation = strtod( end, &end );
+    if( lag != lags[ read ] || pair != pairs[ read ]
+        || correlation != correlations[ read ] || *end != '\0' )
+    {
+      cout << "ERR: Text row " << read << " is '" << line << "'" << endl;
+      passed = false;
+      break;
+    }
+    read++;
+  }
+  text.close();
+  if( read != rows ) {
+    cout << "ERR: Read " << read << " of " << rows << " text rows" << endl;
+    passed = false;
+  }
+
+  // asynchronous output is the same bytes
+  std::ifstream sync( paths[0], std::ios::binary );
+  std::ifstream async( paths[1], std::ios::binary );
+  string syncBytes( ( std::istreambuf_iterator<char>( sync )),
+                    std::istreambuf_iterator<char>() );
+  string asyncBytes( ( std::istreambuf_iterator<char>( async )),
+                     std::istreambuf_iterator<char>() );
+  if( syncBytes.empty() || syncBytes.compare( asyncBytes )) {
+    cout << "ERR: Asynchronous text differs" << endl;
+    passed = false;
+  }
+
+  // binary: header, labels, then each column whole
+  std::ifstream binary( paths[2], std::ios::binary );
+  char magic[4] = { 0 };
+  int fields[5] = { 0 };
+  int length = 0;
+  char label[32] = { 0 };
+  binary.read( magic, 4 );
+  binary.read( (char*)fields, sizeof( fields ));
+  binary.read( (char*)&length, sizeof( int ));
+  binary.read( label, length );
+  passed &= strncmp( magic, RESULTWRITER_MAGIC, 4 ) == 0
+            && fields[0] == RESULTWRITER_VERSION && fields[1] == 5
+            && fields[2] == -rows / 2 && fields[3] == rows && fields[4] == 3
+            && !strcmp( label, "hsynmax10" );
+  binary.read( (char*)&length, sizeof( int ));
+  binary.ignore( length );
+  for( int c = 0; passed && c < 3; c++ ) {
+    int type = 0;
+    binary.read( (char*)&type, sizeof( int ));
+    binary.read( (char*)&length, sizeof( int ));
+    binary.ignore( length );
+    size_t size = rows * ( type == DATATYPE_INT ? sizeof( int )
+                                                : sizeof( double ));
+    const char* expected = type == DATATYPE_INT
+                           ? (const char*)columns[c].ints
+                           : (const char*)columns[c].doubles;
+    std::vector<char> values( size );
+    binary.read( &values[0], size );
+    if( type != columns[c].type || !binary.good()
+        || memcmp( &values[0], expected, size ))
+    {
+      cout << "ERR: Binary column " << c << " differs" << endl;
+      passed = false;
+    }
+  }
+  binary.close();
+  for( int w = 0; w < 3; w++ ) {
+    remove( paths[w] );
+  }
+
+  // a column without values is refused
+  const ResultColumn missing[] = {
+    { "lagMinutes", DATATYPE_INT, NULL, &correlations[0] } };
+  ResultWriter refused( paths[0] );
+  passed &= !refused.writeTable( header, missing, 1, rows );
+  refused.close();
+  remove( paths[0] );
+  return passed;
+}// end bool testResultWriter()
+
+
+bool testJobManifest() {
+  bool passed = true;
+  char manifestPath[ 64 ];
+  char inputPaths[3][ 64 ];
+  snprintf( manifestPath, sizeof( manifestPath ), "/tmp/crsCorrManifest.%d",
+            (int)getpid() );
+  for( int i = 0; i < 3; i++ ) {
+    snprintf( inputPaths[i], sizeof( inputPaths[i] ), "/tmp/crsCorrInput%d.%d",
+              i, (int)getpid() );
+    std::ofstream input( inputPaths[i] );
+    input << "day " << i << " data\n";
+  }
+  remove( manifestPath );
+
+  for( int mode = JOBMANIFEST_MTIME; mode <= JOBMANIFEST_CONTENT; mode++ ) {
+    // a job per input, its signature the input and a stage parameter
+    uint64_t signatures[3];
+    {
+      JobManifest manifest( manifestPath, mode );
+      passed &= manifest.load() && manifest.getEntries() == 0;
+      for( int i = 0; i < 3; i++ ) {
+        uint64_t input = manifest.fingerprint( inputPaths[i] );
+        signatures[i] = JobManifest::hashValue( 720, input );
+        passed &= !manifest.isCurrent( inputPaths[i], signatures[i] );
+        manifest.record( inputPaths[i], signatures[i] );
+      }
+      passed &= manifest.fingerprint( "/tmp/crsCorrNoSuchFile" )
+                == JOBMANIFEST_MISSING;
+      passed &= manifest.save();
+    }
+    if( !passed ) {
+      cout << "ERR: Unable to record jobs in mode " << mode << endl;
+    }
+
+    // change the second input, same size, one second later
+    std::ofstream changed( inputPaths[1] );
+    changed << "day " << mode << " edit\n";
+    changed.close();
+    struct timespec times[2] = { { 0, UTIME_OMIT }, { 0, 0 } };
+    struct stat inputStat;
+    stat( inputPaths[1], &inputStat );
+    times[1].tv_sec = inputStat.st_mtim.tv_sec + 1;
+    utimensat( AT_FDCWD, inputPaths[1], times, 0 );
+
+    JobManifest reloaded( manifestPath, mode );
+    passed &= reloaded.load() && reloaded.getEntries() == 3;
+    for( int i = 0; i < 3; i++ ) {
+      uint64_t input = reloaded.fingerprint( inputPaths[i] );
+      uint64_t signature = JobManifest::hashValue( 720, input );
+      bool current = reloaded.isCurrent( inputPaths[i], signature );
+      if( current != ( i != 1 )) {
+        cout << "ERR: Job " << i << " in mode " << mode << " is " \
+             << ( current ? "" : "not " ) << "current" << endl;
+        passed = false;
+      }
+      // a changed parameter invalidates every job
+      passed &= !reloaded.isCurrent( inputPaths[i],
+                                     JobManifest::hashValue( 360, input ));
+    }
+    reloaded.forget( inputPaths[0] );
+    passed &= reloaded.getEntries() == 2
+              && !reloaded.isCurrent( inputPaths[0], signatures[0] );
+    remove( manifestPath );
+  }
+
+  // touching a file changes its time but not its content hash
+  JobManifest byTime( manifestPath, JOBMANIFEST_MTIME );
+  JobManifest byContent( manifestPath, JOBMANIFEST_CONTENT );
+  uint64_t timePrint = byTime.fingerprint( inputPaths[2] );
+  uint64_t contentPrint = byContent.fingerprint( inputPaths[2] );
+  struct timespec later[2] = { { 0, UTIME_OMIT }, { 12345, 0 } };
+  utimensat( AT_FDCWD, inputPaths[2], later, 0 );
+  JobManifest touchedTime( manifestPath, JOBMANIFEST_MTIME );
+  JobManifest touchedContent( manifestPath, JOBMANIFEST_CONTENT );
+  if( touchedTime.fingerprint( inputPaths[2] ) == timePrint
+      || touchedContent.fingerprint( inputPaths[2] ) != contentPrint )
+  {
+    cout << "ERR: Fingerprints do not follow their modes" << endl;
+    passed = false;
+  }
+
+  // a file that is not a manifest is refused
+  std::ofstream bogus( manifestPath );
+  bogus << "not a manifest\n";
+  bogus.close();
+  JobManifest refused( manifestPath );
+  passed &= !refused.load();
+
+  remove( manifestPath );
+  for( int i = 0; i < 3; i++ ) {
+    remove( inputPaths[i] );
+  }
+  return passed;
+}// end bool testJobManifest()
@@ -9,6 +9,50 @@
  *   --DataSeries can be retrieved
  *   --Retrieving a non-stored DataSeries returns default DataSeries
  *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of table columns aligned by start time.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of gzip and zstd input.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of ClkStatsParser tail mode.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of the sidecar cache: round trips, stale sidecars,
+ *             and corrupt sidecars.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of storing days before the first stored year.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of TextScan field splitting.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of peerstats demultiplexing.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of the loopstats and peerstats parsers.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of elementwise series expressions.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of the series codec.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added tests of grid placement and of the series store.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of the columnar table against the series.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of series handles against tag lookups.
+ *
+ * Modified: 10/19/26
+ * Notes:    --Added a test of the resample cache: repeated requests share one
+ *             series and the memory budget evicts old resamples.
+ *
  * Modified: 09/10/10
  * Notes:    --Further tests indicated a flaw in the parsing methods which
  *             resulted in an additional duplicated value at the end of each
@@ -62,6 +106,26 @@
 #include <crsCorr/gsMagParser.h>
 #include <crsCorr/gpPartParser.h>
 #include <crsCorr/gsPartParser.h>
+#include <crsCorr/loopStatsParser.h>
+#include <crsCorr/peerStatsParser.h>
+#include <crsCorr/seriesStore.h>
+#include <crsCorr/seriesExpr.h>
+#include <crsCorr/textScan.h>
+#include <crsCorr/decompressBuf.h>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <vector>
+#include <iterator>
+#include <zlib.h>
+#ifdef CRSCORR_HAVE_ZSTD
+#include <zstd.h>
+#endif
 
 //----------------------Testing Vars--------------------------------------------
 
@@ -129,6 +193,116 @@ bool testValues( FileParser* parser,
 bool testParser( FileParser* parser,
                  string testDataPath );
 
+/*
+ * Requests resamples of the parser's first integer series and checks that
+ *   repeated requests return the same series and that a memory budget evicts
+ *   the least recently requested resamples.
+ */
+bool testResamples( FileParser* parser );
+
+/*
+ * Resolves a handle for every series of the parser and checks that it
+ *   yields the same (possibly resampled) series as a tag lookup, and that unknown labels and
+ *   mismatched types give invalid handles.
+ */
+bool testHandles( FileParser* parser );
+
+/*
+ * Checks that every column of the parser's table holds the same values as
+ *   the series it was built from, with the same cells marked valid.
+ */
+bool testTable( FileParser* parser );
+
+/*
+ * Places values into a grid series and checks that unplaced cells stay
+ *   invalid through finalizing, copying, resampling, and concatenation, and
+ *   that the padding the parser appended to its series is marked invalid.
+ */
+bool testGrid( FileParser* parser );
+
+/*
+ * Stores the parser's series as two days with a missing day between them in
+ *   a scratch store, then checks that views and copies over the three days
+ *   return the stored values, with the missing day invalid, both from the
+ *   writing store and from a store reopening the files.
+ */
+bool testStore( FileParser* parser );
+
+/*
+ * Stores a day of 2011 and then days of 2010 and 2009 in a scratch store,
+ *   and checks that every stored day reads back over the whole range, that
+ *   the days between are invalid, and that a view taken before the earlier
+ *   days were stored still reads its day.
+ */
+bool testStoreBackfill();
+
+/*
+ * Parses a generated loopstats file with the sidecar cache enabled, then
+ *   checks that the sidecar restores identical series; that a sidecar is
+ *   ignored and rebuilt once the file's mtime or size changes; and that a
+ *   sidecar with a flipped byte, or truncated to any length, falls back to
+ *   parsing the file and is rebuilt.
+ */
+bool testCache();
+
+/*
+ * Follows a generated clockstats file in tail mode and checks that appended
+ *   complete lines reach the series and the callback, that a partial line is
+ *   held until its newline arrives, that truncating the file restarts
+ *   reading at its beginning, and that rotating it loses no line written to
+ *   the old file and reads the new file from its beginning.
+ */
+bool testTail();
+
+/*
+ * Compresses a generated loopstats file with gzip (and zstd when built with
+ *   it) and checks that the decompressed text, read with several chunk
+ *   sizes, and the parsed series match the plain file; that concatenated
+ *   gzip members are read as one; that trailing garbage after the last
+ *   member is ignored; and that truncated streams fail without a sidecar.
+ */
+bool testCompressed();
+
+/*
+ * Builds a table of series starting at different times, first the latest,
+ *   and checks that columns are aligned by their start times, that uncovered
+ *   cells are invalid, and that series of another resolution or starting
+ *   between cells are dropped.
+ */
+bool testTableAlignment();
+
+/*
+ * Round trips every series of the parser, and random integers and doubles,
+ *   through the series codec, both whole and streamed a block at a time, and
+ *   checks that a day of HHMM stamps shrinks at least fivefold.
+ */
+bool testCodec( FileParser* parser );
+
+/*
+ * Evaluates elementwise expressions of the parser's synmax series and checks
+ *   each cell, the validity carried through the expression, and that series
+ *   of differing resolution are refused.
+ */
+bool testExpressions( FileParser* parser );
+
+/*
+ * Parses generated loopstats and peerstats files spanning three days with
+ *   the middle day missing, and checks that lines land in the cells of their
+ *   MJD and seconds, that lines sharing a cell are averaged, that malformed
+ *   lines are skipped, and that only the system peer's lines are kept.
+ *   Then demultiplexes the peerstats file, and a file of many peers, and
+ *   checks each peer's series and lookup.
+ */
+bool testNtpStats();
+
+/*
+ * Splits fixed lines (fields across the 64 byte block boundary, the
+ *   maxFields cutoff, tabs and runs of spaces, an empty line, a trailing
+ *   delimiter) and random lines, and checks every field, the count, and the
+ *   report of further fields against a plain byte by byte split.
+ */
+bool testTextScan();
+
 
 int main() {
   bool test_aceMag = false;
@@ -139,6 +313,20 @@ int main() {
   bool test_gsMag = false;
   bool test_gsPart = false;
   bool test_gpPart = false;
+  bool test_resamples = false;
+  bool test_handles = false;
+  bool test_table = false;
+  bool test_grid = false;
+  bool test_store = false;
+  bool test_backfill = false;
+  bool test_cache = false;
+  bool test_tail = false;
+  bool test_compressed = false;
+  bool test_alignment = false;
+  bool test_codec = false;
+  bool test_expressions = false;
+  bool test_ntpStats = false;
+  bool test_textScan = false;
 
   // AceMagParser
   #ifdef ACEMAG
@@ -173,6 +361,13 @@ int main() {
     cout << "  Loading " << testDataFile << endl;
     ClkStatsParser clkStats( testDataFile );
     test_clkStats = testValues( &clkStats, testDataPath, 288 );
+    test_resamples = testResamples( &clkStats );
+    test_handles = testHandles( &clkStats );
+    test_table = testTable( &clkStats );
+    test_grid = testGrid( &clkStats );
+    test_store = testStore( &clkStats );
+    test_codec = testCodec( &clkStats );
+    test_expressions = testExpressions( &clkStats );
   }
   #endif
 
@@ -236,6 +431,34 @@ int main() {
   }
   #endif
 
+  // LoopStatsParser, PeerStatsParser
+  cout << "Testing LoopStatsParser, PeerStatsParser: " << endl;
+  test_ntpStats = testNtpStats();
+
+  // TextScan
+  cout << "Testing TextScan: " << endl;
+  test_textScan = testTextScan();
+
+  // SeriesStore
+  cout << "Testing SeriesStore backfill: " << endl;
+  test_backfill = testStoreBackfill();
+
+  // FileParser sidecar cache
+  cout << "Testing the sidecar cache: " << endl;
+  test_cache = testCache();
+
+  // ClkStatsParser tail mode
+  cout << "Testing ClkStatsParser tail mode: " << endl;
+  test_tail = testTail();
+
+  // DecompressBuf
+  cout << "Testing compressed input: " << endl;
+  test_compressed = testCompressed();
+
+  // SeriesTable alignment
+  cout << "Testing SeriesTable alignment: " << endl;
+  test_alignment = testTableAlignment();
+
   cout << "Test Summary:" << endl;
   cout << left << setfill( '-' ) << setw( 80 ) << "-" << setfill( ' ' ) << endl;
   cout << '|' << setw( 40 ) << " Test Name" << '|'
@@ -263,6 +486,76 @@ int main() {
     notApp();
   #endif
 
+  cout << setw( 40 ) << " Resample Cache: ";
+  #ifdef CLKSTATS
+     passFail( test_resamples );
+  #else
+    notApp();
+  #endif
+
+  cout << setw( 40 ) << " Series Handles: ";
+  #ifdef CLKSTATS
+     passFail( test_handles );
+  #else
+    notApp();
+  #endif
+
+  cout << setw( 40 ) << " Series Table: ";
+  #ifdef CLKSTATS
+     passFail( test_table );
+  #else
+    notApp();
+  #endif
+
+  cout << setw( 40 ) << " Grid Placement: ";
+  #ifdef CLKSTATS
+     passFail( test_grid );
+  #else
+    notApp();
+  #endif
+
+  cout << setw( 40 ) << " Series Store: ";
+  #ifdef CLKSTATS
+     passFail( test_store );
+  #else
+    notApp();
+  #endif
+
+  cout << setw( 40 ) << " Series Codec: ";
+  #ifdef CLKSTATS
+     passFail( test_codec );
+  #else
+    notApp();
+  #endif
+
+  cout << setw( 40 ) << " Series Expressions: ";
+  #ifdef CLKSTATS
+     passFail( test_expressions );
+  #else
+    notApp();
+  #endif
+
+  cout << setw( 40 ) << " NTP Stats Parsers: ";
+  passFail( test_ntpStats );
+
+  cout << setw( 40 ) << " Text Scanner: ";
+  passFail( test_textScan );
+
+  cout << setw( 40 ) << " Store Backfill: ";
+  passFail( test_backfill );
+
+  cout << setw( 40 ) << " Sidecar Cache: ";
+  passFail( test_cache );
+
+  cout << setw( 40 ) << " Clockstats Tail: ";
+  passFail( test_tail );
+
+  cout << setw( 40 ) << " Compressed Input: ";
+  passFail( test_compressed );
+
+  cout << setw( 40 ) << " Table Alignment: ";
+  passFail( test_alignment );
+
   cout << setw( 40 ) << " Gp Mag Parser: ";
   #ifdef GPMAG
      passFail( test_gpMag );
@@ -430,3 +723,1465 @@ bool testValues( FileParser* parser,
 
   return result;
 }// end bool testValues( const FileParser* )
+
+
+bool testResamples( FileParser* parser ) {
+  bool result = true;
+  const FileParser::DataTag* const tags = parser->getTags();
+
+  // locate an integer series
+  int index = 0;
+  while( index < parser->getLength() && tags[index].type != DATATYPE_INT ) {
+    index++;
+  }
+  if( index == parser->getLength() ) {
+    LOG_ERR( "No integer series to resample." )
+    return false;
+  }
+
+  FileParser::DataTag twice = { tags[index].label, DATATYPE_INT, 2, 0 };
+  FileParser::DataTag thrice = { tags[index].label, DATATYPE_INT, 3, 0 };
+  FileParser::DataTag fourTimes = { tags[index].label, DATATYPE_INT, 4, 0 };
+
+  // repeated requests share a series
+  const DataSeries<int>* first = parser->getSeries<int>( &twice );
+  size_t bytes = parser->getResampleBytes();
+  const DataSeries<int>* second = parser->getSeries<int>( &twice );
+  if( first == NULL || first != second ) {
+    LOG_ERR( "Repeated resample request returned a new series." )
+    result = false;
+  }
+  if( parser->getResampleBytes() != bytes ) {
+    LOG_ERR( "Repeated resample request allocated " \
+             << parser->getResampleBytes() - bytes << " bytes." )
+    result = false;
+  }
+
+  // a one byte budget keeps only the most recent resamples
+  FileParser::setResampleBudget( 1 );
+  parser->getSeries<int>( &thrice );
+  parser->getSeries<int>( &fourTimes );
+  if( parser->getResampleBytes() > bytes * 2 ) {
+    LOG_ERR( "Resample budget did not evict: " \
+             << parser->getResampleBytes() << " bytes held." )
+    result = false;
+  }
+  FileParser::setResampleBudget( 0 );
+
+  parser->clearResamples();
+  if( parser->getResampleBytes() != 0 ) {
+    LOG_ERR( "Resamples remain after clearing." )
+    result = false;
+  }
+
+  return result;
+}// end bool testResamples( FileParser* )
+
+
+bool testHandles( FileParser* parser ) {
+  bool result = true;
+  const FileParser::DataTag* const tags = parser->getTags();
+
+  for( int i = 0; i < parser->getLength(); i++ ) {
+    if( tags[i].type == DATATYPE_INT ) {
+      FileParser::SeriesHandle<int> handle =
+          parser->getHandle<int>( tags[i].label );
+      FileParser::SeriesHandle<double> wrongType =
+          parser->getHandle<double>( tags[i].label );
+      if( !handle.isValid() || wrongType.isValid()
+          || parser->getSeries( handle, tags[i].reso, tags[i].start )
+             != parser->getSeries<int>( &tags[i] ))
+      {
+        LOG_ERR( "Handle mismatch for " << tags[i].label )
+        result = false;
+      }
+    } else if( tags[i].type == DATATYPE_DOUBLE ) {
+      FileParser::SeriesHandle<double> handle =
+          parser->getHandle<double>( tags[i].label );
+      FileParser::SeriesHandle<int> wrongType =
+          parser->getHandle<int>( tags[i].label );
+      if( !handle.isValid() || wrongType.isValid()
+          || parser->getSeries( handle, tags[i].reso, tags[i].start )
+             != parser->getSeries<double>( &tags[i] ))
+      {
+        LOG_ERR( "Handle mismatch for " << tags[i].label )
+        result = false;
+      }
+    }
+  }
+
+  if( parser->getHandle<int>( "no such label" ).isValid() ) {
+    LOG_ERR( "Handle resolved for an unknown label." )
+    result = false;
+  }
+
+  return result;
+}// end bool testHandles( FileParser* )
+
+
+/*
+ * Compares one column to its series, placed at the offset of its start time.
+ *   Cells of the column the series does not cover must be invalid.
+ */
+template<typename DataType>
+bool testColumn( const SeriesTable* table,
+                 const int column,
+                 const DataSeries<DataType>* series )
+{
+  ColumnSpan<DataType> span = table->getColumn<DataType>( column );
+  if( series == NULL || span.isEmpty() ) {
+    LOG_ERR( "Missing column or series for " << table->getLabel( column ))
+    return false;
+  }
+
+  int offset = ( series->getStartTime() - table->getStartTime() )
+               / table->getResolution();
+  for( int i = 0; i < span.getLength(); i++ ) {
+    int cell = i - offset;
+    if( cell < 0 || cell >= series->getLength() ) {
+      if( span.isValid( i )) {
+        LOG_ERR( "Column " << table->getLabel( column ) << " is valid at " \
+                 << i << " outside its series." )
+        return false;
+      }
+    } else if( span.isValid( i ) != series->isValid( cell )
+               || span[i] != series->getData()[cell] )
+    {
+      LOG_ERR( "Column " << table->getLabel( column ) << " differs at " << i )
+      return false;
+    }
+  }
+  return true;
+}// end bool testColumn( const SeriesTable*, const int, ... )
+
+
+bool testTable( FileParser* parser ) {
+  bool result = true;
+  const SeriesTable* table = parser->getTable();
+  if( table == NULL || table->getColumnCount() == 0 ) {
+    LOG_ERR( "No table for the parser." )
+    return false;
+  }
+  if( table != parser->getTable() ) {
+    LOG_ERR( "Table was rebuilt." )
+    result = false;
+  }
+
+  for( int column = 0; column < table->getColumnCount(); column++ ) {
+    const string& label = table->getLabel( column );
+    if( table->findColumn( label ) != column ) {
+      LOG_ERR( "Column lookup failed for " << label )
+      result = false;
+    }
+    if( table->getType( column ) == DATATYPE_INT ) {
+      result &= testColumn( table, column,
+          parser->getSeries( parser->getHandle<int>( label )));
+      if( !table->getColumn<double>( column ).isEmpty() ) {
+        LOG_ERR( "Integer column " << label << " viewed as double." )
+        result = false;
+      }
+    } else {
+      result &= testColumn( table, column,
+          parser->getSeries( parser->getHandle<double>( label )));
+    }
+  }
+
+  return result;
+}// end bool testTable( FileParser* )
+
+
+bool testGrid( FileParser* parser ) {
+  bool result = true;
+
+  // cells 1, 2, 5, and 8 of ten hold data
+  DataSeries<double> grid( "GRID" );
+  grid.initGrid( 10, 1, 0 );
+  double value = 1.5;
+  int placed[] = { 1, 2, 5, 8 };
+  for( int i = 0; i < 4; i++ ) {
+    grid.placeValue( &value, placed[i] );
+  }
+  if( grid.addValue( &value ) || grid.placeValue( &value, 10 )) {
+    LOG_ERR( "Grid accepted an appended or out of range value." )
+    result = false;
+  }
+  grid.finalizeData();
+  if( !grid.isFinal() || grid.getLength() != 10
+      || grid.getValidCount() != 4 || grid.getValidity() == NULL )
+  {
+    LOG_ERR( "Finalized grid has " << grid.getValidCount() << " valid cells." )
+    result = false;
+  }
+  for( int i = 0; i < 10; i++ ) {
+    bool valid = ( i == 1 || i == 2 || i == 5 || i == 8 );
+    if( grid.isValid( i ) != valid
+        || grid.getData()[i] != ( valid ? value : 0.0 ))
+    {
+      LOG_ERR( "Grid cell " << i << " is wrong." )
+      result = false;
+    }
+  }
+
+  // copies, resamples (every other cell), and concatenations keep gaps
+  DataSeries<double> copy( grid );
+  DataSeries<double> resampled( grid, "RESAMPLED", 2, 0 );
+  DataSeries<double> sum = resampled + resampled;
+  DataSeries<double>* halves = resampled.clone();
+  *halves += resampled;
+  if( copy.getValidCount() != 4 || !copy.isValid( 8 ) || copy.isValid( 9 )) {
+    LOG_ERR( "Copy lost the validity of the grid." )
+    result = false;
+  }
+  if( resampled.getLength() != 5 || resampled.getValidCount() != 2
+      || !resampled.isValid( 1 ) || resampled.isValid( 2 )
+      || !resampled.isValid( 4 ))
+  {
+    LOG_ERR( "Resample lost the validity of the grid." )
+    result = false;
+  }
+  if( sum.getLength() != 10 || sum.getValidCount() != 4
+      || !sum.isValid( 6 ) || sum.isValid( 7 )
+      || halves->getLength() != 10 || halves->getValidCount() != 4
+      || !halves->isValid( 9 ) || halves->isValid( 5 ))
+  {
+    LOG_ERR( "Concatenation lost the validity of the grid." )
+    result = false;
+  }
+  delete halves;
+
+  // a fully placed grid needs no bitmap
+  DataSeries<int> full( "FULL" );
+  full.initGrid( 3, 5, 0 );
+  for( int i = 0; i < 3; i++ ) {
+    full.placeValue( &i, i );
+  }
+  full.finalizeData();
+  if( full.getValidity() != NULL || full.getValidCount() != 3 ) {
+    LOG_ERR( "Fully placed grid kept a bitmap." )
+    result = false;
+  }
+
+  // parser padding follows the data and is invalid
+  const FileParser::DataTag* const tags = parser->getTags();
+  for( int i = 0; i < parser->getLength(); i++ ) {
+    const AbstractDataSeries* series = NULL;
+    if( tags[i].type == DATATYPE_INT ) {
+      series = parser->getSeries( parser->getHandle<int>( tags[i].label ));
+    } else if( tags[i].type == DATATYPE_DOUBLE ) {
+      series = parser->getSeries( parser->getHandle<double>( tags[i].label ));
+    }
+    if( series == NULL ) {
+      continue;
+    }
+    int validCount = series->getValidCount();
+    for( int cell = 0; cell < series->getLength(); cell++ ) {
+      if( series->isValid( cell ) != ( cell < validCount )) {
+        LOG_ERR( "Series " << tags[i].label << " padding is not trailing." )
+        result = false;
+        break;
+      }
+    }
+  }
+
+  return result;
+}// end bool testGrid( FileParser* )
+
+
+/*
+ * Compares three stored days against a series stored on the first and last.
+ */
+template<typename DataType>
+bool testStoredDays( SeriesStore& store,
+                     const DataSeries<DataType>* series )
+{
+  if( series == NULL ) {
+    return true;
+  }
+  const StoreView<DataType> view = store.getView<DataType>(
+      "clkStats", series->getLabel(), 20100716, 20100718 );
+  int cellsPerDay = view.getCellsPerDay();
+  if( view.isEmpty() || view.getLength() != 3 * cellsPerDay
+      || view.getResolution() != series->getResolution()
+      || view.getStartTime() != series->getStartTime()
+      || !store.getView<DataType>( "clkStats", series->getLabel(),
+                                   20100719, 20100720 ).isEmpty() )
+  {
+    LOG_ERR( "Bad view of " << series->getLabel() )
+    return false;
+  }
+
+  for( int cell = 0; cell < cellsPerDay; cell++ ) {
+    for( int day = 0; day < 3; day += 2 ) {
+      int i = day * cellsPerDay + cell;
+      bool valid = series->isValid( cell );
+      if( view.isValid( i ) != valid
+          || ( valid && view[i] != series->getData()[cell] ))
+      {
+        LOG_ERR( "Stored " << series->getLabel() << " differs at " << i )
+        return false;
+      }
+    }
+    if( view.isValid( cellsPerDay + cell )) {
+      LOG_ERR( "Missing day of " << series->getLabel() << " is valid." )
+      return false;
+    }
+  }
+  return true;
+}// end bool testStoredDays( SeriesStore&, const DataSeries<DataType>* )
+
+
+bool testStore( FileParser* parser ) {
+  bool result = true;
+  char root[ 64 ];
+  snprintf( root, sizeof( root ), "/tmp/crsCorrStore.%d", (int)getpid() );
+  const FileParser::DataTag* const tags = parser->getTags();
+
+  {
+    SeriesStore store( root );
+    int stored = store.storeParser( "clkStats", parser, 20100716 );
+    if( stored == 0
+        || store.storeParser( "clkStats", parser, 20100718 ) != stored )
+    {
+      LOG_ERR( "Stored " << stored << " series." )
+      result = false;
+    }
+    for( int i = 0; result && i < parser->getLength(); i++ ) {
+      if( tags[i].type == DATATYPE_INT ) {
+        result &= testStoredDays( store,
+            parser->getSeries( parser->getHandle<int>( tags[i].label )));
+      } else if( tags[i].type == DATATYPE_DOUBLE ) {
+        result &= testStoredDays( store,
+            parser->getSeries( parser->getHandle<double>( tags[i].label )));
+      }
+    }
+  }
+
+  // reopened files hold the same days
+  {
+    SeriesStore store( root );
+    for( int i = 0; result && i < parser->getLength(); i++ ) {
+      if( tags[i].type != DATATYPE_INT ) {
+        continue;
+      }
+      const DataSeries<int>* series =
+          parser->getSeries( parser->getHandle<int>( tags[i].label ));
+      result &= testStoredDays( store, series );
+      if( !store.getView<double>( "clkStats", tags[i].label,
+                                  20100716, 20100716 ).isEmpty() )
+      {
+        LOG_ERR( "Integer series viewed as double." )
+        result = false;
+      }
+
+      // a copy at twice the resolution samples every other cell
+      int reso = series->getResolution() * 2;
+      DataSeries<int>* copy = store.getSeries<int>( "clkStats", tags[i].label,
+                                                   20100716, 20100718, reso );
+      if( copy == NULL || copy->getResolution() != reso
+          || copy->getLength() != 3 * ( 1440 / series->getResolution() ) / 2
+          || copy->getData()[1] != series->getData()[2]
+          || copy->isValid( 1 ) != series->isValid( 2 ))
+      {
+        LOG_ERR( "Bad resampled copy of " << tags[i].label )
+        result = false;
+      }
+      delete copy;
+    }
+  }
+
+  string remove = string( "rm -rf " ) + root;
+  if( system( remove.c_str() ) != 0 ) {
+    LOG_ERR( "Unable to remove " << root )
+  }
+  return result;
+}// end bool testStore( FileParser* )
+
+
+/*
+ * Checks that a view holds the values date * 1000 + cell on the stored dates
+ *   and nothing valid on the others. The view begins on fromDate.
+ */
+bool testBackfillView( const StoreView<int>& view,
+                       const int fromDate,
+                       const int* dates,
+                       const int dateCount )
+{
+  int cellsPerDay = view.getCellsPerDay();
+  if( view.isEmpty() || view.getLength() % cellsPerDay != 0 ) {
+    LOG_ERR( "Bad view from " << fromDate )
+    return false;
+  }
+
+  int firstDay = SeriesStore::dateToDay( fromDate );
+  for( int day = 0; day < view.getLength() / cellsPerDay; day++ ) {
+    int date = SeriesStore::dayToDate( firstDay + day );
+    bool stored = false;
+    for( int i = 0; i < dateCount; i++ ) {
+      stored |= dates[i] == date;
+    }
+    for( int cell = 0; cell < cellsPerDay; cell++ ) {
+      int i = day * cellsPerDay + cell;
+      if( view.isValid( i ) != stored
+          || ( stored && view[i] != ( date % 1000000 ) * 1000 + cell ))
+      {
+        LOG_ERR( "Stored day " << date << " differs at cell " << cell )
+        return false;
+      }
+    }
+  }
+  return true;
+}// end bool testBackfillView( const StoreView<int>&, const int, ... )
+
+
+bool testStoreBackfill() {
+  bool result = true;
+  char root[ 64 ];
+  snprintf( root, sizeof( root ), "/tmp/crsCorrBackfill.%d", (int)getpid() );
+  const int dates[] = { 20110305, 20101230, 20090615 };
+  const int cellsPerDay = 144;
+
+  DataSeries<int>* days[3];
+  for( int i = 0; i < 3; i++ ) {
+    int values[ cellsPerDay ];
+    for( int cell = 0; cell < cellsPerDay; cell++ ) {
+      values[cell] = ( dates[i] % 1000000 ) * 1000 + cell;
+    }
+    days[i] = new DataSeries<int>( "backfill" );
+    days[i]->loadRawData( values, cellsPerDay, 10, 0 );
+  }
+
+  {
+    SeriesStore store( root );
+    if( !store.storeDay( "ntpStats", days[0], dates[0] )) {
+      LOG_ERR( "Unable to store " << dates[0] )
+      result = false;
+    }
+    const StoreView<int> early = store.getView<int>( "ntpStats", "backfill",
+                                                     dates[0], dates[0] );
+    if( !store.storeDay( "ntpStats", days[1], dates[1] )) {
+      LOG_ERR( "Unable to store " << dates[1] << " after " << dates[0] )
+      result = false;
+    }
+    result = result
+             && testBackfillView( early, dates[0], dates, 1 )
+             && testBackfillView( store.getView<int>( "ntpStats", "backfill",
+                                                      20100101, dates[0] ),
+                                  20100101, dates, 2 );
+  }
+
+  // reopened files hold both days and re-base again
+  {
+    SeriesStore store( root );
+    result = result
+             && testBackfillView( store.getView<int>( "ntpStats", "backfill",
+                                                      20100101, dates[0] ),
+                                  20100101, dates, 2 );
+    if( result && !store.storeDay( "ntpStats", days[2], dates[2] )) {
+      LOG_ERR( "Unable to store " << dates[2] << " in reopened files" )
+      result = false;
+    }
+    result = result
+             && testBackfillView( store.getView<int>( "ntpStats", "backfill",
+                                                      20090101, dates[0] ),
+                                  20090101, dates, 3 )
+             && store.getView<int>( "ntpStats", "backfill",
+                                    20081231, dates[0] ).isEmpty();
+  }
+
+  for( int i = 0; i < 3; i++ ) {
+    delete days[i];
+  }
+  string remove = string( "rm -rf " ) + root;
+  if( system( remove.c_str() ) != 0 ) {
+    LOG_ERR( "Unable to remove " << root )
+  }
+  return result;
+}// end bool testStoreBackfill()
+
+
+/*
+ * Encodes count values, then decodes them and compares the bits of each
+ *   value. Returns the encoded size, or 0 on a
+ *   mismatch.
+ */
+template<typename DataType>
+size_t testRoundTrip( const DataType* values, const int count ) {
+  string encoded;
+  if( !SeriesCodec::encode( values, count, SeriesType<DataType>::type,
+                            encoded ))
+  {
+    return 0;
+  }
+
+  DataType* decoded = new DataType[ count ];
+  bool good = SeriesCodec::decode( encoded.data(), encoded.size(),
+                                   SeriesType<DataType>::type, count,
+                                   decoded )
+              && memcmp( decoded, values, count * sizeof( DataType )) == 0;
+  delete[] decoded;
+
+  // a truncated column must be rejected rather than misread
+  if( good && count > 0 ) {
+    decoded = new DataType[ count ];
+    good = !SeriesCodec::decode( encoded.data(), encoded.size() - 1,
+                                 SeriesType<DataType>::type, count,
+                                 decoded );
+    delete[] decoded;
+  }
+  return good ? encoded.size() : 0;
+}// end size_t testRoundTrip( const DataType*, const int )
+
+
+bool testCodec( FileParser* parser ) {
+  bool result = true;
+  const FileParser::DataTag* const tags = parser->getTags();
+  for( int i = 0; i < parser->getLength(); i++ ) {
+    size_t size = 1;
+    if( tags[i].type == DATATYPE_INT ) {
+      const DataSeries<int>* series =
+          parser->getSeries( parser->getHandle<int>( tags[i].label ));
+      size = testRoundTrip( series->getData(), series->getLength() );
+    } else if( tags[i].type == DATATYPE_DOUBLE ) {
+      const DataSeries<double>* series =
+          parser->getSeries( parser->getHandle<double>( tags[i].label ));
+      size = testRoundTrip( series->getData(), series->getLength() );
+    }
+    if( size == 0 ) {
+      LOG_ERR( "Codec round trip of " << tags[i].label << " failed." )
+      result = false;
+    }
+  }
+
+  // one minute stamps only jump at the top of each hour
+  int stamps[ 1440 ];
+  for( int i = 0; i < 1440; i++ ) {
+    stamps[i] = ( i / 60 ) * 100 + i % 60;
+  }
+  size_t size = testRoundTrip( stamps, 1440 );
+  if( size == 0 || sizeof( stamps ) < 5 * size ) {
+    LOG_ERR( "HHMM stamps encoded to " << size << " of " \
+             << sizeof( stamps ) << " bytes." )
+    result = false;
+  }
+
+  // random values over several blocks, including extreme deltas
+  const int count = 3 * SERIESCODEC_BLOCK + 17;
+  int* ints = new int[ count ];
+  double* doubles = new double[ count ];
+  srand( 36 );
+  for( int i = 0; i < count; i++ ) {
+    ints[i] = i % 97 == 0 ? ( i % 2 ? INT_MAX : INT_MIN ) : rand() - RAND_MAX / 2;
+    doubles[i] = i % 5 == 0 ? -999.9 : rand() / (double)RAND_MAX * 1e3;
+  }
+  if( testRoundTrip( ints, count ) == 0
+      || testRoundTrip( doubles, count ) == 0
+      || testRoundTrip( ints, 1 ) == 0
+      || testRoundTrip( doubles, 1 ) == 0 )
+  {
+    LOG_ERR( "Codec round trip of random values failed." )
+    result = false;
+  }
+  delete[] ints;
+  delete[] doubles;
+  return result;
+}// end bool testCodec( FileParser* )
+
+
+bool testExpressions( FileParser* parser ) {
+  bool result = true;
+  const DataSeries<int>* vsyn =
+      parser->getSeries( parser->getHandle<int>( "vsynmax10" ));
+  const DataSeries<int>* hsyn =
+      parser->getSeries( parser->getHandle<int>( "hsynmax10" ));
+  if( vsyn == NULL || hsyn == NULL ) {
+    LOG_ERR( "No synmax series." )
+    return false;
+  }
+
+  // invalidate a few cells of one operand
+  DataSeries<int> gapped( *hsyn );
+  gapped.invalidate( 3, 2 );
+  const int length = vsyn->getLength();
+
+  DataSeries<double>* scaled = evaluate(
+      ( elementwise( *vsyn ) - gapped ) * 0.5 + 1, "scaled" );
+  DataSeries<int>* sum = evaluate( add( *vsyn, *hsyn ), "sum" );
+  DataSeries<int>* bounded = evaluate(
+      clamp( abs( elementwise( *vsyn ) - *hsyn ), 10, 100 ), "bounded" );
+  DataSeries<double>* ratio = evaluate(
+      log( div( *vsyn, elementwise( *hsyn ) + 1 )), "ratio" );
+  if( scaled == NULL || sum == NULL || bounded == NULL || ratio == NULL
+      || scaled->getLength() != length
+      || scaled->getResolution() != vsyn->getResolution()
+      || scaled->getStartTime() != vsyn->getStartTime()
+      || scaled->getLabel() != "scaled" )
+  {
+    LOG_ERR( "Expressions did not evaluate." )
+    result = false;
+  }
+
+  for( int i = 0; result && i < length; i++ ) {
+    int v = vsyn->getData()[i];
+    int h = hsyn->getData()[i];
+    int difference = v - h < 0 ? h - v : v - h;
+    int clamped = difference < 10 ? 10 : ( difference > 100 ? 100 : difference );
+    bool valid = vsyn->isValid( i ) && gapped.isValid( i );
+    if( scaled->getData()[i] != ( v - h ) * 0.5 + 1
+        || scaled->isValid( i ) != valid
+        || sum->getData()[i] != v + h
+        || sum->isValid( i ) != ( vsyn->isValid( i ) && hsyn->isValid( i ))
+        || bounded->getData()[i] != clamped
+        || ratio->getData()[i] != std::log( v / ( h + 1.0 )))
+    {
+      LOG_ERR( "Expression differs at cell " << i )
+      result = false;
+    }
+  }
+  if( result && ( scaled->isValid( 3 ) || scaled->isValid( 4 ))) {
+    LOG_ERR( "Invalid operand cells are valid in the result." )
+    result = false;
+  }
+  delete scaled;
+  delete sum;
+  delete bounded;
+  delete ratio;
+
+  // differing resolutions are refused
+  FileParser::DataTag twice = { "hsynmax10", DATATYPE_INT, 10, 0 };
+  const DataSeries<int>* coarse = parser->getSeries<int>( &twice );
+  DataSeries<int>* mismatched = evaluate( elementwise( *vsyn ) + *coarse );
+  if( coarse == NULL || mismatched != NULL ) {
+    LOG_ERR( "Mismatched resolutions evaluated." )
+    delete mismatched;
+    result = false;
+  }
+  return result;
+}// end bool testExpressions( FileParser* )
+
+
+/*
+ * Checks one cell of a series for its validity and, if valid, its value.
+ */
+template<typename DataType>
+bool testCell( const DataSeries<DataType>* series,
+               const int cell,
+               const bool valid,
+               const DataType value )
+{
+  if( series == NULL || series->isValid( cell ) != valid
+      || ( valid && std::fabs( (double)( series->getData()[cell] - value ))
+                    > 1e-12 ))
+  {
+    LOG_ERR( "Unexpected cell " << cell << " of " \
+             << ( series == NULL ? "missing series" : series->getLabel() ))
+    return false;
+  }
+  return true;
+}// end bool testCell( const DataSeries<DataType>*, const int, ... )
+
+
+bool testNtpStats() {
+  bool result = true;
+  char loopPath[ 64 ];
+  char peerPath[ 64 ];
+  snprintf( loopPath, sizeof( loopPath ), "/tmp/crsCorrLoop.%d",
+            (int)getpid() );
+  snprintf( peerPath, sizeof( peerPath ), "/tmp/crsCorrPeer.%d",
+            (int)getpid() );
+
+  // two lines share minute 0 of the first day; the second day is missing;
+  // the lines of minutes 1 and 2 run long, the second past 64 bytes
+  FILE* file = fopen( loopPath, "w" );
+  fputs( "61332 30.500 0.001 -21.5 0.0001 0.004 6\n"
+         "61332 50.000 0.003 -21.7 0.0003 0.006 7\n"
+         "61332 bad 0.005 -21.6 0.0002 0.005 6\n"
+         "61332 3600\n"
+         "61332 90.000 0.009 -21.7 0.0003 0.006 7 8\n"
+         "61332 150.000 0.009 -21.7 0.0003 0.006 7"
+         "                          8\n"
+         "61334 3659.9 -0.5 -22.0 0.0010 0.010 10\n", file );
+  fclose( file );
+
+  // the system peer reports as 9614 and 961a; 9424 is only a candidate;
+  // the lines of minutes 1 and 2 run long, the second past 64 bytes
+  file = fopen( peerPath, "w" );
+  fputs( "61332 30.500 127.127.36.0 9614 0.002 0.000 0.0009 0.0003\n"
+         "61332 31.000 192.168.1.2 9424 9.999 0.050 0.0100 0.0040\n"
+         "61332 59.000 127.127.36.0 961a 0.004 0.000 0.0011 0.0005\n"
+         "61332 90.000 127.127.36.0 9614 0.009 0.000 0.0011 0.0005 7\n"
+         "61332 150.000 127.127.36.0 9614 0.009 0.000 0.0011"
+         "          0.0005 7\n"
+         "61334 7200.0 127.127.36.0 zz14 0.100 0.000 0.0010 0.0010\n"
+         "61334 7201.0 127.127.36.0 9614 -0.25 0.001 0.0020 0.0020\n", file );
+  fclose( file );
+
+  FileParser::setCaching( false );
+  {
+    LoopStatsParser loop( loopPath );
+    FileParser::DataTag offsetTag = { "offset", DATATYPE_DOUBLE, 1, 0 };
+    FileParser::DataTag mjdTag = { "mjd", DATATYPE_INT, 1, 0 };
+    FileParser::DataTag pollTag = { "poll", DATATYPE_INT, 1, 0 };
+    const DataSeries<double>* offset = loop.getSeries<double>( &offsetTag );
+    const DataSeries<int>* mjd = loop.getSeries<int>( &mjdTag );
+    const DataSeries<int>* poll = loop.getSeries<int>( &pollTag );
+    if( offset == NULL || offset->getLength() != 3 * 1440 ) {
+      LOG_ERR( "Loopstats grid does not span three days." )
+      result = false;
+    } else {
+      int last = 2 * 1440 + 60;
+      result &= testCell( offset, 0, true, 0.002 );
+      result &= testCell( offset, 1, false, 0.0 );
+      result &= testCell( offset, 60, false, 0.0 );
+      result &= testCell( offset, 1440 + 60, false, 0.0 );
+      result &= testCell( offset, last, true, -0.5 );
+      result &= testCell( mjd, last, true, 61334 );
+      result &= testCell( poll, 0, true, 7 );
+      for( int i = 0; i < offset->getLength(); i++ ) {
+        if( offset->isValid( i ) && i != 0 && i != last ) {
+          LOG_ERR( "Unexpected loopstats value in cell " << i )
+          result = false;
+          break;
+        }
+      }
+    }
+  }
+
+  {
+    PeerStatsParser peer( peerPath );
+    FileParser::DataTag offsetTag = { "offset", DATATYPE_DOUBLE, 1, 0 };
+    FileParser::DataTag delayTag = { "delay", DATATYPE_DOUBLE, 1, 0 };
+    FileParser::DataTag jitterTag = { "jitter", DATATYPE_DOUBLE, 1, 0 };
+    const DataSeries<double>* offset = peer.getSeries<double>( &offsetTag );
+    const DataSeries<double>* delay = peer.getSeries<double>( &delayTag );
+    const DataSeries<double>* jitter = peer.getSeries<double>( &jitterTag );
+    if( offset == NULL || offset->getLength() != 3 * 1440 ) {
+      LOG_ERR( "Peerstats grid does not span three days." )
+      result = false;
+    } else {
+      result &= testCell( offset, 0, true, 0.003 );
+      result &= testCell( jitter, 0, true, 0.0004 );
+      result &= testCell( offset, 2 * 1440 + 120, true, -0.25 );
+      result &= testCell( delay, 2 * 1440 + 120, true, 0.001 );
+      result &= testCell( offset, 1, false, 0.0 );
+      result &= testCell( offset, 2, false, 0.0 );
+    }
+  }
+
+  // every peer gets its own series on the grid of the whole file
+  {
+    PeerStatsParser peer( peerPath, true );
+    FileParser::DataTag offsetTag = { "offset", DATATYPE_DOUBLE, 1, 0 };
+    PeerStatsParser* wwv = peer.findPeer( "127.127.36.0" );
+    PeerStatsParser* other = peer.findPeer( "192.168.1.2" );
+    if( peer.getPeerCount() != 2 || wwv == NULL || other == NULL
+        || peer.getPeer( 0 ) != wwv || peer.findPeer( "10.9.9.9" ) != NULL
+        || wwv->getAddress() != "127.127.36.0" )
+    {
+      LOG_ERR( "Demultiplexed " << peer.getPeerCount() << " peers." )
+      result = false;
+    } else {
+      const DataSeries<double>* wwvOffset =
+          wwv->getSeries<double>( &offsetTag );
+      const DataSeries<double>* otherOffset =
+          other->getSeries<double>( &offsetTag );
+      const DataSeries<double>* systemOffset =
+          peer.getSeries<double>( &offsetTag );
+      if( wwvOffset == NULL || otherOffset == NULL
+          || wwvOffset->getLength() != 3 * 1440
+          || otherOffset->getLength() != 3 * 1440 )
+      {
+        LOG_ERR( "Peer grids do not span the file." )
+        result = false;
+      } else {
+        result &= testCell( wwvOffset, 0, true, 0.003 );
+        result &= testCell( wwvOffset, 2 * 1440 + 120, true, -0.25 );
+        result &= testCell( otherOffset, 0, true, 9.999 );
+        result &= testCell( otherOffset, 2 * 1440 + 120, false, 0.0 );
+        result &= testCell( systemOffset, 0, true, 0.003 );
+      }
+    }
+  }
+
+  // enough peers to grow the table several times
+  file = fopen( peerPath, "w" );
+  for( int i = 0; i < 300; i++ ) {
+    fprintf( file, "61332 %d.0 10.0.%d.%d 9424 %d.0 0.0 0.0 0.0\n",
+             i * 60, i / 256, i % 256, i );
+  }
+  fclose( file );
+  {
+    PeerStatsParser peer( peerPath, true );
+    FileParser::DataTag offsetTag = { "offset", DATATYPE_DOUBLE, 1, 0 };
+    if( peer.getPeerCount() != 300 ) {
+      LOG_ERR( "Demultiplexed " << peer.getPeerCount() << " of 300 peers." )
+      result = false;
+    }
+    for( int i = 0; result && i < 300; i++ ) {
+      char address[ 32 ];
+      snprintf( address, sizeof( address ), "10.0.%d.%d", i / 256, i % 256 );
+      PeerStatsParser* child = peer.findPeer( address );
+      if( child == NULL || child != peer.getPeer( i ) ) {
+        LOG_ERR( "Peer " << address << " not found." )
+        result = false;
+      } else {
+        result &= testCell( child->getSeries<double>( &offsetTag ), i, true,
+                            (double)i );
+      }
+    }
+  }
+  FileParser::setCaching( true );
+
+  unlink( loopPath );
+  unlink( peerPath );
+  return result;
+}// end bool testNtpStats()
+
+
+/*
+ * Splits text with splitFields and compares the fields with a byte by byte
+ *   split of the same text.
+ */
+bool testSplit( const string& text, const int maxFields, const bool slash ) {
+  std::vector<string> expected;
+  size_t i = 0;
+  while( i < text.size() ) {
+    size_t end = i;
+    while( end < text.size()
+           && !strchr( slash ? " \t\r\n/" : " \t\r\n", text[ end ] ))
+    {
+      end++;
+    }
+    if( end > i ) {
+      expected.push_back( text.substr( i, end - i ));
+    }
+    i = end + 1;
+  }
+
+  std::vector<char> line( text.begin(), text.end() );
+  line.push_back( '\0' );
+  std::vector<char*> fields( maxFields + 1 );
+  bool more = false;
+  int count = TextScan::splitFields( &line[0], text.size(), &fields[0],
+                                     maxFields, slash, &more );
+  int wanted = (int)expected.size() < maxFields ? expected.size() : maxFields;
+  bool passed = count == wanted
+                && more == ( (int)expected.size() > maxFields );
+  for( int f = 0; passed && f < count; f++ ) {
+    passed = !expected[f].compare( fields[f] );
+  }
+  if( !passed ) {
+    LOG_ERR( "Split of '" << text << "' into " << maxFields \
+             << " fields gave " << count << ( more ? " and more" : "" ))
+  }
+  return passed;
+}// end bool testSplit( const string&, const int, const bool )
+
+
+bool testTextScan() {
+  bool passed = true;
+
+  // the third field ends in the second block
+  string crossing = string( 58, 'a' ) + " bb ccccccccc dd ee";
+  passed &= testSplit( crossing, 3, false );
+  passed &= testSplit( crossing, 5, false );
+  passed &= testSplit( crossing, 6, false );
+  char copy[ 128 ];
+  char* fields[3];
+  bool more = false;
+  strcpy( copy, crossing.c_str() );
+  if( TextScan::splitFields( copy, crossing.size(), fields, 3, false,
+                             &more ) != 3
+      || strcmp( fields[2], "ccccccccc" ) || !more )
+  {
+    LOG_ERR( "Last field ran on: '" << fields[2] << "'" )
+    passed = false;
+  }
+
+  // fields starting, ending, and straddling each side of the boundary
+  for( int offset = 56; offset <= 72; offset++ ) {
+    string line = string( offset, ' ' ) + "xxxxxxxx\tyy  zz";
+    for( int maxFields = 0; maxFields <= 4; maxFields++ ) {
+      passed &= testSplit( line, maxFields, false );
+    }
+  }
+
+  // tabs and runs of spaces, empty lines, trailing delimiters, slashes
+  passed &= testSplit( "a\t\tb    c \t d", 4, false );
+  passed &= testSplit( "", 3, false );
+  passed &= testSplit( "   \t ", 3, false );
+  passed &= testSplit( "a b ", 2, false );
+  passed &= testSplit( "a b ", 1, false );
+  passed &= testSplit( "2010/08/13 0000", 4, true );
+  passed &= testSplit( "2010/08/13 0000", 2, true );
+
+  // random lines over several blocks
+  srand( 29 );
+  const char alphabet[] = "ab1.-  \t/";
+  for( int trial = 0; passed && trial < 2000; trial++ ) {
+    string line( rand() % 200, ' ' );
+    for( size_t i = 0; i < line.size(); i++ ) {
+      line[i] = alphabet[ rand() % ( sizeof( alphabet ) - 1 ) ];
+    }
+    passed &= testSplit( line, rand() % 12, trial % 2 == 1 );
+  }
+  return passed;
+}// end bool testTextScan()
+
+
+/*
+ * Compares one series of two parsers: layout, validity, and the bits of
+ *   every valid value.
+ */
+template<typename DataType>
+bool testSameSeries( const DataSeries<DataType>* expected,
+                     const DataSeries<DataType>* actual )
+{
+  if( expected == NULL || actual == NULL
+      || expected->getLength() != actual->getLength()
+      || expected->getResolution() != actual->getResolution()
+      || expected->getStartTime() != actual->getStartTime() )
+  {
+    LOG_ERR( "Series layouts differ." )
+    return false;
+  }
+  for( int i = 0; i < expected->getLength(); i++ ) {
+    if( expected->isValid( i ) != actual->isValid( i )
+        || ( expected->isValid( i )
+             && memcmp( &expected->getData()[i], &actual->getData()[i],
+                        sizeof( DataType )) != 0 ))
+    {
+      LOG_ERR( "Series " << expected->getLabel() << " differs at " << i )
+      return false;
+    }
+  }
+  return true;
+}// end bool testSameSeries( const DataSeries<DataType>*, ... )
+
+
+/*
+ * Compares every series of two parsers of the same type.
+ */
+bool testSameParse( const FileParser* expected, const FileParser* actual ) {
+  bool result = expected->getLength() == actual->getLength();
+  const FileParser::DataTag* const tags = expected->getTags();
+  for( int i = 0; result && i < expected->getLength(); i++ ) {
+    if( tags[i].type == DATATYPE_INT ) {
+      result = testSameSeries(
+          expected->getSeries( expected->getHandle<int>( tags[i].label )),
+          actual->getSeries( actual->getHandle<int>( tags[i].label )));
+    } else if( tags[i].type == DATATYPE_DOUBLE ) {
+      result = testSameSeries(
+          expected->getSeries( expected->getHandle<double>( tags[i].label )),
+          actual->getSeries( actual->getHandle<double>( tags[i].label )));
+    }
+  }
+  return result;
+}// end bool testSameParse( const FileParser*, const FileParser* )
+
+
+/*
+ * Writes text to a file and, when mtime is provided, sets the file's
+ *   modification time to it so that only the contents change.
+ */
+void writeFile( const char* path,
+                const char* text,
+                const struct timespec* mtime = NULL )
+{
+  FILE* file = fopen( path, "w" );
+  fputs( text, file );
+  fclose( file );
+  if( mtime != NULL ) {
+    struct timespec times[2] = { *mtime, *mtime };
+    utimensat( AT_FDCWD, path, times, 0 );
+  }
+}// end void writeFile( const char*, const char*, const struct timespec* )
+
+
+/*
+ * Returns the offset a freshly constructed parser reads for minute 0 of a
+ *   loopstats file, or 0 if the cell is invalid.
+ */
+double cachedOffset( const char* path ) {
+  LoopStatsParser loop( path );
+  FileParser::DataTag offsetTag = { "offset", DATATYPE_DOUBLE, 1, 0 };
+  const DataSeries<double>* offset = loop.getSeries<double>( &offsetTag );
+  if( offset == NULL || !offset->isValid( 0 )) {
+    return 0.0;
+  }
+  return offset->getData()[0];
+}// end double cachedOffset( const char* )
+
+
+bool testCache() {
+  bool result = true;
+  char path[ 64 ];
+  snprintf( path, sizeof( path ), "/tmp/crsCorrCache.%d", (int)getpid() );
+  string sidecar = string( path ) + FILEPARSER_CACHE_EXT;
+
+  // the two texts have the same size and differ only in the offset of minute 0
+  const char* first = "61332 30.000 0.001 -21.5 0.0001 0.004 6\n"
+                      "61332 3659.9 -0.5 -22.0 0.0010 0.010 10\n";
+  const char* second = "61332 30.000 0.007 -21.5 0.0001 0.004 6\n"
+                       "61332 3659.9 -0.5 -22.0 0.0010 0.010 10\n";
+  unlink( sidecar.c_str() );
+  writeFile( path, first );
+  struct stat fileStat;
+  stat( path, &fileStat );
+  struct timespec mtime = fileStat.st_mtim;
+
+  // round trip: a second parser restores identical series from the sidecar
+  {
+    FileParser::setCaching( false );
+    LoopStatsParser parsed( path );
+    FileParser::setCaching( true );
+    LoopStatsParser written( path );
+    LoopStatsParser restored( path );
+    if( stat( sidecar.c_str(), &fileStat ) != 0 ) {
+      LOG_ERR( "No sidecar was written for " << path )
+      result = false;
+    }
+    result = result
+             && testSameParse( &parsed, &written )
+             && testSameParse( &parsed, &restored );
+  }
+
+  // the sidecar, not the text, is read while the key matches
+  writeFile( path, second, &mtime );
+  if( result && cachedOffset( path ) != 0.001 ) {
+    LOG_ERR( "Sidecar was not used for an unchanged key." )
+    result = false;
+  }
+
+  // a later mtime makes the sidecar stale; it is rebuilt from the text
+  mtime.tv_sec += 10;
+  writeFile( path, second, &mtime );
+  if( result && cachedOffset( path ) != 0.007 ) {
+    LOG_ERR( "Sidecar with an old mtime was used." )
+    result = false;
+  }
+  writeFile( path, first, &mtime );
+  if( result && cachedOffset( path ) != 0.007 ) {
+    LOG_ERR( "Sidecar was not rebuilt after a changed mtime." )
+    result = false;
+  }
+
+  // a changed size with the same mtime makes the sidecar stale too
+  writeFile( path, "61332 30.000 0.003 -21.5 0.0001 0.004 6\n", &mtime );
+  if( result && cachedOffset( path ) != 0.003 ) {
+    LOG_ERR( "Sidecar of a different size was used." )
+    result = false;
+  }
+
+  // corrupt sidecars fall back to parsing and are rebuilt
+  writeFile( path, first, &mtime );
+  cachedOffset( path );
+  stat( sidecar.c_str(), &fileStat );
+  const off_t sidecarSize = fileStat.st_size;
+  const off_t cuts[] = { -1, 0, 1, 4, sidecarSize / 2, sidecarSize - 1 };
+  for( size_t i = 0; result && i < sizeof( cuts ) / sizeof( cuts[0] ); i++ ) {
+    if( cuts[i] < 0 ) {
+      // flip one byte in the middle
+      int fd = open( sidecar.c_str(), O_RDWR );
+      unsigned char byte = 0;
+      if( pread( fd, &byte, 1, sidecarSize / 2 ) == 1 ) {
+        byte ^= 0x5a;
+        result &= pwrite( fd, &byte, 1, sidecarSize / 2 ) == 1;
+      }
+      close( fd );
+    } else {
+      result &= truncate( sidecar.c_str(), cuts[i] ) == 0;
+    }
+
+    FileParser::setCaching( false );
+    LoopStatsParser parsed( path );
+    FileParser::setCaching( true );
+    LoopStatsParser fallback( path );
+    if( !testSameParse( &parsed, &fallback )
+        || stat( sidecar.c_str(), &fileStat ) != 0
+        || fileStat.st_size != sidecarSize )
+    {
+      LOG_ERR( "Corrupt sidecar " << i << " was not replaced by a parse." )
+      result = false;
+    }
+  }
+
+  // the rebuilt sidecar is used again
+  writeFile( path, second, &mtime );
+  if( result && cachedOffset( path ) != 0.001 ) {
+    LOG_ERR( "Rebuilt sidecar was not used." )
+    result = false;
+  }
+
+  unlink( path );
+  unlink( sidecar.c_str() );
+  return result;
+}// end bool testCache()
+
+
+/*
+ * Returns a wwv5 line of the WV2 station with a gain of 2 whose vsynmax2 and
+ *   hsynmax2 values are 2 * vsynmax and 2 * hsynmax.
+ */
+string wwv5Line( const int vsynmax, const int hsynmax ) {
+  char line[ WWV5_LINESIZE ];
+  snprintf( line, sizeof( line ),
+            "55393 60.000 127.127.36.0 wwv5 0000 2 0 0 0 0 0 WV2 "
+            "1 2 %d 4 5 6 WH2 1 2 %d 4 5 6 7\n", vsynmax, hsynmax );
+  return line;
+}// end string wwv5Line( const int, const int )
+
+
+/*
+ * Appends text to a file.
+ */
+void appendFile( const char* path, const string& text ) {
+  FILE* file = fopen( path, "a" );
+  fputs( text.c_str(), file );
+  fclose( file );
+}// end void appendFile( const char*, const string& )
+
+
+/*
+ * Tail callback counting the values it is passed.
+ */
+void countSample( const AbstractDataSeries& series,
+                  const void* value,
+                  void* context )
+{
+  (*(int*)context)++;
+}// end void countSample( const AbstractDataSeries&, const void*, void* )
+
+
+/*
+ * Checks the length of a snapshot of vsynmax2 and its last value.
+ */
+bool testTailSnapshot( const ClkStatsParser& parser,
+                       const int length,
+                       const int last )
+{
+  FileParser::DataTag tag = { "vsynmax2", DATATYPE_INT, 5, 0 };
+  DataSeries<int>* copy = parser.snapshot<int>( &tag );
+  bool result = copy != NULL
+                && copy->getLength() == length
+                && copy->getData()[ length - 1 ] == last;
+  if( !result ) {
+    LOG_ERR( "Snapshot of " << ( copy == NULL ? 0 : copy->getLength() ) \
+             << " values does not end with the " << length << "th, " << last )
+  }
+  delete copy;
+  return result;
+}// end bool testTailSnapshot( const ClkStatsParser&, const int, const int )
+
+
+bool testTail() {
+  bool result = true;
+  char path[ 64 ];
+  char rotated[ sizeof( path ) + 2 ];
+  snprintf( path, sizeof( path ), "/tmp/crsCorrTail.%d", (int)getpid() );
+  snprintf( rotated, sizeof( rotated ), "%s.1", path );
+  writeFile( path, "" );
+
+  int samples = 0;
+  ClkStatsParser parser( path, countSample, &samples );
+  if( parser.poll() != 0 ) {
+    LOG_ERR( "Empty file produced lines." )
+    result = false;
+  }
+
+  // complete lines, with a line of another kind between them
+  appendFile( path, wwv5Line( 10, 11 ) + "55393 61.000 127.127.36.0 wwv3\n"
+                    + wwv5Line( 20, 21 ));
+  if( parser.poll() != 2 || samples != 4 ) {
+    LOG_ERR( "Appended lines were not read: " << samples << " samples" )
+    result = false;
+  }
+  result &= testTailSnapshot( parser, 2, 40 );
+  FileParser::DataTag unknown = { "vsynmax3", DATATYPE_INT, 5, 0 };
+  FileParser::DataTag mistyped = { "vsynmax2", DATATYPE_DOUBLE, 5, 0 };
+  if( parser.snapshot<int>( &unknown ) != NULL
+      || parser.snapshot<double>( &mistyped ) != NULL )
+  {
+    LOG_ERR( "Snapshot of an unknown or mistyped label." )
+    result = false;
+  }
+
+  // a partial line is held until its newline arrives
+  string line = wwv5Line( 30, 31 );
+  appendFile( path, line.substr( 0, 40 ));
+  if( parser.poll() != 0 || samples != 4 ) {
+    LOG_ERR( "Partial line was parsed." )
+    result = false;
+  }
+  appendFile( path, line.substr( 40, line.size() - 41 ));
+  if( parser.poll() != 0 ) {
+    LOG_ERR( "Line without its newline was parsed." )
+    result = false;
+  }
+  appendFile( path, "\n" );
+  if( parser.poll() != 1 || samples != 6 ) {
+    LOG_ERR( "Completed line was not read." )
+    result = false;
+  }
+  result &= testTailSnapshot( parser, 3, 60 );
+
+  // truncation restarts at the beginning and drops a held partial line
+  appendFile( path, line.substr( 0, 40 ));
+  parser.poll();
+  writeFile( path, wwv5Line( 40, 41 ).c_str() );
+  if( parser.poll() != 1 || samples != 8 ) {
+    LOG_ERR( "Truncated file was not restarted." )
+    result = false;
+  }
+  result &= testTailSnapshot( parser, 4, 80 );
+
+  // lines appended just before a rotation are read from the old file
+  appendFile( path, wwv5Line( 50, 51 ));
+  if( rename( path, rotated ) != 0 ) {
+    LOG_ERR( "Unable to rotate " << path )
+    result = false;
+  }
+  if( parser.poll() != 1 || samples != 10 ) {
+    LOG_ERR( "Line written before the rotation was lost." )
+    result = false;
+  }
+  result &= testTailSnapshot( parser, 5, 100 );
+
+  // the old file is read to its end before the new one is followed, and
+  // no line is delivered twice
+  appendFile( rotated, wwv5Line( 60, 61 ));
+  writeFile( path, ( wwv5Line( 70, 71 ) + wwv5Line( 80, 81 )).c_str() );
+  if( parser.poll() != 3 || samples != 16 ) {
+    LOG_ERR( "Rotated file was not drained and reopened." )
+    result = false;
+  }
+  if( parser.poll() != 0 || samples != 16 ) {
+    LOG_ERR( "Lines were delivered twice." )
+    result = false;
+  }
+  result &= testTailSnapshot( parser, 8, 160 );
+
+  // finishing finalizes the series, padded to a day of invalid cells
+  parser.finishTail();
+  FileParser::DataTag tag = { "hsynmax2", DATATYPE_INT, 5, 0 };
+  const DataSeries<int>* hsynmax = parser.getSeries<int>( &tag );
+  if( parser.poll() != -1 || hsynmax == NULL || !hsynmax->isFinal()
+      || hsynmax->getLength() != 288 || hsynmax->getData()[7] != 162
+      || !hsynmax->isValid( 7 ) || hsynmax->isValid( 8 ))
+  {
+    LOG_ERR( "Finished tail series are not final." )
+    result = false;
+  }
+
+  unlink( path );
+  unlink( rotated );
+  return result;
+}// end bool testTail()
+
+
+/*
+ * Reads a compressed file through a DecompressBuf into text and returns
+ *   whether the buffer reports success.
+ */
+bool readCompressed( const string& path,
+                     const int format,
+                     const size_t chunkSize,
+                     string* text )
+{
+  DecompressBuf buffer( path, format, chunkSize, 2 );
+  text->assign( std::istreambuf_iterator<char>( &buffer ),
+                std::istreambuf_iterator<char>() );
+  return buffer.good();
+}// end bool readCompressed( const string&, const int, ... )
+
+
+/*
+ * Writes text to a file as one gzip member; mode "ab" appends another member.
+ */
+void writeGzip( const string& path, const string& text, const char* mode ) {
+  gzFile file = gzopen( path.c_str(), mode );
+  gzwrite( file, text.data(), text.size() );
+  gzclose( file );
+}// end void writeGzip( const string&, const string&, const char* )
+
+
+/*
+ * Checks that a compressed file decompresses to text with every chunk size
+ *   and parses to the same series as the plain file.
+ */
+bool testDecompressed( const string& path,
+                       const int format,
+                       const string& text,
+                       const FileParser* plain )
+{
+  const size_t chunkSizes[] = { 1, 2, 3, 7, 64, DECOMPRESS_CHUNK_SIZE };
+  for( size_t i = 0; i < sizeof( chunkSizes ) / sizeof( chunkSizes[0] ); i++ ) {
+    string read;
+    if( !readCompressed( path, format, chunkSizes[i], &read )
+        || read != text )
+    {
+      LOG_ERR( "Reading " << path << " in chunks of " << chunkSizes[i] \
+               << " gave " << read.size() << " of " << text.size() \
+               << " bytes." )
+      return false;
+    }
+  }
+
+  LoopStatsParser parsed( path );
+  return testSameParse( plain, &parsed );
+}// end bool testDecompressed( const string&, const int, ... )
+
+
+/*
+ * Checks that a truncated compressed file fails, yields only a prefix of
+ *   the text, and leaves no sidecar behind when parsed.
+ */
+bool testTruncated( const string& path,
+                    const int format,
+                    const string& text )
+{
+  string read;
+  if( readCompressed( path, format, 64, &read )
+      || text.compare( 0, read.size(), read ) != 0 )
+  {
+    LOG_ERR( "Truncated " << path << " was read as good." )
+    return false;
+  }
+
+  struct stat fileStat;
+  string sidecar = path + FILEPARSER_CACHE_EXT;
+  {
+    LoopStatsParser parsed( path );
+  }
+  if( stat( sidecar.c_str(), &fileStat ) == 0 ) {
+    LOG_ERR( "Truncated " << path << " left a sidecar." )
+    unlink( sidecar.c_str() );
+    return false;
+  }
+  return true;
+}// end bool testTruncated( const string&, const int, const string& )
+
+
+bool testCompressed() {
+  bool result = true;
+  char path[ 64 ];
+  snprintf( path, sizeof( path ), "/tmp/crsCorrCompressed.%d", (int)getpid() );
+  string gzPath = string( path ) + ".gz";
+  string zstPath = string( path ) + ".zst";
+
+  // a day of loopstats lines, one a minute
+  string text;
+  for( int minute = 0; minute < 1440; minute++ ) {
+    char line[ 80 ];
+    snprintf( line, sizeof( line ), "61332 %d.000 %.6f -21.5 0.0001 0.004 6\n",
+              minute * 60, minute * 1e-6 );
+    text += line;
+  }
+  writeFile( path, text.c_str() );
+
+  FileParser::setCaching( false );
+  LoopStatsParser plain( path );
+
+  // one member, then two members
+  writeGzip( gzPath, text, "wb" );
+  result &= testDecompressed( gzPath, COMPRESSION_GZIP, text, &plain );
+  writeGzip( gzPath, text.substr( 0, text.size() / 3 ), "wb" );
+  writeGzip( gzPath, text.substr( text.size() / 3 ), "ab" );
+  result &= testDecompressed( gzPath, COMPRESSION_GZIP, text, &plain );
+
+  // trailing garbage after the last member is ignored, including a lone
+  // first magic byte and a magic byte followed by something else
+  const char* garbage[] = { "not gzip\n", "\x1f", "\x1fz", "\n\n" };
+  for( size_t i = 0; i < sizeof( garbage ) / sizeof( garbage[0] ); i++ ) {
+    writeGzip( gzPath, text.substr( 0, text.size() / 3 ), "wb" );
+    writeGzip( gzPath, text.substr( text.size() / 3 ), "ab" );
+    appendFile( gzPath.c_str(), garbage[i] );
+    result &= testDecompressed( gzPath, COMPRESSION_GZIP, text, &plain );
+  }
+
+  // truncated in the header, the data, and the trailer
+  FileParser::setCaching( true );
+  writeGzip( gzPath, text, "wb" );
+  struct stat fileStat;
+  stat( gzPath.c_str(), &fileStat );
+  const off_t gzSize = fileStat.st_size;
+  const off_t cuts[] = { 5, gzSize / 2, gzSize - 3 };
+  for( size_t i = 0; i < sizeof( cuts ) / sizeof( cuts[0] ); i++ ) {
+    writeGzip( gzPath, text, "wb" );
+    result &= truncate( gzPath.c_str(), cuts[i] ) == 0
+              && testTruncated( gzPath, COMPRESSION_GZIP, text );
+  }
+  FileParser::setCaching( false );
+
+#ifdef CRSCORR_HAVE_ZSTD
+  std::vector<char> frame( ZSTD_compressBound( text.size() ));
+  size_t frameSize = ZSTD_compress( &frame[0], frame.size(), text.data(),
+                                    text.size(), 3 );
+  FILE* file = fopen( zstPath.c_str(), "w" );
+  fwrite( &frame[0], 1, frameSize, file );
+  fclose( file );
+  result &= testDecompressed( zstPath, COMPRESSION_ZSTD, text, &plain );
+
+  FileParser::setCaching( true );
+  result &= truncate( zstPath.c_str(), frameSize / 2 ) == 0
+            && testTruncated( zstPath, COMPRESSION_ZSTD, text );
+  FileParser::setCaching( false );
+#else
+  // without zstd support a zstd file fails rather than parsing as text
+  writeFile( zstPath.c_str(), "\x28\xb5\x2f\xfd zstd frame" );
+  result &= DecompressBuf::detectFormat( zstPath ) == COMPRESSION_ZSTD;
+  FileParser::setCaching( true );
+  result &= testTruncated( zstPath, COMPRESSION_ZSTD, text );
+  FileParser::setCaching( false );
+#endif
+
+  FileParser::setCaching( true );
+  unlink( path );
+  unlink( gzPath.c_str() );
+  unlink( zstPath.c_str() );
+  return result;
+}// end bool testCompressed()
+
+
+bool testTableAlignment() {
+  // resolution 5: late starts at 00:10, early at 00:00, offset at 00:03
+  const int values[] = { 1, 2, 3, 4 };
+  DataSeries<int> late( "LATE" );
+  DataSeries<int> early( "EARLY" );
+  DataSeries<int> offset( "OFFSET" );
+  DataSeries<int> coarse( "COARSE" );
+  late.loadRawData( values, 3, 5, 10 );
+  early.loadRawData( values, 4, 5, 0 );
+  offset.loadRawData( values, 4, 5, 3 );
+  coarse.loadRawData( values, 4, 10, 0 );
+  early.invalidate( 1, 1 );
+  const AbstractDataSeries* series[] = { &late, NULL, &offset, &early,
+                                         &coarse };
+
+  SeriesTable table( series, 5 );
+  bool result = table.getColumnCount() == 2
+                && table.getStartTime() == 0
+                && table.getResolution() == 5
+                && table.getLength() == 5
+                && table.findColumn( "OFFSET" ) < 0
+                && table.findColumn( "COARSE" ) < 0;
+  if( !result ) {
+    LOG_ERR( "Table of " << table.getColumnCount() << " columns starts at " \
+             << table.getStartTime() << " with " << table.getLength() \
+             << " cells." )
+    return false;
+  }
+
+  ColumnSpan<int> lateSpan = table.getColumn<int>( table.findColumn( "LATE" ));
+  ColumnSpan<int> earlySpan =
+      table.getColumn<int>( table.findColumn( "EARLY" ));
+  result = testColumn( &table, table.findColumn( "LATE" ), &late )
+           && testColumn( &table, table.findColumn( "EARLY" ), &early )
+           && !lateSpan.isValid( 1 ) && lateSpan.isValid( 2 )
+           && lateSpan[2] == 1 && lateSpan[4] == 3
+           && !earlySpan.isValid( 1 ) && !earlySpan.isValid( 4 )
+           && earlySpan[3] == 4;
+  if( !result ) {
+    LOG_ERR( "Columns are not aligned by start time." )
+  }
+  return result;
+}// end bool testTableAlignment()